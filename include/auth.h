@@ -2,48 +2,121 @@
 #define AUTH_H
 
 #include <stdint.h>
+#include "wire.h"
 
 // Authentication message types
 enum AuthMsgType {
     AUTH_VERIFY = 1,    // Request verification (biometric sample)
     AUTH_SUCCESS = 2,   // Authentication successful
-    AUTH_FAILURE = 3    // Authentication failed
+    AUTH_FAILURE = 3,   // Authentication failed
+    AUTH_LOCK = 4,      // Session confidence fell below AUTH_LOCK_BELOW
+    AUTH_UNLOCK = 5     // Session confidence recovered above AUTH_UNLOCK_ABOVE
 };
 
+#define AUTH_TEMPLATE_DIM 32            // Floats per profile and per sample
+
+typedef uint8_t auth_token_t[32];
+typedef float auth_sample_t[AUTH_TEMPLATE_DIM];  // Biometric features (see dsp_profile.h)
+
+// Schemas (see wire.h). Append new fields at the end and bump the
+// version; the C structs and their wire payloads share one layout.
+// Version 2 added the sample an AUTH_VERIFY request is scored on. A
+// request from an older sender decodes with an all-zero sample and is
+// refused.
+// Version 3 added the session confidence for continuous authentication
+#define AUTH_MSG_VERSION 3
+#define AUTH_MSG_FIELDS(X, S) \
+    X(S, int32_t, type)                 /* AuthMsgType */ \
+    X(S, int32_t, user_id)              /* User identifier */ \
+    X(S, uint32_t, timestamp)           /* Authentication timestamp */ \
+    X(S, auth_token_t, security_token)  /* Security token/hash */ \
+    X(S, auth_sample_t, sample)         /* AUTH_VERIFY only */ \
+    X(S, float, confidence)             /* [0, 1], see dsp_trust.h */
+
+// Version 2 added the window metrics behind the score (see dsp_hrv.h)
+#define HRV_VERSION 2
+#define HRV_FIELDS(X, S) \
+    X(S, uint32_t, timestamp)           /* Monotonic ms, at the beat */ \
+    X(S, float, heart_rate) \
+    X(S, float, hrv_score) \
+    X(S, float, stress_level) \
+    X(S, float, rmssd)                  /* ms */ \
+    X(S, float, sdnn)                   /* ms */ \
+    X(S, float, pnn50)                  /* percent */
+
+#define EEG_VERSION 1
+#define EEG_FIELDS(X, S) \
+    X(S, uint32_t, timestamp)           /* Monotonic ms, at the window end */ \
+    X(S, float, alpha_waves)            /* Relative band power (see dsp_eeg.h) */ \
+    X(S, float, beta_waves) \
+    X(S, float, theta_waves) \
+    X(S, float, delta_waves) \
+    X(S, float, focus_level)            /* [0, 1] */ \
+    X(S, float, relaxation_level)       /* [0, 1] */
+
 // Authentication message structure
 struct AuthMsg {
-    int type;           // AuthMsgType
-    int user_id;        // User identifier
-    uint32_t timestamp; // Authentication timestamp
-    uint8_t security_token[32]; // Security token/hash
-} __attribute__((packed));
+    AUTH_MSG_FIELDS(WIRE_FIELD, AuthMsg)
+};
 
-// Biometric data structures
+// Biometric data structures: one sample, and a struct-of-arrays batch of
+// up to WIRE_BATCH_MAX samples whose arrays are 16-byte aligned
 struct HRVData {
-    uint32_t timestamp;
-    float heart_rate;
-    float hrv_score;
-    float stress_level;
-} __attribute__((packed));
+    HRV_FIELDS(WIRE_FIELD, HRVData)
+};
+
+struct HRVBatch {
+    HRV_FIELDS(WIRE_SOA_FIELD, HRVBatch)
+};
 
 struct EEGData {
-    uint32_t timestamp;
-    float alpha_waves;
-    float beta_waves;
-    float theta_waves;
-    float delta_waves;
-    float focus_level;
-    float relaxation_level;
-} __attribute__((packed));
+    EEG_FIELDS(WIRE_FIELD, EEGData)
+};
+
+struct EEGBatch {
+    EEG_FIELDS(WIRE_SOA_FIELD, EEGBatch)
+};
+
+// auth_msg_encode(msg, 1, buf, size) / auth_msg_decode(buf, size, msg), etc.
+WIRE_CODEC(AuthMsg, auth_msg, WIRE_TYPE_AUTH, AUTH_MSG_VERSION, 1, AUTH_MSG_FIELDS)
+WIRE_CODEC(HRVData, hrv, WIRE_TYPE_HRV, HRV_VERSION, 1, HRV_FIELDS)
+WIRE_CODEC(HRVBatch, hrv_batch, WIRE_TYPE_HRV_BATCH, HRV_VERSION, WIRE_BATCH_MAX, HRV_FIELDS)
+WIRE_CODEC(EEGData, eeg, WIRE_TYPE_EEG, EEG_VERSION, 1, EEG_FIELDS)
+WIRE_CODEC(EEGBatch, eeg_batch, WIRE_TYPE_EEG_BATCH, EEG_VERSION, WIRE_BATCH_MAX, EEG_FIELDS)
+
+// Encoded sizes, for receive buffers
+#define AUTH_MSG_WIRE_SIZE (sizeof(struct wire_hdr) + sizeof(struct AuthMsg))
+#define HRV_BATCH_WIRE_SIZE (sizeof(struct wire_hdr) + sizeof(struct HRVBatch))
+#define EEG_BATCH_WIRE_SIZE (sizeof(struct wire_hdr) + sizeof(struct EEGBatch))
 
 // Authentication service constants
-#define MAX_USERS 16
+#define MAX_USERS 4096                 // User ids are 0..MAX_USERS-1
 #define BIOMETRIC_SAMPLE_SIZE 256
+#define AUTH_MATCH_THRESHOLD 0.85f      // Cosine similarity that verifies
 #define AUTH_TIMEOUT_MS 30000
+#define AUTH_VERIFY_ENDPOINT "auth/verify"  // AUTH_VERIFY requests, reply handle attached
+#define AUTH_SESSION_TOPIC "auth_session"   // AUTH_LOCK/AUTH_UNLOCK, last one retained
+
+// Continuous authentication (see dsp_trust.h)
+#define AUTH_BASELINE_RECORDS 60        // Fused frames per stream, learned after the first verification
+#define AUTH_TRUST_HALF_LIFE_MS 10000   // A saturated session locks about this long after a change of user
+#define AUTH_START_CONFIDENCE 0.95f
+#define AUTH_LOCK_BELOW 0.2f
+#define AUTH_UNLOCK_ABOVE 0.8f
+
+// Sensor fusion (see dsp_fuse.h): records are batched, so a frame may
+// wait for the slower sensor's next batch, up to the latency
+#define AUTH_FUSE_PERIOD_MS 500         // One joint vector per EEG window hop
+#define AUTH_FUSE_LATENCY_MS 10000      // Longer than an HRV batch of WIRE_BATCH_MAX beats
+#define AUTH_HRV_MAX_GAP_MS 3000        // A couple of missed beats
+#define AUTH_EEG_MAX_GAP_MS 1500        // Two missed window hops
 
-// Function prototypes for auth service
-int auth_verify_user(int user_id, const void *biometric_data);
-int auth_store_profile(int user_id, const void *profile_data);
+// Function prototypes for auth service. Profiles and samples are
+// AUTH_TEMPLATE_DIM floats of biometric features (see dsp_profile.h).
+int auth_verify_user(int user_id, const void *biometric_data);     // 1 if it matches the profile
+int auth_store_profile(int user_id, const void *profile_data);     // 0 or a negative error
+void auth_profiles_load(const void *image, uint32_t size);         // Stored image, or NULL for an empty store
+void auth_handle_requests(int verify);                             // Answer AUTH_VERIFY requests queued on it
 void auth_service_main(void);
 
 #endif // AUTH_H
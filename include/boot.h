@@ -0,0 +1,29 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+// Multiboot2 modules loaded with the kernel (module2 lines in
+// grub.cfg). Each is named by the first word of its command line, and
+// the rest holds key=value options:
+//
+//   module2 /boot/hrv.rec hrv speed=10
+//
+// kernel_main() records them before paging is enabled. Only modules
+// inside the identity-mapped first BOOT_MAPPED_LIMIT bytes are kept.
+
+#define BOOT_MAX_MODULES 8
+#define BOOT_CMDLINE_MAX 64
+#define BOOT_MAPPED_LIMIT 0x800000      // 8 MiB, see enable_paging()
+
+struct boot_module {
+    const uint8_t *data;
+    uint32_t size;
+    char cmdline[BOOT_CMDLINE_MAX];
+};
+
+int boot_modules_init(uint32_t mbi_addr);   // Modules recorded
+const struct boot_module *boot_module_find(const char *name);
+uint32_t boot_module_arg(const struct boot_module *m, const char *key, uint32_t fallback);
+
+#endif // BOOT_H
@@ -0,0 +1,38 @@
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Signal processing for the biometric services (src/dsp). Freestanding:
+// no libm and no allocation; every engine keeps its state in a struct
+// owned by the caller, so one service can run a stream per user.
+
+#define DSP_ERR_INVAL -1        // Unsupported size or parameter
+#define DSP_ERR_FULL -2         // No room left
+
+// Four packed floats. Kernel DSP objects are built with -msse2 (CR4
+// enables SSE at boot), so arithmetic on this type compiles to SSE;
+// loads and stores must be 16-byte aligned.
+#ifdef __SSE__
+typedef float dsp_v4 __attribute__((vector_size(16), may_alias));
+#endif
+
+// Square root by Newton's method from a halved-exponent first guess.
+// The kernel links no libm, and __builtin_sqrtf may still call sqrtf.
+static inline float dsp_sqrtf(float x) {
+    if (!(x > 0.0f)) return 0.0f;
+    union { float f; uint32_t u; } v = { x };
+    v.u = 0x1FBD1DF5 + (v.u >> 1);
+    float r = v.f;
+    for (int i = 0; i < 4; i++) {
+        r = 0.5f * (r + x / r);
+    }
+    return r;
+}
+
+static inline float dsp_clampf(float x, float lo, float hi) {
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+#endif // DSP_H
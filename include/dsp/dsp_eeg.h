@@ -0,0 +1,70 @@
+#ifndef DSP_EEG_H
+#define DSP_EEG_H
+
+#include "dsp_fft.h"
+
+// EEG band power by Welch's method. Each channel keeps its last nfft
+// samples; every hop (nfft / 2, so windows overlap by half) the window
+// is Hann-weighted and transformed, and its band powers are kept for the
+// last `segments` windows. Band power is linear in the spectrum, so
+// averaging the per-window band powers equals integrating the averaged
+// periodogram, without storing whole spectra.
+
+#define EEG_MAX_FFT DSP_FFT_MAX
+#define EEG_MAX_SEGMENTS 8
+
+enum eeg_band {
+    EEG_DELTA,              // 0.5-4 Hz
+    EEG_THETA,              // 4-8 Hz
+    EEG_ALPHA,              // 8-13 Hz
+    EEG_BETA,               // 13-30 Hz
+    EEG_BANDS
+};
+
+// Shared by every channel at one sample rate. Not const once built:
+// the windowed segment and spectrum are worked on here, one channel's
+// window at a time.
+struct eeg_plan {
+    struct dsp_fft fft;
+    uint32_t sample_rate;
+    uint32_t nfft;
+    uint32_t hop;
+    uint32_t segments;          // Windows averaged
+    uint32_t band_lo[EEG_BANDS];    // FFT bins [lo, hi) per band
+    uint32_t band_hi[EEG_BANDS];
+    float scale;                // Bin |X|^2 to one-sided power
+    float window[EEG_MAX_FFT] __attribute__((aligned(16)));
+    float seg[EEG_MAX_FFT] __attribute__((aligned(16)));
+    float re[EEG_MAX_FFT / 2 + 4] __attribute__((aligned(16)));
+    float im[EEG_MAX_FFT / 2 + 4] __attribute__((aligned(16)));
+};
+
+struct eeg_channel {
+    struct eeg_plan *plan;
+    float ring[EEG_MAX_FFT];    // Last nfft samples
+    uint32_t pos;               // Next write
+    uint32_t filled;            // Up to nfft
+    uint32_t since_hop;
+    float power[EEG_MAX_SEGMENTS][EEG_BANDS];   // Per window, newest at seg_pos - 1
+    uint32_t seg_pos;
+    uint32_t seg_count;
+    uint32_t windows;           // Transformed so far
+};
+
+// Averaged band powers and the indices derived from them
+struct eeg_bands {
+    uint32_t segments;          // Windows in the average, 0 = none yet
+    float power[EEG_BANDS];     // Signal units squared
+    float relative[EEG_BANDS];  // Share of the delta..beta total
+    float focus;                // beta / (alpha + theta + beta), in [0, 1]
+    float relaxation;           // alpha / (alpha + beta), in [0, 1]
+};
+
+// 0, or DSP_ERR_INVAL for an unsupported nfft or a rate too low for the bands
+int eeg_plan_init(struct eeg_plan *p, uint32_t sample_rate, uint32_t nfft, uint32_t segments);
+void eeg_init(struct eeg_channel *c, struct eeg_plan *p);
+int eeg_push(struct eeg_channel *c, float sample);         // 1 when a window was transformed
+int eeg_push_block(struct eeg_channel *c, const float *x, uint32_t n);  // Windows transformed
+void eeg_bands(const struct eeg_channel *c, struct eeg_bands *b);
+
+#endif // DSP_EEG_H
@@ -0,0 +1,40 @@
+#ifndef DSP_FFT_H
+#define DSP_FFT_H
+
+#include "dsp.h"
+
+// Real FFT for power-of-two sizes. The n real points are transformed as
+// n/2 complex ones by a radix-4 decimation-in-time FFT (with one radix-2
+// stage when log2(n/2) is odd), then split into the n/2 + 1 bins of the
+// real spectrum. Complex data is kept as separate re/im arrays so four
+// butterflies run per SSE operation. A plan is read-only once built and
+// can be shared by any number of streams.
+
+#define DSP_FFT_MIN 16
+#define DSP_FFT_MAX 2048                        // Real points
+#define DSP_FFT_TWIDDLES (DSP_FFT_MAX / 2 + 64) // Per-stage tables, each padded to 4
+
+struct dsp_fft {
+    uint32_t n;             // Real points
+    uint32_t m;             // Complex points, n / 2
+    uint32_t radix2;        // 1 if the first stage is radix-2
+    // Radix-4 stage tables, W^k, W^2k and W^3k for each k < L in turn
+    float tw_re[DSP_FFT_TWIDDLES] __attribute__((aligned(16)));
+    float tw_im[DSP_FFT_TWIDDLES] __attribute__((aligned(16)));
+    // exp(-2 pi i k / n) for k <= n / 4, to split the real spectrum
+    float split_re[DSP_FFT_MAX / 4 + 1];
+    float split_im[DSP_FFT_MAX / 4 + 1];
+    uint16_t rev[DSP_FFT_MAX / 2];  // Bit reversal of the complex index
+};
+
+// 0, or DSP_ERR_INVAL unless n is a power of two in [DSP_FFT_MIN, DSP_FFT_MAX]
+int dsp_fft_init(struct dsp_fft *f, uint32_t n);
+
+// Spectrum of x[0..n) into re/im[0..n/2]. re and im need n/2 + 1
+// entries, 16-byte aligned; they are also the working buffers.
+void dsp_rfft(const struct dsp_fft *f, const float *x, float *re, float *im);
+
+// sin and cos to double precision, for building tables without libm
+void dsp_sincos(double x, double *s, double *c);
+
+#endif // DSP_FFT_H
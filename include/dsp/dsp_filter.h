@@ -0,0 +1,82 @@
+#ifndef DSP_FILTER_H
+#define DSP_FILTER_H
+
+#include "dsp.h"
+
+// Multi-channel filter banks for sensor preprocessing. All channels of
+// a bank share one design, and their state is stored struct-of-arrays:
+// one float per channel per state variable, padded to a multiple of 4
+// so each SSE operation advances four channels.
+//
+// Block calls take frames of `stride` floats (dsp_filter_stride()), one
+// sample per channel and 16-byte aligned, and may filter in place.
+// Streaming calls take one tight sample per channel.
+
+#define DSP_FILTER_MAX_CHANNELS 16
+#define DSP_IIR_MAX_SECTIONS 8
+#define DSP_FIR_MAX_TAPS 64
+#define DSP_FIR_MAX_FACTOR 8
+
+static inline uint32_t dsp_filter_stride(uint32_t channels) {
+    return (channels + 3) & ~3u;
+}
+
+// One second-order section, normalised so a0 = 1:
+//   y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+struct dsp_biquad {
+    float b0, b1, b2, a1, a2;
+};
+
+enum dsp_biquad_type {
+    DSP_BIQUAD_LOWPASS,
+    DSP_BIQUAD_HIGHPASS,
+    DSP_BIQUAD_BANDPASS,    // 0 dB at f0
+    DSP_BIQUAD_NOTCH
+};
+
+// Cascade of biquads in transposed direct form II
+struct dsp_iir_bank {
+    uint32_t channels;
+    uint32_t stride;
+    uint32_t sections;
+    float coef[DSP_IIR_MAX_SECTIONS][5][4] __attribute__((aligned(16)));   // b0 b1 b2 a1 a2, broadcast
+    float z1[DSP_IIR_MAX_SECTIONS][DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+    float z2[DSP_IIR_MAX_SECTIONS][DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+};
+
+// FIR low-pass and decimate by `factor`, in polyphase form: tap
+// h[j * factor + p] belongs to branch p, which only ever sees every
+// factor-th input, so work is done at the output rate
+struct dsp_fir_decim {
+    uint32_t channels;
+    uint32_t stride;
+    uint32_t taps;
+    uint32_t factor;
+    uint32_t branch_len;    // Taps per branch, ceil(taps / factor)
+    uint32_t phase;         // Input index mod factor
+    uint32_t pos;           // Newest slot of every branch delay line
+    float h[DSP_FIR_MAX_FACTOR][DSP_FIR_MAX_TAPS];
+    // Per branch, 2 * branch_len rows of stride floats: each line is
+    // written twice so its window is always contiguous
+    float delay[2 * (DSP_FIR_MAX_TAPS + DSP_FIR_MAX_FACTOR) * DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+};
+
+// Design (RBJ cookbook). 0, or DSP_ERR_INVAL unless 0 < f0 < rate / 2 and q > 0.
+int dsp_biquad_design(struct dsp_biquad *c, enum dsp_biquad_type type, float rate, float f0, float q);
+
+int dsp_iir_init(struct dsp_iir_bank *f, uint32_t channels, const struct dsp_biquad *sections, uint32_t n);
+void dsp_iir_reset(struct dsp_iir_bank *f);
+void dsp_iir_push(struct dsp_iir_bank *f, const float *in, float *out);
+void dsp_iir_block(struct dsp_iir_bank *f, const float *in, float *out, uint32_t frames);
+
+// Hamming-windowed sinc low-pass with unity DC gain
+int dsp_fir_lowpass(float *h, uint32_t taps, float rate, float cutoff);
+
+int dsp_fir_decim_init(struct dsp_fir_decim *d, uint32_t channels, const float *h, uint32_t taps,
+                       uint32_t factor);
+void dsp_fir_decim_reset(struct dsp_fir_decim *d);
+int dsp_fir_decim_push(struct dsp_fir_decim *d, const float *in, float *out);  // 1 when out was written
+uint32_t dsp_fir_decim_block(struct dsp_fir_decim *d, const float *in, uint32_t frames,
+                             float *out);                                       // Output frames
+
+#endif // DSP_FILTER_H
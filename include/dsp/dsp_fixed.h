@@ -0,0 +1,116 @@
+#ifndef DSP_FIXED_H
+#define DSP_FIXED_H
+
+#include "dsp_filter.h"
+#include "dsp_fft.h"
+#include "dsp_hrv.h"
+
+// Fixed-point versions of the filter, FFT and HRV statistics kernels,
+// for driver and interrupt paths that must not touch FPU state. The
+// sensor front end delivers ADC codes as Q15 (int16_t); filters keep
+// Q31 state with Q30 coefficients and 64-bit accumulators, and every
+// narrowing step rounds and saturates.
+//
+// The kernels in dsp_fixed.c are compiled with -mgeneral-regs-only in
+// the kernel, so the compiler guarantees they use no x87 or SSE
+// registers. Setting a kernel up from a float design (dsp_fixed_init.c)
+// does use the FPU, and belongs in thread context.
+
+#define DSP_Q15_ONE 32768
+#define DSP_Q30_ONE (1 << 30)
+
+// Saturate to the Q15 and Q31 ranges
+static inline int16_t dsp_sat_q15(int32_t v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : (int16_t)v);
+}
+
+static inline int32_t dsp_sat_q31(int64_t v) {
+    return v > 0x7FFFFFFFLL ? 0x7FFFFFFF : (v < -0x80000000LL ? (int32_t)-0x7FFFFFFF - 1 : (int32_t)v);
+}
+
+// Arithmetic shift right by s >= 1, rounding half up
+static inline int64_t dsp_round_shift(int64_t v, uint32_t s) {
+    return (v + ((int64_t)1 << (s - 1))) >> s;
+}
+
+static inline int16_t dsp_add_q15(int16_t a, int16_t b) {
+    return dsp_sat_q15((int32_t)a + b);
+}
+
+// Q15 product; -1 * -1 saturates to just under 1
+static inline int16_t dsp_mul_q15(int16_t a, int16_t b) {
+    return dsp_sat_q15((int32_t)dsp_round_shift((int32_t)a * b, 15));
+}
+
+static inline int32_t dsp_mul_q31(int32_t a, int32_t b) {
+    return dsp_sat_q31(dsp_round_shift((int64_t)a * b, 31));
+}
+
+// Biquad cascade in direct form I: unlike the transposed form its state
+// is just past inputs and outputs, which stay in range in Q31
+struct dsp_iir_q31 {
+    uint32_t channels;
+    uint32_t sections;
+    int32_t coef[DSP_IIR_MAX_SECTIONS][5];  // b0 b1 b2 a1 a2, Q30
+    int32_t x1[DSP_IIR_MAX_SECTIONS][DSP_FILTER_MAX_CHANNELS];
+    int32_t x2[DSP_IIR_MAX_SECTIONS][DSP_FILTER_MAX_CHANNELS];
+    int32_t y1[DSP_IIR_MAX_SECTIONS][DSP_FILTER_MAX_CHANNELS];
+    int32_t y2[DSP_IIR_MAX_SECTIONS][DSP_FILTER_MAX_CHANNELS];
+};
+
+// FIR low-pass and decimate; the dot product runs only at output time
+struct dsp_fir_q15 {
+    uint32_t channels;
+    uint32_t taps;
+    uint32_t factor;
+    uint32_t phase;         // Input index mod factor
+    uint32_t pos;           // Newest history row
+    int16_t h[DSP_FIR_MAX_TAPS];    // Q15
+    // 2 * taps rows of one sample per channel, written twice so the
+    // window is always contiguous
+    int16_t hist[2 * DSP_FIR_MAX_TAPS][DSP_FILTER_MAX_CHANNELS];
+};
+
+// Real FFT with the same stage structure and tables as dsp_fft, in Q15.
+// Each radix-4 stage scales by 1/4 (radix-2 by 1/2) so nothing can
+// overflow; the output is X[k] / n.
+struct dsp_fft_q15 {
+    uint32_t n;
+    uint32_t m;
+    uint32_t radix2;
+    int16_t tw_re[DSP_FFT_TWIDDLES];
+    int16_t tw_im[DSP_FFT_TWIDDLES];
+    int16_t split_re[DSP_FFT_MAX / 4 + 1];
+    int16_t split_im[DSP_FFT_MAX / 4 + 1];
+    uint16_t rev[DSP_FFT_MAX / 2];
+};
+
+// HRV window metrics in Q16.16
+struct hrv_metrics_q {
+    uint32_t beats;
+    int32_t mean_rr;        // ms
+    int32_t heart_rate;     // bpm
+    int32_t sdnn;           // ms
+    int32_t rmssd;          // ms
+    int32_t pnn50;          // percent
+};
+
+// Setup, from float designs (dsp_fixed_init.c)
+int16_t dsp_q15_from_float(float x);            // Rounded and saturated
+int dsp_iir_q31_init(struct dsp_iir_q31 *f, uint32_t channels, const struct dsp_biquad *sections, uint32_t n);
+int dsp_fir_q15_init(struct dsp_fir_q15 *d, uint32_t channels, const float *h, uint32_t taps, uint32_t factor);
+int dsp_fft_q15_init(struct dsp_fft_q15 *f, uint32_t n);
+
+// Integer-only kernels (dsp_fixed.c)
+void dsp_iir_q31_reset(struct dsp_iir_q31 *f);
+void dsp_iir_q31_block(struct dsp_iir_q31 *f, const int32_t *in, int32_t *out, uint32_t frames);  // Tight Q31 frames
+void dsp_iir_q15_push(struct dsp_iir_q31 *f, const int16_t *in, int16_t *out);
+void dsp_fir_q15_reset(struct dsp_fir_q15 *d);
+int dsp_fir_q15_push(struct dsp_fir_q15 *d, const int16_t *in, int16_t *out);    // 1 when out was written
+uint32_t dsp_fir_q15_block(struct dsp_fir_q15 *d, const int16_t *in, uint32_t frames, int16_t *out);
+void dsp_rfft_q15(const struct dsp_fft_q15 *f, const int16_t *x, int32_t *re, int32_t *im);    // re/im: n/2 + 1
+void hrv_metrics_q(const struct hrv_stream *s, struct hrv_metrics_q *m);
+uint64_t dsp_udiv64(uint64_t n, uint32_t d);    // No libgcc in the kernel
+uint32_t dsp_isqrt64(uint64_t v);
+
+#endif // DSP_FIXED_H
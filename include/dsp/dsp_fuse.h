@@ -0,0 +1,63 @@
+#ifndef DSP_FUSE_H
+#define DSP_FUSE_H
+
+#include "dsp.h"
+
+// Multi-stream fusion. Sensor streams deliver feature records at their
+// own irregular times: an HRV record per beat, an EEG record per window
+// hop, each published in batches. A fusion stage buffers every stream
+// in a ring, ordered by timestamp, and emits one joint feature vector
+// every `period_ms` on the shared monotonic clock.
+//
+// Frame time T is emitted once every stream has a record at or after T,
+// the merge frontier over the k sorted rings, or once any stream is
+// `latency_ms` past T, so a stalled sensor delays output but does not
+// stop it. Each stream's part of the frame is interpolated between the
+// records either side of T when they are at most `max_gap_ms` apart.
+// Otherwise the nearest record is held if it lies within half of that.
+// A stream with neither is marked missing in `valid`.
+//
+// Memory and work per frame grow with the number of streams only, and
+// one stage serves every consumer.
+
+#define DSP_FUSE_MAX_STREAMS 8
+#define DSP_FUSE_MAX_WIDTH 8        // Features per stream
+#define DSP_FUSE_MAX_FEATURES 16    // Joint vector
+#define DSP_FUSE_RING 32            // Records buffered per stream, a power of two
+
+struct dsp_fuse_stream {
+    uint32_t width;
+    uint32_t offset;                // First feature in the joint vector
+    uint32_t max_gap_ms;
+    uint32_t head, count;           // Oldest record and records held
+    uint32_t dropped;               // Records out of order or pushed out of a full ring
+    uint32_t t[DSP_FUSE_RING];
+    float v[DSP_FUSE_RING][DSP_FUSE_MAX_WIDTH];
+};
+
+struct dsp_fuse_frame {
+    uint32_t t_ms;
+    uint32_t valid;                 // Bit per stream with data at t_ms
+    float v[DSP_FUSE_MAX_FEATURES]; // Zero where a stream is missing
+};
+
+struct dsp_fuse {
+    uint32_t streams;
+    uint32_t width;                 // Features in the joint vector
+    uint32_t period_ms, latency_ms;
+    uint32_t next_ms;               // Time of the next frame
+    uint32_t newest_ms;             // Latest record on any stream
+    int started;
+    struct dsp_fuse_stream s[DSP_FUSE_MAX_STREAMS];
+};
+
+int dsp_fuse_init(struct dsp_fuse *f, uint32_t period_ms, uint32_t latency_ms);
+// Add a stream of `width` features; returns its index or DSP_ERR_INVAL
+int dsp_fuse_add_stream(struct dsp_fuse *f, uint32_t width, uint32_t max_gap_ms);
+// Buffer one record. Records must be in time order per stream; an
+// older one is dropped (DSP_ERR_INVAL).
+int dsp_fuse_push(struct dsp_fuse *f, uint32_t stream, uint32_t t_ms, const float *x);
+// Emit the next frame if it is due: 1 with *out filled, else 0
+int dsp_fuse_pull(struct dsp_fuse *f, struct dsp_fuse_frame *out);
+
+#endif // DSP_FUSE_H
@@ -0,0 +1,70 @@
+#ifndef DSP_HRV_H
+#define DSP_HRV_H
+
+#include "dsp.h"
+
+// Streaming heart rate variability. Raw PPG/ECG samples go in one at a
+// time; beats are found with an adaptive threshold, and each RR interval
+// updates the window metrics from running sums in O(1).
+
+#define HRV_MAX_WINDOW 128      // RR intervals per metrics window
+#define HRV_MWI_MAX 64          // Integration window samples (150 ms at up to 426 Hz)
+#define HRV_RR_MIN_MS 300       // 200 bpm; shorter intervals are artifacts
+#define HRV_RR_MAX_MS 2000      // 30 bpm; longer ones are dropouts
+#define HRV_NN50_MS 50
+
+// Window metrics
+struct hrv_metrics {
+    uint32_t beats;         // RR intervals in the window
+    float mean_rr;          // ms
+    float heart_rate;       // bpm, from mean_rr
+    float sdnn;             // ms, standard deviation of RR
+    float rmssd;            // ms, root mean square of successive differences
+    float pnn50;            // Percent of successive differences over 50 ms
+};
+
+struct hrv_stream {
+    uint32_t sample_rate;
+    uint32_t window;        // Metrics window in RR intervals
+    uint32_t n;             // Samples consumed
+
+    // Beat detector: derivative, square, moving-window integration
+    float x[4];             // Last raw samples for the derivative
+    float mwi[HRV_MWI_MAX];
+    float raw[HRV_MWI_MAX]; // Raw samples over the same window, to time the R peak
+    uint32_t mwi_len;
+    uint32_t mwi_pos;
+    double mwi_sum;         // Double so the sliding sum does not drift
+    float prev;             // Last two integrated values, to find peaks
+    float prev2;
+    float spk;              // Running signal and noise peak levels
+    float npk;
+    float threshold;
+    uint32_t learn_until;   // Sample index where detection starts
+    uint32_t refractory;    // Samples
+    uint32_t last_beat;     // Sample index, 0 = none yet
+    uint32_t last_decay;    // Sample index of the last threshold decay
+    uint32_t artifacts;     // RR intervals rejected as implausible
+
+    // RR window: ring of intervals and the successive difference each
+    // made with its predecessor, with sums kept exact in integers
+    uint16_t rr[HRV_MAX_WINDOW];
+    int16_t diff[HRV_MAX_WINDOW];
+    uint8_t diff_valid[HRV_MAX_WINDOW];
+    uint32_t head;          // Oldest interval
+    uint32_t count;
+    uint32_t last_rr;       // Previous accepted interval, 0 after a gap
+    int64_t sum_rr;
+    int64_t sum_rr2;
+    int64_t sum_d2;
+    uint32_t ndiff;
+    uint32_t nn50;
+};
+
+void hrv_init(struct hrv_stream *s, uint32_t sample_rate, uint32_t window);
+int hrv_push(struct hrv_stream *s, float sample);              // 1 if a beat was detected
+int hrv_push_block(struct hrv_stream *s, const float *x, uint32_t n); // Beats detected
+int hrv_add_rr(struct hrv_stream *s, uint32_t rr_ms);          // For sources that report RR directly
+void hrv_metrics(const struct hrv_stream *s, struct hrv_metrics *m);
+
+#endif // DSP_HRV_H
@@ -0,0 +1,83 @@
+#ifndef DSP_MATCH_H
+#define DSP_MATCH_H
+
+#include "dsp.h"
+
+// Biometric template matching. Each enrolled user has one feature
+// vector of DSP_MATCH_DIM floats; a probe scores against a template by
+// cosine similarity. Templates are stored unit length and interleaved
+// four users per block ([block][dim][4]), so one SSE multiply-add
+// advances four users and a scan streams through contiguous memory.
+//
+// Verification (dsp_match_score) is one dot product. Identification
+// (dsp_match_identify) scans linearly while the set is small. Past
+// DSP_MATCH_LINEAR_MAX users it builds a coarse index: spherical
+// k-means cells whose users are stored contiguously, of which only the
+// DSP_MATCH_NPROBE cells nearest the probe are scanned. Users enrolled
+// after a build sit in a linear tail that every search also scans,
+// until the next rebuild folds them in.
+//
+// Diagonal Mahalanobis matching: dsp_match_set_scale() whitens every
+// template and probe by per-feature inverse standard deviations before
+// normalisation.
+
+#define DSP_MATCH_DIM 32            // Multiple of 8
+#define DSP_MATCH_MAX 4096          // Users; ids are 0..DSP_MATCH_MAX-1
+#define DSP_MATCH_LINEAR_MAX 512    // Largest set searched without the index
+#define DSP_MATCH_TAIL_MAX 256      // Unindexed users that trigger a rebuild
+#define DSP_MATCH_LISTS 64          // Index cells
+#define DSP_MATCH_NPROBE 8          // Cells scanned per search
+#define DSP_MATCH_KMEANS_ROUNDS 8
+// Cells are padded to whole blocks, and tombstones stay until a rebuild
+#define DSP_MATCH_SLOTS (DSP_MATCH_MAX + 4 * DSP_MATCH_LISTS + DSP_MATCH_TAIL_MAX)
+#define DSP_MATCH_NONE (-2.0f)      // Score for a user with no template
+
+struct dsp_match_result {
+    int32_t user;           // Best match at or above the threshold, -1 for none
+    float score;            // Its cosine similarity
+    uint32_t scanned;       // Templates compared
+    uint32_t scored;        // Of those, scored in full rather than cut short by the bound
+};
+
+struct dsp_match {
+    uint32_t count;         // Enrolled users
+    uint32_t slots;         // Slots in use, a multiple of 4; tombstones included
+    uint32_t indexed;       // Slots covered by the index; slots after it are the tail
+    uint32_t lists;         // Index cells, 0 while searches are linear
+    uint32_t nprobe;
+    int scaled;
+    float scale[DSP_MATCH_DIM];
+    float feat[DSP_MATCH_SLOTS / 4][DSP_MATCH_DIM][4] __attribute__((aligned(16)));
+    // Norm of each template's second half, for the early exit
+    float tail_norm[DSP_MATCH_SLOTS] __attribute__((aligned(16)));
+    int32_t user[DSP_MATCH_SLOTS];          // -1 for free or removed slots
+    uint16_t slot_of[DSP_MATCH_MAX];        // 0xFFFF when not enrolled
+    float centroid[DSP_MATCH_LISTS][DSP_MATCH_DIM];
+    uint32_t list_start[DSP_MATCH_LISTS + 1];   // Slot ranges, multiples of 4
+    // Build scratch: enrolled templates gathered densely, and their cells
+    float dense[DSP_MATCH_MAX][DSP_MATCH_DIM];
+    int32_t dense_user[DSP_MATCH_MAX];
+    uint16_t cell[DSP_MATCH_MAX];
+};
+
+void dsp_match_init(struct dsp_match *m);
+// Per-feature inverse standard deviations; only before the first enrolment
+int dsp_match_set_scale(struct dsp_match *m, const float *inv_std);
+
+// 0, DSP_ERR_INVAL for a bad id or an all-zero template, or DSP_ERR_FULL.
+// Enrolling an enrolled user replaces their template.
+int dsp_match_enroll(struct dsp_match *m, uint32_t user, const float *features);
+int dsp_match_remove(struct dsp_match *m, uint32_t user);
+
+// Cosine similarity of the probe to one user's template, or DSP_MATCH_NONE
+float dsp_match_score(const struct dsp_match *m, uint32_t user, const float *probe);
+
+// Best user scoring at least threshold; returns its id or -1
+int32_t dsp_match_identify(const struct dsp_match *m, const float *probe, float threshold,
+                           struct dsp_match_result *r);
+
+// Rebuild the index (or compact a linear set). Enrolment calls this
+// itself as the set grows; call it after removing many users.
+void dsp_match_build(struct dsp_match *m);
+
+#endif // DSP_MATCH_H
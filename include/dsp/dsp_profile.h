@@ -0,0 +1,105 @@
+#ifndef DSP_PROFILE_H
+#define DSP_PROFILE_H
+
+#include "dsp.h"
+
+// Persistent biometric profile store. The on-disk image is used where
+// it lies (in the kernel, a boot module): opening it reads the header
+// and replays the short append log, and nothing else, so cold start
+// costs the same for ten users as for thousands.
+//
+//   header      32 bytes, CRC-checked at open
+//   directory   capacity uint32 record indices by user id, padded to 16
+//   base        `records` template records, 16-byte aligned
+//   log         records appended since the image was written
+//
+// A record carries its user id and its own CRC. A directory entry is
+// trusted only once the record it names checks out, the first time
+// that user is looked up, so no step at open touches the base.
+//
+// Updates are append-only: enrolment and removal write a record to a
+// journal (the bytes the storage layer appends to the file), and the
+// newest record per user wins. Once the log reaches
+// DSP_PROFILE_TAIL_MAX records, dsp_profile_compact() writes a fresh
+// image holding only the live templates.
+
+#define DSP_PROFILE_MAGIC 0x46504441    // "ADPF"
+#define DSP_PROFILE_VERSION 1
+#define DSP_PROFILE_DIM 32
+#define DSP_PROFILE_MAX 4096            // Largest capacity (user ids 0..capacity-1)
+#define DSP_PROFILE_TAIL_MAX 256        // Log records before a compaction is needed
+#define DSP_PROFILE_NONE (-2.0f)        // Score for a user with no template
+
+#define DSP_PROFILE_RECORD_MAGIC 0x52504441     // "ADPR"
+#define DSP_PROFILE_REMOVED 0x1         // Record flag: the user was removed
+#define DSP_PROFILE_NO_RECORD 0xFFFFFFFFu
+
+struct dsp_profile_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t dim;
+    uint32_t capacity;
+    uint32_t records;       // Base records
+    uint32_t generation;    // Compactions since the store was formatted
+    uint32_t reserved;
+    uint32_t crc;           // CRC-32 of the header with this field zero
+};
+
+struct dsp_profile_record {
+    uint32_t magic;
+    uint32_t user;
+    uint32_t flags;         // DSP_PROFILE_REMOVED
+    uint32_t crc;           // CRC-32 of the record with this field zero
+    float feat[DSP_PROFILE_DIM];    // Unit length
+};
+
+// Bytes of an image holding `records` base records
+#define DSP_PROFILE_DIR_SIZE(capacity) (((capacity) * 4 + 15) & ~15u)
+#define DSP_PROFILE_IMAGE_SIZE(capacity, records) \
+    (sizeof(struct dsp_profile_header) + DSP_PROFILE_DIR_SIZE(capacity) + \
+     (records) * sizeof(struct dsp_profile_record))
+#define DSP_PROFILE_JOURNAL_SIZE (DSP_PROFILE_TAIL_MAX * sizeof(struct dsp_profile_record))
+
+#define DSP_PROFILE_TAIL_HASH (2 * DSP_PROFILE_TAIL_MAX)
+
+struct dsp_profile_store {
+    const struct dsp_profile_header *header;
+    const uint32_t *dir;
+    const struct dsp_profile_record *base;
+    uint32_t capacity;
+    // Log records: those in the image, then those appended this session
+    const struct dsp_profile_record *tail[DSP_PROFILE_TAIL_MAX];
+    uint32_t tail_count;
+    uint16_t tail_hash[DSP_PROFILE_TAIL_HASH];  // 1 + newest tail index per user, 0 = empty
+    struct dsp_profile_record *journal;
+    uint32_t journal_max, journal_count;
+    // Base records whose CRC has been checked, and those that failed
+    uint32_t checked[DSP_PROFILE_MAX / 32];
+    uint32_t bad[DSP_PROFILE_MAX / 32];
+};
+
+// Write an empty store for user ids 0..capacity-1; bytes used or DSP_ERR_INVAL
+long dsp_profile_format(void *image, uint32_t size, uint32_t capacity);
+
+// Open an image in place (4-byte aligned; it must stay mapped). New
+// records go to `journal`, which may be NULL for a read-only store.
+// 0, or DSP_ERR_INVAL for a bad header or a log longer than TAIL_MAX.
+int dsp_profile_open(struct dsp_profile_store *s, const void *image, uint32_t size, void *journal,
+                     uint32_t journal_size);
+
+// Append an enrolment or a removal. 0, DSP_ERR_INVAL (bad id, all-zero
+// template, no journal) or DSP_ERR_FULL (compact first).
+int dsp_profile_put(struct dsp_profile_store *s, uint32_t user, const float *features);
+int dsp_profile_remove(struct dsp_profile_store *s, uint32_t user);
+
+// The user's unit-length template, checked, or NULL
+const float *dsp_profile_get(struct dsp_profile_store *s, uint32_t user);
+// Cosine similarity of a probe to the user's template, or DSP_PROFILE_NONE
+float dsp_profile_score(struct dsp_profile_store *s, uint32_t user, const float *probe);
+
+// Write the live templates as a new image, with an empty log and the
+// next generation; bytes written, DSP_ERR_INVAL or DSP_ERR_FULL. The
+// caller then opens the new image with an empty journal.
+long dsp_profile_compact(struct dsp_profile_store *s, void *out, uint32_t size);
+
+#endif // DSP_PROFILE_H
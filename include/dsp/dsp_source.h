@@ -0,0 +1,79 @@
+#ifndef DSP_SOURCE_H
+#define DSP_SOURCE_H
+
+#include "dsp_synth.h"
+#include "dsp_filter.h"
+
+// Sensor sources: where a service's raw samples come from. A source
+// delivers frames of `channels` floats at `sample_rate`, either from
+// seeded synthetic generators or by replaying a recording held in
+// memory (in the kernel, a Multiboot2 module; see include/boot.h).
+// Either way the sequence is deterministic, so a run can be repeated
+// exactly at any speed.
+
+#define DSP_SOURCE_MAX_CHANNELS DSP_FILTER_MAX_CHANNELS
+
+enum dsp_source_kind {
+    DSP_SOURCE_ECG,         // dsp_synth_ecg per channel
+    DSP_SOURCE_PPG,         // The same beat clocks, pulse waveform
+    DSP_SOURCE_EEG,         // dsp_synth_eeg per channel
+    DSP_SOURCE_REPLAY
+};
+
+// Recordings: a little-endian header followed by `frames` frames of
+// `channels` interleaved samples. Q15 samples map to [-1, 1).
+#define DSP_RECORDING_MAGIC 0x52534441     // "ADSR"
+#define DSP_RECORDING_VERSION 1
+
+enum dsp_sample_format {
+    DSP_SAMPLE_Q15 = 1,     // int16_t
+    DSP_SAMPLE_F32 = 2      // IEEE float
+};
+
+struct dsp_recording_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t channels;
+    uint32_t sample_rate;   // Hz
+    uint32_t format;        // DSP_SAMPLE_*
+    uint32_t frames;
+};
+
+struct dsp_source {
+    enum dsp_source_kind kind;
+    uint32_t channels;
+    uint32_t sample_rate;
+    uint32_t speed;         // Multiple of real time for dsp_source_due(); 0 = unpaced
+    uint32_t loop;          // Replay restarts at the end instead of stopping
+    uint64_t frames;        // Delivered so far
+    union {
+        // Synthetic: channel c is seeded with seed + c. Parameters may
+        // be changed after dsp_source_synth().
+        struct dsp_synth_ecg ecg[DSP_SOURCE_MAX_CHANNELS];
+        struct dsp_synth_eeg eeg[DSP_SOURCE_MAX_CHANNELS];
+        struct {
+            const uint8_t *samples;
+            uint32_t format;
+            uint32_t length;    // Frames
+            uint32_t pos;       // Next frame
+        } replay;
+    };
+};
+
+// 0, or DSP_ERR_INVAL for a bad channel count or rate
+int dsp_source_synth(struct dsp_source *s, enum dsp_source_kind kind, uint32_t channels, uint32_t sample_rate,
+                     uint32_t seed);
+// 0, or DSP_ERR_INVAL unless data holds a complete recording. The data
+// is read in place and must outlive the source.
+int dsp_source_replay(struct dsp_source *s, const void *data, uint32_t size);
+
+// Up to `frames` tight frames into out. Fewer only at the end of a
+// replay without loop.
+uint32_t dsp_source_read(struct dsp_source *s, float *out, uint32_t frames);
+
+// Frames owed after `elapsed` clock units at `per_second` units per
+// second, at s->speed times real time. Unpaced sources are owed one
+// second of signal per call.
+uint32_t dsp_source_due(const struct dsp_source *s, uint64_t elapsed, uint32_t per_second);
+
+#endif // DSP_SOURCE_H
@@ -0,0 +1,55 @@
+#ifndef DSP_SYNTH_H
+#define DSP_SYNTH_H
+
+#include "dsp.h"
+
+// Deterministic synthetic ECG for tests, benchmarks and services that
+// have no sensor yet: a triangular QRS and T wave per beat, RR intervals
+// drawn uniformly from mean +/- jitter, plus uniform noise. Setting
+// rsa_ms adds respiratory sinus arrhythmia: RR swings sinusoidally by
+// +/- rsa_ms over each breath of resp_ms.
+//
+// The same beat clock drives a PPG: dsp_synth_ppg_next() returns the
+// fingertip pulse, a systolic wave arriving SYNTH_PTT_MS after each R
+// peak followed by a smaller diastolic wave.
+struct dsp_synth_ecg {
+    uint32_t sample_rate;
+    uint32_t mean_rr_ms;
+    uint32_t jitter_ms;
+    uint32_t rsa_ms;        // 0 = no respiratory modulation
+    uint32_t resp_ms;       // Breath period
+    float amplitude;        // R peak height
+    float noise;            // Peak noise amplitude
+    uint32_t rng;
+    uint32_t n;             // Next sample index
+    uint32_t prev_beat_at;  // Sample index of the R peak before beat_at
+    uint32_t beat_at;       // Sample index of the current R peak
+    uint32_t next_beat;     // Sample index of the next R peak
+    uint32_t rr_ms;         // Interval that ended at beat_at, 0 for the first beat
+    uint32_t beats;
+    int beat;               // Set on the sample that is an R peak
+};
+
+// Synthetic EEG: one sine tone per band plus uniform noise. The
+// defaults sit mid-band (2, 6, 10 and 20 Hz for delta..beta) with an
+// alpha-dominant resting mix; set amplitude[] to shift the balance.
+#define DSP_SYNTH_TONES 4
+
+struct dsp_synth_eeg {
+    uint32_t sample_rate;
+    float hz[DSP_SYNTH_TONES];
+    float amplitude[DSP_SYNTH_TONES];
+    float noise;                // Peak noise amplitude
+    uint32_t rng;
+    double phase[DSP_SYNTH_TONES];  // Cycles, kept in [0, 1)
+};
+
+void dsp_synth_ecg_init(struct dsp_synth_ecg *s, uint32_t sample_rate, uint32_t mean_rr_ms,
+                        uint32_t jitter_ms, uint32_t seed);
+float dsp_synth_ecg_next(struct dsp_synth_ecg *s);
+float dsp_synth_ppg_next(struct dsp_synth_ecg *s);
+void dsp_synth_eeg_init(struct dsp_synth_eeg *s, uint32_t sample_rate, uint32_t seed);
+float dsp_synth_eeg_next(struct dsp_synth_eeg *s);
+uint32_t dsp_rand(uint32_t *state);   // xorshift32; state must be non-zero
+
+#endif // DSP_SYNTH_H
@@ -0,0 +1,73 @@
+#ifndef DSP_TRUST_H
+#define DSP_TRUST_H
+
+#include "dsp.h"
+
+// Continuous authentication. After the first verification a session
+// keeps a confidence that the same user is still present, updated from
+// each record the HRV and EEG services publish rather than by running
+// verification again.
+//
+// Each record is scored against the user's baseline by a diagonal
+// Gaussian log-likelihood ratio: how much likelier its features are
+// under the user's own mean and spread than under the population's.
+// The session sums these in log-odds with exponential forgetting,
+// L = L * 2^(-dt / half_life) + evidence, so old evidence fades and the
+// cost per record is one pass over its features. Confidence is the
+// logistic of L; lock and unlock thresholds on it form a hysteresis
+// band so the state does not chatter.
+
+#define DSP_TRUST_MAX_FEATURES 8
+#define DSP_TRUST_EVIDENCE_MAX 4.0f     // Per record, in nats, so one outlier cannot lock
+#define DSP_TRUST_MIN_STD 0.1f          // User spread floor, as a share of the population's
+
+// Session state changes returned by dsp_trust_update()
+#define DSP_TRUST_LOCK 1
+#define DSP_TRUST_UNLOCK 2
+
+// A user's baseline over one record type, learned online (Welford)
+struct dsp_trust_stats {
+    uint32_t n;                         // Features per record
+    uint32_t count;                     // Records seen
+    double mean[DSP_TRUST_MAX_FEATURES];
+    double m2[DSP_TRUST_MAX_FEATURES];
+};
+
+struct dsp_trust_model {
+    uint32_t n;
+    float mean[DSP_TRUST_MAX_FEATURES];
+    float inv_std[DSP_TRUST_MAX_FEATURES];
+    float pop_mean[DSP_TRUST_MAX_FEATURES];
+    float pop_inv_std[DSP_TRUST_MAX_FEATURES];
+    float bias;                         // Sum of log(pop_std / std)
+};
+
+struct dsp_trust {
+    float evidence;                     // Log-odds that the user is present
+    float decay;                        // ln 2 / half-life, per ms
+    float lock_at, unlock_at;           // Thresholds in log-odds
+    uint32_t last_ms;
+    uint32_t updates;
+    int locked;
+};
+
+void dsp_trust_stats_init(struct dsp_trust_stats *s, uint32_t n);
+void dsp_trust_stats_add(struct dsp_trust_stats *s, const float *x);
+
+// The user's model from a baseline and population statistics (std per
+// feature, all positive). 0 or DSP_ERR_INVAL.
+int dsp_trust_model_init(struct dsp_trust_model *m, const struct dsp_trust_stats *user, const float *pop_mean,
+                         const float *pop_std);
+// Log-likelihood ratio of one record, clamped to +/-DSP_TRUST_EVIDENCE_MAX
+float dsp_trust_evidence(const struct dsp_trust_model *m, const float *x);
+
+// A locked session at confidence 0.5; 0 < lock_below < unlock_above < 1
+int dsp_trust_init(struct dsp_trust *t, uint32_t half_life_ms, float lock_below, float unlock_above);
+// Unlock at a verified start, with the given confidence
+void dsp_trust_start(struct dsp_trust *t, uint32_t now_ms, float confidence);
+// Fold in one record's evidence at now_ms (not before the last update);
+// returns DSP_TRUST_LOCK or DSP_TRUST_UNLOCK on a state change, else 0
+int dsp_trust_update(struct dsp_trust *t, uint32_t now_ms, float evidence);
+float dsp_trust_confidence(const struct dsp_trust *t);
+
+#endif // DSP_TRUST_H
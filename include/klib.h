@@ -0,0 +1,13 @@
+#ifndef KLIB_H
+#define KLIB_H
+
+#include <stddef.h>
+
+// Freestanding memory routines provided by the kernel (src/kernel/kernel.c).
+// GCC may also emit calls to these for struct copies and zeroing loops.
+void *memcpy(void *dst, const void *src, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+void *memset(void *dst, int c, size_t n);
+int memcmp(const void *a, const void *b, size_t n);
+
+#endif // KLIB_H
@@ -10,25 +10,252 @@ int sal_recv(int src_pid, void *buf, size_t maxlen);
 int sal_publish(const char *topic, const void *data, size_t len);
 int sal_subscribe(const char *topic, void (*callback)(const void*, size_t));
 
-// SAL message structure
+// Vectored and batched operations: one trap moves many buffers
+struct sal_iovec {
+    const void *base;
+    size_t len;
+};
+
+struct sal_mmsg {
+    void *buf;          // In: receive buffer
+    size_t maxlen;      // In: buffer size
+    size_t len;         // Out: message length
+    int sender_pid;     // Out: sender
+};
+
+struct sal_pub_entry {
+    int topic_id;
+    const void *data;
+    size_t len;
+};
+
+// Delivery attributes. Mailboxes dequeue by priority, then earliest
+// deadline, then arrival; the receiver is scheduled at the priority of
+// its most urgent pending message.
+struct sal_msg_attr {
+    uint32_t priority;      // SAL_PRIO_*
+    uint32_t deadline;      // Absolute tick (see sal_ticks()), 0 = none
+};
+
+int sal_send_attr(int dest_pid, const void *msg, size_t len, const struct sal_msg_attr *attr);
+uint32_t sal_ticks(void);
+
+int sal_sendv(int dest_pid, const struct sal_iovec *iov, int iovcnt);
+int sal_recv_many(int src_pid, struct sal_mmsg *msgs, int n);
+int sal_publish_batch(const struct sal_pub_entry *entries, int n);
+
+// Pub/sub by interned topic id. Intern a name once with sal_topic_id()
+// and use the id on the hot path; no string handling per message.
+int sal_topic_id(const char *topic);
+int sal_publish_id(int topic_id, const void *data, size_t len);
+int sal_subscribe_id(int topic_id);
+int sal_unsubscribe(int topic_id);
+int sal_topic_recv(int topic_id, int *topic_out, void *buf, size_t maxlen);
+int sal_topic_recv_many(int topic_id, struct sal_mmsg *msgs, int n);
+
+// Per-topic delivery policy (SAL_POLICY_*). param is the credit window
+// for SAL_POLICY_CREDIT and ignored otherwise.
+struct sal_topic_stats {
+    uint32_t policy;
+    uint32_t subscribers;
+    uint32_t published;
+    uint32_t delivered;     // Subscriber queue insertions
+    uint32_t drops;         // Entries discarded or overwritten by the policy
+    uint32_t stalls;        // Publishes refused for lack of credit
+    uint32_t retained;      // Messages held for replay
+};
+
+int sal_topic_policy(int topic_id, uint32_t policy, uint32_t param);
+int sal_topic_stats(int topic_id, struct sal_topic_stats *stats);
+
+// Retained history. A topic keeps its last depth messages (0 to stop);
+// each subscription has a cursor that starts at the oldest of them, and
+// sal_topic_history() reads forward from it in one batch. Live receives
+// advance the same cursor, so nothing is delivered twice.
+int sal_topic_retain(int topic_id, uint32_t depth);
+int sal_topic_history(int topic_id, struct sal_mmsg *msgs, int n);
+int sal_topic_seek(int topic_id, uint32_t back);    // Rewind to the last back messages
+
+// Queue instrumentation. Every mailbox and topic keeps these counters;
+// sal_stats() returns a snapshot summed over CPUs. latency[i] counts
+// dequeues that waited [2^i, 2^(i+1)) TSC cycles (bucket 0 also holds 0).
+#define SAL_HIST_BUCKETS 32
+
+struct sal_queue_stats {
+    uint32_t messages;      // Enqueued (published, for a topic)
+    uint32_t dequeued;      // Received; a topic counts every subscriber copy
+    uint64_t bytes;         // Payload bytes enqueued
+    uint32_t drops;         // Refused, evicted or overwritten
+    uint32_t max_depth;     // Deepest queue seen (deepest subscriber, for a topic)
+    uint32_t latency[SAL_HIST_BUCKETS];
+};
+
+int sal_stats(uint32_t kind, int id, struct sal_queue_stats *stats);  // SAL_STATS_*
+
+// Run callbacks registered with sal_subscribe() (see sal_dispatch.c)
+int sal_dispatch(uint32_t timeout_ticks);
+
+// Page grants for payloads larger than SAL_MAX_MESSAGE_SIZE.
+// The sender offers a page-aligned buffer to dest_pid and passes the
+// returned grant id in-band; the receiver maps it without a copy.
+int sal_grant(int dest_pid, void *buf, size_t len, uint32_t flags);
+void *sal_grant_map(int grant_id, size_t *len);
+int sal_grant_unmap(int grant_id);
+int sal_grant_revoke(int grant_id);
+
+// Shared-memory channels (see sal_ring.h for the data path). The first
+// open of a name creates the ring; later opens attach to it.
+struct sal_ring;
+struct sal_ring *sal_channel_open(const char *name, uint32_t flags, uint32_t slot_size, uint32_t nslots);
+int sal_channel_close(struct sal_ring *ring);
+
+// Futex-style wait/wake on a word in shared memory
+int sal_futex_wait(volatile uint32_t *addr, uint32_t expected);
+int sal_futex_wake(volatile uint32_t *addr, uint32_t count);
+
+// Capability handles. An endpoint is a kernel object that delivers to
+// its creator; other processes reach it through handles, small indices
+// into a per-process table that also record what the holder may do.
+int sal_endpoint_create(const char *name);   // NULL for an anonymous endpoint
+int sal_endpoint_open(const char *name);
+int sal_handle_send(int handle, const void *msg, size_t len, int xfer);
+int sal_handle_recv(int handle, void *buf, size_t maxlen, int *xfer_out);
+int sal_handle_dup(int handle, uint32_t rights);
+int sal_handle_close(int handle);
+int sal_endpoint_priority(int handle, uint32_t priority);  // Class for every message sent to it
+
+// Event ports: register interest in several sources, then block in one
+// sal_wait() that returns every source that became ready
+struct sal_watch {
+    uint32_t type;      // SAL_EV_*
+    uint32_t flags;     // SAL_WATCH_EDGE, default level-triggered
+    uintptr_t id;       // Topic id, ring address, timer period (ticks) or IRQ line
+    uintptr_t data;     // Returned untouched in sal_event
+};
+
+struct sal_event {
+    uint32_t type;
+    uint32_t count;     // Notifications since the source was last reported
+    uintptr_t id;
+    uintptr_t data;
+};
+
+int sal_port_create(void);
+int sal_port_close(int port);
+int sal_port_ctl(int port, int op, const struct sal_watch *watch);
+int sal_wait(int port, struct sal_event *events, int max, uint32_t timeout_ticks);
+
+// Real-time scheduling class. A process reserves `budget` ticks of CPU
+// in every `period`, each job due `deadline` ticks after its release.
+// Admission fails with SAL_ERR_BUSY once the reservations would pass
+// SAL_RT_UTIL_MAX percent of the CPU. Admitted jobs run earliest
+// deadline first, ahead of every best-effort process. A job ends when
+// its process next blocks in sal_wait(); one that uses up its budget
+// first drops to best effort until its next release.
+struct sal_rt_params {
+    uint32_t period;        // Ticks between releases
+    uint32_t budget;        // Ticks of CPU per job
+    uint32_t deadline;      // Ticks after the release, at most the period; 0 = the period
+};
+
+struct sal_rt_stats {
+    uint32_t period;
+    uint32_t budget;
+    uint32_t deadline;
+    uint32_t utilization;   // Reserved share of the CPU, 1/65536ths
+    uint32_t jobs;          // Released since admission
+    uint32_t misses;        // Not finished by their deadline
+    uint32_t throttled;     // Stopped at their budget
+    uint32_t max_lateness;  // Ticks past the deadline, of the latest job that still finished
+};
+
+int sal_rt_admit(const struct sal_rt_params *params);
+int sal_rt_leave(void);
+int sal_rt_stats(int pid, struct sal_rt_stats *stats);
+
+// SAL message header. Naturally aligned: every field is a uint32_t.
 struct sal_message {
     uint32_t sender_pid;
     uint32_t dest_pid;
     uint32_t msg_type;
     uint32_t length;
+    uint32_t priority;      // SAL_PRIO_*
+    uint32_t deadline;      // Absolute tick, 0 = none
     uint8_t data[];
-} __attribute__((packed));
-
-// Topic structure for pub/sub
-struct sal_topic {
-    char name[64];
-    void (*callback)(const void*, size_t);
-    struct sal_topic *next;
 };
 
 // SAL constants
 #define SAL_MAX_MESSAGE_SIZE 4096
 #define SAL_MAX_TOPICS 256
-#define AUTH_CHANNEL 1
+#define SAL_TOPIC_NAME_MAX 64   // Including the terminating NUL
+#define SAL_TOPIC_MSG_MAX 256   // Larger samples should travel by grant
+#define SAL_ANY_TOPIC 0
+#define SAL_PAGE_SIZE 4096
+#define SAL_ANY_PID (-1)
+#define SAL_MAX_IOV 16
+#define SAL_MAX_BATCH 64
+#define SAL_MAX_CALLBACKS 16     // Topics with a dispatched callback
+#define SAL_DISPATCH_BUDGET 8    // Messages per topic per dispatch iteration
+#define SAL_RETAIN_MAX 32        // Retained messages per topic
+#define SAL_NO_HANDLE (-1)
+#define AUTH_ENDPOINT "auth"     // Auth results to the kernel
+#define SAL_RT_UTIL_MAX 90       // Percent of the CPU the real-time class may reserve
+#define SAL_RT_MAX_PERIOD 6000   // Ticks (one minute)
+
+// Grant flags
+#define SAL_GRANT_SHARE_RO  0x1  // Receiver gets a read-only shared mapping
+#define SAL_GRANT_TRANSFER  0x2  // Ownership of the pages moves to the receiver
+
+// Channel open flags
+#define SAL_CHAN_PRODUCER   0x1
+#define SAL_CHAN_CONSUMER   0x2
+#define SAL_CHAN_MPSC       0x4  // Allow several producers (default SPSC)
+
+// Message priority classes
+#define SAL_PRIO_BULK       0    // Telemetry, logs
+#define SAL_PRIO_NORMAL     1    // Default
+#define SAL_PRIO_HIGH       2
+#define SAL_PRIO_URGENT     3    // Authentication decisions
+#define SAL_NUM_PRIOS       4
+
+// Topic delivery policies
+#define SAL_POLICY_DROP_NEWEST  0  // Bounded queue; a full queue refuses new samples (default)
+#define SAL_POLICY_DROP_OLDEST  1  // Bounded queue; a full queue evicts its oldest sample
+#define SAL_POLICY_LATEST       2  // One slot per subscriber, overwritten in place
+#define SAL_POLICY_CREDIT       3  // Publisher blocks once a subscriber's window is full
+
+// Handle rights
+#define SAL_RIGHT_SEND      0x1
+#define SAL_RIGHT_RECV      0x2  // Endpoint creator only; never transferred
+#define SAL_RIGHT_GRANT     0x4  // May pass the handle to another process
+
+// sal_stats() kinds
+#define SAL_STATS_MAILBOX   1    // id = PID
+#define SAL_STATS_TOPIC     2    // id = topic id
+
+// Event sources
+#define SAL_EV_MAILBOX      1    // Caller's mailbox has messages; id unused
+#define SAL_EV_TOPIC        2    // Caller's subscription to topic id has messages
+#define SAL_EV_CHANNEL      3    // Ring opened by the caller as consumer is non-empty
+#define SAL_EV_TIMER        4    // Periodic timer, id = period in ticks
+#define SAL_EV_IRQ          5    // Hardware interrupt line id fired
+
+// Watch flags and port_ctl operations
+#define SAL_WATCH_EDGE      0x1  // Report once per notification burst
+#define SAL_PORT_ADD        1
+#define SAL_PORT_DEL        2
+#define SAL_WAIT_FOREVER    0xFFFFFFFFu
+
+// SAL error codes (negative return values)
+#define SAL_OK           0
+#define SAL_ERR_INVAL   -1   // Bad argument
+#define SAL_ERR_NOPROC  -2   // Destination process does not exist
+#define SAL_ERR_FULL    -3   // Destination queue full
+#define SAL_ERR_AGAIN   -4   // Nothing to receive
+#define SAL_ERR_TOOBIG  -5   // Message larger than buffer or limit
+#define SAL_ERR_NOMEM   -6   // Kernel table exhausted
+#define SAL_ERR_PERM    -7   // Caller does not hold the right
+#define SAL_ERR_NOSYS   -8   // Unknown SAL syscall
+#define SAL_ERR_BUSY    -9   // Resource already claimed
 
 #endif // SAL_H
@@ -0,0 +1,18 @@
+#ifndef SAL_HOST_H
+#define SAL_HOST_H
+
+#include <stdint.h>
+
+// Host-native SAL (make host). The SAL kernel modules run in-process
+// against a simulated kernel (src/sal/host/sal_host.c): every thread acts
+// as one SAL process, and the sal_* wrappers call sal_syscall() directly
+// instead of trapping. Grants and channels are identity-mapped.
+
+#define SAL_HOST_TICK_US 10000  // Simulated timer period, 100 Hz like the PIT
+
+void sal_host_init(void);           // Start the tick thread
+void sal_host_shutdown(void);
+void sal_host_attach(uint32_t pid); // Run the calling thread as pid (default 0)
+uint32_t sal_host_pid(void);
+
+#endif // SAL_HOST_H
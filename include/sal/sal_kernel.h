@@ -0,0 +1,407 @@
+#ifndef SAL_KERNEL_H
+#define SAL_KERNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sal.h"
+
+// Kernel-side SAL definitions. Shared by src/sal/*.c and the kernel;
+// user services only need sal.h.
+
+// SAL syscall numbers. SAL lives above SYS_SAL_BASE so it does not
+// collide with the POSIX-style numbers handled in kernel.c.
+#define SYS_SAL_BASE 64
+
+enum Syscalls {
+    SYS_SAL_SEND = SYS_SAL_BASE,
+    SYS_SAL_RECV,
+    SYS_SAL_PUBLISH,
+    SYS_SAL_SUBSCRIBE,
+    SYS_SAL_GRANT,
+    SYS_SAL_GRANT_MAP,
+    SYS_SAL_GRANT_UNMAP,
+    SYS_SAL_GRANT_REVOKE,
+    SYS_SAL_TOPIC_INTERN,
+    SYS_SAL_TOPIC_RECV,
+    SYS_SAL_UNSUBSCRIBE,
+    SYS_SAL_CHANNEL_OPEN,
+    SYS_SAL_CHANNEL_CLOSE,
+    SYS_SAL_FUTEX_WAIT,
+    SYS_SAL_FUTEX_WAKE,
+    SYS_SAL_SENDV,
+    SYS_SAL_RECV_MANY,
+    SYS_SAL_PUBLISH_BATCH,
+    SYS_SAL_PORT_CREATE,
+    SYS_SAL_PORT_CLOSE,
+    SYS_SAL_PORT_CTL,
+    SYS_SAL_WAIT,
+    SYS_SAL_TOPIC_RECV_MANY,
+    SYS_SAL_ENDPOINT_CREATE,
+    SYS_SAL_ENDPOINT_OPEN,
+    SYS_SAL_HANDLE_SEND,
+    SYS_SAL_HANDLE_RECV,
+    SYS_SAL_HANDLE_DUP,
+    SYS_SAL_HANDLE_CLOSE,
+    SYS_SAL_TOPIC_POLICY,
+    SYS_SAL_TOPIC_STATS,
+    SYS_SAL_SEND_ATTR,
+    SYS_SAL_TICKS,
+    SYS_SAL_ENDPOINT_PRIORITY,
+    SYS_SAL_TOPIC_RETAIN,
+    SYS_SAL_TOPIC_HISTORY,
+    SYS_SAL_TOPIC_SEEK,
+    SYS_SAL_STATS,
+    SYS_SAL_RT_ADMIT,
+    SYS_SAL_RT_LEAVE,
+    SYS_SAL_RT_STATS,
+    SYS_SAL_LAST
+};
+
+// Kernel limits
+#define SAL_MAX_PROCS 17        // PID 0 (kernel/idle) plus 16 user processes
+#define SAL_MAX_CPUS 1          // Per-CPU counter copies
+#define SAL_MAILBOX_DEPTH 8     // Queued messages per process
+#define SAL_MAX_GRANTS 64
+#define SAL_GRANT_MAX_PAGES 1024
+#define SAL_GRANT_MAX_EXTENTS 8 // Physically contiguous runs per grant
+#define SAL_TOPIC_HASH_SIZE 512 // Open-addressed, 2x SAL_MAX_TOPICS
+#define SAL_MAX_TOPIC_SUBS 16   // Direct subscribers per topic or pattern
+#define SAL_TRIE_NODES 512      // Topic name levels across all topics
+#define SAL_MAX_SUBSCRIPTIONS 128
+#define SAL_MAX_FANOUT SAL_MAX_SUBSCRIPTIONS // Cached subscriber set per topic, patterns included
+#define SAL_MAX_PROC_SUBS 16    // Subscriptions per process
+#define SAL_SUB_QUEUE_DEPTH 16  // Pending messages per subscription (power of two)
+#define SAL_MAX_TOPIC_LOGS 4    // Topics with a retention log
+// Shared payload buffers: enough for every subscription queue and
+// retention log slot to hold a different one, plus the publish in flight
+#define SAL_BROKER_BUFFERS (SAL_MAX_SUBSCRIPTIONS * SAL_SUB_QUEUE_DEPTH + SAL_MAX_TOPIC_LOGS * SAL_RETAIN_MAX + 1)
+#define SAL_MAX_CHANNELS 16
+#define SAL_CHANNEL_MAX_OPENS 8 // Mappings per channel
+#define SAL_CHANNEL_POOL_PAGES 64
+#define SAL_CHANNEL_MAX_PAGES 16
+#define SAL_MAX_FUTEX_WAITERS 32
+#define SAL_MAX_PORTS 16
+#define SAL_MAX_WATCHES 128     // Registrations across all ports
+#define SAL_MAX_IRQS 16
+#define SAL_NO_WATCH 0xFFFF     // End of a watch list
+#define SAL_MAX_ENDPOINTS 32
+#define SAL_MAX_HANDLES 32      // Handle table size per process
+
+// Mailbox slot: header plus inline payload
+struct sal_mbox_slot {
+    struct sal_message hdr;
+    uint32_t endpoint;      // Endpoint index + 1 when sent through a handle
+    uint32_t xfer;          // Handle in flight (endpoint + 1) << 16 | rights
+    uint64_t stamp;         // Cycle count at enqueue
+    uint8_t data[SAL_MAX_MESSAGE_SIZE] __attribute__((aligned(16)));
+};
+
+// Per-process mailbox. order[] keeps queued slot indices in delivery
+// order (priority, then deadline, then arrival) so a filtered receive can
+// remove from the middle without moving payloads.
+struct sal_mailbox {
+    uint32_t count;
+    uint32_t used_mask;
+    uint32_t priority;      // Priority of order[0], reported to the scheduler
+    uint8_t order[SAL_MAILBOX_DEPTH];
+    struct sal_queue_stats stats[SAL_MAX_CPUS];
+    struct sal_mbox_slot slots[SAL_MAILBOX_DEPTH];
+};
+
+// Physically contiguous run of page frames
+struct sal_extent {
+    uintptr_t phys;
+    uint32_t npages;
+};
+
+// Grant states
+enum SalGrantState {
+    SAL_GRANT_FREE = 0,
+    SAL_GRANT_OFFERED,
+    SAL_GRANT_MAPPED
+};
+
+// Grant table entry
+struct sal_grant {
+    uint32_t state;
+    uint32_t generation;   // Bumped on free so stale ids are rejected
+    uint32_t owner_pid;
+    uint32_t grantee_pid;
+    uint32_t flags;
+    uint32_t npages;
+    size_t length;
+    uint32_t nextents;
+    struct sal_extent extents[SAL_GRANT_MAX_EXTENTS];
+    void *map_addr;        // Grantee mapping while SAL_GRANT_MAPPED
+};
+
+// Published payload. Copied from the publisher once and shared by
+// reference between every subscriber queue it was delivered to.
+struct sal_pub_buf {
+    uint32_t refs;
+    uint32_t seq;           // Position in the topic's sequence
+    uint64_t stamp;         // Cycle count at publish
+    uint32_t topic_id;
+    uint32_t publisher;
+    uint32_t length;
+    uint8_t data[SAL_TOPIC_MSG_MAX] __attribute__((aligned(16)));  // Aligned for wire.h payloads
+};
+
+// Interned topic. Ids are 1-based indices into the topic table.
+struct sal_topic {
+    char name[SAL_TOPIC_NAME_MAX];
+    uint32_t hash;
+    uint32_t pattern;       // Name contains '+' or '#'; subscribe only
+    uint32_t ndirect;
+    uint16_t direct[SAL_MAX_TOPIC_SUBS]; // Subscriptions naming this topic
+    uint32_t gen;           // Subscription generation subs[] was built for
+    uint32_t nsubs;
+    uint16_t subs[SAL_MAX_FANOUT]; // Direct and wildcard subscriptions, fan-out order
+    uint32_t policy;        // SAL_POLICY_*
+    uint32_t credits;       // Window per subscriber under SAL_POLICY_CREDIT
+    uint32_t waiters;       // Bitmask of PIDs blocked on credit
+    uint32_t published;
+    uint32_t delivered;
+    uint32_t drops;
+    uint32_t stalls;
+    uint32_t seq;           // Sequence number of the next publish
+    uint32_t log;           // Retention log index + 1, 0 = none
+    struct sal_queue_stats stats[SAL_MAX_CPUS];
+};
+
+// Last-N history of a topic: references to the newest payload buffers,
+// indexed by sequence number. The oldest held has seq topic->seq - count.
+struct sal_topic_log {
+    uint32_t in_use;
+    uint32_t depth;         // Messages to keep, at most SAL_RETAIN_MAX
+    uint32_t count;
+    uint16_t bufs[SAL_RETAIN_MAX];
+};
+
+// One level of a topic name. Children and siblings are node indices,
+// 0 = none; the level text is len bytes at off in topic ref's name.
+struct sal_trie_node {
+    uint16_t child;
+    uint16_t sibling;
+    uint16_t topic;     // Topic whose name ends at this level, 0 = none
+    uint16_t ref;
+    uint8_t off;
+    uint8_t len;
+};
+
+// One process subscribed to one topic: a ring of payload buffer indices
+struct sal_subscription {
+    uint32_t in_use;
+    uint32_t pid;
+    uint32_t topic_id;
+    uint32_t head;      // Next entry to dequeue (free-running)
+    uint32_t tail;      // Next entry to fill (free-running)
+    uint32_t dropped;   // Publishes lost because the queue was full
+    uint32_t cursor;    // Sequence number of the next message to read
+    uint16_t queue[SAL_SUB_QUEUE_DEPTH];
+};
+
+// Shared-memory channel: pages from the channel pool holding a sal_ring
+struct sal_channel {
+    uint32_t in_use;
+    char name[SAL_TOPIC_NAME_MAX];
+    uint32_t flags;
+    uint32_t slot_size;
+    uint32_t nslots;
+    uint32_t first_page;    // Index into the channel page pool
+    uint32_t npages;
+    uint32_t producers;
+    uint32_t consumer_pid;  // Valid while has_consumer
+    uint32_t has_consumer;
+    uintptr_t wake_key;     // Futex key of the ring's wake_seq
+    uint32_t nopens;
+    struct {
+        uint32_t pid;
+        uint32_t flags;
+        void *addr;
+    } opens[SAL_CHANNEL_MAX_OPENS];
+};
+
+// Kernel endpoint: a named or anonymous destination whose messages land
+// in the owner's mailbox. Kept alive by the handles that refer to it.
+struct sal_endpoint {
+    uint32_t in_use;
+    char name[SAL_TOPIC_NAME_MAX];  // Empty for anonymous endpoints
+    uint32_t owner_pid;
+    struct sal_mailbox *owner_mb;   // Resolved at create, so a send needs no PID lookup
+    uint32_t refs;          // Handles and transfers in flight
+    uint32_t receivers;     // Handles holding SAL_RIGHT_RECV
+    uint32_t priority;      // Class given to every message sent to it
+};
+
+// Handle table entry. The index into the caller's table is the handle.
+struct sal_handle {
+    uint16_t endpoint;      // Endpoint index + 1, 0 = free
+    uint16_t rights;
+};
+
+// Futex waiter, keyed by physical address so every mapping of a shared
+// page agrees on the key
+struct sal_futex_waiter {
+    uint32_t in_use;
+    uint32_t pid;
+    uintptr_t key;
+};
+
+// One registration on an event port. It sits on its source's watch list
+// and, while ready, on the port's doubly linked ready list; both are
+// index links into the global watch table so notify and harvest are O(1).
+struct sal_watch_item {
+    uint8_t in_use;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t queued;         // On the port's ready list
+    uint16_t port;
+    uint16_t src;           // Source index: pid, subscription, channel or IRQ line
+    uint16_t next_src;      // Next watcher of the same source
+    uint16_t next_port;     // Next registration on the same port
+    uint16_t prev_ready;
+    uint16_t next_ready;
+    uint16_t next_timer;    // Timer queue, sorted by expiry
+    uint32_t count;         // Notifications not yet reported
+    uint32_t period;
+    uint32_t expires;
+    uintptr_t id;
+    uintptr_t data;
+};
+
+// Real-time task, indexed by PID (see sal_rt.c)
+#define SAL_RT_PENDING      0   // Job released with budget left
+#define SAL_RT_DONE         1   // Job finished; waits for the next release
+#define SAL_RT_THROTTLED    2   // Budget used up; waits for the next release
+
+struct sal_rt_task {
+    uint32_t in_use;
+    uint32_t period;
+    uint32_t budget;
+    uint32_t deadline;
+    uint32_t util;          // budget / deadline in 1/65536ths, rounded up
+    uint32_t release;       // Tick the current job was released
+    uint32_t due;           // Its absolute deadline
+    uint32_t used;          // Ticks it has run
+    uint32_t state;         // SAL_RT_*
+    uint32_t missed;        // Already counted as a miss
+    uint32_t jobs;
+    uint32_t misses;
+    uint32_t throttled;
+    uint32_t max_lateness;
+};
+
+struct sal_port {
+    uint32_t in_use;
+    uint32_t owner;
+    uint16_t watches;       // Registration list
+    uint16_t ready_head;
+    uint16_t ready_tail;
+    uint16_t waiting;       // Owner is asleep in sal_wait
+    uint32_t deadline_armed;
+    uint32_t deadline;      // Tick at which a pending wait times out
+};
+
+// Syscall entry: called by the kernel trap handler with the caller's PID
+long sal_syscall(uint32_t caller, long num, long a1, long a2, long a3, long a4);
+
+// Kernel-side syscall implementations
+long sys_sal_send(uint32_t caller, int dest_pid, const void *buf, size_t size);
+long sys_sal_recv(uint32_t caller, int src_pid, void *buf, size_t maxlen);
+long sys_sal_sendv(uint32_t caller, int dest_pid, const struct sal_iovec *iov, int iovcnt);
+long sys_sal_send_attr(uint32_t caller, int dest_pid, const void *buf, size_t size, const struct sal_msg_attr *attr);
+long sys_sal_ticks(uint32_t caller);
+long sys_sal_recv_many(uint32_t caller, int src_pid, struct sal_mmsg *msgs, int n);
+long sys_sal_publish_batch(uint32_t caller, const struct sal_pub_entry *entries, int n);
+long sys_sal_topic_intern(uint32_t caller, const char *name);
+long sys_sal_publish(uint32_t caller, int topic_id, const void *data, size_t len);
+long sys_sal_subscribe(uint32_t caller, int topic_id);
+long sys_sal_unsubscribe(uint32_t caller, int topic_id);
+long sys_sal_topic_recv(uint32_t caller, int topic_id, int *topic_out, void *buf, size_t maxlen);
+long sys_sal_topic_recv_many(uint32_t caller, int topic_id, struct sal_mmsg *msgs, int n);
+long sys_sal_topic_policy(uint32_t caller, int topic_id, uint32_t policy, uint32_t param);
+long sys_sal_topic_retain(uint32_t caller, int topic_id, uint32_t depth);
+long sys_sal_topic_history(uint32_t caller, int topic_id, struct sal_mmsg *msgs, int n);
+long sys_sal_topic_seek(uint32_t caller, int topic_id, uint32_t back);
+long sys_sal_stats(uint32_t caller, uint32_t kind, int id, struct sal_queue_stats *stats);
+long sys_sal_topic_stats(uint32_t caller, int topic_id, struct sal_topic_stats *stats);
+long sys_sal_channel_open(uint32_t caller, const char *name, uint32_t flags, uint32_t slot_size, uint32_t nslots);
+long sys_sal_channel_close(uint32_t caller, void *ring);
+long sys_sal_futex_wait(uint32_t caller, volatile uint32_t *addr, uint32_t expected);
+long sys_sal_futex_wake(uint32_t caller, volatile uint32_t *addr, uint32_t count);
+long sys_sal_port_create(uint32_t caller);
+long sys_sal_port_close(uint32_t caller, int port);
+long sys_sal_port_ctl(uint32_t caller, int port, int op, const struct sal_watch *watch);
+long sys_sal_wait(uint32_t caller, int port, struct sal_event *events, int max, uint32_t timeout);
+long sys_sal_endpoint_create(uint32_t caller, const char *name);
+long sys_sal_endpoint_open(uint32_t caller, const char *name);
+long sys_sal_handle_send(uint32_t caller, int handle, const void *buf, size_t len, int xfer);
+long sys_sal_handle_recv(uint32_t caller, int handle, void *buf, size_t maxlen, int *xfer_out);
+long sys_sal_handle_dup(uint32_t caller, int handle, uint32_t rights);
+long sys_sal_handle_close(uint32_t caller, int handle);
+long sys_sal_endpoint_priority(uint32_t caller, int handle, uint32_t priority);
+long sys_sal_rt_admit(uint32_t caller, const struct sal_rt_params *params);
+long sys_sal_rt_leave(uint32_t caller);
+long sys_sal_rt_stats(uint32_t caller, int pid, struct sal_rt_stats *stats);
+long sys_sal_grant(uint32_t caller, int dest_pid, void *buf, size_t len, uint32_t flags);
+long sys_sal_grant_map(uint32_t caller, int grant_id, void **addr, size_t *len);
+long sys_sal_grant_unmap(uint32_t caller, int grant_id);
+long sys_sal_grant_revoke(uint32_t caller, int grant_id);
+
+// Shared helpers
+struct sal_mailbox *sal_mailbox_get(int pid);
+long sal_mailbox_put(struct sal_mailbox *mb, const struct sal_message *hdr, uint32_t endpoint,
+                     uint32_t xfer, const struct sal_iovec *iov, int iovcnt);
+long sal_mailbox_take(struct sal_mailbox *mb, int src_pid, uint32_t endpoint, void *buf, size_t maxlen,
+                      uint32_t *sender, uint32_t *xfer);
+void sal_mailbox_flush(struct sal_mailbox *mb, uint32_t endpoint);
+void sal_handle_xfer_drop(uint32_t xfer);
+const char *sal_topic_name(int topic_id);
+int sal_trie_classify(const char *name);
+int sal_trie_insert(int topic_id, const char *name);
+int sal_trie_match(const char *name, uint16_t *ids, int max);
+struct sal_queue_stats *sal_topic_qstats(int topic_id);
+
+// Counter updates (lock held) on the calling CPU's copy, stats[sal_arch_cpu()]
+void sal_stats_enqueue(struct sal_queue_stats *s, size_t bytes, uint32_t depth);
+void sal_stats_dequeue(struct sal_queue_stats *s, uint64_t stamp);
+int sal_resolve_extents(const void *buf, uint32_t npages, struct sal_extent *ext, uint32_t max);
+
+// Event port notifications, called by the SAL modules with the lock held
+// and by the kernel's interrupt handlers without it
+void sal_port_notify(uint32_t type, uint32_t src);
+void sal_port_drop_source(uint32_t type, uint32_t src);
+void sal_port_tick(uint32_t now);
+void sal_port_irq(uint32_t line);
+
+// Real-time class. admit_at, tick and pick take the lock; complete is
+// called by sal_wait() with it held, as the caller blocks.
+long sal_rt_admit_at(uint32_t pid, const struct sal_rt_params *params, uint32_t now);
+void sal_rt_tick(uint32_t now, uint32_t running);
+void sal_rt_complete(uint32_t pid, uint32_t now);
+int sal_rt_pick(uint32_t runnable);    // Bitmask of runnable PIDs; -1 for none
+
+// Source queries used by the event port (lock held)
+int sal_mailbox_pending(uint32_t pid);
+int sal_sub_index(uint32_t pid, int topic_id);
+int sal_sub_pending(uint32_t idx);
+int sal_channel_index(uint32_t pid, const void *ring);
+int sal_channel_pending(uint32_t idx);
+void sal_channel_arm(uint32_t idx, int waiting);
+
+// Architecture hooks implemented by the kernel (src/kernel/kernel.c)
+uint32_t sal_arch_lock(void);
+void sal_arch_unlock(uint32_t flags);
+int sal_arch_pid_valid(uint32_t pid);
+int sal_arch_virt_to_phys(const void *vaddr, uintptr_t *phys);
+void *sal_arch_map_extents(const struct sal_extent *ext, uint32_t nextents, int writable);
+void sal_arch_unmap(void *vaddr, uint32_t npages);
+void sal_arch_sleep(uint32_t pid);
+void sal_arch_wake(uint32_t pid);
+uint32_t sal_arch_ticks(void);
+uint64_t sal_arch_cycles(void);
+uint32_t sal_arch_cpu(void);
+void sal_arch_set_priority(uint32_t pid, uint32_t priority);
+
+#endif // SAL_KERNEL_H
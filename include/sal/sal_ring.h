@@ -0,0 +1,172 @@
+#ifndef SAL_RING_H
+#define SAL_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sal.h"
+
+// Shared-memory rings set up by sal_channel_open(). The data path below
+// runs entirely in user space; the kernel is only entered to sleep when
+// the ring is empty and to wake a sleeping consumer.
+//
+// SPSC rings use a Lamport queue with cached peer indices. MPSC rings use
+// per-slot sequence numbers so producers claim slots with one CAS.
+
+#define SAL_CACHELINE 64
+
+// Ring types
+#define SAL_RING_SPSC 0
+#define SAL_RING_MPSC 1
+
+// Slot header; the payload follows
+struct sal_ring_slot {
+    uint32_t seq;   // MPSC publication sequence
+    uint32_t len;
+    uint8_t data[];
+};
+
+struct sal_ring {
+    // Producer side
+    uint32_t tail __attribute__((aligned(SAL_CACHELINE)));
+    uint32_t head_cache;        // SPSC producer's last view of head
+
+    // Consumer side
+    uint32_t head __attribute__((aligned(SAL_CACHELINE)));
+    uint32_t tail_cache;        // SPSC consumer's last view of tail
+
+    // Sleep handshake. Every producer reads the flag after each push, so
+    // it sits apart from head rather than pulling the consumer's line
+    // over on every send.
+    uint32_t consumer_waiting __attribute__((aligned(SAL_CACHELINE)));  // Set while the consumer sleeps
+    uint32_t wake_seq;          // Futex word for consumer wakeups
+
+    // Read-only after setup
+    uint32_t type __attribute__((aligned(SAL_CACHELINE)));
+    uint32_t mask;              // nslots - 1
+    uint32_t slot_size;         // Max payload bytes per slot
+    uint32_t stride;            // Bytes between slots
+
+    uint8_t slots[] __attribute__((aligned(SAL_CACHELINE)));
+};
+
+static inline struct sal_ring_slot *sal_ring_slot(struct sal_ring *r, uint32_t pos) {
+    return (struct sal_ring_slot *)(r->slots + (size_t)(pos & r->mask) * r->stride);
+}
+
+static inline void sal_ring_copy(void *dst, const void *src, uint32_t len) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    while (len--) *d++ = *s++;
+}
+
+// Non-zero when the consumer has a message waiting
+static inline int sal_ring_readable(struct sal_ring *r) {
+    uint32_t h = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    if (r->type == SAL_RING_SPSC) {
+        return __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) != h;
+    }
+    return __atomic_load_n(&sal_ring_slot(r, h)->seq, __ATOMIC_ACQUIRE) == h + 1;
+}
+
+// Wake the consumer if it announced it is going to sleep. The full fence
+// pairs with the one in sal_ring_pop_wait() so a wakeup cannot be lost.
+static inline void sal_ring_notify(struct sal_ring *r) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&r->consumer_waiting, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&r->wake_seq, 1, __ATOMIC_RELEASE);
+        sal_futex_wake(&r->wake_seq, 1);
+    }
+}
+
+// Enqueue one message. Returns SAL_OK or SAL_ERR_FULL.
+static inline int sal_ring_push(struct sal_ring *r, const void *data, uint32_t len) {
+    if (len > r->slot_size) return SAL_ERR_TOOBIG;
+
+    if (r->type == SAL_RING_SPSC) {
+        uint32_t t = r->tail;
+        if (t - r->head_cache > r->mask) {
+            r->head_cache = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+            if (t - r->head_cache > r->mask) return SAL_ERR_FULL;
+        }
+        struct sal_ring_slot *s = sal_ring_slot(r, t);
+        s->len = len;
+        sal_ring_copy(s->data, data, len);
+        __atomic_store_n(&r->tail, t + 1, __ATOMIC_RELEASE);
+    } else {
+        uint32_t pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        struct sal_ring_slot *s;
+        for (;;) {
+            s = sal_ring_slot(r, pos);
+            int32_t dif = (int32_t)(__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) - pos);
+            if (dif == 0) {
+                if (__atomic_compare_exchange_n(&r->tail, &pos, pos + 1, 1,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return SAL_ERR_FULL;
+            } else {
+                pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+            }
+        }
+        s->len = len;
+        sal_ring_copy(s->data, data, len);
+        __atomic_store_n(&s->seq, pos + 1, __ATOMIC_RELEASE);
+    }
+    return SAL_OK;
+}
+
+// Dequeue one message. Returns its length or SAL_ERR_AGAIN when empty.
+static inline int sal_ring_pop(struct sal_ring *r, void *buf, uint32_t maxlen) {
+    uint32_t h = r->head;
+    struct sal_ring_slot *s = sal_ring_slot(r, h);
+
+    if (r->type == SAL_RING_SPSC) {
+        if (h == r->tail_cache) {
+            r->tail_cache = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+            if (h == r->tail_cache) return SAL_ERR_AGAIN;
+        }
+    } else {
+        int32_t dif = (int32_t)(__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) - (h + 1));
+        if (dif < 0) return SAL_ERR_AGAIN;
+    }
+
+    uint32_t len = s->len;
+    if (len > maxlen) return SAL_ERR_TOOBIG;
+    sal_ring_copy(buf, s->data, len);
+
+    if (r->type == SAL_RING_MPSC) {
+        __atomic_store_n(&s->seq, h + r->mask + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&r->head, h + 1, __ATOMIC_RELEASE);
+    return (int)len;
+}
+
+// Enqueue and wake a sleeping consumer
+static inline int sal_ring_send(struct sal_ring *r, const void *data, uint32_t len) {
+    int ret = sal_ring_push(r, data, len);
+    if (ret == SAL_OK) sal_ring_notify(r);
+    return ret;
+}
+
+// Dequeue, sleeping in the kernel while the ring is empty
+static inline int sal_ring_pop_wait(struct sal_ring *r, void *buf, uint32_t maxlen) {
+    for (;;) {
+        int ret = sal_ring_pop(r, buf, maxlen);
+        if (ret != SAL_ERR_AGAIN) return ret;
+
+        uint32_t seq = __atomic_load_n(&r->wake_seq, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&r->consumer_waiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        ret = sal_ring_pop(r, buf, maxlen);
+        if (ret != SAL_ERR_AGAIN) {
+            __atomic_store_n(&r->consumer_waiting, 0, __ATOMIC_RELAXED);
+            return ret;
+        }
+        sal_futex_wait(&r->wake_seq, seq);
+        __atomic_store_n(&r->consumer_waiting, 0, __ATOMIC_RELAXED);
+    }
+}
+
+#endif // SAL_RING_H
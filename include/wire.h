@@ -0,0 +1,88 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Wire layouts for payloads carried over SAL. Every message starts with
+// a wire_hdr; the payload follows at a 16-byte offset in the same layout
+// as the C struct, so nothing needs packing and an aligned receive buffer
+// can be loaded straight into SSE registers.
+struct wire_hdr {
+    uint16_t type;      // WIRE_TYPE_*
+    uint16_t version;   // Schema version of the sender
+    uint32_t length;    // Payload bytes after the header
+    uint32_t count;     // Records: 1, or the samples used in a batch
+    uint32_t reserved;
+};
+
+#define WIRE_ALIGN 16
+#define WIRE_BATCH_MAX 8        // Samples per struct-of-arrays batch (two SSE vectors)
+
+// Message types
+#define WIRE_TYPE_AUTH       1
+#define WIRE_TYPE_HRV        2
+#define WIRE_TYPE_EEG        3
+#define WIRE_TYPE_HRV_BATCH  4
+#define WIRE_TYPE_EEG_BATCH  5
+
+// Codec errors (negative return values)
+#define WIRE_ERR_SPACE  -1   // Buffer too small
+#define WIRE_ERR_TYPE   -2   // Not the expected message type
+#define WIRE_ERR_FORMAT -3   // Bad version, length or count
+
+// Schemas are X-macros: FIELDS(X, S) expands X(S, type, name) once per
+// field. Fields are only ever appended, and each addition bumps the
+// version, so a decoder zero-fills whatever an older sender did not have
+// and ignores what a newer one added.
+#define WIRE_FIELD(S, type, name) type name;
+#define WIRE_SOA_FIELD(S, type, name) type name[WIRE_BATCH_MAX] __attribute__((aligned(WIRE_ALIGN)));
+
+#define WIRE_MEMBER_SIZE(S, name) sizeof(((struct S *)0)->name)
+
+#define WIRE_PUT(S, type, name) \
+    __builtin_memcpy(payload + offsetof(struct S, name), &in->name, WIRE_MEMBER_SIZE(S, name));
+
+#define WIRE_GET(S, type, name) \
+    if (offsetof(struct S, name) + WIRE_MEMBER_SIZE(S, name) <= len) { \
+        __builtin_memcpy(&out->name, payload + offsetof(struct S, name), WIRE_MEMBER_SIZE(S, name)); \
+    } else { \
+        __builtin_memset(&out->name, 0, WIRE_MEMBER_SIZE(S, name)); \
+    }
+
+// Generate prefix_encode() and prefix_decode() for struct S.
+// encode returns the message size; decode returns the record count.
+// max_count is 1 for a single record, WIRE_BATCH_MAX for a batch.
+#define WIRE_CODEC(S, prefix, type_id, ver, max_count, FIELDS) \
+    static inline long prefix##_encode(const struct S *in, uint32_t count, void *buf, size_t size) { \
+        if (count == 0 || count > (max_count)) return WIRE_ERR_FORMAT; \
+        if (size < sizeof(struct wire_hdr) + sizeof(struct S)) return WIRE_ERR_SPACE; \
+        struct wire_hdr *hdr = (struct wire_hdr *)buf; \
+        uint8_t *payload = (uint8_t *)buf + sizeof(struct wire_hdr); \
+        hdr->type = (type_id); \
+        hdr->version = (ver); \
+        hdr->length = sizeof(struct S); \
+        hdr->count = count; \
+        hdr->reserved = 0; \
+        __builtin_memset(payload, 0, sizeof(struct S)); \
+        FIELDS(WIRE_PUT, S) \
+        return (long)(sizeof(struct wire_hdr) + sizeof(struct S)); \
+    } \
+    static inline int prefix##_decode(const void *buf, size_t size, struct S *out) { \
+        if (size < sizeof(struct wire_hdr)) return WIRE_ERR_FORMAT; \
+        const struct wire_hdr *hdr = (const struct wire_hdr *)buf; \
+        const uint8_t *payload = (const uint8_t *)buf + sizeof(struct wire_hdr); \
+        size_t len = hdr->length; \
+        if (hdr->type != (type_id)) return WIRE_ERR_TYPE; \
+        if (hdr->version == 0 || len > size - sizeof(struct wire_hdr)) return WIRE_ERR_FORMAT; \
+        if (hdr->count == 0 || hdr->count > (max_count)) return WIRE_ERR_FORMAT; \
+        FIELDS(WIRE_GET, S) \
+        return (int)hdr->count; \
+    }
+
+// Type of a message without decoding it, or 0 if it is too short
+static inline uint32_t wire_type(const void *buf, size_t size) {
+    return size >= sizeof(struct wire_hdr) ? ((const struct wire_hdr *)buf)->type : 0;
+}
+
+#endif // WIRE_H
@@ -0,0 +1,116 @@
+#include "../include/dsp/dsp_eeg.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+#define EEG_PI 3.14159265358979323846
+
+// Band edges in tenths of a hertz
+static const uint32_t eeg_edges_dhz[EEG_BANDS + 1] = { 5, 40, 80, 130, 300 };
+
+// First bin at or above the frequency
+static uint32_t eeg_bin(const struct eeg_plan *p, uint32_t dhz) {
+    return (dhz * p->nfft + p->sample_rate * 10 - 1) / (p->sample_rate * 10);
+}
+
+int eeg_plan_init(struct eeg_plan *p, uint32_t sample_rate, uint32_t nfft, uint32_t segments) {
+    if (sample_rate * 10 <= 2 * eeg_edges_dhz[EEG_BANDS]) return DSP_ERR_INVAL;
+    memset(p, 0, sizeof(*p));
+    if (dsp_fft_init(&p->fft, nfft) != 0) return DSP_ERR_INVAL;
+    if (segments == 0) segments = 1;
+    if (segments > EEG_MAX_SEGMENTS) segments = EEG_MAX_SEGMENTS;
+    p->sample_rate = sample_rate;
+    p->nfft = nfft;
+    p->hop = nfft / 2;
+    p->segments = segments;
+    for (uint32_t b = 0; b < EEG_BANDS; b++) {
+        p->band_lo[b] = eeg_bin(p, eeg_edges_dhz[b]);
+        p->band_hi[b] = eeg_bin(p, eeg_edges_dhz[b + 1]);
+    }
+
+    // Periodic Hann window. A band sums bins of width rate / nfft, and
+    // the one-sided density of bin k is 2 |X[k]|^2 / (rate * sum(w^2)),
+    // so the rate cancels out of the band power.
+    double energy = 0.0;
+    for (uint32_t i = 0; i < nfft; i++) {
+        double s, c;
+        dsp_sincos(2.0 * EEG_PI * (double)i / (double)nfft, &s, &c);
+        p->window[i] = (float)(0.5 - 0.5 * c);
+        energy += (double)p->window[i] * p->window[i];
+    }
+    p->scale = (float)(2.0 / ((double)nfft * energy));
+    return 0;
+}
+
+void eeg_init(struct eeg_channel *c, struct eeg_plan *p) {
+    memset(c, 0, sizeof(*c));
+    c->plan = p;
+}
+
+// Window the last nfft samples, oldest first, and keep the band powers
+static void eeg_transform(struct eeg_channel *c) {
+    struct eeg_plan *p = c->plan;
+    uint32_t n = p->nfft, tail = n - c->pos;
+    for (uint32_t i = 0; i < tail; i++) p->seg[i] = c->ring[c->pos + i] * p->window[i];
+    for (uint32_t i = tail; i < n; i++) p->seg[i] = c->ring[i - tail] * p->window[i];
+    dsp_rfft(&p->fft, p->seg, p->re, p->im);
+
+    float *power = c->power[c->seg_pos];
+    for (uint32_t b = 0; b < EEG_BANDS; b++) {
+        float sum = 0.0f;
+        for (uint32_t k = p->band_lo[b]; k < p->band_hi[b]; k++) {
+            sum += p->re[k] * p->re[k] + p->im[k] * p->im[k];
+        }
+        power[b] = sum * p->scale;
+    }
+    if (++c->seg_pos == p->segments) c->seg_pos = 0;
+    if (c->seg_count < p->segments) c->seg_count++;
+    c->windows++;
+}
+
+int eeg_push(struct eeg_channel *c, float sample) {
+    const struct eeg_plan *p = c->plan;
+    c->ring[c->pos] = sample;
+    if (++c->pos == p->nfft) c->pos = 0;
+    if (c->filled < p->nfft) c->filled++;
+    if (++c->since_hop >= p->hop && c->filled == p->nfft) {
+        c->since_hop = 0;
+        eeg_transform(c);
+        return 1;
+    }
+    return 0;
+}
+
+int eeg_push_block(struct eeg_channel *c, const float *x, uint32_t n) {
+    int windows = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        windows += eeg_push(c, x[i]);
+    }
+    return windows;
+}
+
+// r / (1 + r) for r = num / den, without dividing by zero
+static float eeg_ratio(float num, float den) {
+    return num + den > 0.0f ? num / (num + den) : 0.0f;
+}
+
+void eeg_bands(const struct eeg_channel *c, struct eeg_bands *b) {
+    memset(b, 0, sizeof(*b));
+    b->segments = c->seg_count;
+    if (c->seg_count == 0) return;
+
+    float total = 0.0f;
+    for (uint32_t band = 0; band < EEG_BANDS; band++) {
+        float sum = 0.0f;
+        for (uint32_t s = 0; s < c->seg_count; s++) sum += c->power[s][band];
+        b->power[band] = sum / (float)c->seg_count;
+        total += b->power[band];
+    }
+    for (uint32_t band = 0; band < EEG_BANDS; band++) {
+        b->relative[band] = total > 0.0f ? b->power[band] / total : 0.0f;
+    }
+
+    // Engagement index beta / (alpha + theta), and alpha over beta for
+    // relaxation, each mapped onto [0, 1] as r / (1 + r)
+    b->focus = eeg_ratio(b->power[EEG_BETA], b->power[EEG_ALPHA] + b->power[EEG_THETA]);
+    b->relaxation = eeg_ratio(b->power[EEG_ALPHA], b->power[EEG_BETA]);
+}
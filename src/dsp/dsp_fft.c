@@ -0,0 +1,195 @@
+#include "../include/dsp/dsp_fft.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+#define FFT_PI 3.14159265358979323846
+#define FFT_HALF_PI 1.57079632679489661923
+
+// Reduce to |r| <= pi/4 around a multiple of pi/2, then Taylor series;
+// the terms past r^17 are below double precision there
+void dsp_sincos(double x, double *s, double *c) {
+    double q = x / FFT_HALF_PI;
+    int32_t k = (int32_t)(q < 0.0 ? q - 0.5 : q + 0.5);
+    double r = x - (double)k * FFT_HALF_PI;
+    double r2 = r * r;
+    double sn = r, cs = 1.0, term_s = r, term_c = 1.0;
+    for (int i = 1; i <= 8; i++) {
+        term_s *= -r2 / (double)((2 * i) * (2 * i + 1));
+        term_c *= -r2 / (double)((2 * i - 1) * (2 * i));
+        sn += term_s;
+        cs += term_c;
+    }
+    switch (k & 3) {
+    case 0: *s = sn;  *c = cs;  break;
+    case 1: *s = cs;  *c = -sn; break;
+    case 2: *s = -sn; *c = -cs; break;
+    default: *s = -cs; *c = sn; break;
+    }
+}
+
+int dsp_fft_init(struct dsp_fft *f, uint32_t n) {
+    if (n < DSP_FFT_MIN || n > DSP_FFT_MAX || (n & (n - 1)) != 0) return DSP_ERR_INVAL;
+    memset(f, 0, sizeof(*f));
+    f->n = n;
+    f->m = n / 2;
+
+    uint32_t bits = 0;
+    while ((1u << bits) < f->m) bits++;
+    f->radix2 = bits & 1;
+    for (uint32_t i = 0; i < f->m; i++) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        f->rev[i] = (uint16_t)r;
+    }
+
+    // W = exp(-2 pi i / 4L); the block for L holds W^k, W^2k, W^3k
+    uint32_t at = 0;
+    for (uint32_t len = f->radix2 ? 2 : 1; len < f->m; len *= 4) {
+        for (uint32_t j = 1; j <= 3; j++) {
+            for (uint32_t k = 0; k < len; k++) {
+                double s, c;
+                dsp_sincos(-2.0 * FFT_PI * (double)(j * k) / (double)(4 * len), &s, &c);
+                f->tw_re[at + (j - 1) * len + k] = (float)c;
+                f->tw_im[at + (j - 1) * len + k] = (float)s;
+            }
+        }
+        at += (3 * len + 3) & ~3u;
+    }
+
+    for (uint32_t k = 0; k <= f->m / 2; k++) {
+        double s, c;
+        dsp_sincos(-2.0 * FFT_PI * (double)k / (double)n, &s, &c);
+        f->split_re[k] = (float)c;
+        f->split_im[k] = (float)s;
+    }
+    return 0;
+}
+
+static void fft_radix2(float *re, float *im, uint32_t m) {
+    for (uint32_t i = 0; i < m; i += 2) {
+        float ar = re[i], ai = im[i], br = re[i + 1], bi = im[i + 1];
+        re[i] = ar + br;
+        im[i] = ai + bi;
+        re[i + 1] = ar - br;
+        im[i + 1] = ai - bi;
+    }
+}
+
+// One radix-4 stage: two radix-2 stages of span len and 2 * len fused.
+// With W = exp(-2 pi i k / 4L) and inputs a0..a3 at k + {0, 1, 2, 3} L:
+//   b1 = W^2 a1, b2 = W a2, b3 = W^3 a3
+//   y0 = (a0 + b1) + (b2 + b3)      y2 = (a0 + b1) - (b2 + b3)
+//   y1 = (a0 - b1) - i (b2 - b3)    y3 = (a0 - b1) + i (b2 - b3)
+static void fft_radix4_scalar(float *re, float *im, uint32_t m, uint32_t len,
+                              const float *wr, const float *wi) {
+    for (uint32_t j = 0; j < m; j += 4 * len) {
+        for (uint32_t k = 0; k < len; k++) {
+            float *r = re + j + k, *i = im + j + k;
+            float w1r = wr[k], w1i = wi[k];
+            float w2r = wr[len + k], w2i = wi[len + k];
+            float w3r = wr[2 * len + k], w3i = wi[2 * len + k];
+            float b1r = r[len] * w2r - i[len] * w2i, b1i = r[len] * w2i + i[len] * w2r;
+            float b2r = r[2 * len] * w1r - i[2 * len] * w1i, b2i = r[2 * len] * w1i + i[2 * len] * w1r;
+            float b3r = r[3 * len] * w3r - i[3 * len] * w3i, b3i = r[3 * len] * w3i + i[3 * len] * w3r;
+            float t0r = r[0] + b1r, t0i = i[0] + b1i;
+            float t1r = r[0] - b1r, t1i = i[0] - b1i;
+            float t2r = b2r + b3r, t2i = b2i + b3i;
+            float t3r = b2r - b3r, t3i = b2i - b3i;
+            r[0] = t0r + t2r;
+            i[0] = t0i + t2i;
+            r[len] = t1r + t3i;
+            i[len] = t1i - t3r;
+            r[2 * len] = t0r - t2r;
+            i[2 * len] = t0i - t2i;
+            r[3 * len] = t1r - t3i;
+            i[3 * len] = t1i + t3r;
+        }
+    }
+}
+
+#ifdef __SSE__
+// The same stage four k at a time; needs len to be a multiple of 4
+static void fft_radix4_sse(float *re, float *im, uint32_t m, uint32_t len,
+                           const float *wr, const float *wi) {
+    for (uint32_t j = 0; j < m; j += 4 * len) {
+        for (uint32_t k = 0; k < len; k += 4) {
+            dsp_v4 *r0 = (dsp_v4 *)(re + j + k), *i0 = (dsp_v4 *)(im + j + k);
+            dsp_v4 *r1 = (dsp_v4 *)(re + j + k + len), *i1 = (dsp_v4 *)(im + j + k + len);
+            dsp_v4 *r2 = (dsp_v4 *)(re + j + k + 2 * len), *i2 = (dsp_v4 *)(im + j + k + 2 * len);
+            dsp_v4 *r3 = (dsp_v4 *)(re + j + k + 3 * len), *i3 = (dsp_v4 *)(im + j + k + 3 * len);
+            dsp_v4 w1r = *(const dsp_v4 *)(wr + k), w1i = *(const dsp_v4 *)(wi + k);
+            dsp_v4 w2r = *(const dsp_v4 *)(wr + len + k), w2i = *(const dsp_v4 *)(wi + len + k);
+            dsp_v4 w3r = *(const dsp_v4 *)(wr + 2 * len + k), w3i = *(const dsp_v4 *)(wi + 2 * len + k);
+            dsp_v4 a0r = *r0, a0i = *i0;
+            dsp_v4 b1r = *r1 * w2r - *i1 * w2i, b1i = *r1 * w2i + *i1 * w2r;
+            dsp_v4 b2r = *r2 * w1r - *i2 * w1i, b2i = *r2 * w1i + *i2 * w1r;
+            dsp_v4 b3r = *r3 * w3r - *i3 * w3i, b3i = *r3 * w3i + *i3 * w3r;
+            dsp_v4 t0r = a0r + b1r, t0i = a0i + b1i;
+            dsp_v4 t1r = a0r - b1r, t1i = a0i - b1i;
+            dsp_v4 t2r = b2r + b3r, t2i = b2i + b3i;
+            dsp_v4 t3r = b2r - b3r, t3i = b2i - b3i;
+            *r0 = t0r + t2r;
+            *i0 = t0i + t2i;
+            *r1 = t1r + t3i;
+            *i1 = t1i - t3r;
+            *r2 = t0r - t2r;
+            *i2 = t0i - t2i;
+            *r3 = t1r - t3i;
+            *i3 = t1i + t3r;
+        }
+    }
+}
+#endif
+
+void dsp_rfft(const struct dsp_fft *f, const float *x, float *re, float *im) {
+    uint32_t m = f->m;
+
+    // Even samples are the real parts, odd ones the imaginary parts,
+    // loaded in bit-reversed order for the in-place passes
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t r = f->rev[i];
+        re[r] = x[2 * i];
+        im[r] = x[2 * i + 1];
+    }
+
+    uint32_t len = 1, at = 0;
+    if (f->radix2) {
+        fft_radix2(re, im, m);
+        len = 2;
+    }
+    for (; len < m; len *= 4) {
+        const float *wr = f->tw_re + at, *wi = f->tw_im + at;
+#ifdef __SSE__
+        if ((len & 3) == 0) {
+            fft_radix4_sse(re, im, m, len, wr, wi);
+        } else {
+            fft_radix4_scalar(re, im, m, len, wr, wi);
+        }
+#else
+        fft_radix4_scalar(re, im, m, len, wr, wi);
+#endif
+        at += (3 * len + 3) & ~3u;
+    }
+
+    // Z = FFT(x_even + i x_odd). With A = Z[k] and B = conj(Z[m - k]),
+    // E = (A + B) / 2 and O = -i (A - B) / 2 are the spectra of the even
+    // and odd samples, and X[k] = E + W^k O, X[m - k] = conj(E - W^k O).
+    float z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = 0.0f;
+    re[m] = z0r - z0i;
+    im[m] = 0.0f;
+    for (uint32_t k = 1; k <= m / 2; k++) {
+        float ar = re[k], ai = im[k], br = re[m - k], bi = -im[m - k];
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+        float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+        float wr = f->split_re[k], wi = f->split_im[k];
+        float tr = or_ * wr - oi * wi, ti = or_ * wi + oi * wr;
+        re[k] = er + tr;
+        im[k] = ei + ti;
+        re[m - k] = er - tr;
+        im[m - k] = -(ei - ti);
+    }
+}
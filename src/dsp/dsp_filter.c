@@ -0,0 +1,227 @@
+#include "../include/dsp/dsp_filter.h"
+#include "../include/dsp/dsp_fft.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+#define FILTER_PI 3.14159265358979323846
+
+int dsp_biquad_design(struct dsp_biquad *c, enum dsp_biquad_type type, float rate, float f0, float q) {
+    if (!(rate > 0.0f) || !(f0 > 0.0f) || !(f0 < 0.5f * rate) || !(q > 0.0f)) return DSP_ERR_INVAL;
+    double sn, cs;
+    dsp_sincos(2.0 * FILTER_PI * (double)f0 / (double)rate, &sn, &cs);
+    double alpha = sn / (2.0 * (double)q);
+    double b0, b1, b2;
+    switch (type) {
+    case DSP_BIQUAD_LOWPASS:
+        b0 = (1.0 - cs) / 2.0;
+        b1 = 1.0 - cs;
+        b2 = b0;
+        break;
+    case DSP_BIQUAD_HIGHPASS:
+        b0 = (1.0 + cs) / 2.0;
+        b1 = -(1.0 + cs);
+        b2 = b0;
+        break;
+    case DSP_BIQUAD_BANDPASS:
+        b0 = alpha;
+        b1 = 0.0;
+        b2 = -alpha;
+        break;
+    case DSP_BIQUAD_NOTCH:
+        b0 = 1.0;
+        b1 = -2.0 * cs;
+        b2 = 1.0;
+        break;
+    default:
+        return DSP_ERR_INVAL;
+    }
+    double a0 = 1.0 + alpha;
+    c->b0 = (float)(b0 / a0);
+    c->b1 = (float)(b1 / a0);
+    c->b2 = (float)(b2 / a0);
+    c->a1 = (float)(-2.0 * cs / a0);
+    c->a2 = (float)((1.0 - alpha) / a0);
+    return 0;
+}
+
+int dsp_iir_init(struct dsp_iir_bank *f, uint32_t channels, const struct dsp_biquad *sections, uint32_t n) {
+    if (channels == 0 || channels > DSP_FILTER_MAX_CHANNELS || n == 0 || n > DSP_IIR_MAX_SECTIONS) {
+        return DSP_ERR_INVAL;
+    }
+    memset(f, 0, sizeof(*f));
+    f->channels = channels;
+    f->stride = dsp_filter_stride(channels);
+    f->sections = n;
+    for (uint32_t s = 0; s < n; s++) {
+        const float c[5] = { sections[s].b0, sections[s].b1, sections[s].b2, sections[s].a1, sections[s].a2 };
+        for (int k = 0; k < 5; k++) {
+            for (int l = 0; l < 4; l++) f->coef[s][k][l] = c[k];
+        }
+    }
+    return 0;
+}
+
+void dsp_iir_reset(struct dsp_iir_bank *f) {
+    memset(f->z1, 0, sizeof(f->z1));
+    memset(f->z2, 0, sizeof(f->z2));
+}
+
+// One section over every frame for four channels at a time, so the
+// coefficients and state stay in registers for the whole block
+static void iir_section(struct dsp_iir_bank *f, uint32_t s, float *x, uint32_t frames) {
+    const float (*c)[4] = f->coef[s];
+#ifdef __SSE__
+    dsp_v4 b0 = *(const dsp_v4 *)c[0], b1 = *(const dsp_v4 *)c[1], b2 = *(const dsp_v4 *)c[2];
+    dsp_v4 a1 = *(const dsp_v4 *)c[3], a2 = *(const dsp_v4 *)c[4];
+    for (uint32_t g = 0; g < f->stride; g += 4) {
+        dsp_v4 z1 = *(dsp_v4 *)&f->z1[s][g], z2 = *(dsp_v4 *)&f->z2[s][g];
+        for (uint32_t i = 0; i < frames; i++) {
+            dsp_v4 *v = (dsp_v4 *)(x + i * f->stride + g);
+            dsp_v4 in = *v;
+            dsp_v4 y = b0 * in + z1;
+            z1 = b1 * in - a1 * y + z2;
+            z2 = b2 * in - a2 * y;
+            *v = y;
+        }
+        *(dsp_v4 *)&f->z1[s][g] = z1;
+        *(dsp_v4 *)&f->z2[s][g] = z2;
+    }
+#else
+    for (uint32_t ch = 0; ch < f->stride; ch++) {
+        float z1 = f->z1[s][ch], z2 = f->z2[s][ch];
+        for (uint32_t i = 0; i < frames; i++) {
+            float *v = x + i * f->stride + ch;
+            float in = *v;
+            float y = c[0][0] * in + z1;
+            z1 = c[1][0] * in - c[3][0] * y + z2;
+            z2 = c[2][0] * in - c[4][0] * y;
+            *v = y;
+        }
+        f->z1[s][ch] = z1;
+        f->z2[s][ch] = z2;
+    }
+#endif
+}
+
+void dsp_iir_block(struct dsp_iir_bank *f, const float *in, float *out, uint32_t frames) {
+    if (in != out) memcpy(out, in, frames * f->stride * sizeof(float));
+    for (uint32_t s = 0; s < f->sections; s++) {
+        iir_section(f, s, out, frames);
+    }
+}
+
+void dsp_iir_push(struct dsp_iir_bank *f, const float *in, float *out) {
+    float frame[DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+    memset(frame, 0, sizeof(frame));
+    memcpy(frame, in, f->channels * sizeof(float));
+    dsp_iir_block(f, frame, frame, 1);
+    memcpy(out, frame, f->channels * sizeof(float));
+}
+
+int dsp_fir_lowpass(float *h, uint32_t taps, float rate, float cutoff) {
+    if (taps == 0 || taps > DSP_FIR_MAX_TAPS || !(cutoff > 0.0f) || !(cutoff < 0.5f * rate)) {
+        return DSP_ERR_INVAL;
+    }
+    double fc = (double)cutoff / (double)rate, centre = (double)(taps - 1) / 2.0, sum = 0.0;
+    for (uint32_t i = 0; i < taps; i++) {
+        double t = (double)i - centre, sn, cs, v;
+        if (t == 0.0) {
+            v = 2.0 * fc;
+        } else {
+            dsp_sincos(2.0 * FILTER_PI * fc * t, &sn, &cs);
+            v = sn / (FILTER_PI * t);
+        }
+        if (taps > 1) {
+            dsp_sincos(2.0 * FILTER_PI * (double)i / (double)(taps - 1), &sn, &cs);
+            v *= 0.54 - 0.46 * cs;
+        }
+        h[i] = (float)v;
+        sum += v;
+    }
+    for (uint32_t i = 0; i < taps; i++) h[i] = (float)((double)h[i] / sum);
+    return 0;
+}
+
+int dsp_fir_decim_init(struct dsp_fir_decim *d, uint32_t channels, const float *h, uint32_t taps,
+                       uint32_t factor) {
+    if (channels == 0 || channels > DSP_FILTER_MAX_CHANNELS || taps == 0 || taps > DSP_FIR_MAX_TAPS ||
+        factor == 0 || factor > DSP_FIR_MAX_FACTOR) {
+        return DSP_ERR_INVAL;
+    }
+    memset(d, 0, sizeof(*d));
+    d->channels = channels;
+    d->stride = dsp_filter_stride(channels);
+    d->taps = taps;
+    d->factor = factor;
+    d->branch_len = (taps + factor - 1) / factor;
+    for (uint32_t k = 0; k < taps; k++) {
+        d->h[k % factor][k / factor] = h[k];
+    }
+    return 0;
+}
+
+void dsp_fir_decim_reset(struct dsp_fir_decim *d) {
+    memset(d->delay, 0, sizeof(d->delay));
+    d->phase = 0;
+    d->pos = 0;
+}
+
+// Feed one padded frame. With y[m] = sum_k h[k] x[mM - k] and k = jM + p,
+// branch p is fed x[mM - p]: input n with n mod M = r goes to branch 0
+// for output n / M when r = 0, else to branch M - r for the next output.
+// Branch 0 arrives last, so its sample completes an output.
+static int fir_decim_step(struct dsp_fir_decim *d, const float *x, float *out) {
+    uint32_t r = d->phase, len = d->branch_len, stride = d->stride;
+    if (r == 1 % d->factor) {
+        d->pos = d->pos == 0 ? len - 1 : d->pos - 1;    // A new output period
+    }
+    uint32_t p = r == 0 ? 0 : d->factor - r;
+    float *line = d->delay + p * 2 * len * stride;
+    memcpy(line + d->pos * stride, x, stride * sizeof(float));
+    memcpy(line + (d->pos + len) * stride, x, stride * sizeof(float));
+    if (++d->phase == d->factor) d->phase = 0;
+    if (r != 0) return 0;
+
+    for (uint32_t g = 0; g < stride; g += 4) {
+#ifdef __SSE__
+        dsp_v4 acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (uint32_t b = 0; b < d->factor; b++) {
+            const float *row = d->delay + (b * 2 * len + d->pos) * stride + g;
+            for (uint32_t j = 0; j < len; j++) {
+                float h = d->h[b][j];
+                dsp_v4 hv = { h, h, h, h };
+                acc += hv * *(const dsp_v4 *)(row + j * stride);
+            }
+        }
+        *(dsp_v4 *)(out + g) = acc;
+#else
+        for (uint32_t ch = g; ch < g + 4; ch++) {
+            float acc = 0.0f;
+            for (uint32_t b = 0; b < d->factor; b++) {
+                const float *row = d->delay + (b * 2 * len + d->pos) * stride + ch;
+                for (uint32_t j = 0; j < len; j++) acc += d->h[b][j] * row[j * stride];
+            }
+            out[ch] = acc;
+        }
+#endif
+    }
+    return 1;
+}
+
+uint32_t dsp_fir_decim_block(struct dsp_fir_decim *d, const float *in, uint32_t frames, float *out) {
+    uint32_t produced = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+        produced += (uint32_t)fir_decim_step(d, in + i * d->stride, out + produced * d->stride);
+    }
+    return produced;
+}
+
+int dsp_fir_decim_push(struct dsp_fir_decim *d, const float *in, float *out) {
+    float frame[DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+    float y[DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+    memset(frame, 0, sizeof(frame));
+    memcpy(frame, in, d->channels * sizeof(float));
+    if (!fir_decim_step(d, frame, y)) return 0;
+    memcpy(out, y, d->channels * sizeof(float));
+    return 1;
+}
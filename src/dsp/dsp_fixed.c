@@ -0,0 +1,211 @@
+#include "../include/dsp/dsp_fixed.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Integer only: built with -mgeneral-regs-only in the kernel (see the
+// Makefile), so nothing here may use float or double.
+
+uint64_t dsp_udiv64(uint64_t n, uint32_t d) {
+    uint64_t q = 0, r = 0;
+    for (int i = 63; i >= 0; i--) {
+        r = (r << 1) | ((n >> i) & 1);
+        if (r >= d) {
+            r -= d;
+            q |= (uint64_t)1 << i;
+        }
+    }
+    return q;
+}
+
+// Floor of the square root, one result bit per step
+uint32_t dsp_isqrt64(uint64_t v) {
+    uint64_t root = 0, bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+void dsp_iir_q31_reset(struct dsp_iir_q31 *f) {
+    memset(f->x1, 0, sizeof(f->x1));
+    memset(f->x2, 0, sizeof(f->x2));
+    memset(f->y1, 0, sizeof(f->y1));
+    memset(f->y2, 0, sizeof(f->y2));
+}
+
+// Q30 coefficients times Q31 samples are Q61. Each product drops two
+// bits first, so the five-term sum cannot overflow 64 bits.
+void dsp_iir_q31_block(struct dsp_iir_q31 *f, const int32_t *in, int32_t *out, uint32_t frames) {
+    for (uint32_t i = 0; i < frames; i++) {
+        for (uint32_t ch = 0; ch < f->channels; ch++) {
+            int32_t v = in[i * f->channels + ch];
+            for (uint32_t s = 0; s < f->sections; s++) {
+                const int32_t *c = f->coef[s];
+                int64_t acc = (((int64_t)c[0] * v) >> 2) + (((int64_t)c[1] * f->x1[s][ch]) >> 2) +
+                              (((int64_t)c[2] * f->x2[s][ch]) >> 2) - (((int64_t)c[3] * f->y1[s][ch]) >> 2) -
+                              (((int64_t)c[4] * f->y2[s][ch]) >> 2);
+                int32_t y = dsp_sat_q31(dsp_round_shift(acc, 28));
+                f->x2[s][ch] = f->x1[s][ch];
+                f->x1[s][ch] = v;
+                f->y2[s][ch] = f->y1[s][ch];
+                f->y1[s][ch] = y;
+                v = y;
+            }
+            out[i * f->channels + ch] = v;
+        }
+    }
+}
+
+void dsp_iir_q15_push(struct dsp_iir_q31 *f, const int16_t *in, int16_t *out) {
+    int32_t frame[DSP_FILTER_MAX_CHANNELS];
+    memset(frame, 0, sizeof(frame));
+    for (uint32_t ch = 0; ch < f->channels; ch++) frame[ch] = (int32_t)((uint32_t)(int32_t)in[ch] << 16);
+    dsp_iir_q31_block(f, frame, frame, 1);
+    for (uint32_t ch = 0; ch < f->channels; ch++) out[ch] = dsp_sat_q15((int32_t)dsp_round_shift(frame[ch], 16));
+}
+
+void dsp_fir_q15_reset(struct dsp_fir_q15 *d) {
+    memset(d->hist, 0, sizeof(d->hist));
+    d->phase = 0;
+    d->pos = 0;
+}
+
+// y[m] = sum_k h[k] x[mM - k], computed when x[mM] arrives
+int dsp_fir_q15_push(struct dsp_fir_q15 *d, const int16_t *in, int16_t *out) {
+    d->pos = d->pos == 0 ? d->taps - 1 : d->pos - 1;
+    memcpy(d->hist[d->pos], in, d->channels * sizeof(int16_t));
+    memcpy(d->hist[d->pos + d->taps], in, d->channels * sizeof(int16_t));
+    uint32_t r = d->phase;
+    if (++d->phase == d->factor) d->phase = 0;
+    if (r != 0) return 0;
+
+    for (uint32_t ch = 0; ch < d->channels; ch++) {
+        int64_t acc = 0;
+        for (uint32_t k = 0; k < d->taps; k++) {
+            acc += (int32_t)d->h[k] * d->hist[d->pos + k][ch];
+        }
+        out[ch] = dsp_sat_q15((int32_t)dsp_sat_q31(dsp_round_shift(acc, 15)));
+    }
+    return 1;
+}
+
+uint32_t dsp_fir_q15_block(struct dsp_fir_q15 *d, const int16_t *in, uint32_t frames, int16_t *out) {
+    uint32_t produced = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+        produced += (uint32_t)dsp_fir_q15_push(d, in + i * d->channels, out + produced * d->channels);
+    }
+    return produced;
+}
+
+// Q15 complex product. Twiddles have magnitude at most 1 and scaled
+// data at most sqrt(2), so the 32-bit sums stay below 2^31.
+#define Q15_CMUL_RE(ar, ai, wr, wi) ((int32_t)dsp_round_shift((ar) * (int32_t)(wr) - (ai) * (int32_t)(wi), 15))
+#define Q15_CMUL_IM(ar, ai, wr, wi) ((int32_t)dsp_round_shift((ar) * (int32_t)(wi) + (ai) * (int32_t)(wr), 15))
+
+// The butterflies of dsp_fft.c, scaled by 1/4 per stage
+static void fft_q15_radix4(int32_t *re, int32_t *im, uint32_t m, uint32_t len,
+                           const int16_t *wr, const int16_t *wi) {
+    for (uint32_t j = 0; j < m; j += 4 * len) {
+        for (uint32_t k = 0; k < len; k++) {
+            int32_t *r = re + j + k, *i = im + j + k;
+            int32_t b1r = Q15_CMUL_RE(r[len], i[len], wr[len + k], wi[len + k]);
+            int32_t b1i = Q15_CMUL_IM(r[len], i[len], wr[len + k], wi[len + k]);
+            int32_t b2r = Q15_CMUL_RE(r[2 * len], i[2 * len], wr[k], wi[k]);
+            int32_t b2i = Q15_CMUL_IM(r[2 * len], i[2 * len], wr[k], wi[k]);
+            int32_t b3r = Q15_CMUL_RE(r[3 * len], i[3 * len], wr[2 * len + k], wi[2 * len + k]);
+            int32_t b3i = Q15_CMUL_IM(r[3 * len], i[3 * len], wr[2 * len + k], wi[2 * len + k]);
+            int32_t t0r = r[0] + b1r, t0i = i[0] + b1i;
+            int32_t t1r = r[0] - b1r, t1i = i[0] - b1i;
+            int32_t t2r = b2r + b3r, t2i = b2i + b3i;
+            int32_t t3r = b2r - b3r, t3i = b2i - b3i;
+            r[0] = (int32_t)dsp_round_shift(t0r + t2r, 2);
+            i[0] = (int32_t)dsp_round_shift(t0i + t2i, 2);
+            r[len] = (int32_t)dsp_round_shift(t1r + t3i, 2);
+            i[len] = (int32_t)dsp_round_shift(t1i - t3r, 2);
+            r[2 * len] = (int32_t)dsp_round_shift(t0r - t2r, 2);
+            i[2 * len] = (int32_t)dsp_round_shift(t0i - t2i, 2);
+            r[3 * len] = (int32_t)dsp_round_shift(t1r - t3i, 2);
+            i[3 * len] = (int32_t)dsp_round_shift(t1i + t3r, 2);
+        }
+    }
+}
+
+void dsp_rfft_q15(const struct dsp_fft_q15 *f, const int16_t *x, int32_t *re, int32_t *im) {
+    uint32_t m = f->m;
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t r = f->rev[i];
+        re[r] = x[2 * i];
+        im[r] = x[2 * i + 1];
+    }
+
+    uint32_t len = 1, at = 0;
+    if (f->radix2) {
+        for (uint32_t i = 0; i < m; i += 2) {
+            int32_t ar = re[i], ai = im[i], br = re[i + 1], bi = im[i + 1];
+            re[i] = (int32_t)dsp_round_shift(ar + br, 1);
+            im[i] = (int32_t)dsp_round_shift(ai + bi, 1);
+            re[i + 1] = (int32_t)dsp_round_shift(ar - br, 1);
+            im[i + 1] = (int32_t)dsp_round_shift(ai - bi, 1);
+        }
+        len = 2;
+    }
+    for (; len < m; len *= 4) {
+        fft_q15_radix4(re, im, m, len, f->tw_re + at, f->tw_im + at);
+        at += (3 * len + 3) & ~3u;
+    }
+
+    // The real split of dsp_rfft(), with E and O halved once more so
+    // the result is X / n rather than X / m
+    int32_t z0r = re[0], z0i = im[0];
+    re[0] = (int32_t)dsp_round_shift(z0r + z0i, 1);
+    im[0] = 0;
+    re[m] = (int32_t)dsp_round_shift(z0r - z0i, 1);
+    im[m] = 0;
+    for (uint32_t k = 1; k <= m / 2; k++) {
+        int32_t ar = re[k], ai = im[k], br = re[m - k], bi = -im[m - k];
+        int32_t er = (int32_t)dsp_round_shift(ar + br, 2), ei = (int32_t)dsp_round_shift(ai + bi, 2);
+        int32_t or_ = (int32_t)dsp_round_shift(ai - bi, 2), oi = (int32_t)dsp_round_shift(br - ar, 2);
+        int32_t tr = Q15_CMUL_RE(or_, oi, f->split_re[k], f->split_im[k]);
+        int32_t ti = Q15_CMUL_IM(or_, oi, f->split_re[k], f->split_im[k]);
+        re[k] = er + tr;
+        im[k] = ei + ti;
+        re[m - k] = er - tr;
+        im[m - k] = ti - ei;
+    }
+}
+
+// value / den in Q32, for value = num / den below 2^31
+static uint64_t hrv_q32_ratio(uint64_t num, uint32_t den) {
+    uint64_t q = dsp_udiv64(num, den);
+    uint64_t rem = num - q * den;
+    return (q << 32) + dsp_udiv64(rem << 32, den);
+}
+
+void hrv_metrics_q(const struct hrv_stream *s, struct hrv_metrics_q *m) {
+    memset(m, 0, sizeof(*m));
+    m->beats = s->count;
+    if (s->count == 0) return;
+
+    uint32_t n = s->count;
+    uint64_t mean_q32 = hrv_q32_ratio((uint64_t)s->sum_rr, n);
+    m->mean_rr = (int32_t)dsp_round_shift((int64_t)mean_q32, 16);
+    if (m->mean_rr > 0) {
+        m->heart_rate = (int32_t)dsp_udiv64((uint64_t)60000 << 32, (uint32_t)m->mean_rr);
+    }
+    if (n > 1) {
+        // Same exact sums as hrv_metrics(), square-rooted in Q32 -> Q16
+        uint64_t num = (uint64_t)((int64_t)n * s->sum_rr2 - s->sum_rr * s->sum_rr);
+        m->sdnn = (int32_t)dsp_isqrt64(hrv_q32_ratio(num, n * (n - 1)));
+    }
+    if (s->ndiff > 0) {
+        m->rmssd = (int32_t)dsp_isqrt64(hrv_q32_ratio((uint64_t)s->sum_d2, s->ndiff));
+        m->pnn50 = (int32_t)dsp_udiv64((uint64_t)s->nn50 * 100 << 16, s->ndiff);
+    }
+}
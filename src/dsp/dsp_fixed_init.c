@@ -0,0 +1,76 @@
+#include "../include/dsp/dsp_fixed.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Fixed-point setup from float designs. Unlike dsp_fixed.c this uses
+// the FPU, so it runs in thread context before the kernels are handed
+// to a driver.
+
+static int32_t fixed_round(double v) {
+    return (int32_t)(v < 0.0 ? v - 0.5 : v + 0.5);
+}
+
+int16_t dsp_q15_from_float(float x) {
+    double v = (double)x * DSP_Q15_ONE;
+    if (v >= 32767.0) return 32767;
+    if (v <= -32768.0) return -32768;
+    return (int16_t)fixed_round(v);
+}
+
+// Q30 holds [-2, 2), which covers the a1 of any stable biquad
+static int32_t fixed_q30(float x) {
+    double v = (double)x * DSP_Q30_ONE;
+    if (v >= 2147483647.0) return 0x7FFFFFFF;
+    if (v <= -2147483648.0) return (int32_t)-0x7FFFFFFF - 1;
+    return fixed_round(v);
+}
+
+int dsp_iir_q31_init(struct dsp_iir_q31 *f, uint32_t channels, const struct dsp_biquad *sections, uint32_t n) {
+    if (channels == 0 || channels > DSP_FILTER_MAX_CHANNELS || n == 0 || n > DSP_IIR_MAX_SECTIONS) {
+        return DSP_ERR_INVAL;
+    }
+    memset(f, 0, sizeof(*f));
+    f->channels = channels;
+    f->sections = n;
+    for (uint32_t s = 0; s < n; s++) {
+        f->coef[s][0] = fixed_q30(sections[s].b0);
+        f->coef[s][1] = fixed_q30(sections[s].b1);
+        f->coef[s][2] = fixed_q30(sections[s].b2);
+        f->coef[s][3] = fixed_q30(sections[s].a1);
+        f->coef[s][4] = fixed_q30(sections[s].a2);
+    }
+    return 0;
+}
+
+int dsp_fir_q15_init(struct dsp_fir_q15 *d, uint32_t channels, const float *h, uint32_t taps, uint32_t factor) {
+    if (channels == 0 || channels > DSP_FILTER_MAX_CHANNELS || taps == 0 || taps > DSP_FIR_MAX_TAPS ||
+        factor == 0 || factor > DSP_FIR_MAX_FACTOR) {
+        return DSP_ERR_INVAL;
+    }
+    memset(d, 0, sizeof(*d));
+    d->channels = channels;
+    d->taps = taps;
+    d->factor = factor;
+    for (uint32_t k = 0; k < taps; k++) d->h[k] = dsp_q15_from_float(h[k]);
+    return 0;
+}
+
+// The tables of dsp_fft_init(), rounded to Q15
+int dsp_fft_q15_init(struct dsp_fft_q15 *f, uint32_t n) {
+    static struct dsp_fft plan;     // Too large for a kernel stack
+    if (dsp_fft_init(&plan, n) != 0) return DSP_ERR_INVAL;
+    memset(f, 0, sizeof(*f));
+    f->n = plan.n;
+    f->m = plan.m;
+    f->radix2 = plan.radix2;
+    for (uint32_t i = 0; i < DSP_FFT_TWIDDLES; i++) {
+        f->tw_re[i] = dsp_q15_from_float(plan.tw_re[i]);
+        f->tw_im[i] = dsp_q15_from_float(plan.tw_im[i]);
+    }
+    for (uint32_t k = 0; k <= plan.m / 2; k++) {
+        f->split_re[k] = dsp_q15_from_float(plan.split_re[k]);
+        f->split_im[k] = dsp_q15_from_float(plan.split_im[k]);
+    }
+    memcpy(f->rev, plan.rev, sizeof(f->rev));
+    return 0;
+}
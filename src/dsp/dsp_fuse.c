@@ -0,0 +1,121 @@
+#include "../include/dsp/dsp_fuse.h"
+
+#define FUSE_MASK (DSP_FUSE_RING - 1)
+
+int dsp_fuse_init(struct dsp_fuse *f, uint32_t period_ms, uint32_t latency_ms) {
+    if (period_ms == 0) return DSP_ERR_INVAL;
+    f->streams = 0;
+    f->width = 0;
+    f->period_ms = period_ms;
+    f->latency_ms = latency_ms;
+    f->next_ms = 0;
+    f->newest_ms = 0;
+    f->started = 0;
+    return 0;
+}
+
+int dsp_fuse_add_stream(struct dsp_fuse *f, uint32_t width, uint32_t max_gap_ms) {
+    if (f->streams == DSP_FUSE_MAX_STREAMS || width == 0 || width > DSP_FUSE_MAX_WIDTH ||
+        f->width + width > DSP_FUSE_MAX_FEATURES || f->started) {
+        return DSP_ERR_INVAL;
+    }
+    struct dsp_fuse_stream *s = &f->s[f->streams];
+    s->width = width;
+    s->offset = f->width;
+    s->max_gap_ms = max_gap_ms;
+    s->head = 0;
+    s->count = 0;
+    s->dropped = 0;
+    f->width += width;
+    return (int)f->streams++;
+}
+
+// Time of the i-th buffered record, oldest first
+static uint32_t fuse_t(const struct dsp_fuse_stream *s, uint32_t i) {
+    return s->t[(s->head + i) & FUSE_MASK];
+}
+
+static const float *fuse_v(const struct dsp_fuse_stream *s, uint32_t i) {
+    return s->v[(s->head + i) & FUSE_MASK];
+}
+
+int dsp_fuse_push(struct dsp_fuse *f, uint32_t stream, uint32_t t_ms, const float *x) {
+    if (stream >= f->streams) return DSP_ERR_INVAL;
+    struct dsp_fuse_stream *s = &f->s[stream];
+    if (s->count > 0 && t_ms <= fuse_t(s, s->count - 1)) {
+        s->dropped++;
+        return DSP_ERR_INVAL;
+    }
+    if (s->count == DSP_FUSE_RING) {
+        s->head = (s->head + 1) & FUSE_MASK;
+        s->count--;
+        s->dropped++;
+    }
+    uint32_t at = (s->head + s->count++) & FUSE_MASK;
+    s->t[at] = t_ms;
+    for (uint32_t k = 0; k < s->width; k++) s->v[at][k] = x[k];
+
+    if (!f->started) {
+        // Frames fall on multiples of the period
+        f->started = 1;
+        f->next_ms = (t_ms + f->period_ms - 1) / f->period_ms * f->period_ms;
+        f->newest_ms = t_ms;
+    }
+    if (t_ms > f->newest_ms) f->newest_ms = t_ms;
+    return 0;
+}
+
+// One stream's features at time t into out; 1 if it has data there
+static int fuse_sample(struct dsp_fuse_stream *s, uint32_t t, float *out) {
+    // Frame times only advance, so records before the last one at or
+    // before t are no longer needed
+    while (s->count >= 2 && fuse_t(s, 1) <= t) {
+        s->head = (s->head + 1) & FUSE_MASK;
+        s->count--;
+    }
+    for (uint32_t k = 0; k < s->width; k++) out[k] = 0.0f;
+    if (s->count == 0) return 0;
+
+    uint32_t t0 = fuse_t(s, 0);
+    if (t0 <= t && s->count >= 2 && fuse_t(s, 1) - t0 <= s->max_gap_ms) {
+        uint32_t t1 = fuse_t(s, 1);
+        float w = (float)(t - t0) / (float)(t1 - t0);
+        const float *a = fuse_v(s, 0), *b = fuse_v(s, 1);
+        for (uint32_t k = 0; k < s->width; k++) out[k] = a[k] + w * (b[k] - a[k]);
+        return 1;
+    }
+
+    // Not bracketed closely enough: hold the nearest record
+    uint32_t near = 0, dist = t0 <= t ? t - t0 : t0 - t;
+    if (t0 <= t && s->count >= 2 && fuse_t(s, 1) - t < dist) {
+        near = 1;
+        dist = fuse_t(s, 1) - t;
+    }
+    if (dist > s->max_gap_ms / 2) return 0;
+    const float *v = fuse_v(s, near);
+    for (uint32_t k = 0; k < s->width; k++) out[k] = v[k];
+    return 1;
+}
+
+int dsp_fuse_pull(struct dsp_fuse *f, struct dsp_fuse_frame *out) {
+    if (!f->started) return 0;
+    uint32_t t = f->next_ms;
+    int due = f->newest_ms >= t + f->latency_ms;
+    if (!due) {
+        due = 1;
+        for (uint32_t i = 0; i < f->streams; i++) {
+            const struct dsp_fuse_stream *s = &f->s[i];
+            due &= s->count > 0 && fuse_t(s, s->count - 1) >= t;
+        }
+        if (!due) return 0;
+    }
+
+    out->t_ms = t;
+    out->valid = 0;
+    for (uint32_t k = f->width; k < DSP_FUSE_MAX_FEATURES; k++) out->v[k] = 0.0f;
+    for (uint32_t i = 0; i < f->streams; i++) {
+        if (fuse_sample(&f->s[i], t, out->v + f->s[i].offset)) out->valid |= 1u << i;
+    }
+    f->next_ms += f->period_ms;
+    return 1;
+}
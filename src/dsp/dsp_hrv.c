@@ -0,0 +1,176 @@
+#include "../include/dsp/dsp_hrv.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Beat detection follows Pan-Tompkins: a 5-point derivative, squared,
+// then integrated over 150 ms. Local maxima of the integrated signal are
+// classified against a threshold a quarter of the way from the running
+// noise peak level to the running signal peak level. The integrated
+// signal plateaus for most of its window, so a beat is timed at the
+// largest raw sample inside the window rather than at the plateau peak.
+
+void hrv_init(struct hrv_stream *s, uint32_t sample_rate, uint32_t window) {
+    memset(s, 0, sizeof(*s));
+    if (sample_rate == 0) sample_rate = 1;
+    if (window < 2) window = 2;
+    if (window > HRV_MAX_WINDOW) window = HRV_MAX_WINDOW;
+    s->sample_rate = sample_rate;
+    s->window = window;
+    s->mwi_len = sample_rate * 150 / 1000;
+    if (s->mwi_len == 0) s->mwi_len = 1;
+    if (s->mwi_len > HRV_MWI_MAX) s->mwi_len = HRV_MWI_MAX;
+    s->refractory = sample_rate * HRV_RR_MIN_MS / 1000;
+    s->learn_until = sample_rate * 2;  // Two seconds to learn the signal level
+    s->last_decay = s->learn_until;
+}
+
+// The oldest interval leaves the window. The successive difference of
+// the new oldest one pointed at it, so that leaves the sums too.
+static void hrv_evict(struct hrv_stream *s) {
+    uint32_t o = s->head;
+    int64_t rr = s->rr[o];
+    s->sum_rr -= rr;
+    s->sum_rr2 -= rr * rr;
+    if (++s->head == s->window) s->head = 0;
+    s->count--;
+
+    uint32_t next = s->head;
+    if (s->diff_valid[next]) {
+        int32_t d = s->diff[next];
+        s->sum_d2 -= (int64_t)d * d;
+        s->ndiff--;
+        if (d > HRV_NN50_MS || d < -HRV_NN50_MS) s->nn50--;
+        s->diff_valid[next] = 0;
+    }
+}
+
+// Add one RR interval to the window. Returns 0 if it was rejected as an
+// artifact; the next interval then starts a new difference chain.
+int hrv_add_rr(struct hrv_stream *s, uint32_t rr_ms) {
+    if (rr_ms < HRV_RR_MIN_MS || rr_ms > HRV_RR_MAX_MS) {
+        s->artifacts++;
+        s->last_rr = 0;
+        return 0;
+    }
+    if (s->count == s->window) hrv_evict(s);
+
+    uint32_t slot = s->head + s->count;
+    if (slot >= s->window) slot -= s->window;
+    s->rr[slot] = (uint16_t)rr_ms;
+    s->sum_rr += rr_ms;
+    s->sum_rr2 += (int64_t)rr_ms * rr_ms;
+
+    // The oldest interval's difference is never counted
+    s->diff_valid[slot] = s->last_rr != 0 && s->count > 0;
+    if (s->diff_valid[slot]) {
+        int32_t d = (int32_t)rr_ms - (int32_t)s->last_rr;
+        s->diff[slot] = (int16_t)d;
+        s->sum_d2 += (int64_t)d * d;
+        s->ndiff++;
+        if (d > HRV_NN50_MS || d < -HRV_NN50_MS) s->nn50++;
+    }
+    s->count++;
+    s->last_rr = rr_ms;
+    return 1;
+}
+
+static void hrv_beat(struct hrv_stream *s, uint32_t at) {
+    if (s->last_beat != 0) {
+        uint32_t delta = at - s->last_beat;
+        if (delta > s->sample_rate * 10) delta = s->sample_rate * 10;  // Keep the ms conversion in range
+        hrv_add_rr(s, (delta * 1000 + s->sample_rate / 2) / s->sample_rate);
+    }
+    s->last_beat = at;
+}
+
+// Sample index of the largest raw sample in the integration window,
+// which ends at sample `last`
+static uint32_t hrv_fiducial(const struct hrv_stream *s, uint32_t last) {
+    uint32_t best = 0;
+    float max = s->raw[s->mwi_pos];
+    for (uint32_t k = 1; k < s->mwi_len; k++) {
+        uint32_t slot = s->mwi_pos + k;
+        if (slot >= s->mwi_len) slot -= s->mwi_len;
+        if (s->raw[slot] > max) {
+            max = s->raw[slot];
+            best = k;
+        }
+    }
+    return last + 1 - s->mwi_len + best;
+}
+
+int hrv_push(struct hrv_stream *s, float sample) {
+    // y(n) = (2x(n) + x(n-1) - x(n-3) - 2x(n-4)) / 8, squared
+    float d = (2.0f * sample + s->x[0] - s->x[2] - 2.0f * s->x[3]) * 0.125f;
+    s->x[3] = s->x[2];
+    s->x[2] = s->x[1];
+    s->x[1] = s->x[0];
+    s->x[0] = sample;
+    float e = d * d;
+
+    s->mwi_sum += e - s->mwi[s->mwi_pos];
+    s->mwi[s->mwi_pos] = e;
+    s->raw[s->mwi_pos] = sample;
+    if (++s->mwi_pos == s->mwi_len) s->mwi_pos = 0;
+    float m = (float)(s->mwi_sum / s->mwi_len);
+    if (m < 0.0f) m = 0.0f;
+
+    uint32_t i = s->n++;
+    int beat = 0;
+    if (s->prev > s->prev2 && s->prev >= m) {
+        // The previous value was a peak
+        float peak = s->prev;
+        uint32_t at = i - 1;
+        if (i < s->learn_until) {
+            if (peak > s->spk) s->spk = peak;
+        } else if (peak > s->threshold && (s->last_beat == 0 || at - s->last_beat >= s->refractory)) {
+            s->spk = 0.125f * peak + 0.875f * s->spk;
+            hrv_beat(s, i >= s->mwi_len ? hrv_fiducial(s, i) : at);
+            beat = 1;
+        } else {
+            s->npk = 0.125f * peak + 0.875f * s->npk;
+        }
+        s->threshold = s->npk + 0.25f * (s->spk - s->npk);
+    }
+    s->prev2 = s->prev;
+    s->prev = m;
+
+    // No beat for one and a half intervals (or the longest plausible one
+    // without a rhythm): the signal got weaker than the learned level, so
+    // halve it until beats are found again
+    uint32_t since = s->last_beat > s->last_decay ? s->last_beat : s->last_decay;
+    uint32_t wait_ms = s->last_rr != 0 ? s->last_rr * 3 / 2 : HRV_RR_MAX_MS;
+    if (i > since && i - since >= s->sample_rate * wait_ms / 1000) {
+        s->spk *= 0.5f;
+        s->threshold = s->npk + 0.25f * (s->spk - s->npk);
+        s->last_decay = i;
+    }
+    return beat;
+}
+
+int hrv_push_block(struct hrv_stream *s, const float *x, uint32_t n) {
+    int beats = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        beats += hrv_push(s, x[i]);
+    }
+    return beats;
+}
+
+void hrv_metrics(const struct hrv_stream *s, struct hrv_metrics *m) {
+    memset(m, 0, sizeof(*m));
+    m->beats = s->count;
+    if (s->count == 0) return;
+
+    double n = (double)s->count;
+    m->mean_rr = (float)((double)s->sum_rr / n);
+    m->heart_rate = 60000.0f / m->mean_rr;
+    if (s->count > 1) {
+        // n*sum(x^2) - sum(x)^2 is exact in 64 bits for the window sizes used
+        double var = (double)((int64_t)s->count * s->sum_rr2 - s->sum_rr * s->sum_rr) / (n * (n - 1.0));
+        m->sdnn = dsp_sqrtf((float)var);
+    }
+    if (s->ndiff > 0) {
+        m->rmssd = dsp_sqrtf((float)((double)s->sum_d2 / s->ndiff));
+        m->pnn50 = 100.0f * (float)s->nn50 / (float)s->ndiff;
+    }
+}
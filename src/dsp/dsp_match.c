@@ -0,0 +1,263 @@
+#include "../include/dsp/dsp_match.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+#define MATCH_HALF (DSP_MATCH_DIM / 2)
+#define MATCH_NO_SLOT 0xFFFF
+// The early-exit bound is computed in float; keep candidates it might
+// round just below the cut
+#define MATCH_BOUND_SLACK 1e-5f
+
+// Scale v to unit length in place; 0 for an all-zero vector
+static int match_normalize(float *v) {
+    float sum = 0.0f;
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) sum += v[d] * v[d];
+    if (!(sum > 0.0f)) return 0;
+    float inv = 1.0f / dsp_sqrtf(sum);
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) v[d] *= inv;
+    return 1;
+}
+
+// Whitened and normalised copy of a template or probe
+static int match_prepare(const struct dsp_match *m, const float *v, float *out) {
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) out[d] = m->scaled ? v[d] * m->scale[d] : v[d];
+    return match_normalize(out);
+}
+
+static float match_tail_norm(const float *v) {
+    float sum = 0.0f;
+    for (uint32_t d = MATCH_HALF; d < DSP_MATCH_DIM; d++) sum += v[d] * v[d];
+    return dsp_sqrtf(sum);
+}
+
+static void match_put(struct dsp_match *m, uint32_t slot, int32_t user, const float *v) {
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) m->feat[slot / 4][d][slot % 4] = v[d];
+    m->tail_norm[slot] = match_tail_norm(v);
+    m->user[slot] = user;
+    if (user >= 0) m->slot_of[user] = (uint16_t)slot;
+}
+
+static void match_get(const struct dsp_match *m, uint32_t slot, float *v) {
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) v[d] = m->feat[slot / 4][d][slot % 4];
+}
+
+// A removed slot scores 0 against everything and is skipped as a result
+static void match_clear(struct dsp_match *m, uint32_t slot) {
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) m->feat[slot / 4][d][slot % 4] = 0.0f;
+    m->tail_norm[slot] = 0.0f;
+    m->user[slot] = -1;
+}
+
+static float match_dot(const float *a, const float *b) {
+    float sum = 0.0f;
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) sum += a[d] * b[d];
+    return sum;
+}
+
+void dsp_match_init(struct dsp_match *m) {
+    memset(m, 0, sizeof(*m));
+    m->nprobe = DSP_MATCH_NPROBE;
+    for (uint32_t s = 0; s < DSP_MATCH_SLOTS; s++) m->user[s] = -1;
+    for (uint32_t u = 0; u < DSP_MATCH_MAX; u++) m->slot_of[u] = MATCH_NO_SLOT;
+}
+
+int dsp_match_set_scale(struct dsp_match *m, const float *inv_std) {
+    if (m->count != 0 || m->slots != 0) return DSP_ERR_INVAL;
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) {
+        if (!(inv_std[d] > 0.0f)) return DSP_ERR_INVAL;
+        m->scale[d] = inv_std[d];
+    }
+    m->scaled = 1;
+    return 0;
+}
+
+int dsp_match_remove(struct dsp_match *m, uint32_t user) {
+    if (user >= DSP_MATCH_MAX || m->slot_of[user] == MATCH_NO_SLOT) return DSP_ERR_INVAL;
+    match_clear(m, m->slot_of[user]);
+    m->slot_of[user] = MATCH_NO_SLOT;
+    m->count--;
+    return 0;
+}
+
+int dsp_match_enroll(struct dsp_match *m, uint32_t user, const float *features) {
+    float v[DSP_MATCH_DIM];
+    if (user >= DSP_MATCH_MAX || !match_prepare(m, features, v)) return DSP_ERR_INVAL;
+    if (m->slot_of[user] != MATCH_NO_SLOT) dsp_match_remove(m, user);
+    if (m->slots == DSP_MATCH_SLOTS) dsp_match_build(m);    // Reclaim tombstones
+    if (m->slots == DSP_MATCH_SLOTS) return DSP_ERR_FULL;
+
+    match_put(m, m->slots++, (int32_t)user, v);
+    m->count++;
+    if (m->lists == 0 ? m->count > DSP_MATCH_LINEAR_MAX : m->slots - m->indexed > DSP_MATCH_TAIL_MAX) {
+        dsp_match_build(m);
+    }
+    return 0;
+}
+
+float dsp_match_score(const struct dsp_match *m, uint32_t user, const float *probe) {
+    float p[DSP_MATCH_DIM], t[DSP_MATCH_DIM];
+    if (user >= DSP_MATCH_MAX || m->slot_of[user] == MATCH_NO_SLOT || !match_prepare(m, probe, p)) {
+        return DSP_MATCH_NONE;
+    }
+    match_get(m, m->slot_of[user], t);
+    return match_dot(p, t);
+}
+
+// Scan slots [from, to), from a multiple of 4, four users per step. The
+// first half of the dimensions gives a partial score; by Cauchy-Schwarz
+// the rest adds at most |probe tail| * |template tail|, so a block whose
+// four bounds all fall below the current cut skips its second half.
+static void match_scan(const struct dsp_match *m, const float *p, float p_tail, uint32_t from, uint32_t to,
+                       float threshold, struct dsp_match_result *r) {
+    for (uint32_t b = from / 4; b < (to + 3) / 4; b++) {
+        const float (*f)[4] = m->feat[b];
+        float cut = r->user >= 0 && r->score > threshold ? r->score : threshold;
+        float score[4];
+#ifdef __SSE__
+        dsp_v4 acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (uint32_t d = 0; d < MATCH_HALF; d++) {
+            dsp_v4 pv = { p[d], p[d], p[d], p[d] };
+            acc += *(const dsp_v4 *)f[d] * pv;
+        }
+        dsp_v4 ptv = { p_tail, p_tail, p_tail, p_tail };
+        dsp_v4 bound = acc + ptv * *(const dsp_v4 *)&m->tail_norm[4 * b];
+        r->scanned += 4;
+        if (bound[0] + MATCH_BOUND_SLACK < cut && bound[1] + MATCH_BOUND_SLACK < cut &&
+            bound[2] + MATCH_BOUND_SLACK < cut && bound[3] + MATCH_BOUND_SLACK < cut) {
+            continue;
+        }
+        r->scored += 4;
+        for (uint32_t d = MATCH_HALF; d < DSP_MATCH_DIM; d++) {
+            dsp_v4 pv = { p[d], p[d], p[d], p[d] };
+            acc += *(const dsp_v4 *)f[d] * pv;
+        }
+        for (int l = 0; l < 4; l++) score[l] = acc[l];
+#else
+        float acc[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        int live = 0;
+        for (int l = 0; l < 4; l++) {
+            for (uint32_t d = 0; d < MATCH_HALF; d++) acc[l] += f[d][l] * p[d];
+            live |= acc[l] + p_tail * m->tail_norm[4 * b + l] + MATCH_BOUND_SLACK >= cut;
+        }
+        r->scanned += 4;
+        if (!live) continue;
+        r->scored += 4;
+        for (int l = 0; l < 4; l++) {
+            for (uint32_t d = MATCH_HALF; d < DSP_MATCH_DIM; d++) acc[l] += f[d][l] * p[d];
+            score[l] = acc[l];
+        }
+#endif
+        for (uint32_t l = 0; l < 4; l++) {
+            int32_t user = m->user[4 * b + l];
+            if (user >= 0 && score[l] >= threshold && (r->user < 0 || score[l] > r->score)) {
+                r->user = user;
+                r->score = score[l];
+            }
+        }
+    }
+}
+
+int32_t dsp_match_identify(const struct dsp_match *m, const float *probe, float threshold,
+                           struct dsp_match_result *r) {
+    float p[DSP_MATCH_DIM];
+    r->user = -1;
+    r->score = DSP_MATCH_NONE;
+    r->scanned = 0;
+    r->scored = 0;
+    if (!match_prepare(m, probe, p)) return -1;
+    float p_tail = match_tail_norm(p);
+
+    if (m->lists != 0) {
+        // The nprobe cells whose centroids are nearest the probe
+        uint32_t best[DSP_MATCH_LISTS];
+        float score[DSP_MATCH_LISTS];
+        uint32_t n = m->nprobe < m->lists ? m->nprobe : m->lists, have = 0;
+        for (uint32_t c = 0; c < m->lists; c++) {
+            float s = match_dot(p, m->centroid[c]);
+            uint32_t at = have < n ? have++ : n;
+            while (at > 0 && score[at - 1] < s) {
+                if (at < n) {
+                    score[at] = score[at - 1];
+                    best[at] = best[at - 1];
+                }
+                at--;
+            }
+            if (at < n) {
+                score[at] = s;
+                best[at] = c;
+            }
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            match_scan(m, p, p_tail, m->list_start[best[i]], m->list_start[best[i] + 1], threshold, r);
+        }
+    }
+    match_scan(m, p, p_tail, m->indexed, m->slots, threshold, r);
+    return r->user;
+}
+
+// Spherical k-means: cells are the directions of their members' mean,
+// started from evenly spaced templates so builds are deterministic
+static void match_kmeans(struct dsp_match *m, uint32_t n, uint32_t k) {
+    static float sum[DSP_MATCH_LISTS][DSP_MATCH_DIM];
+    for (uint32_t c = 0; c < k; c++) memcpy(m->centroid[c], m->dense[c * n / k], sizeof(m->centroid[c]));
+    for (uint32_t round = 0; round <= DSP_MATCH_KMEANS_ROUNDS; round++) {
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t best = 0;
+            float best_score = match_dot(m->dense[i], m->centroid[0]);
+            for (uint32_t c = 1; c < k; c++) {
+                float s = match_dot(m->dense[i], m->centroid[c]);
+                if (s > best_score) {
+                    best_score = s;
+                    best = c;
+                }
+            }
+            m->cell[i] = (uint16_t)best;
+        }
+        if (round == DSP_MATCH_KMEANS_ROUNDS) break;
+
+        memset(sum, 0, sizeof(sum));
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) sum[m->cell[i]][d] += m->dense[i][d];
+        }
+        for (uint32_t c = 0; c < k; c++) {
+            // An empty cell keeps its centroid
+            if (match_normalize(sum[c])) memcpy(m->centroid[c], sum[c], sizeof(sum[c]));
+        }
+    }
+}
+
+void dsp_match_build(struct dsp_match *m) {
+    // Gather the live templates, already whitened and normalised
+    uint32_t n = 0;
+    for (uint32_t s = 0; s < m->slots; s++) {
+        if (m->user[s] < 0) continue;
+        match_get(m, s, m->dense[n]);
+        m->dense_user[n++] = m->user[s];
+    }
+    for (uint32_t s = 0; s < m->slots; s++) match_clear(m, s);
+
+    if (n <= DSP_MATCH_LINEAR_MAX) {
+        for (uint32_t i = 0; i < n; i++) match_put(m, i, m->dense_user[i], m->dense[i]);
+        m->lists = 0;
+        m->indexed = 0;
+        m->slots = n;
+        return;
+    }
+
+    uint32_t k = DSP_MATCH_LISTS;
+    match_kmeans(m, n, k);
+
+    // Counting sort into cells, each padded to whole blocks
+    uint32_t size[DSP_MATCH_LISTS], fill[DSP_MATCH_LISTS];
+    memset(size, 0, sizeof(size));
+    for (uint32_t i = 0; i < n; i++) size[m->cell[i]]++;
+    m->list_start[0] = 0;
+    for (uint32_t c = 0; c < k; c++) {
+        m->list_start[c + 1] = m->list_start[c] + ((size[c] + 3) & ~3u);
+        fill[c] = m->list_start[c];
+    }
+    for (uint32_t i = 0; i < n; i++) match_put(m, fill[m->cell[i]]++, m->dense_user[i], m->dense[i]);
+    m->lists = k;
+    m->indexed = m->list_start[k];
+    m->slots = m->indexed;
+}
@@ -0,0 +1,218 @@
+#include "../include/dsp/dsp_profile.h"
+
+#define PROFILE_HEADER_SIZE sizeof(struct dsp_profile_header)
+#define PROFILE_RECORD_SIZE sizeof(struct dsp_profile_record)
+
+// CRC-32 (IEEE, reflected), four bits per step from a 16-entry table
+static const uint32_t crc_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+static uint32_t crc_update(uint32_t crc, const uint8_t *p, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ crc_nibble[crc & 15];
+        crc = (crc >> 4) ^ crc_nibble[crc & 15];
+    }
+    return crc;
+}
+
+// CRC of a structure whose crc field, at offset `at`, counts as zero
+static uint32_t crc_skipping(const void *p, uint32_t len, uint32_t at) {
+    static const uint8_t zero[4] = { 0, 0, 0, 0 };
+    const uint8_t *b = (const uint8_t *)p;
+    uint32_t crc = crc_update(0xFFFFFFFF, b, at);
+    crc = crc_update(crc, zero, 4);
+    return ~crc_update(crc, b + at + 4, len - at - 4);
+}
+
+static uint32_t header_crc(const struct dsp_profile_header *h) {
+    return crc_skipping(h, PROFILE_HEADER_SIZE, offsetof(struct dsp_profile_header, crc));
+}
+
+static uint32_t record_crc(const struct dsp_profile_record *r) {
+    return crc_skipping(r, PROFILE_RECORD_SIZE, offsetof(struct dsp_profile_record, crc));
+}
+
+static int record_valid(const struct dsp_profile_record *r, uint32_t capacity) {
+    return r->magic == DSP_PROFILE_RECORD_MAGIC && r->user < capacity && r->crc == record_crc(r);
+}
+
+static uint32_t tail_slot(uint32_t user) {
+    return (user * 2654435761u) >> 23 & (DSP_PROFILE_TAIL_HASH - 1);
+}
+
+// Record a log entry as the newest for its user
+static int tail_add(struct dsp_profile_store *s, const struct dsp_profile_record *r) {
+    if (s->tail_count == DSP_PROFILE_TAIL_MAX) return DSP_ERR_FULL;
+    uint32_t h = tail_slot(r->user);
+    while (s->tail_hash[h] != 0 && s->tail[s->tail_hash[h] - 1]->user != r->user) {
+        h = (h + 1) & (DSP_PROFILE_TAIL_HASH - 1);
+    }
+    s->tail[s->tail_count++] = r;
+    s->tail_hash[h] = (uint16_t)s->tail_count;
+    return 0;
+}
+
+static const struct dsp_profile_record *tail_find(const struct dsp_profile_store *s, uint32_t user) {
+    for (uint32_t h = tail_slot(user); s->tail_hash[h] != 0; h = (h + 1) & (DSP_PROFILE_TAIL_HASH - 1)) {
+        const struct dsp_profile_record *r = s->tail[s->tail_hash[h] - 1];
+        if (r->user == user) return r;
+    }
+    return NULL;
+}
+
+static void header_init(struct dsp_profile_header *h, uint32_t capacity, uint32_t records, uint32_t generation) {
+    h->magic = DSP_PROFILE_MAGIC;
+    h->version = DSP_PROFILE_VERSION;
+    h->dim = DSP_PROFILE_DIM;
+    h->capacity = capacity;
+    h->records = records;
+    h->generation = generation;
+    h->reserved = 0;
+    h->crc = header_crc(h);
+}
+
+// Zero the record slot after the base so a reopen finds an empty log
+static void profile_end_log(void *image, uint32_t used, uint32_t size) {
+    uint8_t *p = (uint8_t *)image;
+    for (uint32_t at = used; at < size && at < used + PROFILE_RECORD_SIZE; at++) p[at] = 0;
+}
+
+long dsp_profile_format(void *image, uint32_t size, uint32_t capacity) {
+    uint32_t used = DSP_PROFILE_IMAGE_SIZE(capacity, 0);
+    if (capacity == 0 || capacity > DSP_PROFILE_MAX || size < used || ((uintptr_t)image & 3) != 0) {
+        return DSP_ERR_INVAL;
+    }
+    header_init((struct dsp_profile_header *)image, capacity, 0, 0);
+    uint32_t *dir = (uint32_t *)((uint8_t *)image + PROFILE_HEADER_SIZE);
+    for (uint32_t i = 0; i < DSP_PROFILE_DIR_SIZE(capacity) / 4; i++) dir[i] = DSP_PROFILE_NO_RECORD;
+    profile_end_log(image, used, size);
+    return used;
+}
+
+int dsp_profile_open(struct dsp_profile_store *s, const void *image, uint32_t size, void *journal,
+                     uint32_t journal_size) {
+    const struct dsp_profile_header *h = (const struct dsp_profile_header *)image;
+    if (image == NULL || ((uintptr_t)image & 3) != 0 || ((uintptr_t)journal & 3) != 0 ||
+        size < PROFILE_HEADER_SIZE) {
+        return DSP_ERR_INVAL;
+    }
+    if (h->magic != DSP_PROFILE_MAGIC || h->version != DSP_PROFILE_VERSION || h->dim != DSP_PROFILE_DIM ||
+        h->crc != header_crc(h) || h->capacity == 0 || h->capacity > DSP_PROFILE_MAX ||
+        h->records > DSP_PROFILE_MAX || size < DSP_PROFILE_IMAGE_SIZE(h->capacity, h->records)) {
+        return DSP_ERR_INVAL;
+    }
+    const uint8_t *p = (const uint8_t *)image;
+    s->header = h;
+    s->capacity = h->capacity;
+    s->dir = (const uint32_t *)(p + PROFILE_HEADER_SIZE);
+    s->base = (const struct dsp_profile_record *)(p + PROFILE_HEADER_SIZE + DSP_PROFILE_DIR_SIZE(h->capacity));
+    s->journal = (struct dsp_profile_record *)journal;
+    s->journal_max = journal != NULL ? journal_size / PROFILE_RECORD_SIZE : 0;
+    s->journal_count = 0;
+    s->tail_count = 0;
+    for (uint32_t i = 0; i < DSP_PROFILE_TAIL_HASH; i++) s->tail_hash[i] = 0;
+    for (uint32_t i = 0; i < DSP_PROFILE_MAX / 32; i++) {
+        s->checked[i] = 0;
+        s->bad[i] = 0;
+    }
+
+    // Replay the log up to the first record that does not check out: a
+    // torn final write, or the zeroed space after the last record
+    for (uint32_t at = DSP_PROFILE_IMAGE_SIZE(h->capacity, h->records); at + PROFILE_RECORD_SIZE <= size;
+         at += PROFILE_RECORD_SIZE) {
+        const struct dsp_profile_record *r = (const struct dsp_profile_record *)(p + at);
+        if (!record_valid(r, s->capacity)) break;
+        if (tail_add(s, r) != 0) return DSP_ERR_INVAL;
+    }
+    return 0;
+}
+
+static int profile_append(struct dsp_profile_store *s, uint32_t user, uint32_t flags, const float *v) {
+    if (s->journal_count == s->journal_max || s->tail_count == DSP_PROFILE_TAIL_MAX) return DSP_ERR_FULL;
+    struct dsp_profile_record *r = &s->journal[s->journal_count];
+    r->magic = DSP_PROFILE_RECORD_MAGIC;
+    r->user = user;
+    r->flags = flags;
+    for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) r->feat[d] = v[d];
+    r->crc = record_crc(r);
+    s->journal_count++;
+    return tail_add(s, r);
+}
+
+int dsp_profile_put(struct dsp_profile_store *s, uint32_t user, const float *features) {
+    float v[DSP_PROFILE_DIM], sum = 0.0f;
+    if (user >= s->capacity || s->journal == NULL) return DSP_ERR_INVAL;
+    for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) sum += features[d] * features[d];
+    if (!(sum > 0.0f)) return DSP_ERR_INVAL;
+    float inv = 1.0f / dsp_sqrtf(sum);
+    for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) v[d] = features[d] * inv;
+    return profile_append(s, user, 0, v);
+}
+
+int dsp_profile_remove(struct dsp_profile_store *s, uint32_t user) {
+    static const float zero[DSP_PROFILE_DIM];
+    if (user >= s->capacity || s->journal == NULL || dsp_profile_get(s, user) == NULL) return DSP_ERR_INVAL;
+    return profile_append(s, user, DSP_PROFILE_REMOVED, zero);
+}
+
+const float *dsp_profile_get(struct dsp_profile_store *s, uint32_t user) {
+    if (user >= s->capacity) return NULL;
+    const struct dsp_profile_record *r = tail_find(s, user);
+    if (r != NULL) return r->flags & DSP_PROFILE_REMOVED ? NULL : r->feat;
+
+    uint32_t i = s->dir[user];
+    if (i >= s->header->records) return NULL;
+    r = &s->base[i];
+    // First use of a base record: check it once
+    uint32_t bit = 1u << (i % 32);
+    if (!(s->checked[i / 32] & bit)) {
+        s->checked[i / 32] |= bit;
+        if (!record_valid(r, s->capacity) || r->user != user || (r->flags & DSP_PROFILE_REMOVED)) {
+            s->bad[i / 32] |= bit;
+        }
+    }
+    return s->bad[i / 32] & bit ? NULL : r->feat;
+}
+
+float dsp_profile_score(struct dsp_profile_store *s, uint32_t user, const float *probe) {
+    const float *t = dsp_profile_get(s, user);
+    if (t == NULL) return DSP_PROFILE_NONE;
+    float dot = 0.0f, sum = 0.0f;
+    for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) {
+        dot += probe[d] * t[d];
+        sum += probe[d] * probe[d];
+    }
+    if (!(sum > 0.0f)) return DSP_PROFILE_NONE;
+    return dot / dsp_sqrtf(sum);
+}
+
+long dsp_profile_compact(struct dsp_profile_store *s, void *out, uint32_t size) {
+    if (((uintptr_t)out & 3) != 0) return DSP_ERR_INVAL;
+    uint32_t live = 0;
+    for (uint32_t u = 0; u < s->capacity; u++) live += dsp_profile_get(s, u) != NULL;
+    uint32_t used = DSP_PROFILE_IMAGE_SIZE(s->capacity, live);
+    if (size < used) return DSP_ERR_FULL;
+
+    uint8_t *p = (uint8_t *)out;
+    uint32_t *dir = (uint32_t *)(p + PROFILE_HEADER_SIZE);
+    struct dsp_profile_record *base = (struct dsp_profile_record *)(p + PROFILE_HEADER_SIZE +
+                                                                    DSP_PROFILE_DIR_SIZE(s->capacity));
+    uint32_t n = 0;
+    for (uint32_t u = 0; u < DSP_PROFILE_DIR_SIZE(s->capacity) / 4; u++) {
+        const float *t = u < s->capacity ? dsp_profile_get(s, u) : NULL;
+        dir[u] = t != NULL ? n : DSP_PROFILE_NO_RECORD;
+        if (t == NULL) continue;
+        struct dsp_profile_record *r = &base[n++];
+        r->magic = DSP_PROFILE_RECORD_MAGIC;
+        r->user = u;
+        r->flags = 0;
+        for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) r->feat[d] = t[d];
+        r->crc = record_crc(r);
+    }
+    profile_end_log(out, used, size);
+    header_init((struct dsp_profile_header *)out, s->capacity, n, s->header->generation + 1);
+    return used;
+}
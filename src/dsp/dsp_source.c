@@ -0,0 +1,134 @@
+#include "../include/dsp/dsp_source.h"
+#include "../include/dsp/dsp_fixed.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Recordings are read byte by byte: a module or file buffer need not be
+// aligned, and the format is little-endian whatever the host
+static uint32_t source_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t source_sample_size(uint32_t format) {
+    switch (format) {
+    case DSP_SAMPLE_Q15:
+        return 2;
+    case DSP_SAMPLE_F32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+int dsp_source_synth(struct dsp_source *s, enum dsp_source_kind kind, uint32_t channels, uint32_t sample_rate,
+                     uint32_t seed) {
+    if (channels == 0 || channels > DSP_SOURCE_MAX_CHANNELS || sample_rate == 0 || kind == DSP_SOURCE_REPLAY) {
+        return DSP_ERR_INVAL;
+    }
+    memset(s, 0, sizeof(*s));
+    s->kind = kind;
+    s->channels = channels;
+    s->sample_rate = sample_rate;
+    s->speed = 1;
+    for (uint32_t c = 0; c < channels; c++) {
+        if (kind == DSP_SOURCE_EEG) {
+            dsp_synth_eeg_init(&s->eeg[c], sample_rate, seed + c);
+        } else {
+            // Resting rhythm with breathing, as the services default to
+            dsp_synth_ecg_init(&s->ecg[c], sample_rate, 800, 30, seed + c);
+            s->ecg[c].rsa_ms = 40;
+            s->ecg[c].noise = 0.05f;
+        }
+    }
+    return 0;
+}
+
+int dsp_source_replay(struct dsp_source *s, const void *data, uint32_t size) {
+    const uint8_t *p = data;
+    if (p == NULL || size < sizeof(struct dsp_recording_header)) return DSP_ERR_INVAL;
+    uint32_t channels = source_u32(p + 8), rate = source_u32(p + 12);
+    uint32_t format = source_u32(p + 16), frames = source_u32(p + 20);
+    uint32_t bytes = source_sample_size(format);
+    if (source_u32(p) != DSP_RECORDING_MAGIC || source_u32(p + 4) != DSP_RECORDING_VERSION || bytes == 0 ||
+        channels == 0 || channels > DSP_SOURCE_MAX_CHANNELS || rate == 0 || frames == 0) {
+        return DSP_ERR_INVAL;
+    }
+    // Checked in 64 bits so a huge frame count cannot wrap the size test
+    uint64_t need = (uint64_t)frames * channels * bytes;
+    if (need > size - sizeof(struct dsp_recording_header)) return DSP_ERR_INVAL;
+
+    memset(s, 0, sizeof(struct dsp_source));
+    s->kind = DSP_SOURCE_REPLAY;
+    s->channels = channels;
+    s->sample_rate = rate;
+    s->speed = 1;
+    s->replay.samples = p + sizeof(struct dsp_recording_header);
+    s->replay.format = format;
+    s->replay.length = frames;
+    return 0;
+}
+
+static uint32_t source_replay(struct dsp_source *s, float *out, uint32_t frames) {
+    uint32_t done = 0, ch = s->channels;
+    while (done < frames) {
+        if (s->replay.pos == s->replay.length) {
+            if (!s->loop) break;
+            s->replay.pos = 0;
+        }
+        uint32_t n = s->replay.length - s->replay.pos;
+        if (n > frames - done) n = frames - done;
+        float *o = out + done * ch;
+        if (s->replay.format == DSP_SAMPLE_Q15) {
+            const uint8_t *p = s->replay.samples + s->replay.pos * ch * 2;
+            for (uint32_t i = 0; i < n * ch; i++, p += 2) {
+                o[i] = (float)(int16_t)(p[0] | p[1] << 8) * (1.0f / DSP_Q15_ONE);
+            }
+        } else {
+            const uint8_t *p = s->replay.samples + s->replay.pos * ch * 4;
+            for (uint32_t i = 0; i < n * ch; i++, p += 4) {
+                union { uint32_t u; float f; } v = { source_u32(p) };
+                o[i] = v.f;
+            }
+        }
+        s->replay.pos += n;
+        done += n;
+    }
+    return done;
+}
+
+uint32_t dsp_source_read(struct dsp_source *s, float *out, uint32_t frames) {
+    uint32_t done;
+    switch (s->kind) {
+    case DSP_SOURCE_REPLAY:
+        done = source_replay(s, out, frames);
+        break;
+    case DSP_SOURCE_EEG:
+        for (uint32_t i = 0; i < frames; i++) {
+            for (uint32_t c = 0; c < s->channels; c++) out[i * s->channels + c] = dsp_synth_eeg_next(&s->eeg[c]);
+        }
+        done = frames;
+        break;
+    case DSP_SOURCE_PPG:
+        for (uint32_t i = 0; i < frames; i++) {
+            for (uint32_t c = 0; c < s->channels; c++) out[i * s->channels + c] = dsp_synth_ppg_next(&s->ecg[c]);
+        }
+        done = frames;
+        break;
+    default:
+        for (uint32_t i = 0; i < frames; i++) {
+            for (uint32_t c = 0; c < s->channels; c++) out[i * s->channels + c] = dsp_synth_ecg_next(&s->ecg[c]);
+        }
+        done = frames;
+        break;
+    }
+    s->frames += done;
+    return done;
+}
+
+uint32_t dsp_source_due(const struct dsp_source *s, uint64_t elapsed, uint32_t per_second) {
+    if (s->speed == 0 || per_second == 0) return s->sample_rate;
+    uint64_t target = dsp_udiv64(elapsed * s->sample_rate * s->speed, per_second);
+    if (target <= s->frames) return 0;
+    target -= s->frames;
+    return target > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)target;
+}
@@ -0,0 +1,157 @@
+#include "../include/dsp/dsp_synth.h"
+#include "../include/dsp/dsp_fft.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+#define SYNTH_QRS_MS 40         // Base width of the R triangle
+#define SYNTH_T_OFFSET_MS 250   // T wave centre after the R peak
+#define SYNTH_T_MS 120
+#define SYNTH_T_HEIGHT 0.25f    // Relative to the R peak
+#define SYNTH_RR_MIN_MS 250     // Floor under jitter plus RSA
+#define SYNTH_RESP_MS 4000      // Default breath, 15 per minute
+#define SYNTH_PTT_MS 200        // Pulse transit time, R peak to PPG foot
+#define SYNTH_SYSTOLE_MS 300    // Width of the systolic wave
+#define SYNTH_DIASTOLE_OFFSET_MS 300    // Diastolic wave after the systolic one
+#define SYNTH_DIASTOLE_MS 300
+#define SYNTH_DIASTOLE_HEIGHT 0.4f
+#define SYNTH_TWO_PI 6.28318530717958647692
+
+uint32_t dsp_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t synth_ms_to_samples(const struct dsp_synth_ecg *s, uint32_t ms) {
+    return (ms * s->sample_rate + 500) / 1000;
+}
+
+// The RR interval that starts at sample i
+static uint32_t synth_next_rr(struct dsp_synth_ecg *s, uint32_t i) {
+    uint32_t span = 2 * s->jitter_ms + 1;
+    int32_t rr = (int32_t)(s->mean_rr_ms - s->jitter_ms + dsp_rand(&s->rng) % span);
+    if (s->rsa_ms != 0 && s->resp_ms != 0) {
+        double sn, cs;
+        double breaths = (double)i * 1000.0 / ((double)s->sample_rate * (double)s->resp_ms);
+        dsp_sincos(SYNTH_TWO_PI * (breaths - (double)(uint32_t)breaths), &sn, &cs);
+        rr += (int32_t)(sn * (double)s->rsa_ms + (sn < 0.0 ? -0.5 : 0.5));
+    }
+    return rr < SYNTH_RR_MIN_MS ? SYNTH_RR_MIN_MS : (uint32_t)rr;
+}
+
+void dsp_synth_ecg_init(struct dsp_synth_ecg *s, uint32_t sample_rate, uint32_t mean_rr_ms,
+                        uint32_t jitter_ms, uint32_t seed) {
+    memset(s, 0, sizeof(*s));
+    s->sample_rate = sample_rate;
+    s->mean_rr_ms = mean_rr_ms;
+    s->jitter_ms = jitter_ms < mean_rr_ms ? jitter_ms : mean_rr_ms - 1;
+    s->amplitude = 1.0f;
+    s->noise = 0.0f;
+    s->resp_ms = SYNTH_RESP_MS;
+    s->rng = seed != 0 ? seed : 1;
+    s->next_beat = synth_ms_to_samples(s, mean_rr_ms / 2);
+}
+
+// Unit triangle of the given base width centred on 0
+static float synth_triangle(int32_t offset, uint32_t width) {
+    int32_t half = (int32_t)width / 2;
+    if (half == 0) return offset == 0 ? 1.0f : 0.0f;
+    int32_t a = offset < 0 ? -offset : offset;
+    return a >= half ? 0.0f : 1.0f - (float)a / (float)half;
+}
+
+// Uniform in [-1, 1)
+static float synth_noise(uint32_t *rng) {
+    float u = (float)(dsp_rand(rng) >> 8) * (1.0f / 16777216.0f);  // [0, 1)
+    return 2.0f * u - 1.0f;
+}
+
+// Smooth unit bump (1 - t^2)^2 of the given base width, starting at 0
+static float synth_bump(int32_t offset, uint32_t width) {
+    if (offset < 0 || (uint32_t)offset >= width) return 0.0f;
+    float t = 2.0f * (float)offset / (float)width - 1.0f;
+    float u = 1.0f - t * t;
+    return u * u;
+}
+
+// Advance the beat clock by one sample and return its index
+static uint32_t synth_step(struct dsp_synth_ecg *s) {
+    uint32_t i = s->n++;
+    s->beat = 0;
+    if (i == s->next_beat) {
+        uint32_t rr = synth_next_rr(s, i);
+        // Rounded the way hrv_push() converts sample counts
+        s->rr_ms = s->beats == 0 ? 0 : ((i - s->beat_at) * 1000 + s->sample_rate / 2) / s->sample_rate;
+        s->beats++;
+        s->prev_beat_at = s->beat_at;
+        s->beat_at = i;
+        s->next_beat = i + synth_ms_to_samples(s, rr);
+        s->beat = 1;
+    }
+    return i;
+}
+
+float dsp_synth_ecg_next(struct dsp_synth_ecg *s) {
+    uint32_t i = synth_step(s);
+
+    // The current beat's waves, and the start of the next QRS
+    int32_t since = (int32_t)(i - s->beat_at);
+    int32_t until = (int32_t)(s->next_beat - i);
+    float v = synth_triangle(since, synth_ms_to_samples(s, SYNTH_QRS_MS)) +
+              synth_triangle(until, synth_ms_to_samples(s, SYNTH_QRS_MS)) +
+              SYNTH_T_HEIGHT * synth_triangle(since - (int32_t)synth_ms_to_samples(s, SYNTH_T_OFFSET_MS),
+                                              synth_ms_to_samples(s, SYNTH_T_MS));
+    v *= s->amplitude;
+    if (s->noise > 0.0f) v += s->noise * synth_noise(&s->rng);
+    return v;
+}
+
+// The pulse of one beat, `since` samples after its R peak
+static float synth_pulse(const struct dsp_synth_ecg *s, int32_t since) {
+    int32_t foot = since - (int32_t)synth_ms_to_samples(s, SYNTH_PTT_MS);
+    return synth_bump(foot, synth_ms_to_samples(s, SYNTH_SYSTOLE_MS)) +
+           SYNTH_DIASTOLE_HEIGHT * synth_bump(foot - (int32_t)synth_ms_to_samples(s, SYNTH_DIASTOLE_OFFSET_MS),
+                                              synth_ms_to_samples(s, SYNTH_DIASTOLE_MS));
+}
+
+float dsp_synth_ppg_next(struct dsp_synth_ecg *s) {
+    uint32_t i = synth_step(s);
+
+    // A pulse outlasts short RR intervals, so the previous beat's tail
+    // can still be arriving
+    float v = 0.0f;
+    if (s->beats > 0) v += synth_pulse(s, (int32_t)(i - s->beat_at));
+    if (s->beats > 1) v += synth_pulse(s, (int32_t)(i - s->prev_beat_at));
+    v *= s->amplitude;
+    if (s->noise > 0.0f) v += s->noise * synth_noise(&s->rng);
+    return v;
+}
+
+void dsp_synth_eeg_init(struct dsp_synth_eeg *s, uint32_t sample_rate, uint32_t seed) {
+    static const float hz[DSP_SYNTH_TONES] = { 2.0f, 6.0f, 10.0f, 20.0f };
+    static const float amplitude[DSP_SYNTH_TONES] = { 0.6f, 0.5f, 1.0f, 0.4f };
+    memset(s, 0, sizeof(*s));
+    s->sample_rate = sample_rate;
+    s->rng = seed != 0 ? seed : 1;
+    s->noise = 0.1f;
+    for (int i = 0; i < DSP_SYNTH_TONES; i++) {
+        s->hz[i] = hz[i];
+        s->amplitude[i] = amplitude[i];
+    }
+}
+
+float dsp_synth_eeg_next(struct dsp_synth_eeg *s) {
+    float v = 0.0f;
+    for (int i = 0; i < DSP_SYNTH_TONES; i++) {
+        double sn, cs;
+        dsp_sincos(SYNTH_TWO_PI * s->phase[i], &sn, &cs);
+        v += s->amplitude[i] * (float)sn;
+        s->phase[i] += (double)s->hz[i] / (double)s->sample_rate;
+        if (s->phase[i] >= 1.0) s->phase[i] -= 1.0;
+    }
+    if (s->noise > 0.0f) v += s->noise * synth_noise(&s->rng);
+    return v;
+}
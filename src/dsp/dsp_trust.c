@@ -0,0 +1,126 @@
+#include "../include/dsp/dsp_trust.h"
+
+#define TRUST_LN2 0.69314718f
+
+// e^x for |x| <= 80: x = k ln 2 + r with |r| <= ln 2 / 2, a degree-5
+// series for e^r, and k added to the exponent bits
+static float trust_exp(float x) {
+    x = dsp_clampf(x, -80.0f, 80.0f);
+    float kf = x * 1.44269504f;
+    int32_t k = (int32_t)(kf + (kf >= 0.0f ? 0.5f : -0.5f));
+    float r = x - (float)k * TRUST_LN2;
+    float p = 1.0f + r * (1.0f + r * (0.5f + r * (1.0f / 6.0f + r * (1.0f / 24.0f + r * (1.0f / 120.0f)))));
+    union { float f; uint32_t u; } v = { p };
+    v.u += (uint32_t)k << 23;
+    return v.f;
+}
+
+// ln x for x > 0: x = m 2^e with m in [sqrt(1/2), sqrt(2)), and
+// ln m = 2 atanh(s) for s = (m - 1) / (m + 1), |s| < 0.18
+static float trust_log(float x) {
+    union { float f; uint32_t u; } v = { x };
+    int32_t e = (int32_t)(v.u >> 23) - 127;
+    v.u = (v.u & 0x7FFFFF) | 0x3F800000;
+    if (v.f > 1.41421356f) {
+        v.f *= 0.5f;
+        e++;
+    }
+    float s = (v.f - 1.0f) / (v.f + 1.0f), s2 = s * s;
+    return (float)e * TRUST_LN2 + 2.0f * s * (1.0f + s2 * (1.0f / 3.0f + s2 * (0.2f + s2 * (1.0f / 7.0f))));
+}
+
+static float trust_logit(float p) {
+    return trust_log(p / (1.0f - p));
+}
+
+void dsp_trust_stats_init(struct dsp_trust_stats *s, uint32_t n) {
+    s->n = n <= DSP_TRUST_MAX_FEATURES ? n : DSP_TRUST_MAX_FEATURES;
+    s->count = 0;
+    for (uint32_t i = 0; i < DSP_TRUST_MAX_FEATURES; i++) {
+        s->mean[i] = 0.0;
+        s->m2[i] = 0.0;
+    }
+}
+
+void dsp_trust_stats_add(struct dsp_trust_stats *s, const float *x) {
+    s->count++;
+    for (uint32_t i = 0; i < s->n; i++) {
+        double d = x[i] - s->mean[i];
+        s->mean[i] += d / s->count;
+        s->m2[i] += d * (x[i] - s->mean[i]);
+    }
+}
+
+int dsp_trust_model_init(struct dsp_trust_model *m, const struct dsp_trust_stats *user, const float *pop_mean,
+                         const float *pop_std) {
+    if (user->n == 0 || user->count < 2) return DSP_ERR_INVAL;
+    m->n = user->n;
+    m->bias = 0.0f;
+    for (uint32_t i = 0; i < m->n; i++) {
+        if (!(pop_std[i] > 0.0f)) return DSP_ERR_INVAL;
+        // A steady synthetic baseline has almost no spread; floor it so
+        // ordinary drift is not read as an impostor
+        float std = dsp_sqrtf((float)(user->m2[i] / (user->count - 1)));
+        if (std < DSP_TRUST_MIN_STD * pop_std[i]) std = DSP_TRUST_MIN_STD * pop_std[i];
+        m->mean[i] = (float)user->mean[i];
+        m->inv_std[i] = 1.0f / std;
+        m->pop_mean[i] = pop_mean[i];
+        m->pop_inv_std[i] = 1.0f / pop_std[i];
+        m->bias += trust_log(pop_std[i] / std);
+    }
+    return 0;
+}
+
+float dsp_trust_evidence(const struct dsp_trust_model *m, const float *x) {
+    float llr = m->bias;
+    for (uint32_t i = 0; i < m->n; i++) {
+        float zu = (x[i] - m->mean[i]) * m->inv_std[i];
+        float zp = (x[i] - m->pop_mean[i]) * m->pop_inv_std[i];
+        llr += 0.5f * (zp * zp - zu * zu);
+    }
+    return dsp_clampf(llr, -DSP_TRUST_EVIDENCE_MAX, DSP_TRUST_EVIDENCE_MAX);
+}
+
+int dsp_trust_init(struct dsp_trust *t, uint32_t half_life_ms, float lock_below, float unlock_above) {
+    if (half_life_ms == 0 || !(lock_below > 0.0f) || !(lock_below < unlock_above) || !(unlock_above < 1.0f)) {
+        return DSP_ERR_INVAL;
+    }
+    t->evidence = 0.0f;
+    t->decay = TRUST_LN2 / (float)half_life_ms;
+    t->lock_at = trust_logit(lock_below);
+    t->unlock_at = trust_logit(unlock_above);
+    t->last_ms = 0;
+    t->updates = 0;
+    t->locked = 1;
+    return 0;
+}
+
+void dsp_trust_start(struct dsp_trust *t, uint32_t now_ms, float confidence) {
+    t->evidence = trust_logit(dsp_clampf(confidence, 1e-6f, 1.0f - 1e-6f));
+    t->last_ms = now_ms;
+    t->locked = 0;
+}
+
+int dsp_trust_update(struct dsp_trust *t, uint32_t now_ms, float evidence) {
+    // An update stamped before the last one, such as a record from a
+    // slower stream, adds its evidence without decaying
+    if (now_ms > t->last_ms) {
+        t->evidence *= trust_exp(-t->decay * (float)(now_ms - t->last_ms));
+        t->last_ms = now_ms;
+    }
+    t->evidence += evidence;
+    t->updates++;
+    if (!t->locked && t->evidence < t->lock_at) {
+        t->locked = 1;
+        return DSP_TRUST_LOCK;
+    }
+    if (t->locked && t->evidence > t->unlock_at) {
+        t->locked = 0;
+        return DSP_TRUST_UNLOCK;
+    }
+    return 0;
+}
+
+float dsp_trust_confidence(const struct dsp_trust *t) {
+    return 1.0f / (1.0f + trust_exp(-t->evidence));
+}
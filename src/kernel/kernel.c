@@ -1,7 +1,44 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
 #include "../include/auth.h"
+#include "../include/klib.h"
+#include "../include/boot.h"
+
+// Freestanding memory routines (see include/klib.h)
+void *memcpy(void *dst, const void *src, size_t n) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    while (n--) *d++ = *s++;
+    return dst;
+}
+
+void *memmove(void *dst, const void *src, size_t n) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    if (d < s) {
+        while (n--) *d++ = *s++;
+    } else {
+        while (n--) d[n] = s[n];
+    }
+    return dst;
+}
+
+void *memset(void *dst, int c, size_t n) {
+    uint8_t *d = dst;
+    while (n--) *d++ = (uint8_t)c;
+    return dst;
+}
+
+int memcmp(const void *a, const void *b, size_t n) {
+    const uint8_t *x = a;
+    const uint8_t *y = b;
+    for (size_t i = 0; i < n; i++) {
+        if (x[i] != y[i]) return x[i] - y[i];
+    }
+    return 0;
+}
 
 // Basic I/O functions - make them non-static for testing
 void outb(uint16_t port, uint8_t val) {
@@ -114,12 +151,16 @@ extern void irq1();
 // Timer variables
 volatile uint32_t timer_ticks = 0;
 
-// Forward declaration
+// Forward declarations
 void timer_handler();
+uint32_t get_current_pid(void);
 
-// Timer interrupt handler
+// Timer interrupt handler. The tick is charged to the real-time job it
+// interrupted, if any, before the timers it releases fire.
 void timer_handler() {
     timer_ticks++;
+    sal_rt_tick(timer_ticks, get_current_pid());
+    sal_port_tick(timer_ticks);
     // Send EOI to PIC
     outb(0x20, 0x20);
 }
@@ -204,6 +245,7 @@ void irq1() {
     serial_print("Keyboard interrupt\n");
     uint8_t scancode = inb(0x60); // Read scancode
     (void)scancode; // Suppress unused warning
+    sal_port_irq(1);
     outb(0x20, 0x20); // Send EOI
 }
 
@@ -251,6 +293,13 @@ void init_idt() {
 static uint32_t page_directory[PAGE_DIRECTORY_ENTRIES] __attribute__((aligned(4096)));
 static uint32_t first_page_table[PAGE_TABLE_ENTRIES] __attribute__((aligned(4096)));
 
+// SAL grant window: 4MB of virtual space right above the identity map,
+// where granted pages are mapped into the receiving service
+#define GRANT_WINDOW_PDE  2
+#define GRANT_WINDOW_BASE ((uint32_t)GRANT_WINDOW_PDE << 22)
+static uint32_t grant_page_table[PAGE_TABLE_ENTRIES] __attribute__((aligned(4096)));
+static uint32_t grant_window_used[PAGE_TABLE_ENTRIES / 32];
+
 void enable_paging() {
     serial_print("Paging setup...\n");
     
@@ -274,6 +323,12 @@ void enable_paging() {
     }
     page_directory[1] = ((uint32_t)second_page_table) | 3; // Present, writable
     
+    // Grant window starts empty; SAL maps granted frames into it on demand
+    for (int i = 0; i < PAGE_TABLE_ENTRIES; i++) {
+        grant_page_table[i] = 0;
+    }
+    page_directory[GRANT_WINDOW_PDE] = ((uint32_t)grant_page_table) | 3;
+    
     // Load page directory into CR3
     asm volatile ("mov %0, %%cr3" :: "r"(page_directory));
     
@@ -286,6 +341,84 @@ void enable_paging() {
     serial_print("Paging enabled with 8MB identity mapping\n");
 }
 
+// The DSP modules are compiled with -msse2. SSE needs CR0.EM clear and
+// CR0.MP set for the FPU, and CR4.OSFXSR/OSXMMEXCPT so SSE instructions
+// and their exceptions are enabled. Processes have no saved contexts
+// yet, so there is no FXSAVE area to switch.
+static int enable_sse() {
+    uint32_t eax = 1, ebx, ecx, edx;
+    asm volatile ("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    if (!(edx & (1 << 25)) || !(edx & (1 << 26))) {
+        return -1;  // No SSE/SSE2
+    }
+    
+    uint32_t cr0, cr4;
+    asm volatile ("mov %%cr0, %0" : "=r"(cr0));
+    cr0 &= ~(1u << 2);  // Clear EM
+    cr0 |= 1u << 1;     // Set MP
+    asm volatile ("mov %0, %%cr0" :: "r"(cr0));
+    asm volatile ("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= (1u << 9) | (1u << 10);  // OSFXSR, OSXMMEXCPT
+    asm volatile ("mov %0, %%cr4" :: "r"(cr4));
+    asm volatile ("fninit");
+    return 0;
+}
+
+// Translate a kernel virtual address through the page directory
+int sal_arch_virt_to_phys(const void *vaddr, uintptr_t *phys) {
+    uint32_t va = (uint32_t)vaddr;
+    uint32_t pde = page_directory[va >> 22];
+    if (!(pde & 1)) return -1;
+    
+    uint32_t *table = (uint32_t *)(pde & ~0xFFF);
+    uint32_t pte = table[(va >> 12) & 0x3FF];
+    if (!(pte & 1)) return -1;
+    
+    *phys = (pte & ~0xFFF) | (va & 0xFFF);
+    return 0;
+}
+
+// Map frame runs at a free spot of the grant window (first fit)
+void *sal_arch_map_extents(const struct sal_extent *ext, uint32_t nextents, int writable) {
+    uint32_t npages = 0;
+    for (uint32_t i = 0; i < nextents; i++) {
+        npages += ext[i].npages;
+    }
+    if (npages == 0 || npages > PAGE_TABLE_ENTRIES) return NULL;
+    
+    uint32_t run = 0;
+    uint32_t start = 0;
+    for (uint32_t i = 0; i < PAGE_TABLE_ENTRIES && run < npages; i++) {
+        if (grant_window_used[i / 32] & (1u << (i % 32))) {
+            run = 0;
+            start = i + 1;
+        } else {
+            run++;
+        }
+    }
+    if (run < npages) return NULL;
+    
+    uint32_t flags = writable ? 3 : 1; // Present, optionally writable
+    uint32_t idx = start;
+    for (uint32_t i = 0; i < nextents; i++) {
+        for (uint32_t p = 0; p < ext[i].npages; p++, idx++) {
+            grant_page_table[idx] = (ext[i].phys + p * PAGE_SIZE) | flags;
+            grant_window_used[idx / 32] |= 1u << (idx % 32);
+        }
+    }
+    return (void *)(GRANT_WINDOW_BASE + start * PAGE_SIZE);
+}
+
+// Remove a grant window mapping and flush its TLB entries
+void sal_arch_unmap(void *vaddr, uint32_t npages) {
+    uint32_t start = ((uint32_t)vaddr - GRANT_WINDOW_BASE) / PAGE_SIZE;
+    for (uint32_t i = start; i < start + npages && i < PAGE_TABLE_ENTRIES; i++) {
+        grant_page_table[i] = 0;
+        grant_window_used[i / 32] &= ~(1u << (i % 32));
+        asm volatile ("invlpg (%0)" :: "r"(GRANT_WINDOW_BASE + i * PAGE_SIZE) : "memory");
+    }
+}
+
 void init_timer_interrupt() {
     serial_print("Timer interrupt setup...\n");
     
@@ -360,8 +493,10 @@ void init_interrupt_controller() {
 #define SYS_WRITE   4
 #define SYS_GETPID  20
 
+uint32_t get_current_pid(void);
+
 // Syscall handler
-uint32_t syscall_handler(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint32_t arg3) {
+uint32_t syscall_handler(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4) {
     (void)arg1; // Suppress unused warning for now
     (void)arg2; // Suppress unused warning for now
     
@@ -387,6 +522,10 @@ uint32_t syscall_handler(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uin
             return 1; // Dummy PID
         
         default:
+            if (syscall_num >= SYS_SAL_BASE && syscall_num < SYS_SAL_LAST) {
+                return (uint32_t)sal_syscall(get_current_pid(), syscall_num,
+                                             arg1, arg2, arg3, arg4);
+            }
             serial_print("Unknown syscall: ");
             // Simple number output
             char num[10];
@@ -413,11 +552,14 @@ uint32_t syscall_handler(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uin
     }
 }
 
+// Register-to-stack entry stub for int 0x80 (boot.S)
+extern void syscall_entry();
+
 void init_syscall_handler() {
     serial_print("Syscall handler setup...\n");
     
     // Set up syscall interrupt (int 0x80)
-    idt_set_gate(0x80, (uint32_t)syscall_handler, 0x08, 0xEE); // User-accessible
+    idt_set_gate(0x80, (uint32_t)syscall_entry, 0x08, 0xEE); // User-accessible
     
     serial_print("Syscall handler registered at interrupt 0x80\n");
 }
@@ -439,6 +581,8 @@ struct Process {
     uint32_t ebp;     // Base pointer
     uint32_t eip;     // Instruction pointer
     uint32_t page_dir; // Page directory
+    uint32_t priority; // SAL_PRIO_* of the most urgent queued message
+    uint32_t rt_misses; // Deadline misses already reported
     struct Process* next;
 };
 
@@ -498,14 +642,88 @@ void create_idle_thread() {
 static struct Process processes[16];
 static int process_count = 0;
 
-void create_user_process(const char* name) {
+// PID of the process that trapped into the kernel (0 for kernel context)
+uint32_t get_current_pid(void) {
+    return current_process ? current_process->pid : 0;
+}
+
+// Look up a live user process by PID
+static struct Process* find_process(uint32_t pid) {
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].pid == pid && processes[i].state != PROCESS_TERMINATED) {
+            return &processes[i];
+        }
+    }
+    return NULL;
+}
+
+// SAL hooks: PID 0 is the kernel itself, other PIDs must be live processes
+int sal_arch_pid_valid(uint32_t pid) {
+    return pid == 0 || find_process(pid) != NULL;
+}
+
+// Called with the SAL lock held. There is no context switch out of a
+// syscall yet, so sleeping degrades to an early return and callers
+// re-check their wait condition.
+void sal_arch_sleep(uint32_t pid) {
+    (void)pid;
+    asm volatile ("pause");
+}
+
+void sal_arch_wake(uint32_t pid) {
+    struct Process* proc = find_process(pid);
+    if (proc != NULL && proc->state == PROCESS_BLOCKED) {
+        proc->state = PROCESS_READY;
+    }
+}
+
+uint32_t sal_arch_ticks(void) {
+    return timer_ticks;
+}
+
+// Time base for SAL latency histograms
+uint64_t sal_arch_cycles(void) {
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Uniprocessor for now; SAL_MAX_CPUS is 1
+uint32_t sal_arch_cpu(void) {
+    return 0;
+}
+
+// A process inherits the class of the most urgent message in its
+// mailbox, so an auth decision is not left queued behind bulk telemetry
+void sal_arch_set_priority(uint32_t pid, uint32_t priority) {
+    struct Process* proc = find_process(pid);
+    if (proc != NULL) {
+        proc->priority = priority;
+    }
+}
+
+// SAL critical sections disable interrupts and restore the previous state
+uint32_t sal_arch_lock(void) {
+    uint32_t flags;
+    asm volatile ("pushf; pop %0; cli" : "=r"(flags) :: "memory");
+    return flags;
+}
+
+void sal_arch_unlock(uint32_t flags) {
+    if (flags & 0x200) {
+        asm volatile ("sti" ::: "memory");
+    }
+}
+
+// Returns the new PID, or 0 if the process table is full
+uint32_t create_user_process(const char* name) {
     serial_print("Creating user process: ");
     serial_print(name);
     serial_print("\n");
     
     if (process_count >= 16) {
         serial_print("ERROR: Too many processes\n");
-        return;
+        return 0;
     }
     
     struct Process* proc = &processes[process_count++];
@@ -520,6 +738,8 @@ void create_user_process(const char* name) {
     proc->name[i] = '\0';
     
     proc->state = PROCESS_READY;
+    proc->priority = 0;
+    proc->rt_misses = 0;
     proc->page_dir = (uint32_t)page_directory; // Share kernel page directory for now
     proc->next = NULL;
     
@@ -565,19 +785,57 @@ void create_user_process(const char* name) {
     pid_str[j] = '\0';
     serial_print(pid_str);
     serial_print("\n");
+    return proc->pid;
+}
+
+// Print new deadline misses of real-time processes (see sal_rt.c)
+static void report_deadline_misses() {
+    for (int i = 0; i < process_count; i++) {
+        struct sal_rt_stats st;
+        if (sys_sal_rt_stats(0, (int)processes[i].pid, &st) != SAL_OK || st.misses == processes[i].rt_misses) {
+            continue;
+        }
+        processes[i].rt_misses = st.misses;
+        serial_print("Deadline miss: ");
+        serial_print(processes[i].name);
+        serial_print("\n");
+    }
+}
+
+// Ready processes as a PID bitmask for the real-time class
+static uint32_t runnable_pids() {
+    uint32_t mask = 0;
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].state == PROCESS_READY || processes[i].state == PROCESS_RUNNING) {
+            mask |= 1u << processes[i].pid;
+        }
+    }
+    return mask;
 }
 
 void schedule() {
-    // Simple round-robin scheduler
+    // Real-time jobs first, earliest deadline first; then round-robin
+    // among the ready processes of the highest priority
+    report_deadline_misses();
     if (process_list == NULL) {
         // No processes, just halt
         asm volatile ("hlt");
         return;
     }
     
-    // Find next ready process
     struct Process* next = NULL;
+    int rt = sal_rt_pick(runnable_pids());
+    if (rt > 0) {
+        next = find_process((uint32_t)rt);
+        if (next != NULL) {
+            current_process = next;
+            current_process->state = PROCESS_RUNNING;
+            asm volatile ("hlt");
+            return;
+        }
+    }
     
+    // Find next ready process
     if (current_process == NULL) {
         // Start with first process
         next = process_list;
@@ -589,19 +847,21 @@ void schedule() {
         }
     }
     
-    // Find a ready process
+    // Find the first ready process of the highest priority, in turn order
     struct Process* start = next;
-    while (next != NULL && next->state != PROCESS_READY) {
+    struct Process* best = NULL;
+    do {
+        if (next->state == PROCESS_READY && (best == NULL || next->priority > best->priority)) {
+            best = next;
+        }
         next = next->next;
         if (next == NULL) {
             next = process_list; // Wrap around
         }
-        if (next == start) {
-            break; // Avoid infinite loop
-        }
-    }
+    } while (next != start);
+    next = best;
     
-    if (next == NULL || next->state != PROCESS_READY) {
+    if (next == NULL) {
         // No ready process found, halt
         asm volatile ("hlt");
         return;
@@ -635,7 +895,15 @@ void* kmalloc(size_t size) {
     return ptr;
 }
 
+#ifdef SAL_BENCH
+// Benchmarks from test/sal_benchmark.c and test/dsp_benchmark.c
+void run_sal_benchmarks(void);
+void run_dsp_benchmarks(void);
+#endif
+
 // Authentication gating logic
+static int auth_endpoint = SAL_NO_HANDLE;
+
 void wait_for_auth() {
     struct AuthMsg msg;
     serial_print("Waiting for biometric authentication...\n");
@@ -650,14 +918,16 @@ void wait_for_auth() {
         msg.security_token[i] = 0;
     }
     
+    // Room for newer, longer versions of the message
+    static uint8_t wire[SAL_MAX_MESSAGE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
     while (1) {
-        // TODO: Replace with actual SAL implementation
-        // if (sal_recv(AUTH_CHANNEL, &msg, sizeof(msg)) == sizeof(msg)) {
-        //     if (msg.type == AUTH_SUCCESS) {
-        //         serial_print("Authentication successful!\n");
-        //         break;
-        //     }
-        // }
+        long len = sys_sal_handle_recv(0, auth_endpoint, wire, sizeof(wire), NULL);
+        if (len > 0 && auth_msg_decode(wire, (size_t)len, &msg) > 0) {
+            if (msg.type == AUTH_SUCCESS) {
+                serial_print("Authentication successful!\n");
+                break;
+            }
+        }
         
         // Temporary: simulate authentication after some time
         static int counter = 0;
@@ -684,10 +954,26 @@ void kernel_init() {
     init_syscall_handler();
     init_scheduler();
     
-    // Launch initial user process (init/manager)
     create_idle_thread();
+    
+#ifdef SAL_BENCH
+    // Benchmark image (make BENCH=1): the workers take every process slot
+    run_sal_benchmarks();
+    run_dsp_benchmarks();
+    serial_print("bench=done\n");
+    while (1) {
+        asm volatile ("hlt");
+    }
+#endif
+    
+    // Launch initial user process (init/manager)
     create_user_process("init");
     
+    // The auth service reports to this endpoint by name; its results go
+    // ahead of anything else queued for the kernel
+    auth_endpoint = (int)sys_sal_endpoint_create(0, AUTH_ENDPOINT);
+    sys_sal_endpoint_priority(0, auth_endpoint, SAL_PRIO_URGENT);
+    
     // Start biometric auth service
     create_user_process("auth_service");
     
@@ -705,10 +991,75 @@ void kernel_init() {
     }
 }
 
+// Multiboot2 boot modules (see include/boot.h)
+#define MB2_TAG_END     0
+#define MB2_TAG_MODULE  3
+
+static struct boot_module boot_modules[BOOT_MAX_MODULES];
+static int boot_module_count = 0;
+
+// The information structure is a size, a reserved word, then 8-byte
+// aligned tags of { type, size, ... }
+int boot_modules_init(uint32_t mbi_addr) {
+    const uint8_t *mbi = (const uint8_t *)(uintptr_t)mbi_addr;
+    uint32_t total = *(const uint32_t *)mbi;
+    uint32_t at = 8;
+    while (at + 8 <= total) {
+        const uint32_t *tag = (const uint32_t *)(mbi + at);
+        if (tag[0] == MB2_TAG_END || tag[1] < 8) break;
+        if (tag[0] == MB2_TAG_MODULE && tag[1] >= 16) {
+            uint32_t start = tag[2], end = tag[3];
+            const char *cmdline = (const char *)&tag[4];
+            if (end <= start || end > BOOT_MAPPED_LIMIT) {
+                serial_print("Boot module outside the mapped range, skipped: ");
+                serial_print(cmdline);
+                serial_print("\n");
+            } else if (boot_module_count < BOOT_MAX_MODULES) {
+                struct boot_module *m = &boot_modules[boot_module_count++];
+                m->data = (const uint8_t *)(uintptr_t)start;
+                m->size = end - start;
+                uint32_t i;
+                for (i = 0; i + 1 < BOOT_CMDLINE_MAX && cmdline[i] != '\0'; i++) m->cmdline[i] = cmdline[i];
+                m->cmdline[i] = '\0';
+                serial_print("Boot module: ");
+                serial_print(m->cmdline);
+                serial_print("\n");
+            }
+        }
+        at += (tag[1] + 7) & ~7u;
+    }
+    return boot_module_count;
+}
+
+const struct boot_module *boot_module_find(const char *name) {
+    for (int i = 0; i < boot_module_count; i++) {
+        const char *c = boot_modules[i].cmdline;
+        int j = 0;
+        while (name[j] != '\0' && c[j] == name[j]) j++;
+        if (name[j] == '\0' && (c[j] == '\0' || c[j] == ' ')) return &boot_modules[i];
+    }
+    return NULL;
+}
+
+// Decimal value of " key=" in the command line, or fallback
+uint32_t boot_module_arg(const struct boot_module *m, const char *key, uint32_t fallback) {
+    const char *c = m->cmdline;
+    while (*c != '\0') {
+        while (*c == ' ') c++;
+        int j = 0;
+        while (key[j] != '\0' && c[j] == key[j]) j++;
+        if (key[j] == '\0' && c[j] == '=' && c[j + 1] >= '0' && c[j + 1] <= '9') {
+            uint32_t v = 0;
+            for (c += j + 1; *c >= '0' && *c <= '9'; c++) v = v * 10 + (uint32_t)(*c - '0');
+            return v;
+        }
+        while (*c != '\0' && *c != ' ') c++;
+    }
+    return fallback;
+}
+
 // Kernel entry point called from assembly
 void kernel_main(uint32_t magic, uint32_t multiboot_addr) {
-    (void)multiboot_addr; // Suppress unused warning for now
-    
     // Initialize serial for early debug output
     init_serial();
     
@@ -731,6 +1082,10 @@ void kernel_main(uint32_t magic, uint32_t multiboot_addr) {
     
     serial_print("Multiboot2 magic verified\n");
     
+    // Sensor recordings and other modules, read while memory is still
+    // accessed physically
+    boot_modules_init(multiboot_addr);
+    
     // Disable interrupts initially
     asm volatile ("cli");
     serial_print("Interrupts disabled\n");
@@ -748,6 +1103,12 @@ void kernel_main(uint32_t magic, uint32_t multiboot_addr) {
     enable_paging();
     serial_print("Paging setup complete\n");
     
+    if (enable_sse() != 0) {
+        serial_print("ERROR: CPU lacks SSE2, required by the DSP modules\n");
+        while (1) asm volatile ("hlt");
+    }
+    serial_print("SSE enabled\n");
+    
     serial_print("Initializing timer...\n");
     init_timer_interrupt();
     serial_print("Timer initialized\n");
@@ -0,0 +1,128 @@
+#define _GNU_SOURCE
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/sal/sal_host.h"
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// Simulated kernel for the host build. One mutex stands in for
+// interrupts-off, sleeping waits on a per-PID futex word that wakes bump,
+// and a thread drives the event port timers like the PIT interrupt does.
+static pthread_mutex_t sal_host_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t sal_host_wake_seq[SAL_MAX_PROCS];
+static uint32_t sal_host_priority[SAL_MAX_PROCS];
+static volatile uint32_t sal_host_ticks;
+static volatile int sal_host_running;
+static pthread_t sal_host_ticker;
+static __thread uint32_t sal_host_self;
+
+static long sal_host_futex(uint32_t *addr, int op, uint32_t val, const struct timespec *timeout) {
+    return syscall(SYS_futex, addr, op, val, timeout, NULL, 0);
+}
+
+static void *sal_host_tick_main(void *arg) {
+    (void)arg;
+    struct timespec period = { 0, SAL_HOST_TICK_US * 1000L };
+    while (__atomic_load_n(&sal_host_running, __ATOMIC_RELAXED)) {
+        nanosleep(&period, NULL);
+        sal_port_tick(__atomic_add_fetch(&sal_host_ticks, 1, __ATOMIC_RELAXED));
+    }
+    return NULL;
+}
+
+void sal_host_init(void) {
+    if (sal_host_running) return;
+    sal_host_running = 1;
+    pthread_create(&sal_host_ticker, NULL, sal_host_tick_main, NULL);
+}
+
+void sal_host_shutdown(void) {
+    if (!sal_host_running) return;
+    __atomic_store_n(&sal_host_running, 0, __ATOMIC_RELAXED);
+    pthread_join(sal_host_ticker, NULL);
+}
+
+void sal_host_attach(uint32_t pid) {
+    sal_host_self = pid;
+}
+
+uint32_t sal_host_pid(void) {
+    return sal_host_self;
+}
+
+// Architecture hooks (see the kernel versions in src/kernel/kernel.c)
+uint32_t sal_arch_lock(void) {
+    pthread_mutex_lock(&sal_host_lock);
+    return 0;
+}
+
+void sal_arch_unlock(uint32_t flags) {
+    (void)flags;
+    pthread_mutex_unlock(&sal_host_lock);
+}
+
+int sal_arch_pid_valid(uint32_t pid) {
+    return pid < SAL_MAX_PROCS;
+}
+
+// One address space: physical and virtual addresses are the same, so
+// every buffer resolves to a single extent and maps onto itself
+int sal_arch_virt_to_phys(const void *vaddr, uintptr_t *phys) {
+    *phys = (uintptr_t)vaddr;
+    return 0;
+}
+
+void *sal_arch_map_extents(const struct sal_extent *ext, uint32_t nextents, int writable) {
+    (void)writable;
+    return nextents == 1 ? (void *)ext[0].phys : NULL;
+}
+
+void sal_arch_unmap(void *vaddr, uint32_t npages) {
+    (void)vaddr;
+    (void)npages;
+}
+
+// Called with the lock held. Unlike the kernel this really blocks, for up
+// to one tick; callers still re-check their condition on return.
+void sal_arch_sleep(uint32_t pid) {
+    if (pid >= SAL_MAX_PROCS) return;
+    uint32_t seq = __atomic_load_n(&sal_host_wake_seq[pid], __ATOMIC_ACQUIRE);
+    struct timespec timeout = { 0, SAL_HOST_TICK_US * 1000L };
+    pthread_mutex_unlock(&sal_host_lock);
+    sal_host_futex(&sal_host_wake_seq[pid], FUTEX_WAIT_PRIVATE, seq, &timeout);
+    pthread_mutex_lock(&sal_host_lock);
+}
+
+void sal_arch_wake(uint32_t pid) {
+    if (pid >= SAL_MAX_PROCS) return;
+    __atomic_add_fetch(&sal_host_wake_seq[pid], 1, __ATOMIC_RELEASE);
+    sal_host_futex(&sal_host_wake_seq[pid], FUTEX_WAKE_PRIVATE, INT_MAX, NULL);
+}
+
+uint32_t sal_arch_ticks(void) {
+    return __atomic_load_n(&sal_host_ticks, __ATOMIC_RELAXED);
+}
+
+uint64_t sal_arch_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+uint32_t sal_arch_cpu(void) {
+    return 0;
+}
+
+// Host threads are scheduled by Linux; the class is only recorded
+void sal_arch_set_priority(uint32_t pid, uint32_t priority) {
+    if (pid < SAL_MAX_PROCS) sal_host_priority[pid] = priority;
+}
@@ -1,22 +1,29 @@
 #include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/klib.h"
 #include <stdint.h>
 
-// Syscall numbers
-enum Syscalls {
-    SYS_SAL_SEND = 1,
-    SYS_SAL_RECV = 2,
-    SYS_SAL_PUBLISH = 3,
-    SYS_SAL_SUBSCRIBE = 4,
-};
+#ifdef SAL_HOST
+#include "../include/sal/sal_host.h"
 
-// System call wrapper functions
+// Host build: the simulated kernel runs in-process, so a trap is a call
+static inline long syscall3(long num, long arg1, long arg2, long arg3) {
+    return sal_syscall(sal_host_pid(), num, arg1, arg2, arg3, 0);
+}
+
+static inline long syscall4(long num, long arg1, long arg2, long arg3, long arg4) {
+    return sal_syscall(sal_host_pid(), num, arg1, arg2, arg3, arg4);
+}
+#else
+// System call wrapper functions. Arguments go in edi, esi, edx, ecx and
+// the syscall number in eax.
 static inline long syscall3(long num, long arg1, long arg2, long arg3) {
     long ret;
     asm volatile(
-        "movl %1, %%edi; movl %2, %%esi; movl %3, %%edx; movl %4, %%eax; int $0x80"
-        : "=a"(ret) 
-        : "r"(arg1), "r"(arg2), "r"(arg3), "i"(num)
-        : "edi", "esi", "edx", "memory"
+        "int $0x80"
+        : "=a"(ret)
+        : "a"(num), "D"(arg1), "S"(arg2), "d"(arg3)
+        : "memory"
     );
     return ret;
 }
@@ -24,13 +31,14 @@ static inline long syscall3(long num, long arg1, long arg2, long arg3) {
 static inline long syscall4(long num, long arg1, long arg2, long arg3, long arg4) {
     long ret;
     asm volatile(
-        "movl %1, %%edi; movl %2, %%esi; movl %3, %%edx; movl %4, %%ecx; movl %5, %%eax; int $0x80"
-        : "=a"(ret) 
-        : "r"(arg1), "r"(arg2), "r"(arg3), "r"(arg4), "i"(num)
-        : "edi", "esi", "edx", "ecx", "memory"
+        "int $0x80"
+        : "=a"(ret)
+        : "a"(num), "D"(arg1), "S"(arg2), "d"(arg3), "c"(arg4)
+        : "memory"
     );
     return ret;
 }
+#endif
 
 // SAL API implementation
 int sal_send(int dest_pid, const void *msg, size_t len) {
@@ -41,41 +49,502 @@ int sal_recv(int src_pid, void *buf, size_t maxlen) {
     return (int)syscall3(SYS_SAL_RECV, src_pid, (long)buf, maxlen);
 }
 
+int sal_send_attr(int dest_pid, const void *msg, size_t len, const struct sal_msg_attr *attr) {
+    return (int)syscall4(SYS_SAL_SEND_ATTR, dest_pid, (long)msg, len, (long)attr);
+}
+
+uint32_t sal_ticks(void) {
+    return (uint32_t)syscall3(SYS_SAL_TICKS, 0, 0, 0);
+}
+
+int sal_sendv(int dest_pid, const struct sal_iovec *iov, int iovcnt) {
+    return (int)syscall3(SYS_SAL_SENDV, dest_pid, (long)iov, iovcnt);
+}
+
+int sal_recv_many(int src_pid, struct sal_mmsg *msgs, int n) {
+    return (int)syscall3(SYS_SAL_RECV_MANY, src_pid, (long)msgs, n);
+}
+
+// Convenience form: interns the name on every call. Long-running
+// publishers should intern once and use sal_publish_id().
 int sal_publish(const char *topic, const void *data, size_t len) {
-    // For now, implement as a special send to a broker process
-    // TODO: Implement proper pub/sub mechanism
-    return (int)syscall3(SYS_SAL_PUBLISH, (long)topic, (long)data, len);
+    int id = sal_topic_id(topic);
+    if (id < 0) return id;
+    return sal_publish_id(id, data, len);
+}
+
+int sal_topic_id(const char *topic) {
+    return (int)syscall3(SYS_SAL_TOPIC_INTERN, (long)topic, 0, 0);
+}
+
+// Credit topics make the kernel refuse a publish until a subscriber
+// frees a slot; keep trying so the publisher blocks as intended
+int sal_publish_id(int topic_id, const void *data, size_t len) {
+    int ret;
+    do {
+        ret = (int)syscall3(SYS_SAL_PUBLISH, topic_id, (long)data, len);
+    } while (ret == SAL_ERR_AGAIN);
+    return ret;
+}
+
+int sal_topic_policy(int topic_id, uint32_t policy, uint32_t param) {
+    return (int)syscall3(SYS_SAL_TOPIC_POLICY, topic_id, policy, param);
+}
+
+int sal_stats(uint32_t kind, int id, struct sal_queue_stats *stats) {
+    return (int)syscall3(SYS_SAL_STATS, kind, id, (long)stats);
+}
+
+int sal_topic_stats(int topic_id, struct sal_topic_stats *stats) {
+    return (int)syscall3(SYS_SAL_TOPIC_STATS, topic_id, (long)stats, 0);
+}
+
+int sal_rt_admit(const struct sal_rt_params *params) {
+    return (int)syscall3(SYS_SAL_RT_ADMIT, (long)params, 0, 0);
+}
+
+int sal_rt_leave(void) {
+    return (int)syscall3(SYS_SAL_RT_LEAVE, 0, 0, 0);
+}
+
+int sal_rt_stats(int pid, struct sal_rt_stats *stats) {
+    return (int)syscall3(SYS_SAL_RT_STATS, pid, (long)stats, 0);
+}
+
+int sal_topic_retain(int topic_id, uint32_t depth) {
+    return (int)syscall3(SYS_SAL_TOPIC_RETAIN, topic_id, depth, 0);
+}
+
+int sal_topic_history(int topic_id, struct sal_mmsg *msgs, int n) {
+    return (int)syscall3(SYS_SAL_TOPIC_HISTORY, topic_id, (long)msgs, n);
+}
+
+int sal_topic_seek(int topic_id, uint32_t back) {
+    return (int)syscall3(SYS_SAL_TOPIC_SEEK, topic_id, back, 0);
+}
+
+int sal_publish_batch(const struct sal_pub_entry *entries, int n) {
+    return (int)syscall3(SYS_SAL_PUBLISH_BATCH, (long)entries, n, 0);
+}
+
+int sal_subscribe_id(int topic_id) {
+    return (int)syscall3(SYS_SAL_SUBSCRIBE, topic_id, 0, 0);
+}
+
+int sal_unsubscribe(int topic_id) {
+    return (int)syscall3(SYS_SAL_UNSUBSCRIBE, topic_id, 0, 0);
+}
+
+int sal_topic_recv(int topic_id, int *topic_out, void *buf, size_t maxlen) {
+    return (int)syscall4(SYS_SAL_TOPIC_RECV, topic_id, (long)topic_out, (long)buf, maxlen);
+}
+
+int sal_topic_recv_many(int topic_id, struct sal_mmsg *msgs, int n) {
+    return (int)syscall3(SYS_SAL_TOPIC_RECV_MANY, topic_id, (long)msgs, n);
+}
+
+int sal_grant(int dest_pid, void *buf, size_t len, uint32_t flags) {
+    return (int)syscall4(SYS_SAL_GRANT, dest_pid, (long)buf, len, flags);
+}
+
+void *sal_grant_map(int grant_id, size_t *len) {
+    void *addr = NULL;
+    if (syscall3(SYS_SAL_GRANT_MAP, grant_id, (long)&addr, (long)len) < 0) {
+        return NULL;
+    }
+    return addr;
+}
+
+int sal_grant_unmap(int grant_id) {
+    return (int)syscall3(SYS_SAL_GRANT_UNMAP, grant_id, 0, 0);
+}
+
+int sal_grant_revoke(int grant_id) {
+    return (int)syscall3(SYS_SAL_GRANT_REVOKE, grant_id, 0, 0);
+}
+
+struct sal_ring *sal_channel_open(const char *name, uint32_t flags, uint32_t slot_size, uint32_t nslots) {
+    long ret = syscall4(SYS_SAL_CHANNEL_OPEN, (long)name, flags, slot_size, nslots);
+    return ret < 0 ? NULL : (struct sal_ring *)ret;
+}
+
+int sal_channel_close(struct sal_ring *ring) {
+    return (int)syscall3(SYS_SAL_CHANNEL_CLOSE, (long)ring, 0, 0);
+}
+
+int sal_futex_wait(volatile uint32_t *addr, uint32_t expected) {
+    return (int)syscall3(SYS_SAL_FUTEX_WAIT, (long)addr, expected, 0);
 }
 
-int sal_subscribe(const char *topic, void (*callback)(const void*, size_t)) {
-    // Register callback for topic
-    // TODO: Implement proper subscription mechanism
-    return (int)syscall3(SYS_SAL_SUBSCRIBE, (long)topic, (long)callback, 0);
+int sal_futex_wake(volatile uint32_t *addr, uint32_t count) {
+    return (int)syscall3(SYS_SAL_FUTEX_WAKE, (long)addr, count, 0);
 }
 
-// Kernel-side syscall implementations (stubs for now)
-long sys_sal_send(int dest_pid, const void *buf, size_t size) {
-    // TODO: Kernel logic to enqueue message to dest_pid's queue
-    // For now, just return success
-    (void)dest_pid; (void)buf; (void)size;
-    return 0;
+int sal_port_create(void) {
+    return (int)syscall3(SYS_SAL_PORT_CREATE, 0, 0, 0);
 }
 
-long sys_sal_recv(int src_pid, void *buf, size_t maxlen) {
-    // TODO: Kernel logic to dequeue message from src_pid
-    // If blocking, put this thread to sleep until a message arrives
-    (void)src_pid; (void)buf; (void)maxlen;
-    return 0;
+int sal_port_close(int port) {
+    return (int)syscall3(SYS_SAL_PORT_CLOSE, port, 0, 0);
 }
 
-long sys_sal_publish(const char *topic, const void *data, size_t len) {
-    // TODO: Broadcast data to all subscribers of topic
-    (void)topic; (void)data; (void)len;
-    return 0;
+int sal_port_ctl(int port, int op, const struct sal_watch *watch) {
+    return (int)syscall3(SYS_SAL_PORT_CTL, port, op, (long)watch);
+}
+
+int sal_endpoint_create(const char *name) {
+    return (int)syscall3(SYS_SAL_ENDPOINT_CREATE, (long)name, 0, 0);
+}
+
+int sal_endpoint_open(const char *name) {
+    return (int)syscall3(SYS_SAL_ENDPOINT_OPEN, (long)name, 0, 0);
+}
+
+int sal_handle_send(int handle, const void *msg, size_t len, int xfer) {
+    return (int)syscall4(SYS_SAL_HANDLE_SEND, handle, (long)msg, len, xfer);
+}
+
+int sal_handle_recv(int handle, void *buf, size_t maxlen, int *xfer_out) {
+    return (int)syscall4(SYS_SAL_HANDLE_RECV, handle, (long)buf, maxlen, (long)xfer_out);
+}
+
+int sal_handle_dup(int handle, uint32_t rights) {
+    return (int)syscall3(SYS_SAL_HANDLE_DUP, handle, rights, 0);
+}
+
+int sal_handle_close(int handle) {
+    return (int)syscall3(SYS_SAL_HANDLE_CLOSE, handle, 0, 0);
+}
+
+int sal_endpoint_priority(int handle, uint32_t priority) {
+    return (int)syscall3(SYS_SAL_ENDPOINT_PRIORITY, handle, priority, 0);
+}
+
+// The kernel may end a sleep early; go back in until there is an event
+// or the timeout it armed on the first call has expired
+int sal_wait(int port, struct sal_event *events, int max, uint32_t timeout_ticks) {
+    int ret;
+    do {
+        ret = (int)syscall4(SYS_SAL_WAIT, port, (long)events, max, (long)timeout_ticks);
+    } while (ret == SAL_ERR_AGAIN);
+    return ret;
+}
+
+// Kernel-side mailboxes, indexed by PID
+static struct sal_mailbox sal_mailboxes[SAL_MAX_PROCS];
+
+struct sal_mailbox *sal_mailbox_get(int pid) {
+    if (pid < 0 || pid >= SAL_MAX_PROCS || !sal_arch_pid_valid((uint32_t)pid)) {
+        return NULL;
+    }
+    return &sal_mailboxes[pid];
+}
+
+// Does message a go ahead of b? Higher priority first; within a class a
+// deadline beats none and an earlier deadline beats a later one
+// (compared as a signed distance so tick wraparound is harmless). Ties
+// keep arrival order.
+static int sal_msg_before(const struct sal_message *a, const struct sal_message *b) {
+    if (a->priority != b->priority) return a->priority > b->priority;
+    if (a->deadline == 0) return 0;
+    return b->deadline == 0 || (int32_t)(a->deadline - b->deadline) < 0;
+}
+
+// Tell the scheduler when the most urgent pending message changes class
+static void sal_mailbox_reprioritize(struct sal_mailbox *mb, uint32_t pid) {
+    uint32_t prio = mb->count > 0 ? mb->slots[mb->order[0]].hdr.priority : SAL_PRIO_BULK;
+    if (prio != mb->priority) {
+        mb->priority = prio;
+        sal_arch_set_priority(pid, prio);
+    }
+}
+
+// Queue one message gathered from iov. hdr supplies sender, destination,
+// priority, deadline and the total length, which the caller has
+// validated. endpoint tags messages sent through a handle and xfer
+// carries a handle in flight (0 for neither). Called with the SAL lock
+// held.
+long sal_mailbox_put(struct sal_mailbox *mb, const struct sal_message *hdr, uint32_t endpoint,
+                     uint32_t xfer, const struct sal_iovec *iov, int iovcnt) {
+    if (hdr->priority >= SAL_NUM_PRIOS) return SAL_ERR_INVAL;
+    if (mb->count >= SAL_MAILBOX_DEPTH) {
+        mb->stats[sal_arch_cpu()].drops++;
+        return SAL_ERR_FULL;
+    }
+
+    // Take the lowest free slot and insert it by delivery order. The queue
+    // is at most SAL_MAILBOX_DEPTH long, so a shifting insert is cheap.
+    uint32_t free_slots = ~mb->used_mask & ((1u << SAL_MAILBOX_DEPTH) - 1);
+    int slot = __builtin_ctz(free_slots);
+    mb->used_mask |= 1u << slot;
+
+    struct sal_mbox_slot *s = &mb->slots[slot];
+    s->hdr = *hdr;
+    s->hdr.msg_type = 0;
+    s->endpoint = endpoint;
+    s->xfer = xfer;
+    s->stamp = sal_arch_cycles();
+
+    uint32_t pos = mb->count;
+    while (pos > 0 && sal_msg_before(&s->hdr, &mb->slots[mb->order[pos - 1]].hdr)) {
+        mb->order[pos] = mb->order[pos - 1];
+        pos--;
+    }
+    mb->order[pos] = (uint8_t)slot;
+    mb->count++;
+    sal_stats_enqueue(&mb->stats[sal_arch_cpu()], hdr->length, mb->count);
+
+    uint8_t *dst = s->data;
+    for (int i = 0; i < iovcnt; i++) {
+        memcpy(dst, iov[i].base, iov[i].len);
+        dst += iov[i].len;
+    }
+    sal_mailbox_reprioritize(mb, hdr->dest_pid);
+    sal_port_notify(SAL_EV_MAILBOX, hdr->dest_pid);
+    return (long)hdr->length;
+}
+
+// Remove the first message in delivery order from src_pid (or anyone for SAL_ANY_PID)
+// into buf, optionally only one sent to endpoint. A handle carried by the
+// message is passed out through xfer, or released if xfer is NULL.
+// Called with the SAL lock held.
+long sal_mailbox_take(struct sal_mailbox *mb, int src_pid, uint32_t endpoint, void *buf, size_t maxlen,
+                      uint32_t *sender, uint32_t *xfer) {
+    uint32_t pos;
+    for (pos = 0; pos < mb->count; pos++) {
+        struct sal_mbox_slot *s = &mb->slots[mb->order[pos]];
+        if (endpoint != 0 && s->endpoint != endpoint) continue;
+        if (src_pid == SAL_ANY_PID || s->hdr.sender_pid == (uint32_t)src_pid) break;
+    }
+    if (pos == mb->count) return SAL_ERR_AGAIN;
+
+    int slot = mb->order[pos];
+    struct sal_mbox_slot *s = &mb->slots[slot];
+    if (s->hdr.length > maxlen) return SAL_ERR_TOOBIG;
+
+    long len = s->hdr.length;
+    memcpy(buf, s->data, len);
+    sal_stats_dequeue(&mb->stats[sal_arch_cpu()], s->stamp);
+    if (sender != NULL) *sender = s->hdr.sender_pid;
+    if (xfer != NULL) {
+        *xfer = s->xfer;
+    } else if (s->xfer != 0) {
+        sal_handle_xfer_drop(s->xfer);
+    }
+
+    uint32_t pid = s->hdr.dest_pid;
+    for (; pos + 1 < mb->count; pos++) {
+        mb->order[pos] = mb->order[pos + 1];
+    }
+    mb->count--;
+    mb->used_mask &= ~(1u << slot);
+    sal_mailbox_reprioritize(mb, pid);
+    return len;
+}
+
+// Drop every message sent to endpoint, releasing the handles they carry,
+// counted as drops. Called with the SAL lock held when the endpoint's
+// last receiver goes, so a reused endpoint never delivers old messages
+// to its next owner.
+void sal_mailbox_flush(struct sal_mailbox *mb, uint32_t endpoint) {
+    uint32_t kept = 0;
+    for (uint32_t pos = 0; pos < mb->count; pos++) {
+        int slot = mb->order[pos];
+        struct sal_mbox_slot *s = &mb->slots[slot];
+        if (s->endpoint != endpoint) {
+            mb->order[kept++] = (uint8_t)slot;
+            continue;
+        }
+        if (s->xfer != 0) sal_handle_xfer_drop(s->xfer);
+        mb->used_mask &= ~(1u << slot);
+        mb->stats[sal_arch_cpu()].drops++;
+    }
+    if (kept == mb->count) return;
+    mb->count = kept;
+    sal_mailbox_reprioritize(mb, (uint32_t)(mb - sal_mailboxes));
+}
+
+// Event port level check (lock held)
+int sal_mailbox_pending(uint32_t pid) {
+    return pid < SAL_MAX_PROCS && sal_mailboxes[pid].count > 0;
+}
+
+// Kernel-side syscall implementations
+long sys_sal_send(uint32_t caller, int dest_pid, const void *buf, size_t size) {
+    struct sal_iovec iov = { buf, size };
+    return sys_sal_sendv(caller, dest_pid, &iov, 1);
+}
+
+// Gather iov into a single message with the given delivery attributes
+static long sal_sendv_attr(uint32_t caller, int dest_pid, const struct sal_iovec *iov, int iovcnt,
+                           uint32_t priority, uint32_t deadline) {
+    if (iov == NULL || iovcnt <= 0 || iovcnt > SAL_MAX_IOV) return SAL_ERR_INVAL;
+
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].base == NULL && iov[i].len != 0) return SAL_ERR_INVAL;
+        total += iov[i].len;
+        if (total > SAL_MAX_MESSAGE_SIZE) return SAL_ERR_TOOBIG;
+    }
+
+    struct sal_mailbox *mb = sal_mailbox_get(dest_pid);
+    if (mb == NULL) return SAL_ERR_NOPROC;
+
+    struct sal_message hdr = {
+        .sender_pid = caller,
+        .dest_pid = (uint32_t)dest_pid,
+        .length = (uint32_t)total,
+        .priority = priority,
+        .deadline = deadline,
+    };
+    uint32_t flags = sal_arch_lock();
+    long ret = sal_mailbox_put(mb, &hdr, 0, 0, iov, iovcnt);
+    sal_arch_unlock(flags);
+    return ret;
+}
+
+long sys_sal_sendv(uint32_t caller, int dest_pid, const struct sal_iovec *iov, int iovcnt) {
+    return sal_sendv_attr(caller, dest_pid, iov, iovcnt, SAL_PRIO_NORMAL, 0);
+}
+
+// sys_sal_send with an explicit class and deadline; attr NULL is the default
+long sys_sal_send_attr(uint32_t caller, int dest_pid, const void *buf, size_t size,
+                       const struct sal_msg_attr *attr) {
+    struct sal_iovec iov = { buf, size };
+    if (attr == NULL) return sal_sendv_attr(caller, dest_pid, &iov, 1, SAL_PRIO_NORMAL, 0);
+    if (attr->priority >= SAL_NUM_PRIOS) return SAL_ERR_INVAL;
+    return sal_sendv_attr(caller, dest_pid, &iov, 1, attr->priority, attr->deadline);
+}
+
+// Current tick count, the time base for message deadlines
+long sys_sal_ticks(uint32_t caller) {
+    (void)caller;
+    return (long)sal_arch_ticks();
+}
+
+long sys_sal_recv(uint32_t caller, int src_pid, void *buf, size_t maxlen) {
+    struct sal_mailbox *mb = sal_mailbox_get((int)caller);
+    if (mb == NULL) return SAL_ERR_NOPROC;
+
+    uint32_t flags = sal_arch_lock();
+    long ret = sal_mailbox_take(mb, src_pid, 0, buf, maxlen, NULL, NULL);
+    sal_arch_unlock(flags);
+    return ret;
+}
+
+// Drain up to n messages in one trap. Stops early when the mailbox is
+// empty or the next message does not fit its buffer. Returns the count.
+long sys_sal_recv_many(uint32_t caller, int src_pid, struct sal_mmsg *msgs, int n) {
+    if (msgs == NULL || n <= 0 || n > SAL_MAX_BATCH) return SAL_ERR_INVAL;
+    struct sal_mailbox *mb = sal_mailbox_get((int)caller);
+    if (mb == NULL) return SAL_ERR_NOPROC;
+
+    uint32_t flags = sal_arch_lock();
+    long got = 0;
+    for (; got < n; got++) {
+        uint32_t sender;
+        long len = sal_mailbox_take(mb, src_pid, 0, msgs[got].buf, msgs[got].maxlen, &sender, NULL);
+        if (len < 0) {
+            if (got == 0 && len == SAL_ERR_TOOBIG) got = SAL_ERR_TOOBIG;
+            break;
+        }
+        msgs[got].len = (size_t)len;
+        msgs[got].sender_pid = (int)sender;
+    }
+    sal_arch_unlock(flags);
+    if (got == 0) return SAL_ERR_AGAIN;
+    return got;
 }
 
-long sys_sal_subscribe(const char *topic, void (*callback)(const void*, size_t)) {
-    // TODO: Register callback for topic in subscription table
-    (void)topic; (void)callback;
-    return 0;
+// Dispatch a SAL syscall. Arguments arrive in the order the user-side
+// wrappers load them (edi, esi, edx, ecx).
+long sal_syscall(uint32_t caller, long num, long a1, long a2, long a3, long a4) {
+    switch (num) {
+        case SYS_SAL_SEND:
+            return sys_sal_send(caller, (int)a1, (const void *)a2, (size_t)a3);
+        case SYS_SAL_RECV:
+            return sys_sal_recv(caller, (int)a1, (void *)a2, (size_t)a3);
+        case SYS_SAL_SEND_ATTR:
+            return sys_sal_send_attr(caller, (int)a1, (const void *)a2, (size_t)a3,
+                                     (const struct sal_msg_attr *)a4);
+        case SYS_SAL_TICKS:
+            return sys_sal_ticks(caller);
+        case SYS_SAL_SENDV:
+            return sys_sal_sendv(caller, (int)a1, (const struct sal_iovec *)a2, (int)a3);
+        case SYS_SAL_RECV_MANY:
+            return sys_sal_recv_many(caller, (int)a1, (struct sal_mmsg *)a2, (int)a3);
+        case SYS_SAL_PUBLISH:
+            return sys_sal_publish(caller, (int)a1, (const void *)a2, (size_t)a3);
+        case SYS_SAL_PUBLISH_BATCH:
+            return sys_sal_publish_batch(caller, (const struct sal_pub_entry *)a1, (int)a2);
+        case SYS_SAL_SUBSCRIBE:
+            return sys_sal_subscribe(caller, (int)a1);
+        case SYS_SAL_PORT_CREATE:
+            return sys_sal_port_create(caller);
+        case SYS_SAL_PORT_CLOSE:
+            return sys_sal_port_close(caller, (int)a1);
+        case SYS_SAL_PORT_CTL:
+            return sys_sal_port_ctl(caller, (int)a1, (int)a2, (const struct sal_watch *)a3);
+        case SYS_SAL_WAIT:
+            return sys_sal_wait(caller, (int)a1, (struct sal_event *)a2, (int)a3, (uint32_t)a4);
+        case SYS_SAL_GRANT:
+            return sys_sal_grant(caller, (int)a1, (void *)a2, (size_t)a3, (uint32_t)a4);
+        case SYS_SAL_GRANT_MAP:
+            return sys_sal_grant_map(caller, (int)a1, (void **)a2, (size_t *)a3);
+        case SYS_SAL_GRANT_UNMAP:
+            return sys_sal_grant_unmap(caller, (int)a1);
+        case SYS_SAL_GRANT_REVOKE:
+            return sys_sal_grant_revoke(caller, (int)a1);
+        case SYS_SAL_TOPIC_INTERN:
+            return sys_sal_topic_intern(caller, (const char *)a1);
+        case SYS_SAL_TOPIC_RECV:
+            return sys_sal_topic_recv(caller, (int)a1, (int *)a2, (void *)a3, (size_t)a4);
+        case SYS_SAL_TOPIC_RECV_MANY:
+            return sys_sal_topic_recv_many(caller, (int)a1, (struct sal_mmsg *)a2, (int)a3);
+        case SYS_SAL_ENDPOINT_CREATE:
+            return sys_sal_endpoint_create(caller, (const char *)a1);
+        case SYS_SAL_ENDPOINT_OPEN:
+            return sys_sal_endpoint_open(caller, (const char *)a1);
+        case SYS_SAL_HANDLE_SEND:
+            return sys_sal_handle_send(caller, (int)a1, (const void *)a2, (size_t)a3, (int)a4);
+        case SYS_SAL_HANDLE_RECV:
+            return sys_sal_handle_recv(caller, (int)a1, (void *)a2, (size_t)a3, (int *)a4);
+        case SYS_SAL_HANDLE_DUP:
+            return sys_sal_handle_dup(caller, (int)a1, (uint32_t)a2);
+        case SYS_SAL_HANDLE_CLOSE:
+            return sys_sal_handle_close(caller, (int)a1);
+        case SYS_SAL_ENDPOINT_PRIORITY:
+            return sys_sal_endpoint_priority(caller, (int)a1, (uint32_t)a2);
+        case SYS_SAL_TOPIC_POLICY:
+            return sys_sal_topic_policy(caller, (int)a1, (uint32_t)a2, (uint32_t)a3);
+        case SYS_SAL_TOPIC_RETAIN:
+            return sys_sal_topic_retain(caller, (int)a1, (uint32_t)a2);
+        case SYS_SAL_TOPIC_HISTORY:
+            return sys_sal_topic_history(caller, (int)a1, (struct sal_mmsg *)a2, (int)a3);
+        case SYS_SAL_TOPIC_SEEK:
+            return sys_sal_topic_seek(caller, (int)a1, (uint32_t)a2);
+        case SYS_SAL_STATS:
+            return sys_sal_stats(caller, (uint32_t)a1, (int)a2, (struct sal_queue_stats *)a3);
+        case SYS_SAL_TOPIC_STATS:
+            return sys_sal_topic_stats(caller, (int)a1, (struct sal_topic_stats *)a2);
+        case SYS_SAL_RT_ADMIT:
+            return sys_sal_rt_admit(caller, (const struct sal_rt_params *)a1);
+        case SYS_SAL_RT_LEAVE:
+            return sys_sal_rt_leave(caller);
+        case SYS_SAL_RT_STATS:
+            return sys_sal_rt_stats(caller, (int)a1, (struct sal_rt_stats *)a2);
+        case SYS_SAL_UNSUBSCRIBE:
+            return sys_sal_unsubscribe(caller, (int)a1);
+        case SYS_SAL_CHANNEL_OPEN:
+            return sys_sal_channel_open(caller, (const char *)a1, (uint32_t)a2,
+                                        (uint32_t)a3, (uint32_t)a4);
+        case SYS_SAL_CHANNEL_CLOSE:
+            return sys_sal_channel_close(caller, (void *)a1);
+        case SYS_SAL_FUTEX_WAIT:
+            return sys_sal_futex_wait(caller, (volatile uint32_t *)a1, (uint32_t)a2);
+        case SYS_SAL_FUTEX_WAKE:
+            return sys_sal_futex_wake(caller, (volatile uint32_t *)a1, (uint32_t)a2);
+        default:
+            return SAL_ERR_NOSYS;
+    }
 }
@@ -0,0 +1,665 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// In-kernel pub/sub broker. Topic names are interned once into integer
+// ids through an open-addressed hash table; after that publish and
+// subscribe work on ids only. A publish copies the payload from the
+// caller once into a shared buffer and fans out a reference to every
+// subscriber queue. Topics may also keep a log of their last messages
+// for late subscribers, holding references to the same buffers.
+//
+// Names are '/'-separated levels, and a name containing a '+' (one
+// level) or '#' (the rest) is a wildcard pattern that can be subscribed
+// to but not published on. Each topic caches the set of subscriptions a
+// publish fans out to, patterns included, and rebuilds it through the
+// name trie (sal_trie.c) only after subscriptions change.
+static struct sal_topic sal_topics[SAL_MAX_TOPICS];
+static uint32_t sal_topic_count = 0;
+static uint16_t sal_topic_hash[SAL_TOPIC_HASH_SIZE]; // Topic id, 0 = empty
+
+static struct sal_subscription sal_subs[SAL_MAX_SUBSCRIPTIONS];
+static struct sal_topic_log sal_logs[SAL_MAX_TOPIC_LOGS];
+static uint32_t sal_sub_gen = 1;    // Bumped on every subscribe and unsubscribe
+
+// Per-process subscription lists, with a round-robin cursor for
+// receives that accept any topic
+struct sal_proc_subs {
+    uint32_t count;
+    uint32_t rr;
+    uint16_t subs[SAL_MAX_PROC_SUBS];
+};
+static struct sal_proc_subs sal_proc_subs[SAL_MAX_PROCS];
+
+// Shared payload buffers and their free stack
+static struct sal_pub_buf sal_bufs[SAL_BROKER_BUFFERS];
+static uint16_t sal_buf_free[SAL_BROKER_BUFFERS];
+static uint32_t sal_buf_free_count = 0;
+static int sal_broker_ready = 0;
+
+static void sal_broker_init(void) {
+    for (uint32_t i = 0; i < SAL_BROKER_BUFFERS; i++) {
+        sal_buf_free[i] = (uint16_t)(SAL_BROKER_BUFFERS - 1 - i);
+    }
+    sal_buf_free_count = SAL_BROKER_BUFFERS;
+    sal_broker_ready = 1;
+}
+
+static int sal_buf_alloc(void) {
+    if (sal_buf_free_count == 0) return -1;
+    return sal_buf_free[--sal_buf_free_count];
+}
+
+static void sal_buf_put(int idx) {
+    if (--sal_bufs[idx].refs == 0) {
+        sal_buf_free[sal_buf_free_count++] = (uint16_t)idx;
+    }
+}
+
+// FNV-1a over the topic name. Also measures it; returns -1 if the name
+// does not fit in SAL_TOPIC_NAME_MAX.
+static int sal_topic_hash_name(const char *name, uint32_t *hash) {
+    uint32_t h = 2166136261u;
+    int len;
+    for (len = 0; name[len] != '\0'; len++) {
+        if (len == SAL_TOPIC_NAME_MAX - 1) return -1;
+        h = (h ^ (uint8_t)name[len]) * 16777619u;
+    }
+    *hash = h;
+    return len;
+}
+
+static struct sal_topic *sal_topic_get(int topic_id) {
+    if (topic_id <= 0 || (uint32_t)topic_id > sal_topic_count) return NULL;
+    return &sal_topics[topic_id - 1];
+}
+
+const char *sal_topic_name(int topic_id) {
+    return sal_topics[topic_id - 1].name;
+}
+
+// Per-CPU counters of a topic for sys_sal_stats(), NULL if there is none
+struct sal_queue_stats *sal_topic_qstats(int topic_id) {
+    struct sal_topic *t = sal_topic_get(topic_id);
+    return t ? t->stats : NULL;
+}
+
+// Bring a topic's subscriber set up to date: its own subscriptions plus
+// those of every pattern matching its name. Called with the SAL lock held.
+// The set has room for every subscription there is, so no combination of
+// patterns can push one out of it.
+static void sal_topic_fanout(struct sal_topic *t) {
+    if (t->gen == sal_sub_gen) return;
+
+    static uint16_t ids[SAL_MAX_TOPICS];    // Lock held
+    int n = sal_trie_match(t->name, ids, SAL_MAX_TOPICS);
+    t->nsubs = 0;
+    for (int i = 0; i < n; i++) {
+        struct sal_topic *m = &sal_topics[ids[i] - 1];
+        for (uint32_t j = 0; j < m->ndirect; j++) {
+            t->subs[t->nsubs++] = m->direct[j];
+        }
+    }
+    t->gen = sal_sub_gen;
+}
+
+// Intern a topic name. Returns the existing id or allocates a new one.
+long sys_sal_topic_intern(uint32_t caller, const char *name) {
+    (void)caller;
+    if (name == NULL) return SAL_ERR_INVAL;
+
+    uint32_t hash;
+    int len = sal_topic_hash_name(name, &hash);
+    if (len <= 0) return SAL_ERR_INVAL;
+    int pattern = sal_trie_classify(name);
+    if (pattern < 0) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    uint32_t slot = hash & (SAL_TOPIC_HASH_SIZE - 1);
+    while (sal_topic_hash[slot] != 0) {
+        struct sal_topic *t = &sal_topics[sal_topic_hash[slot] - 1];
+        if (t->hash == hash && memcmp(t->name, name, len + 1) == 0) {
+            long id = sal_topic_hash[slot];
+            sal_arch_unlock(irq);
+            return id;
+        }
+        slot = (slot + 1) & (SAL_TOPIC_HASH_SIZE - 1);
+    }
+
+    if (sal_topic_count == SAL_MAX_TOPICS) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+    struct sal_topic *t = &sal_topics[sal_topic_count];
+    memcpy(t->name, name, len + 1);
+    if (sal_trie_insert((int)sal_topic_count + 1, t->name) != SAL_OK) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+    sal_topic_count++;
+    t->hash = hash;
+    t->pattern = (uint32_t)pattern;
+    t->ndirect = 0;
+    t->gen = 0;
+    t->nsubs = 0;
+    t->policy = SAL_POLICY_DROP_NEWEST;
+    t->credits = SAL_SUB_QUEUE_DEPTH;
+    t->waiters = 0;
+    t->published = 0;
+    t->delivered = 0;
+    t->drops = 0;
+    t->stalls = 0;
+    t->seq = 0;
+    t->log = 0;
+    sal_topic_hash[slot] = (uint16_t)sal_topic_count;
+
+    long id = sal_topic_count;
+    sal_arch_unlock(irq);
+    return id;
+}
+
+// Wake publishers blocked on a credit topic
+static void sal_topic_wake_publishers(struct sal_topic *t) {
+    if (t->waiters == 0) return;
+    for (uint32_t pid = 0; pid < SAL_MAX_PROCS; pid++) {
+        if (t->waiters & (1u << pid)) sal_arch_wake(pid);
+    }
+}
+
+// A pattern subscription going away may free credit on any topic it covered
+static void sal_pattern_wake_publishers(void) {
+    for (uint32_t i = 0; i < sal_topic_count; i++) {
+        sal_topic_wake_publishers(&sal_topics[i]);
+    }
+}
+
+static struct sal_subscription *sal_sub_find(uint32_t pid, int topic_id) {
+    struct sal_proc_subs *ps = &sal_proc_subs[pid];
+    for (uint32_t i = 0; i < ps->count; i++) {
+        struct sal_subscription *sub = &sal_subs[ps->subs[i]];
+        if (sub->topic_id == (uint32_t)topic_id) return sub;
+    }
+    return NULL;
+}
+
+// Sequence number of the oldest message a new reader can still get
+static uint32_t sal_topic_oldest(struct sal_topic *t) {
+    return t->log ? t->seq - sal_logs[t->log - 1].count : t->seq;
+}
+
+// Drop the oldest logged messages until at most keep remain
+static void sal_log_trim(struct sal_topic *t, uint32_t keep) {
+    struct sal_topic_log *log = &sal_logs[t->log - 1];
+    while (log->count > keep) {
+        sal_buf_put(log->bufs[(t->seq - log->count) & (SAL_RETAIN_MAX - 1)]);
+        log->count--;
+    }
+}
+
+// Release queued entries the subscriber has already read from the log
+static void sal_sub_skip_read(struct sal_topic *t, struct sal_subscription *sub) {
+    uint32_t head = sub->head;
+    while (sub->head != sub->tail) {
+        int b = sub->queue[sub->head & (SAL_SUB_QUEUE_DEPTH - 1)];
+        if ((int32_t)(sal_bufs[b].seq - sub->cursor) >= 0) break;
+        sal_buf_put(b);
+        sub->head++;
+    }
+    if (sub->head != head) sal_topic_wake_publishers(t);
+}
+
+// Event port hooks (lock held)
+int sal_sub_index(uint32_t pid, int topic_id) {
+    if (pid >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+    struct sal_subscription *sub = sal_sub_find(pid, topic_id);
+    return sub ? (int)(sub - sal_subs) : SAL_ERR_INVAL;
+}
+
+int sal_sub_pending(uint32_t idx) {
+    return sal_subs[idx].head != sal_subs[idx].tail;
+}
+
+// Subscribe the caller to a topic. Subscribing twice is a no-op.
+long sys_sal_subscribe(uint32_t caller, int topic_id) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    if (t == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    if (sal_sub_find(caller, topic_id) != NULL) {
+        sal_arch_unlock(irq);
+        return SAL_OK;
+    }
+
+    struct sal_proc_subs *ps = &sal_proc_subs[caller];
+    int idx;
+    for (idx = 0; idx < SAL_MAX_SUBSCRIPTIONS; idx++) {
+        if (!sal_subs[idx].in_use) break;
+    }
+    if (idx == SAL_MAX_SUBSCRIPTIONS || t->ndirect == SAL_MAX_TOPIC_SUBS ||
+        ps->count == SAL_MAX_PROC_SUBS) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+
+    struct sal_subscription *sub = &sal_subs[idx];
+    sub->in_use = 1;
+    sub->pid = caller;
+    sub->topic_id = (uint32_t)topic_id;
+    sub->head = 0;
+    sub->tail = 0;
+    sub->dropped = 0;
+    sub->cursor = sal_topic_oldest(t);
+    t->direct[t->ndirect++] = (uint16_t)idx;
+    ps->subs[ps->count++] = (uint16_t)idx;
+    sal_sub_gen++;
+
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Remove the caller's subscription and release anything still queued
+long sys_sal_unsubscribe(uint32_t caller, int topic_id) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    struct sal_subscription *sub = t ? sal_sub_find(caller, topic_id) : NULL;
+    if (sub == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    uint16_t idx = (uint16_t)(sub - sal_subs);
+    sal_port_drop_source(SAL_EV_TOPIC, idx);
+
+    while (sub->head != sub->tail) {
+        sal_buf_put(sub->queue[sub->head++ & (SAL_SUB_QUEUE_DEPTH - 1)]);
+    }
+
+    for (uint32_t i = 0; i < t->ndirect; i++) {
+        if (t->direct[i] == idx) {
+            t->direct[i] = t->direct[--t->ndirect];
+            break;
+        }
+    }
+    sal_sub_gen++;
+    struct sal_proc_subs *ps = &sal_proc_subs[caller];
+    for (uint32_t i = 0; i < ps->count; i++) {
+        if (ps->subs[i] == idx) {
+            ps->subs[i] = ps->subs[--ps->count];
+            break;
+        }
+    }
+    sub->in_use = 0;
+    if (t->pattern) {
+        sal_pattern_wake_publishers();
+    } else {
+        sal_topic_wake_publishers(t);
+    }
+
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Fan one payload out to every subscriber of topic_id. Called with the
+// SAL lock held. Returns how many subscriber queues received it. What a
+// full queue does depends on the topic policy; a credit topic refuses
+// the whole publish with SAL_ERR_AGAIN while any subscriber is out of
+// credit.
+static long sal_publish_locked(uint32_t caller, int topic_id, const void *data, size_t len) {
+    if (data == NULL && len != 0) return SAL_ERR_INVAL;
+    if (len > SAL_TOPIC_MSG_MAX) return SAL_ERR_TOOBIG;
+
+    struct sal_topic *t = sal_topic_get(topic_id);
+    if (t == NULL || t->pattern) return SAL_ERR_INVAL;
+    sal_topic_fanout(t);
+    if (t->policy == SAL_POLICY_CREDIT) {
+        for (uint32_t i = 0; i < t->nsubs; i++) {
+            struct sal_subscription *sub = &sal_subs[t->subs[i]];
+            if (sub->tail - sub->head >= t->credits) {
+                t->stalls++;
+                return SAL_ERR_AGAIN;
+            }
+        }
+    }
+    t->published++;
+    struct sal_queue_stats *qs = &t->stats[sal_arch_cpu()];
+    if (t->nsubs == 0 && t->log == 0) {
+        sal_stats_enqueue(qs, len, 0);
+        t->seq++;
+        return 0;
+    }
+
+    // Make room before taking a buffer, so what this publish displaces
+    // is back in the pool for it: the oldest log entry, the head of each
+    // full queue on a drop-oldest topic, and the pending sample each
+    // latest-only subscriber is about to have replaced
+    if (t->log) {
+        struct sal_topic_log *log = &sal_logs[t->log - 1];
+        if (log->count == log->depth) sal_log_trim(t, log->depth - 1);
+    }
+    uint32_t replace[(SAL_MAX_FANOUT + 31) / 32] = { 0 };
+    for (uint32_t i = 0; i < t->nsubs; i++) {
+        struct sal_subscription *sub = &sal_subs[t->subs[i]];
+        uint32_t queued = sub->tail - sub->head;
+        uint16_t *slot = &sub->queue[(sub->tail - 1) & (SAL_SUB_QUEUE_DEPTH - 1)];
+        if (t->policy == SAL_POLICY_LATEST && queued > 0 && sal_bufs[*slot].topic_id == (uint32_t)topic_id) {
+            // A pattern subscription keeps one per matching topic
+            sal_buf_put(*slot);
+            replace[i / 32] |= 1u << (i % 32);
+        } else if (t->policy == SAL_POLICY_DROP_OLDEST && queued == SAL_SUB_QUEUE_DEPTH) {
+            sal_buf_put(sub->queue[sub->head++ & (SAL_SUB_QUEUE_DEPTH - 1)]);
+            sub->dropped++;
+            t->drops++;
+            qs->drops++;
+        }
+    }
+
+    if (!sal_broker_ready) sal_broker_init();
+    int b = sal_buf_alloc();
+    if (b < 0) {
+        // Not reached with the pool sized for every queue and log slot;
+        // the released samples are gone either way
+        for (uint32_t i = 0; i < t->nsubs; i++) {
+            if (replace[i / 32] & (1u << (i % 32))) sal_subs[t->subs[i]].tail--;
+        }
+        return SAL_ERR_NOMEM;
+    }
+
+    struct sal_pub_buf *pb = &sal_bufs[b];
+    pb->refs = 1; // Held by the publisher until fan-out finishes
+    pb->seq = t->seq;
+    pb->topic_id = (uint32_t)topic_id;
+    pb->publisher = caller;
+    pb->length = (uint32_t)len;
+    pb->stamp = sal_arch_cycles();
+    memcpy(pb->data, data, len);
+
+    if (t->log) {
+        struct sal_topic_log *log = &sal_logs[t->log - 1];
+        log->bufs[t->seq & (SAL_RETAIN_MAX - 1)] = (uint16_t)b;
+        log->count++;
+        pb->refs++;
+    }
+    t->seq++;
+
+    long delivered = 0;
+    uint32_t depth = 0;
+    for (uint32_t i = 0; i < t->nsubs; i++) {
+        struct sal_subscription *sub = &sal_subs[t->subs[i]];
+        if (replace[i / 32] & (1u << (i % 32))) {
+            // Replace the pending sample; the reader only wants the newest
+            sub->queue[(sub->tail - 1) & (SAL_SUB_QUEUE_DEPTH - 1)] = (uint16_t)b;
+            pb->refs++;
+            sub->dropped++;
+            t->drops++;
+            qs->drops++;
+            delivered++;
+            continue;
+        }
+        if (sub->tail - sub->head == SAL_SUB_QUEUE_DEPTH) {
+            sub->dropped++;
+            t->drops++;
+            qs->drops++;
+            continue;
+        }
+        sub->queue[sub->tail++ & (SAL_SUB_QUEUE_DEPTH - 1)] = (uint16_t)b;
+        if (sub->tail - sub->head > depth) depth = sub->tail - sub->head;
+        pb->refs++;
+        delivered++;
+        sal_port_notify(SAL_EV_TOPIC, t->subs[i]);
+    }
+    t->delivered += (uint32_t)delivered;
+    sal_stats_enqueue(qs, len, depth);
+    sal_buf_put(b);
+    return delivered;
+}
+
+// Publish to every subscriber of topic_id. On a credit topic with no
+// window left, sleep once until a subscriber frees a slot; the user
+// wrapper retries on SAL_ERR_AGAIN.
+long sys_sal_publish(uint32_t caller, int topic_id, const void *data, size_t len) {
+    uint32_t irq = sal_arch_lock();
+    long ret = sal_publish_locked(caller, topic_id, data, len);
+    if (ret == SAL_ERR_AGAIN && caller < SAL_MAX_PROCS) {
+        struct sal_topic *t = sal_topic_get(topic_id);
+        t->waiters |= 1u << caller;
+        sal_arch_sleep(caller);
+        t->waiters &= ~(1u << caller);
+        ret = sal_publish_locked(caller, topic_id, data, len);
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Set a topic's delivery policy
+long sys_sal_topic_policy(uint32_t caller, int topic_id, uint32_t policy, uint32_t param) {
+    (void)caller;
+    if (policy > SAL_POLICY_CREDIT) return SAL_ERR_INVAL;
+    if (policy == SAL_POLICY_CREDIT && (param == 0 || param > SAL_SUB_QUEUE_DEPTH)) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    if (t == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    t->policy = policy;
+    t->credits = policy == SAL_POLICY_CREDIT ? param : SAL_SUB_QUEUE_DEPTH;
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+long sys_sal_topic_stats(uint32_t caller, int topic_id, struct sal_topic_stats *stats) {
+    (void)caller;
+    if (stats == NULL) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    if (t == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    stats->policy = t->policy;
+    if (!t->pattern) sal_topic_fanout(t);
+    stats->subscribers = t->pattern ? t->ndirect : t->nsubs;
+    stats->published = t->published;
+    stats->delivered = t->delivered;
+    stats->drops = t->drops;
+    stats->stalls = t->stalls;
+    stats->retained = t->log ? sal_logs[t->log - 1].count : 0;
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Publish several samples under one kernel entry. Stops at the first
+// entry that fails; returns how many entries were published, or the
+// error if the first one failed.
+long sys_sal_publish_batch(uint32_t caller, const struct sal_pub_entry *entries, int n) {
+    if (entries == NULL || n <= 0 || n > SAL_MAX_BATCH) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    long done = 0;
+    for (; done < n; done++) {
+        long ret = sal_publish_locked(caller, entries[done].topic_id, entries[done].data, entries[done].len);
+        if (ret < 0) {
+            if (done == 0) done = ret;
+            break;
+        }
+    }
+    sal_arch_unlock(irq);
+    return done;
+}
+
+// Dequeue the next message on one of the caller's subscriptions. With
+// SAL_ANY_TOPIC, subscriptions are served round-robin. Called with the
+// SAL lock held.
+static long sal_topic_take(uint32_t caller, int topic_id, int *topic_out, void *buf, size_t maxlen,
+                           uint32_t *publisher) {
+    struct sal_subscription *sub = NULL;
+    if (topic_id != SAL_ANY_TOPIC) {
+        sub = sal_sub_find(caller, topic_id);
+        if (sub == NULL) return SAL_ERR_INVAL;
+        if (sub->head == sub->tail) sub = NULL;
+    } else {
+        struct sal_proc_subs *ps = &sal_proc_subs[caller];
+        for (uint32_t n = 0; n < ps->count; n++) {
+            struct sal_subscription *s = &sal_subs[ps->subs[(ps->rr + n) % ps->count]];
+            if (s->head != s->tail) {
+                sub = s;
+                ps->rr = (ps->rr + n + 1) % ps->count;
+                break;
+            }
+        }
+    }
+    if (sub == NULL) return SAL_ERR_AGAIN;
+
+    int b = sub->queue[sub->head & (SAL_SUB_QUEUE_DEPTH - 1)];
+    struct sal_pub_buf *pb = &sal_bufs[b];
+    if (pb->length > maxlen) return SAL_ERR_TOOBIG;
+    sub->head++;
+    if (pb->topic_id == sub->topic_id) sub->cursor = pb->seq + 1;
+
+    // Returning a credit may unblock publishers
+    sal_topic_wake_publishers(sal_topic_get((int)pb->topic_id));
+
+    long len = pb->length;
+    memcpy(buf, pb->data, len);
+    sal_stats_dequeue(&sal_topics[pb->topic_id - 1].stats[sal_arch_cpu()], pb->stamp);
+    if (topic_out != NULL) *topic_out = (int)pb->topic_id;
+    if (publisher != NULL) *publisher = pb->publisher;
+    sal_buf_put(b);
+    return len;
+}
+
+long sys_sal_topic_recv(uint32_t caller, int topic_id, int *topic_out, void *buf, size_t maxlen) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+    if (buf == NULL) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    long ret = sal_topic_take(caller, topic_id, topic_out, buf, maxlen, NULL);
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Drain up to n messages from one subscription (or round-robin across
+// all of them) in one trap. Mirrors sys_sal_recv_many(); sender_pid is
+// the publisher.
+long sys_sal_topic_recv_many(uint32_t caller, int topic_id, struct sal_mmsg *msgs, int n) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+    if (msgs == NULL || n <= 0 || n > SAL_MAX_BATCH) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    long got = 0;
+    for (; got < n; got++) {
+        uint32_t publisher;
+        long len = sal_topic_take(caller, topic_id, NULL, msgs[got].buf, msgs[got].maxlen, &publisher);
+        if (len < 0) {
+            if (got == 0 && len != SAL_ERR_AGAIN) got = len;
+            break;
+        }
+        msgs[got].len = (size_t)len;
+        msgs[got].sender_pid = (int)publisher;
+    }
+    sal_arch_unlock(irq);
+    return got == 0 ? SAL_ERR_AGAIN : got;
+}
+
+// Keep the last depth messages of a topic for late subscribers. Depth 0
+// releases the log; a smaller depth trims the oldest entries.
+long sys_sal_topic_retain(uint32_t caller, int topic_id, uint32_t depth) {
+    (void)caller;
+    if (depth > SAL_RETAIN_MAX) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    long ret = SAL_OK;
+    if (t == NULL || t->pattern) {
+        ret = SAL_ERR_INVAL;
+    } else if (t->log == 0 && depth != 0) {
+        int i;
+        for (i = 0; i < SAL_MAX_TOPIC_LOGS; i++) {
+            if (!sal_logs[i].in_use) break;
+        }
+        if (i == SAL_MAX_TOPIC_LOGS) {
+            ret = SAL_ERR_NOMEM;
+        } else {
+            sal_logs[i].in_use = 1;
+            sal_logs[i].depth = depth;
+            sal_logs[i].count = 0;
+            t->log = (uint32_t)i + 1;
+        }
+    } else if (t->log != 0) {
+        sal_log_trim(t, depth);
+        sal_logs[t->log - 1].depth = depth;
+        if (depth == 0) {
+            sal_logs[t->log - 1].in_use = 0;
+            t->log = 0;
+        }
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Read up to n retained messages from the caller's cursor forward. A
+// cursor that fell behind the log skips to its oldest entry and counts
+// the gap as dropped. Queued copies of what was read are released.
+long sys_sal_topic_history(uint32_t caller, int topic_id, struct sal_mmsg *msgs, int n) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+    if (msgs == NULL || n <= 0 || n > SAL_MAX_BATCH) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    struct sal_subscription *sub = t ? sal_sub_find(caller, topic_id) : NULL;
+    if (sub == NULL || t->log == 0) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+
+    struct sal_topic_log *log = &sal_logs[t->log - 1];
+    uint32_t oldest = sal_topic_oldest(t);
+    if ((int32_t)(sub->cursor - oldest) < 0) {
+        sub->dropped += oldest - sub->cursor;
+        sub->cursor = oldest;
+    }
+
+    long got = 0;
+    for (; got < n && sub->cursor != t->seq; got++) {
+        struct sal_pub_buf *pb = &sal_bufs[log->bufs[sub->cursor & (SAL_RETAIN_MAX - 1)]];
+        if (pb->length > msgs[got].maxlen) {
+            if (got == 0) got = SAL_ERR_TOOBIG;
+            break;
+        }
+        memcpy(msgs[got].buf, pb->data, pb->length);
+        sal_stats_dequeue(&t->stats[sal_arch_cpu()], pb->stamp);
+        msgs[got].len = pb->length;
+        msgs[got].sender_pid = (int)pb->publisher;
+        sub->cursor++;
+    }
+    sal_sub_skip_read(t, sub);
+    sal_arch_unlock(irq);
+    return got == 0 ? SAL_ERR_AGAIN : got;
+}
+
+// Move the caller's cursor back to the last back retained messages (all
+// of them if fewer are held). Returns how many are now ahead of it.
+long sys_sal_topic_seek(uint32_t caller, int topic_id, uint32_t back) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_topic *t = sal_topic_get(topic_id);
+    struct sal_subscription *sub = t ? sal_sub_find(caller, topic_id) : NULL;
+    if (sub == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    uint32_t held = t->seq - sal_topic_oldest(t);
+    if (back > held) back = held;
+    sub->cursor = t->seq - back;
+    sal_arch_unlock(irq);
+    return (long)back;
+}
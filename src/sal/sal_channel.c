@@ -0,0 +1,275 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/sal/sal_ring.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Shared-memory channels. The kernel allocates the ring from a page pool,
+// maps it into every opener and then stays out of the data path; it is
+// only involved again through the futex calls when a consumer sleeps.
+static struct sal_channel sal_channels[SAL_MAX_CHANNELS];
+
+static uint8_t sal_channel_pool[SAL_CHANNEL_POOL_PAGES * SAL_PAGE_SIZE] __attribute__((aligned(4096)));
+static uint32_t sal_pool_used[(SAL_CHANNEL_POOL_PAGES + 31) / 32];
+
+static struct sal_futex_waiter sal_futex_waiters[SAL_MAX_FUTEX_WAITERS];
+
+static int sal_pool_page_used(uint32_t page) {
+    return (sal_pool_used[page / 32] >> (page % 32)) & 1;
+}
+
+// First-fit run of free pool pages. Returns the first page or -1.
+static int sal_pool_alloc(uint32_t npages) {
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < SAL_CHANNEL_POOL_PAGES; i++) {
+        run = sal_pool_page_used(i) ? 0 : run + 1;
+        if (run == npages) {
+            uint32_t first = i + 1 - npages;
+            for (uint32_t p = first; p <= i; p++) {
+                sal_pool_used[p / 32] |= 1u << (p % 32);
+            }
+            return (int)first;
+        }
+    }
+    return -1;
+}
+
+static void sal_pool_free(uint32_t first, uint32_t npages) {
+    for (uint32_t p = first; p < first + npages; p++) {
+        sal_pool_used[p / 32] &= ~(1u << (p % 32));
+    }
+}
+
+static struct sal_ring *sal_channel_ring(struct sal_channel *ch) {
+    return (struct sal_ring *)(sal_channel_pool + ch->first_page * SAL_PAGE_SIZE);
+}
+
+static struct sal_channel *sal_channel_find(const char *name, size_t len) {
+    for (int i = 0; i < SAL_MAX_CHANNELS; i++) {
+        if (sal_channels[i].in_use && memcmp(sal_channels[i].name, name, len + 1) == 0) {
+            return &sal_channels[i];
+        }
+    }
+    return NULL;
+}
+
+// Create the channel's ring in fresh pool pages
+static long sal_channel_create(struct sal_channel *ch, const char *name, size_t len,
+                               uint32_t flags, uint32_t slot_size, uint32_t nslots) {
+    if (slot_size == 0 || nslots < 2 || (nslots & (nslots - 1)) != 0) return SAL_ERR_INVAL;
+
+    uint32_t stride = (uint32_t)((sizeof(struct sal_ring_slot) + slot_size + 7) & ~7u);
+    size_t bytes = sizeof(struct sal_ring) + (size_t)nslots * stride;
+    uint32_t npages = (uint32_t)((bytes + SAL_PAGE_SIZE - 1) / SAL_PAGE_SIZE);
+    if (npages > SAL_CHANNEL_MAX_PAGES) return SAL_ERR_TOOBIG;
+
+    int first = sal_pool_alloc(npages);
+    if (first < 0) return SAL_ERR_NOMEM;
+
+    memcpy(ch->name, name, len + 1);
+    ch->flags = flags & SAL_CHAN_MPSC;
+    ch->slot_size = slot_size;
+    ch->nslots = nslots;
+    ch->first_page = (uint32_t)first;
+    ch->npages = npages;
+    ch->producers = 0;
+    ch->has_consumer = 0;
+    ch->nopens = 0;
+
+    struct sal_ring *r = sal_channel_ring(ch);
+    memset(r, 0, npages * SAL_PAGE_SIZE);
+    r->type = (flags & SAL_CHAN_MPSC) ? SAL_RING_MPSC : SAL_RING_SPSC;
+    r->mask = nslots - 1;
+    r->slot_size = slot_size;
+    r->stride = stride;
+    for (uint32_t i = 0; i < nslots; i++) {
+        sal_ring_slot(r, i)->seq = i;
+    }
+    if (sal_arch_virt_to_phys(&r->wake_seq, &ch->wake_key) != 0) ch->wake_key = 0;
+    ch->in_use = 1;
+    return SAL_OK;
+}
+
+// Open or attach to a named channel. Returns the caller's ring address.
+long sys_sal_channel_open(uint32_t caller, const char *name, uint32_t flags, uint32_t slot_size, uint32_t nslots) {
+    if (name == NULL || (flags & (SAL_CHAN_PRODUCER | SAL_CHAN_CONSUMER)) == 0) return SAL_ERR_INVAL;
+    size_t len = 0;
+    while (name[len] != '\0') {
+        if (++len == SAL_TOPIC_NAME_MAX) return SAL_ERR_INVAL;
+    }
+    if (len == 0) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_channel *ch = sal_channel_find(name, len);
+    long ret = SAL_OK;
+    if (ch == NULL) {
+        for (int i = 0; i < SAL_MAX_CHANNELS && ch == NULL; i++) {
+            if (!sal_channels[i].in_use) ch = &sal_channels[i];
+        }
+        ret = ch ? sal_channel_create(ch, name, len, flags, slot_size, nslots) : SAL_ERR_NOMEM;
+    } else if ((slot_size != 0 && slot_size != ch->slot_size) ||
+               (nslots != 0 && nslots != ch->nslots) ||
+               (flags & SAL_CHAN_MPSC) != ch->flags) {
+        ret = SAL_ERR_INVAL;
+    }
+    if (ret == SAL_OK) {
+        if ((flags & SAL_CHAN_CONSUMER && ch->has_consumer) ||
+            (flags & SAL_CHAN_PRODUCER && !(ch->flags & SAL_CHAN_MPSC) && ch->producers > 0) ||
+            ch->nopens == SAL_CHANNEL_MAX_OPENS) {
+            ret = SAL_ERR_BUSY;
+        }
+    }
+    if (ret != SAL_OK) {
+        if (ch != NULL && ch->in_use && ch->nopens == 0) {
+            sal_pool_free(ch->first_page, ch->npages);
+            ch->in_use = 0;
+        }
+        sal_arch_unlock(irq);
+        return ret;
+    }
+
+    struct sal_extent ext[SAL_CHANNEL_MAX_PAGES];
+    int next = sal_resolve_extents(sal_channel_ring(ch), ch->npages, ext, SAL_CHANNEL_MAX_PAGES);
+    void *addr = next > 0 ? sal_arch_map_extents(ext, (uint32_t)next, 1) : NULL;
+    if (addr == NULL) {
+        if (ch->nopens == 0) {
+            sal_pool_free(ch->first_page, ch->npages);
+            ch->in_use = 0;
+        }
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+
+    ch->opens[ch->nopens].pid = caller;
+    ch->opens[ch->nopens].flags = flags;
+    ch->opens[ch->nopens].addr = addr;
+    ch->nopens++;
+    if (flags & SAL_CHAN_PRODUCER) ch->producers++;
+    if (flags & SAL_CHAN_CONSUMER) {
+        ch->has_consumer = 1;
+        ch->consumer_pid = caller;
+    }
+
+    sal_arch_unlock(irq);
+    return (long)(uintptr_t)addr;
+}
+
+// Unmap the caller's view of a channel; the last close frees the ring
+long sys_sal_channel_close(uint32_t caller, void *ring) {
+    uint32_t irq = sal_arch_lock();
+    for (int i = 0; i < SAL_MAX_CHANNELS; i++) {
+        struct sal_channel *ch = &sal_channels[i];
+        if (!ch->in_use) continue;
+        for (uint32_t o = 0; o < ch->nopens; o++) {
+            if (ch->opens[o].pid != caller || ch->opens[o].addr != ring) continue;
+
+            sal_arch_unmap(ring, ch->npages);
+            if (ch->opens[o].flags & SAL_CHAN_PRODUCER) ch->producers--;
+            if (ch->opens[o].flags & SAL_CHAN_CONSUMER) {
+                ch->has_consumer = 0;
+                sal_port_drop_source(SAL_EV_CHANNEL, (uint32_t)i);
+            }
+            ch->opens[o] = ch->opens[--ch->nopens];
+            if (ch->nopens == 0) {
+                sal_pool_free(ch->first_page, ch->npages);
+                ch->in_use = 0;
+            }
+            sal_arch_unlock(irq);
+            return SAL_OK;
+        }
+    }
+    sal_arch_unlock(irq);
+    return SAL_ERR_INVAL;
+}
+
+// Event port hooks (lock held). A port watches the consumer side of a
+// ring; readiness is read straight from the kernel's view of the ring.
+int sal_channel_index(uint32_t pid, const void *ring) {
+    for (int i = 0; i < SAL_MAX_CHANNELS; i++) {
+        struct sal_channel *ch = &sal_channels[i];
+        if (!ch->in_use) continue;
+        for (uint32_t o = 0; o < ch->nopens; o++) {
+            if (ch->opens[o].pid == pid && ch->opens[o].addr == ring &&
+                (ch->opens[o].flags & SAL_CHAN_CONSUMER)) {
+                return i;
+            }
+        }
+    }
+    return SAL_ERR_INVAL;
+}
+
+int sal_channel_pending(uint32_t idx) {
+    return sal_ring_readable(sal_channel_ring(&sal_channels[idx]));
+}
+
+void sal_channel_arm(uint32_t idx, int waiting) {
+    struct sal_ring *r = sal_channel_ring(&sal_channels[idx]);
+    __atomic_store_n(&r->consumer_waiting, waiting ? 1u : 0u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// Sleep until woken if *addr still holds expected. May return early;
+// callers re-check their condition.
+long sys_sal_futex_wait(uint32_t caller, volatile uint32_t *addr, uint32_t expected) {
+    uintptr_t key;
+    if (addr == NULL || ((uintptr_t)addr & 3) != 0 || sal_arch_virt_to_phys((const void *)addr, &key) != 0) {
+        return SAL_ERR_INVAL;
+    }
+
+    uint32_t irq = sal_arch_lock();
+    if (*addr != expected) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_AGAIN;
+    }
+
+    struct sal_futex_waiter *w = NULL;
+    for (int i = 0; i < SAL_MAX_FUTEX_WAITERS; i++) {
+        if (!sal_futex_waiters[i].in_use) {
+            w = &sal_futex_waiters[i];
+            break;
+        }
+    }
+    if (w == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+    w->in_use = 1;
+    w->pid = caller;
+    w->key = key;
+
+    sal_arch_sleep(caller);
+
+    // Still queued after an early return; a wake would have removed us
+    if (w->in_use && w->pid == caller && w->key == key) {
+        w->in_use = 0;
+    }
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Wake up to count waiters on addr. Returns how many were woken.
+long sys_sal_futex_wake(uint32_t caller, volatile uint32_t *addr, uint32_t count) {
+    (void)caller;
+    uintptr_t key;
+    if (addr == NULL || sal_arch_virt_to_phys((const void *)addr, &key) != 0) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    long woken = 0;
+    for (int i = 0; i < SAL_MAX_FUTEX_WAITERS && (uint32_t)woken < count; i++) {
+        struct sal_futex_waiter *w = &sal_futex_waiters[i];
+        if (w->in_use && w->key == key) {
+            w->in_use = 0;
+            sal_arch_wake(w->pid);
+            woken++;
+        }
+    }
+    // A producer's wakeup may be aimed at an event port instead
+    for (int i = 0; i < SAL_MAX_CHANNELS; i++) {
+        if (sal_channels[i].in_use && sal_channels[i].has_consumer && sal_channels[i].wake_key == key) {
+            sal_port_notify(SAL_EV_CHANNEL, (uint32_t)i);
+            break;
+        }
+    }
+    sal_arch_unlock(irq);
+    return woken;
+}
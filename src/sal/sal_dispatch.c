@@ -0,0 +1,98 @@
+#include "../include/sal/sal.h"
+#include <stdint.h>
+
+// User-side callback delivery for sal_subscribe(). Every topic with a
+// callback is watched on a private event port. sal_dispatch() sleeps on
+// that port, drains each ready topic with one batched receive and runs
+// the callbacks in arrival order.
+struct sal_callback {
+    int topic_id;                           // 0 = free
+    void (*fn)(const void *, size_t);
+};
+
+static struct sal_callback sal_callbacks[SAL_MAX_CALLBACKS];
+static int sal_dispatch_port = 0;
+static uint8_t sal_dispatch_bufs[SAL_DISPATCH_BUDGET][SAL_TOPIC_MSG_MAX];
+
+static struct sal_callback *sal_callback_find(int topic_id) {
+    for (int i = 0; i < SAL_MAX_CALLBACKS; i++) {
+        if (sal_callbacks[i].topic_id == topic_id) return &sal_callbacks[i];
+    }
+    return NULL;
+}
+
+static void sal_callback_clear(struct sal_callback *cb) {
+    struct sal_watch w = { SAL_EV_TOPIC, 0, (uintptr_t)cb->topic_id, 0 };
+    sal_port_ctl(sal_dispatch_port, SAL_PORT_DEL, &w);
+    cb->topic_id = 0;
+    cb->fn = NULL;
+}
+
+// Subscribe to a topic by name. A non-NULL callback is run from
+// sal_dispatch(); passing NULL subscribes without one (read with
+// sal_topic_recv()) and drops any callback registered earlier.
+int sal_subscribe(const char *topic, void (*callback)(const void*, size_t)) {
+    int id = sal_topic_id(topic);
+    if (id < 0) return id;
+    int ret = sal_subscribe_id(id);
+    if (ret < 0) return ret;
+
+    struct sal_callback *cb = sal_callback_find(id);
+    if (callback == NULL) {
+        if (cb != NULL) sal_callback_clear(cb);
+        return SAL_OK;
+    }
+    if (cb == NULL) cb = sal_callback_find(0);
+    if (cb == NULL) return SAL_ERR_NOMEM;
+    if (sal_dispatch_port <= 0) {
+        sal_dispatch_port = sal_port_create();
+        if (sal_dispatch_port < 0) return sal_dispatch_port;
+    }
+
+    // Re-adding is harmless (BUSY) and restores a watch the kernel
+    // dropped when the topic was unsubscribed directly
+    struct sal_watch w = { SAL_EV_TOPIC, 0, (uintptr_t)id, (uintptr_t)(cb - sal_callbacks) };
+    ret = sal_port_ctl(sal_dispatch_port, SAL_PORT_ADD, &w);
+    if (ret < 0 && ret != SAL_ERR_BUSY) return ret;
+    cb->topic_id = id;
+    cb->fn = callback;
+    return SAL_OK;
+}
+
+// Run one dispatch iteration. Waits up to timeout_ticks for a subscribed
+// topic to have messages, then delivers at most SAL_DISPATCH_BUDGET from
+// each ready topic. A topic with more queued stays ready and is served
+// again after the others, so one hot topic cannot starve the rest.
+// Returns the number of callbacks run, 0 on timeout.
+int sal_dispatch(uint32_t timeout_ticks) {
+    if (sal_dispatch_port <= 0) return SAL_ERR_INVAL;
+
+    struct sal_event events[SAL_MAX_CALLBACKS];
+    int n = sal_wait(sal_dispatch_port, events, SAL_MAX_CALLBACKS, timeout_ticks);
+    if (n <= 0) return n;
+
+    struct sal_mmsg msgs[SAL_DISPATCH_BUDGET];
+    for (int i = 0; i < SAL_DISPATCH_BUDGET; i++) {
+        msgs[i].buf = sal_dispatch_bufs[i];
+        msgs[i].maxlen = SAL_TOPIC_MSG_MAX;
+    }
+
+    int delivered = 0;
+    for (int i = 0; i < n; i++) {
+        struct sal_callback *cb = &sal_callbacks[events[i].data];
+        if (cb->fn == NULL || (uintptr_t)cb->topic_id != events[i].id) continue;
+
+        int got = sal_topic_recv_many(cb->topic_id, msgs, SAL_DISPATCH_BUDGET);
+        if (got == SAL_ERR_INVAL) {
+            // Unsubscribed directly; the kernel already dropped the watch
+            cb->topic_id = 0;
+            cb->fn = NULL;
+            continue;
+        }
+        for (int m = 0; m < got; m++) {
+            cb->fn(msgs[m].buf, msgs[m].len);
+        }
+        if (got > 0) delivered += got;
+    }
+    return delivered;
+}
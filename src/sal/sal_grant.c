@@ -0,0 +1,190 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include <stdint.h>
+
+// Page grant table. A grant records the frames behind a sender's buffer;
+// mapping installs those frames in the grantee's grant window, so bulk
+// payloads move between services without copying a byte.
+static struct sal_grant sal_grants[SAL_MAX_GRANTS];
+
+// Grant ids carry the slot generation so a stale id cannot reach a
+// recycled entry: id = (generation << 8) | slot
+static int sal_grant_id(int slot) {
+    return (int)((sal_grants[slot].generation << 8) | (uint32_t)slot);
+}
+
+static struct sal_grant *sal_grant_lookup(int grant_id) {
+    if (grant_id <= 0) return NULL;
+    uint32_t slot = (uint32_t)grant_id & 0xFF;
+    if (slot >= SAL_MAX_GRANTS) return NULL;
+    struct sal_grant *g = &sal_grants[slot];
+    if (g->state == SAL_GRANT_FREE || g->generation != ((uint32_t)grant_id >> 8)) {
+        return NULL;
+    }
+    return g;
+}
+
+// Resolve npages of virtual memory into runs of contiguous frames.
+// Returns the number of runs, or an error if a page is unmapped or the
+// buffer needs more than max runs.
+int sal_resolve_extents(const void *buf, uint32_t npages, struct sal_extent *ext, uint32_t max) {
+    uintptr_t base = (uintptr_t)buf;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < npages; i++) {
+        uintptr_t phys;
+        if (sal_arch_virt_to_phys((const void *)(base + i * SAL_PAGE_SIZE), &phys) != 0) {
+            return SAL_ERR_INVAL;
+        }
+        if (n > 0 && ext[n - 1].phys + ext[n - 1].npages * SAL_PAGE_SIZE == phys) {
+            ext[n - 1].npages++;
+            continue;
+        }
+        if (n == max) return SAL_ERR_TOOBIG;
+        ext[n].phys = phys;
+        ext[n].npages = 1;
+        n++;
+    }
+    return (int)n;
+}
+
+static void sal_grant_release(struct sal_grant *g) {
+    g->state = SAL_GRANT_FREE;
+    g->map_addr = NULL;
+    g->generation = (g->generation + 1) & 0x7FFFFF;
+    if (g->generation == 0) g->generation = 1;
+}
+
+// Offer a page-aligned buffer to dest_pid. Returns a grant id.
+long sys_sal_grant(uint32_t caller, int dest_pid, void *buf, size_t len, uint32_t flags) {
+    uintptr_t base = (uintptr_t)buf;
+    if (buf == NULL || len == 0 || (base & (SAL_PAGE_SIZE - 1)) != 0) return SAL_ERR_INVAL;
+    if ((flags & (SAL_GRANT_SHARE_RO | SAL_GRANT_TRANSFER)) == 0 ||
+        (flags & SAL_GRANT_SHARE_RO && flags & SAL_GRANT_TRANSFER)) {
+        return SAL_ERR_INVAL;
+    }
+    if (dest_pid < 0 || !sal_arch_pid_valid((uint32_t)dest_pid)) return SAL_ERR_NOPROC;
+
+    uint32_t npages = (uint32_t)((len + SAL_PAGE_SIZE - 1) / SAL_PAGE_SIZE);
+    if (npages > SAL_GRANT_MAX_PAGES) return SAL_ERR_TOOBIG;
+
+    // Resolve the buffer into contiguous frame runs before taking a slot
+    struct sal_extent ext[SAL_GRANT_MAX_EXTENTS];
+    int nextents = sal_resolve_extents(buf, npages, ext, SAL_GRANT_MAX_EXTENTS);
+    if (nextents < 0) return nextents;
+
+    uint32_t irq = sal_arch_lock();
+    int slot;
+    for (slot = 0; slot < SAL_MAX_GRANTS; slot++) {
+        if (sal_grants[slot].state == SAL_GRANT_FREE) break;
+    }
+    if (slot == SAL_MAX_GRANTS) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+
+    struct sal_grant *g = &sal_grants[slot];
+    if (g->generation == 0) g->generation = 1;
+    g->state = SAL_GRANT_OFFERED;
+    g->owner_pid = caller;
+    g->grantee_pid = (uint32_t)dest_pid;
+    g->flags = flags;
+    g->npages = npages;
+    g->length = len;
+    g->nextents = (uint32_t)nextents;
+    for (int i = 0; i < nextents; i++) {
+        g->extents[i] = ext[i];
+    }
+    g->map_addr = NULL;
+
+    int id = sal_grant_id(slot);
+    sal_arch_unlock(irq);
+    return id;
+}
+
+// Map an offered grant into the caller. Shared grants are read-only;
+// transferred grants are writable and now belong to the caller.
+long sys_sal_grant_map(uint32_t caller, int grant_id, void **addr, size_t *len) {
+    if (addr == NULL) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_grant *g = sal_grant_lookup(grant_id);
+    if (g == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    if (g->grantee_pid != caller) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_PERM;
+    }
+
+    if (g->state == SAL_GRANT_OFFERED) {
+        int writable = (g->flags & SAL_GRANT_TRANSFER) != 0;
+        void *va = sal_arch_map_extents(g->extents, g->nextents, writable);
+        if (va == NULL) {
+            sal_arch_unlock(irq);
+            return SAL_ERR_NOMEM;
+        }
+        g->map_addr = va;
+        g->state = SAL_GRANT_MAPPED;
+        if (writable) {
+            g->owner_pid = caller;
+        }
+    }
+
+    *addr = g->map_addr;
+    if (len != NULL) *len = g->length;
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Drop the grantee's mapping. A shared grant returns to the offered state
+// and may be mapped again; a transferred grant is released entirely.
+long sys_sal_grant_unmap(uint32_t caller, int grant_id) {
+    uint32_t irq = sal_arch_lock();
+    struct sal_grant *g = sal_grant_lookup(grant_id);
+    if (g == NULL || g->state != SAL_GRANT_MAPPED) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    if (g->grantee_pid != caller) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_PERM;
+    }
+
+    sal_arch_unmap(g->map_addr, g->npages);
+    if (g->flags & SAL_GRANT_TRANSFER) {
+        sal_grant_release(g);
+    } else {
+        g->map_addr = NULL;
+        g->state = SAL_GRANT_OFFERED;
+    }
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Withdraw a grant. Tears down any grantee mapping, so later accesses
+// through it fault. Not allowed once the pages were transferred.
+long sys_sal_grant_revoke(uint32_t caller, int grant_id) {
+    uint32_t irq = sal_arch_lock();
+    struct sal_grant *g = sal_grant_lookup(grant_id);
+    if (g == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    if (g->owner_pid != caller) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_PERM;
+    }
+    if (g->flags & SAL_GRANT_TRANSFER && g->state == SAL_GRANT_MAPPED) {
+        // The grantee owns the pages now and releases them with unmap
+        sal_arch_unlock(irq);
+        return SAL_ERR_PERM;
+    }
+
+    if (g->state == SAL_GRANT_MAPPED) {
+        sal_arch_unmap(g->map_addr, g->npages);
+    }
+    sal_grant_release(g);
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
@@ -0,0 +1,269 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Capability handles. Each process has a fixed table of handles to
+// endpoints; a handle is just the table index, so a send resolves and
+// permission-checks its destination with one array lookup instead of
+// validating a PID. Handles can be passed along with a message.
+static struct sal_endpoint sal_endpoints[SAL_MAX_ENDPOINTS];
+static struct sal_handle sal_handles[SAL_MAX_PROCS][SAL_MAX_HANDLES];
+
+static struct sal_handle *sal_handle_get(uint32_t caller, int handle) {
+    if (caller >= SAL_MAX_PROCS || handle < 0 || handle >= SAL_MAX_HANDLES) return NULL;
+    struct sal_handle *h = &sal_handles[caller][handle];
+    return h->endpoint != 0 ? h : NULL;
+}
+
+static int sal_handle_free_slot(uint32_t pid) {
+    for (int i = 0; i < SAL_MAX_HANDLES; i++) {
+        if (sal_handles[pid][i].endpoint == 0) return i;
+    }
+    return -1;
+}
+
+static struct sal_endpoint *sal_endpoint_find(const char *name, size_t len) {
+    for (int i = 0; i < SAL_MAX_ENDPOINTS; i++) {
+        struct sal_endpoint *e = &sal_endpoints[i];
+        if (e->in_use && e->receivers > 0 && memcmp(e->name, name, len + 1) == 0) return e;
+    }
+    return NULL;
+}
+
+// Length of a handle name, or -1 if it is empty or too long
+static long sal_endpoint_name_len(const char *name) {
+    size_t len = 0;
+    while (name[len] != '\0') {
+        if (++len == SAL_TOPIC_NAME_MAX) return -1;
+    }
+    return len == 0 ? -1 : (long)len;
+}
+
+static void sal_endpoint_put(uint32_t ep) {
+    if (--sal_endpoints[ep - 1].refs == 0) {
+        sal_endpoints[ep - 1].in_use = 0;
+    }
+}
+
+static void sal_handle_set(uint32_t pid, int slot, uint32_t ep, uint32_t rights) {
+    sal_handles[pid][slot].endpoint = (uint16_t)ep;
+    sal_handles[pid][slot].rights = (uint16_t)rights;
+    sal_endpoints[ep - 1].refs++;
+    if (rights & SAL_RIGHT_RECV) sal_endpoints[ep - 1].receivers++;
+}
+
+// Drop a table entry. Once the last receiver goes the endpoint is closed:
+// its name is free again, sends through leftover handles fail, and what
+// was still queued for it is dropped.
+static void sal_handle_release(struct sal_handle *h) {
+    struct sal_endpoint *e = &sal_endpoints[h->endpoint - 1];
+    if ((h->rights & SAL_RIGHT_RECV) && --e->receivers == 0) {
+        e->name[0] = '\0';
+        sal_mailbox_flush(e->owner_mb, h->endpoint);
+    }
+    sal_endpoint_put(h->endpoint);
+    h->endpoint = 0;
+    h->rights = 0;
+}
+
+// A message carrying a handle was consumed without accepting it
+void sal_handle_xfer_drop(uint32_t xfer) {
+    sal_endpoint_put(xfer >> 16);
+}
+
+// Create an endpoint owned by the caller. Returns a handle with every
+// right; a named endpoint can then be opened by other processes.
+long sys_sal_endpoint_create(uint32_t caller, const char *name) {
+    struct sal_mailbox *mb = sal_mailbox_get((int)caller);
+    if (mb == NULL) return SAL_ERR_NOPROC;
+    long len = 0;
+    if (name != NULL && (len = sal_endpoint_name_len(name)) < 0) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    if (name != NULL && sal_endpoint_find(name, (size_t)len) != NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_BUSY;
+    }
+    int slot = sal_handle_free_slot(caller);
+    int ep;
+    for (ep = 0; ep < SAL_MAX_ENDPOINTS; ep++) {
+        if (!sal_endpoints[ep].in_use) break;
+    }
+    if (slot < 0 || ep == SAL_MAX_ENDPOINTS) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_NOMEM;
+    }
+
+    struct sal_endpoint *e = &sal_endpoints[ep];
+    e->in_use = 1;
+    e->owner_pid = caller;
+    e->owner_mb = mb;
+    e->refs = 0;
+    e->receivers = 0;
+    e->priority = SAL_PRIO_NORMAL;
+    if (name != NULL) {
+        memcpy(e->name, name, (size_t)len + 1);
+    } else {
+        e->name[0] = '\0';
+    }
+    sal_handle_set(caller, slot, (uint32_t)ep + 1, SAL_RIGHT_SEND | SAL_RIGHT_RECV | SAL_RIGHT_GRANT);
+
+    sal_arch_unlock(irq);
+    return slot;
+}
+
+// Look up a named endpoint. Returns a handle that may send and be passed on.
+long sys_sal_endpoint_open(uint32_t caller, const char *name) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_NOPROC;
+    if (name == NULL) return SAL_ERR_INVAL;
+    long len = sal_endpoint_name_len(name);
+    if (len < 0) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_endpoint *e = sal_endpoint_find(name, (size_t)len);
+    int slot = sal_handle_free_slot(caller);
+    long ret = slot;
+    if (e == NULL) {
+        ret = SAL_ERR_NOPROC;
+    } else if (slot < 0) {
+        ret = SAL_ERR_NOMEM;
+    } else {
+        sal_handle_set(caller, slot, (uint32_t)(e - sal_endpoints) + 1, SAL_RIGHT_SEND | SAL_RIGHT_GRANT);
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Send through a handle. xfer, unless SAL_NO_HANDLE, names a handle that
+// moves to the receiver with the message; it must hold SAL_RIGHT_GRANT.
+long sys_sal_handle_send(uint32_t caller, int handle, const void *buf, size_t len, int xfer) {
+    if (buf == NULL && len != 0) return SAL_ERR_INVAL;
+    if (len > SAL_MAX_MESSAGE_SIZE) return SAL_ERR_TOOBIG;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_handle *h = sal_handle_get(caller, handle);
+    struct sal_handle *x = xfer == SAL_NO_HANDLE ? NULL : sal_handle_get(caller, xfer);
+    long ret = SAL_OK;
+    if (h == NULL || (xfer != SAL_NO_HANDLE && x == NULL)) {
+        ret = SAL_ERR_INVAL;
+    } else if (!(h->rights & SAL_RIGHT_SEND) ||
+               (x != NULL && (!(x->rights & SAL_RIGHT_GRANT) || (x->rights & SAL_RIGHT_RECV)))) {
+        ret = SAL_ERR_PERM;
+    } else if (sal_endpoints[h->endpoint - 1].receivers == 0) {
+        ret = SAL_ERR_NOPROC;
+    }
+    if (ret != SAL_OK) {
+        sal_arch_unlock(irq);
+        return ret;
+    }
+
+    struct sal_endpoint *e = &sal_endpoints[h->endpoint - 1];
+    struct sal_iovec iov = { buf, len };
+    struct sal_message hdr = {
+        .sender_pid = caller,
+        .dest_pid = e->owner_pid,
+        .length = (uint32_t)len,
+        .priority = e->priority,
+    };
+    uint32_t code = x != NULL ? ((uint32_t)x->endpoint << 16) | x->rights : 0;
+    ret = sal_mailbox_put(e->owner_mb, &hdr, h->endpoint, code, &iov, 1);
+    if (ret >= 0 && x != NULL) {
+        // The endpoint reference travels with the message
+        x->endpoint = 0;
+        x->rights = 0;
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Receive the oldest message sent to the endpoint behind handle. A handle
+// that came with it is installed in the caller's table and returned
+// through xfer_out (SAL_NO_HANDLE if none); with xfer_out NULL it is
+// dropped.
+long sys_sal_handle_recv(uint32_t caller, int handle, void *buf, size_t maxlen, int *xfer_out) {
+    if (buf == NULL) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_handle *h = sal_handle_get(caller, handle);
+    int slot = sal_handle_free_slot(caller);
+    long ret = SAL_OK;
+    if (h == NULL) {
+        ret = SAL_ERR_INVAL;
+    } else if (!(h->rights & SAL_RIGHT_RECV)) {
+        ret = SAL_ERR_PERM;
+    } else if (xfer_out != NULL && slot < 0) {
+        ret = SAL_ERR_NOMEM;  // Leave the message queued until there is room
+    }
+    if (ret != SAL_OK) {
+        sal_arch_unlock(irq);
+        return ret;
+    }
+
+    uint32_t code = 0;
+    ret = sal_mailbox_take(sal_endpoints[h->endpoint - 1].owner_mb, SAL_ANY_PID, h->endpoint, buf, maxlen,
+                           NULL, xfer_out != NULL ? &code : NULL);
+    if (ret >= 0 && xfer_out != NULL) {
+        *xfer_out = SAL_NO_HANDLE;
+        if (code != 0) {
+            // Install without a second reference; the message carried one
+            sal_handles[caller][slot].endpoint = (uint16_t)(code >> 16);
+            sal_handles[caller][slot].rights = (uint16_t)(code & 0xFFFF);
+            *xfer_out = slot;
+        }
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Copy a handle with a subset of its rights, e.g. a send-only handle to
+// pass to a less trusted peer
+long sys_sal_handle_dup(uint32_t caller, int handle, uint32_t rights) {
+    uint32_t irq = sal_arch_lock();
+    struct sal_handle *h = sal_handle_get(caller, handle);
+    int slot = sal_handle_free_slot(caller);
+    long ret = slot;
+    if (h == NULL || rights == 0) {
+        ret = SAL_ERR_INVAL;
+    } else if (rights & ~(uint32_t)h->rights) {
+        ret = SAL_ERR_PERM;
+    } else if (slot < 0) {
+        ret = SAL_ERR_NOMEM;
+    } else {
+        sal_handle_set(caller, slot, h->endpoint, rights);
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+long sys_sal_handle_close(uint32_t caller, int handle) {
+    uint32_t irq = sal_arch_lock();
+    struct sal_handle *h = sal_handle_get(caller, handle);
+    if (h == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    sal_handle_release(h);
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Set the class of every message sent through the endpoint, so the
+// receiver can rank a whole service above bulk traffic without trusting
+// senders to mark their own messages. Receivers only.
+long sys_sal_endpoint_priority(uint32_t caller, int handle, uint32_t priority) {
+    if (priority >= SAL_NUM_PRIOS) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_handle *h = sal_handle_get(caller, handle);
+    long ret = SAL_OK;
+    if (h == NULL) {
+        ret = SAL_ERR_INVAL;
+    } else if (!(h->rights & SAL_RIGHT_RECV)) {
+        ret = SAL_ERR_PERM;
+    } else {
+        sal_endpoints[h->endpoint - 1].priority = priority;
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
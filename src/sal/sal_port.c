@@ -0,0 +1,380 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include <stdint.h>
+
+// Event ports. Every source keeps a list of the watches registered on it.
+// A notification walks that list and appends each watch to its port's
+// ready list unless it is already queued; sal_wait() harvests from the
+// front. Both ends are constant time per event, however many sources a
+// port watches.
+static struct sal_port sal_ports[SAL_MAX_PORTS];
+static struct sal_watch_item sal_watches[SAL_MAX_WATCHES];
+
+// Per-source watch lists and the timer queue (sorted by expiry)
+static uint16_t sal_mbox_watch[SAL_MAX_PROCS];
+static uint16_t sal_sub_watch[SAL_MAX_SUBSCRIPTIONS];
+static uint16_t sal_chan_watch[SAL_MAX_CHANNELS];
+static uint16_t sal_irq_watch[SAL_MAX_IRQS];
+static uint16_t sal_timer_head;
+static uint32_t sal_ports_sleeping = 0;
+static int sal_ports_ready = 0;
+
+static void sal_ports_init(void) {
+    for (int i = 0; i < SAL_MAX_PROCS; i++) sal_mbox_watch[i] = SAL_NO_WATCH;
+    for (int i = 0; i < SAL_MAX_SUBSCRIPTIONS; i++) sal_sub_watch[i] = SAL_NO_WATCH;
+    for (int i = 0; i < SAL_MAX_CHANNELS; i++) sal_chan_watch[i] = SAL_NO_WATCH;
+    for (int i = 0; i < SAL_MAX_IRQS; i++) sal_irq_watch[i] = SAL_NO_WATCH;
+    sal_timer_head = SAL_NO_WATCH;
+    sal_ports_ready = 1;
+}
+
+static uint16_t *sal_src_list(uint32_t type, uint32_t src) {
+    switch (type) {
+    case SAL_EV_MAILBOX: return src < SAL_MAX_PROCS ? &sal_mbox_watch[src] : NULL;
+    case SAL_EV_TOPIC:   return src < SAL_MAX_SUBSCRIPTIONS ? &sal_sub_watch[src] : NULL;
+    case SAL_EV_CHANNEL: return src < SAL_MAX_CHANNELS ? &sal_chan_watch[src] : NULL;
+    case SAL_EV_IRQ:     return src < SAL_MAX_IRQS ? &sal_irq_watch[src] : NULL;
+    }
+    return NULL;
+}
+
+static struct sal_port *sal_port_get(uint32_t caller, int port) {
+    if (port <= 0 || port > SAL_MAX_PORTS) return NULL;
+    struct sal_port *p = &sal_ports[port - 1];
+    if (!p->in_use || p->owner != caller) return NULL;
+    return p;
+}
+
+static void sal_ready_push(struct sal_port *p, uint16_t w) {
+    struct sal_watch_item *it = &sal_watches[w];
+    it->queued = 1;
+    it->next_ready = SAL_NO_WATCH;
+    it->prev_ready = p->ready_tail;
+    if (p->ready_tail != SAL_NO_WATCH) {
+        sal_watches[p->ready_tail].next_ready = w;
+    } else {
+        p->ready_head = w;
+    }
+    p->ready_tail = w;
+}
+
+static void sal_ready_remove(struct sal_port *p, uint16_t w) {
+    struct sal_watch_item *it = &sal_watches[w];
+    if (!it->queued) return;
+    if (it->prev_ready != SAL_NO_WATCH) {
+        sal_watches[it->prev_ready].next_ready = it->next_ready;
+    } else {
+        p->ready_head = it->next_ready;
+    }
+    if (it->next_ready != SAL_NO_WATCH) {
+        sal_watches[it->next_ready].prev_ready = it->prev_ready;
+    } else {
+        p->ready_tail = it->prev_ready;
+    }
+    it->queued = 0;
+}
+
+// Record one notification and wake the port's owner if it sleeps
+static void sal_watch_fire(uint16_t w) {
+    struct sal_watch_item *it = &sal_watches[w];
+    struct sal_port *p = &sal_ports[it->port];
+    it->count++;
+    if (!it->queued) sal_ready_push(p, w);
+    if (p->waiting) sal_arch_wake(p->owner);
+}
+
+// Level state of a source; timers and IRQs are pure events
+static int sal_watch_level(const struct sal_watch_item *it) {
+    switch (it->type) {
+    case SAL_EV_MAILBOX: return sal_mailbox_pending(it->src);
+    case SAL_EV_TOPIC:   return sal_sub_pending(it->src);
+    case SAL_EV_CHANNEL: return sal_channel_pending(it->src);
+    }
+    return 0;
+}
+
+static void sal_timer_insert(uint16_t w) {
+    struct sal_watch_item *it = &sal_watches[w];
+    uint16_t *pp = &sal_timer_head;
+    while (*pp != SAL_NO_WATCH && (int32_t)(sal_watches[*pp].expires - it->expires) <= 0) {
+        pp = &sal_watches[*pp].next_timer;
+    }
+    it->next_timer = *pp;
+    *pp = w;
+}
+
+// Unlink a watch from its source, its port and the ready list
+static void sal_watch_free(uint16_t w) {
+    struct sal_watch_item *it = &sal_watches[w];
+    struct sal_port *p = &sal_ports[it->port];
+    sal_ready_remove(p, w);
+
+    if (it->type == SAL_EV_TIMER) {
+        uint16_t *pp = &sal_timer_head;
+        while (*pp != w) pp = &sal_watches[*pp].next_timer;
+        *pp = it->next_timer;
+    } else {
+        uint16_t *pp = sal_src_list(it->type, it->src);
+        while (*pp != w) pp = &sal_watches[*pp].next_src;
+        *pp = it->next_src;
+    }
+
+    uint16_t *pp = &p->watches;
+    while (*pp != w) pp = &sal_watches[*pp].next_port;
+    *pp = it->next_port;
+    it->in_use = 0;
+}
+
+// A source reported new data (lock held)
+void sal_port_notify(uint32_t type, uint32_t src) {
+    if (!sal_ports_ready) return;
+    uint16_t *list = sal_src_list(type, src);
+    if (list == NULL) return;
+    for (uint16_t w = *list; w != SAL_NO_WATCH; w = sal_watches[w].next_src) {
+        sal_watch_fire(w);
+    }
+}
+
+// A source went away (unsubscribe, channel close); drop its watches
+void sal_port_drop_source(uint32_t type, uint32_t src) {
+    if (!sal_ports_ready) return;
+    uint16_t *list = sal_src_list(type, src);
+    if (list == NULL) return;
+    while (*list != SAL_NO_WATCH) {
+        sal_watch_free(*list);
+    }
+}
+
+// Timer interrupt: fire expired timers and wake timed waits that ran out
+void sal_port_tick(uint32_t now) {
+    if (!sal_ports_ready) return;
+    uint32_t irq = sal_arch_lock();
+    while (sal_timer_head != SAL_NO_WATCH &&
+           (int32_t)(now - sal_watches[sal_timer_head].expires) >= 0) {
+        uint16_t w = sal_timer_head;
+        struct sal_watch_item *it = &sal_watches[w];
+        sal_timer_head = it->next_timer;
+        it->expires += it->period;
+        if ((int32_t)(now - it->expires) >= 0) {
+            it->expires = now + it->period;  // Fell behind; skip missed periods
+        }
+        sal_timer_insert(w);
+        sal_watch_fire(w);
+    }
+    for (int i = 0; i < SAL_MAX_PORTS && sal_ports_sleeping > 0; i++) {
+        struct sal_port *p = &sal_ports[i];
+        if (p->waiting && p->deadline_armed && (int32_t)(now - p->deadline) >= 0) {
+            sal_arch_wake(p->owner);
+        }
+    }
+    sal_arch_unlock(irq);
+}
+
+// Hardware interrupt on line
+void sal_port_irq(uint32_t line) {
+    if (!sal_ports_ready) return;
+    uint32_t irq = sal_arch_lock();
+    sal_port_notify(SAL_EV_IRQ, line);
+    sal_arch_unlock(irq);
+}
+
+long sys_sal_port_create(uint32_t caller) {
+    uint32_t irq = sal_arch_lock();
+    if (!sal_ports_ready) sal_ports_init();
+    for (int i = 0; i < SAL_MAX_PORTS; i++) {
+        struct sal_port *p = &sal_ports[i];
+        if (p->in_use) continue;
+        p->in_use = 1;
+        p->owner = caller;
+        p->watches = SAL_NO_WATCH;
+        p->ready_head = SAL_NO_WATCH;
+        p->ready_tail = SAL_NO_WATCH;
+        p->waiting = 0;
+        p->deadline_armed = 0;
+        sal_arch_unlock(irq);
+        return i + 1;
+    }
+    sal_arch_unlock(irq);
+    return SAL_ERR_NOMEM;
+}
+
+long sys_sal_port_close(uint32_t caller, int port) {
+    uint32_t irq = sal_arch_lock();
+    struct sal_port *p = sal_port_get(caller, port);
+    if (p == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    while (p->watches != SAL_NO_WATCH) {
+        sal_watch_free(p->watches);
+    }
+    p->in_use = 0;
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Resolve what a watch refers to into a source index
+static long sal_watch_resolve(uint32_t caller, const struct sal_watch *watch) {
+    switch (watch->type) {
+    case SAL_EV_MAILBOX:
+        return caller < SAL_MAX_PROCS ? (long)caller : SAL_ERR_NOPROC;
+    case SAL_EV_TOPIC:
+        return sal_sub_index(caller, (int)watch->id);
+    case SAL_EV_CHANNEL:
+        return sal_channel_index(caller, (const void *)watch->id);
+    case SAL_EV_TIMER:
+        return watch->id > 0 && watch->id < 0x80000000u ? 0 : SAL_ERR_INVAL;
+    case SAL_EV_IRQ:
+        return watch->id < SAL_MAX_IRQS ? (long)watch->id : SAL_ERR_INVAL;
+    }
+    return SAL_ERR_INVAL;
+}
+
+static long sal_port_add(struct sal_port *p, uint32_t caller, const struct sal_watch *watch) {
+    long src = sal_watch_resolve(caller, watch);
+    if (src < 0) return src;
+
+    for (uint16_t w = p->watches; w != SAL_NO_WATCH; w = sal_watches[w].next_port) {
+        if (sal_watches[w].type == watch->type && sal_watches[w].id == watch->id) {
+            return SAL_ERR_BUSY;
+        }
+    }
+    uint16_t w;
+    for (w = 0; w < SAL_MAX_WATCHES; w++) {
+        if (!sal_watches[w].in_use) break;
+    }
+    if (w == SAL_MAX_WATCHES) return SAL_ERR_NOMEM;
+
+    struct sal_watch_item *it = &sal_watches[w];
+    it->in_use = 1;
+    it->type = (uint8_t)watch->type;
+    it->flags = (uint8_t)(watch->flags & SAL_WATCH_EDGE);
+    it->queued = 0;
+    it->port = (uint16_t)(p - sal_ports);
+    it->src = (uint16_t)src;
+    it->count = 0;
+    it->id = watch->id;
+    it->data = watch->data;
+    it->next_port = p->watches;
+    p->watches = w;
+
+    if (watch->type == SAL_EV_TIMER) {
+        it->period = (uint32_t)watch->id;
+        it->expires = sal_arch_ticks() + it->period;
+        sal_timer_insert(w);
+    } else {
+        uint16_t *list = sal_src_list(watch->type, (uint32_t)src);
+        it->next_src = *list;
+        *list = w;
+        // Data that arrived before the watch counts as its first edge
+        if (sal_watch_level(it)) sal_watch_fire(w);
+    }
+    return SAL_OK;
+}
+
+// Add or remove a watch. Removal matches on type and id.
+long sys_sal_port_ctl(uint32_t caller, int port, int op, const struct sal_watch *watch) {
+    if (watch == NULL) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_port *p = sal_port_get(caller, port);
+    long ret = SAL_ERR_INVAL;
+    if (p != NULL && op == SAL_PORT_ADD) {
+        ret = sal_port_add(p, caller, watch);
+    } else if (p != NULL && op == SAL_PORT_DEL) {
+        for (uint16_t w = p->watches; w != SAL_NO_WATCH; w = sal_watches[w].next_port) {
+            if (sal_watches[w].type == watch->type && sal_watches[w].id == watch->id) {
+                sal_watch_free(w);
+                ret = SAL_OK;
+                break;
+            }
+        }
+    }
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Move up to max ready watches into events. Edge watches leave the ready
+// list once reported. Level watches stay queued behind the current batch
+// and are dropped at the next harvest that finds their source drained.
+static int sal_port_harvest(struct sal_port *p, struct sal_event *events, int max) {
+    int n = 0;
+    uint16_t last = p->ready_tail;
+    uint16_t w = p->ready_head;
+    while (w != SAL_NO_WATCH && n < max) {
+        struct sal_watch_item *it = &sal_watches[w];
+        uint16_t next = it->next_ready;
+        int level = !(it->flags & SAL_WATCH_EDGE) && it->type != SAL_EV_TIMER && it->type != SAL_EV_IRQ;
+
+        sal_ready_remove(p, w);
+        if (!level || sal_watch_level(it)) {
+            events[n].type = it->type;
+            events[n].count = it->count;
+            events[n].id = it->id;
+            events[n].data = it->data;
+            n++;
+            if (level) sal_ready_push(p, w);
+        }
+        it->count = 0;
+
+        if (w == last) break;
+        w = next;
+    }
+    return n;
+}
+
+// Channel producers only trap when the consumer says it is waiting; set
+// that flag on every watched ring for as long as the port sleeps
+static void sal_port_arm(struct sal_port *p, int waiting) {
+    for (uint16_t w = p->watches; w != SAL_NO_WATCH; w = sal_watches[w].next_port) {
+        struct sal_watch_item *it = &sal_watches[w];
+        if (it->type != SAL_EV_CHANNEL) continue;
+        sal_channel_arm(it->src, waiting);
+        if (waiting && !it->queued && sal_channel_pending(it->src)) {
+            sal_watch_fire(w);
+        }
+    }
+}
+
+// Wait for events on a port. Returns the number of events, 0 when the
+// timeout expired, or SAL_ERR_AGAIN when the sleep ended early; the
+// deadline stays armed so a retry keeps the original timeout.
+long sys_sal_wait(uint32_t caller, int port, struct sal_event *events, int max, uint32_t timeout) {
+    if (events == NULL || max <= 0 || max > SAL_MAX_BATCH) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    struct sal_port *p = sal_port_get(caller, port);
+    if (p == NULL) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+
+    long n = sal_port_harvest(p, events, max);
+    if (n == 0 && timeout != 0) {
+        uint32_t now = sal_arch_ticks();
+        if (timeout != SAL_WAIT_FOREVER && !p->deadline_armed) {
+            p->deadline_armed = 1;
+            p->deadline = now + timeout;
+        }
+        if (!p->deadline_armed || (int32_t)(now - p->deadline) < 0) {
+            sal_port_arm(p, 1);
+            if (p->ready_head == SAL_NO_WATCH) {
+                sal_rt_complete(caller, now);   // A real-time job ends when its task blocks
+                p->waiting = 1;
+                sal_ports_sleeping++;
+                sal_arch_sleep(caller);
+                sal_ports_sleeping--;
+                p->waiting = 0;
+            }
+            sal_port_arm(p, 0);
+            n = sal_port_harvest(p, events, max);
+            if (n == 0 && (!p->deadline_armed || (int32_t)(sal_arch_ticks() - p->deadline) < 0)) {
+                sal_arch_unlock(irq);
+                return SAL_ERR_AGAIN;
+            }
+        }
+    }
+    p->deadline_armed = 0;
+    sal_arch_unlock(irq);
+    return n;
+}
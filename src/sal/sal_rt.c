@@ -0,0 +1,152 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include <stdint.h>
+
+// Real-time scheduling class: periodic tasks under earliest deadline
+// first. Time is the timer tick, so budgets are charged a tick at a time
+// to whichever process the tick interrupted.
+//
+// Admission uses the density test: with every deadline at most its
+// period, EDF meets all deadlines when the sum of budget / deadline is
+// at most 1. The class stops at SAL_RT_UTIL_MAX percent, leaving the
+// rest for best-effort processes even when every job runs to budget.
+// Budget enforcement is what keeps that promise: a job that overruns is
+// throttled, so it can only miss its own deadline.
+
+#if SAL_MAX_PROCS > 32
+#error "sal_rt_pick() takes the runnable PIDs as a 32-bit mask"
+#endif
+
+// Each task's share is rounded up, so round the bound up too: a set that
+// sums to exactly SAL_RT_UTIL_MAX percent still fits
+#define SAL_RT_UTIL_LIMIT (((uint32_t)SAL_RT_UTIL_MAX * 65536 + 99) / 100)
+
+static struct sal_rt_task sal_rt_tasks[SAL_MAX_PROCS];
+
+static void sal_rt_release(struct sal_rt_task *t, uint32_t now) {
+    t->release = now;
+    t->due = now + t->deadline;
+    t->used = 0;
+    t->state = SAL_RT_PENDING;
+    t->missed = 0;
+    t->jobs++;
+}
+
+// Join the class, or change the reservation of a task already in it.
+// The first job is released at once.
+long sal_rt_admit_at(uint32_t pid, const struct sal_rt_params *params, uint32_t now) {
+    if (params == NULL || pid >= SAL_MAX_PROCS) return SAL_ERR_INVAL;
+    if (!sal_arch_pid_valid(pid)) return SAL_ERR_NOPROC;
+    uint32_t deadline = params->deadline != 0 ? params->deadline : params->period;
+    if (params->budget == 0 || params->budget > deadline || deadline > params->period ||
+        params->period > SAL_RT_MAX_PERIOD) {
+        return SAL_ERR_INVAL;
+    }
+    uint32_t util = ((params->budget << 16) + deadline - 1) / deadline;
+
+    uint32_t irq = sal_arch_lock();
+    uint32_t total = util;
+    for (uint32_t i = 0; i < SAL_MAX_PROCS; i++) {
+        if (sal_rt_tasks[i].in_use && i != pid) total += sal_rt_tasks[i].util;
+    }
+    if (total > SAL_RT_UTIL_LIMIT) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_BUSY;
+    }
+    struct sal_rt_task *t = &sal_rt_tasks[pid];
+    t->in_use = 1;
+    t->period = params->period;
+    t->budget = params->budget;
+    t->deadline = deadline;
+    t->util = util;
+    t->jobs = 0;
+    t->misses = 0;
+    t->throttled = 0;
+    t->max_lateness = 0;
+    sal_rt_release(t, now);
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+long sys_sal_rt_admit(uint32_t caller, const struct sal_rt_params *params) {
+    return sal_rt_admit_at(caller, params, sal_arch_ticks());
+}
+
+long sys_sal_rt_leave(uint32_t caller) {
+    if (caller >= SAL_MAX_PROCS) return SAL_ERR_INVAL;
+    uint32_t irq = sal_arch_lock();
+    long ret = sal_rt_tasks[caller].in_use ? SAL_OK : SAL_ERR_INVAL;
+    sal_rt_tasks[caller].in_use = 0;
+    sal_arch_unlock(irq);
+    return ret;
+}
+
+// Any process may read another's counters, as with sal_stats()
+long sys_sal_rt_stats(uint32_t caller, int pid, struct sal_rt_stats *stats) {
+    (void)caller;
+    if (stats == NULL || pid < 0 || pid >= SAL_MAX_PROCS) return SAL_ERR_INVAL;
+    uint32_t irq = sal_arch_lock();
+    const struct sal_rt_task *t = &sal_rt_tasks[pid];
+    if (!t->in_use) {
+        sal_arch_unlock(irq);
+        return SAL_ERR_INVAL;
+    }
+    stats->period = t->period;
+    stats->budget = t->budget;
+    stats->deadline = t->deadline;
+    stats->utilization = t->util;
+    stats->jobs = t->jobs;
+    stats->misses = t->misses;
+    stats->throttled = t->throttled;
+    stats->max_lateness = t->max_lateness;
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
+
+// Timer interrupt: charge the tick to the running job, count the jobs
+// that reached their deadline unfinished, and release the next ones
+void sal_rt_tick(uint32_t now, uint32_t running) {
+    uint32_t irq = sal_arch_lock();
+    for (uint32_t pid = 0; pid < SAL_MAX_PROCS; pid++) {
+        struct sal_rt_task *t = &sal_rt_tasks[pid];
+        if (!t->in_use) continue;
+        if (pid == running && t->state == SAL_RT_PENDING && ++t->used >= t->budget) {
+            t->state = SAL_RT_THROTTLED;
+            t->throttled++;
+        }
+        if (t->state != SAL_RT_DONE && !t->missed && (int32_t)(now - t->due) >= 0) {
+            t->missed = 1;
+            t->misses++;
+        }
+        if (now - t->release >= t->period) {
+            // Ticks are never skipped, but keep the phase if they were
+            uint32_t late = (now - t->release) % t->period;
+            sal_rt_release(t, now - late);
+        }
+    }
+    sal_arch_unlock(irq);
+}
+
+// The caller is about to block: its job is done. A job that missed its
+// deadline still records how late it finished.
+void sal_rt_complete(uint32_t pid, uint32_t now) {
+    if (pid >= SAL_MAX_PROCS) return;
+    struct sal_rt_task *t = &sal_rt_tasks[pid];
+    if (!t->in_use || t->state == SAL_RT_DONE) return;
+    if (t->missed && now - t->due > t->max_lateness) t->max_lateness = now - t->due;
+    t->state = SAL_RT_DONE;
+}
+
+// Runnable task whose pending job has the earliest deadline, lowest PID
+// on a tie
+int sal_rt_pick(uint32_t runnable) {
+    int best = -1;
+    uint32_t irq = sal_arch_lock();
+    for (uint32_t pid = 0; pid < SAL_MAX_PROCS; pid++) {
+        const struct sal_rt_task *t = &sal_rt_tasks[pid];
+        if (!t->in_use || t->state != SAL_RT_PENDING || !(runnable & (1u << pid))) continue;
+        if (best < 0 || (int32_t)(t->due - sal_rt_tasks[best].due) < 0) best = (int)pid;
+    }
+    sal_arch_unlock(irq);
+    return best;
+}
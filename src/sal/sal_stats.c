@@ -0,0 +1,57 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Queue instrumentation. Counters are plain increments under the SAL
+// lock that the operation already holds, on a per-CPU copy so CPUs never
+// share a counter line; a snapshot sums the copies. Latency is measured
+// in TSC cycles from enqueue to dequeue and binned by its log2.
+
+void sal_stats_enqueue(struct sal_queue_stats *s, size_t bytes, uint32_t depth) {
+    s->messages++;
+    s->bytes += bytes;
+    if (depth > s->max_depth) s->max_depth = depth;
+}
+
+void sal_stats_dequeue(struct sal_queue_stats *s, uint64_t stamp) {
+    uint64_t cycles = sal_arch_cycles() - stamp;
+    uint32_t bucket = cycles == 0 ? 0 : 63 - (uint32_t)__builtin_clzll(cycles);
+    if (bucket >= SAL_HIST_BUCKETS) bucket = SAL_HIST_BUCKETS - 1;
+    s->latency[bucket]++;
+    s->dequeued++;
+}
+
+// Snapshot the counters of a mailbox (id = PID) or topic (id = topic id)
+long sys_sal_stats(uint32_t caller, uint32_t kind, int id, struct sal_queue_stats *stats) {
+    (void)caller;
+    if (stats == NULL) return SAL_ERR_INVAL;
+
+    uint32_t irq = sal_arch_lock();
+    const struct sal_queue_stats *per_cpu = NULL;
+    if (kind == SAL_STATS_MAILBOX) {
+        struct sal_mailbox *mb = sal_mailbox_get(id);
+        if (mb != NULL) per_cpu = mb->stats;
+    } else if (kind == SAL_STATS_TOPIC) {
+        per_cpu = sal_topic_qstats(id);
+    }
+    if (per_cpu == NULL) {
+        sal_arch_unlock(irq);
+        return kind == SAL_STATS_MAILBOX ? SAL_ERR_NOPROC : SAL_ERR_INVAL;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    for (int cpu = 0; cpu < SAL_MAX_CPUS; cpu++) {
+        const struct sal_queue_stats *s = &per_cpu[cpu];
+        stats->messages += s->messages;
+        stats->dequeued += s->dequeued;
+        stats->bytes += s->bytes;
+        stats->drops += s->drops;
+        if (s->max_depth > stats->max_depth) stats->max_depth = s->max_depth;
+        for (int b = 0; b < SAL_HIST_BUCKETS; b++) {
+            stats->latency[b] += s->latency[b];
+        }
+    }
+    sal_arch_unlock(irq);
+    return SAL_OK;
+}
@@ -0,0 +1,128 @@
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/klib.h"
+#include <stdint.h>
+
+// Topic name trie. Every interned topic, concrete or wildcard pattern,
+// is a path of '/'-separated levels; '+' and '#' are ordinary levels
+// here and only get their meaning in sal_trie_match(). Nodes do not copy
+// their level text: they point into the name of a topic that contains it.
+static struct sal_trie_node sal_trie[SAL_TRIE_NODES]; // [0] is the root
+static uint32_t sal_trie_used = 1;
+
+// Length of the level starting at name (up to '/' or the end)
+static uint32_t sal_level_len(const char *name) {
+    uint32_t len = 0;
+    while (name[len] != '\0' && name[len] != '/') len++;
+    return len;
+}
+
+static int sal_level_is(const char *level, uint32_t len, char c) {
+    return len == 1 && level[0] == c;
+}
+
+static const char *sal_node_level(const struct sal_trie_node *n) {
+    return sal_topic_name(n->ref) + n->off;
+}
+
+static struct sal_trie_node *sal_trie_child(struct sal_trie_node *n, const char *level, uint32_t len) {
+    for (uint16_t c = n->child; c != 0; c = sal_trie[c].sibling) {
+        struct sal_trie_node *child = &sal_trie[c];
+        if (child->len == len && memcmp(sal_node_level(child), level, len) == 0) return child;
+    }
+    return NULL;
+}
+
+// Check a name for well-formed wildcards. Returns 1 for a pattern, 0 for
+// a concrete topic and SAL_ERR_INVAL if '+' or '#' share a level with
+// other text or '#' is not the last level.
+int sal_trie_classify(const char *name) {
+    int pattern = 0;
+    for (const char *level = name; ; level++) {
+        uint32_t len = sal_level_len(level);
+        for (uint32_t i = 0; i < len; i++) {
+            if ((level[i] == '+' || level[i] == '#') && len != 1) return SAL_ERR_INVAL;
+        }
+        if (sal_level_is(level, len, '#') && level[len] != '\0') return SAL_ERR_INVAL;
+        if (sal_level_is(level, len, '+') || sal_level_is(level, len, '#')) pattern = 1;
+        level += len;
+        if (*level == '\0') return pattern;
+    }
+}
+
+// Add the path of topic_id's name. Called with the SAL lock held; the
+// name must stay put for as long as the topic exists.
+int sal_trie_insert(int topic_id, const char *name) {
+    // Reserve the worst case first so a full table never leaves half a path
+    uint32_t levels = 1;
+    for (const char *p = name; *p != '\0'; p++) {
+        if (*p == '/') levels++;
+    }
+    if (sal_trie_used + levels > SAL_TRIE_NODES) return SAL_ERR_NOMEM;
+
+    struct sal_trie_node *n = &sal_trie[0];
+    for (const char *level = name; ; level++) {
+        uint32_t len = sal_level_len(level);
+        struct sal_trie_node *child = sal_trie_child(n, level, len);
+        if (child == NULL) {
+            uint16_t idx = (uint16_t)sal_trie_used++;
+            child = &sal_trie[idx];
+            child->ref = (uint16_t)topic_id;
+            child->off = (uint8_t)(level - name);
+            child->len = (uint8_t)len;
+            child->child = 0;
+            child->topic = 0;
+            child->sibling = n->child;
+            n->child = idx;
+        }
+        n = child;
+        level += len;
+        if (*level == '\0') break;
+    }
+    n->topic = (uint16_t)topic_id;
+    return SAL_OK;
+}
+
+struct sal_trie_walk {
+    uint16_t *ids;
+    int max;
+    int count;
+};
+
+static void sal_trie_emit(struct sal_trie_walk *w, uint16_t topic) {
+    if (topic != 0 && w->count < w->max) w->ids[w->count++] = topic;
+}
+
+// Visit every node whose path matches the remaining levels of name.
+// Recursion depth is bounded by the number of levels in a topic name.
+static void sal_trie_walk(struct sal_trie_walk *w, const struct sal_trie_node *n, const char *level) {
+    uint32_t len = sal_level_len(level);
+    for (uint16_t c = n->child; c != 0; c = sal_trie[c].sibling) {
+        const struct sal_trie_node *child = &sal_trie[c];
+        const char *text = sal_node_level(child);
+        if (sal_level_is(text, child->len, '#')) {
+            sal_trie_emit(w, child->topic);  // Matches this level and everything below
+        } else if (sal_level_is(text, child->len, '+') ||
+                   (child->len == len && memcmp(text, level, len) == 0)) {
+            if (level[len] == '\0') {
+                sal_trie_emit(w, child->topic);
+                // "a/#" also matches "a" itself
+                for (uint16_t g = child->child; g != 0; g = sal_trie[g].sibling) {
+                    if (sal_level_is(sal_node_level(&sal_trie[g]), sal_trie[g].len, '#')) {
+                        sal_trie_emit(w, sal_trie[g].topic);
+                    }
+                }
+            } else {
+                sal_trie_walk(w, child, level + len + 1);
+            }
+        }
+    }
+}
+
+// Collect the ids of every topic whose name matches the concrete name:
+// the topic itself and all matching patterns. Returns the count.
+int sal_trie_match(const char *name, uint16_t *ids, int max) {
+    struct sal_trie_walk w = { ids, max, 0 };
+    sal_trie_walk(&w, &sal_trie[0], name);
+    return w.count;
+}
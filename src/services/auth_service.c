@@ -1,51 +1,178 @@
 #include "../include/sal/sal.h"
 #include "../include/auth.h"
+#include "../include/dsp/dsp_trust.h"
+#include "../include/dsp/dsp_fuse.h"
+#include "../include/boot.h"
+
+#define AUTH_SIM_DELAY_TICKS 50  // Simulated verification time (100Hz ticks)
+
+// Continuous authentication: after the first verification the HRV and
+// EEG records go through one fusion stage (see dsp_fuse.h), which lines
+// them up on the monotonic clock and hands over a joint vector every
+// AUTH_FUSE_PERIOD_MS. Each stream's part is scored against the user's
+// baseline for that stream, learned from its first AUTH_BASELINE_RECORDS
+// frames, and the frame's evidence is folded into one session
+// confidence. Crossing the lock or unlock threshold publishes an AuthMsg
+// on AUTH_SESSION_TOPIC.
+#define HRV_FEATURES 3
+#define EEG_FEATURES 4
+
+// Resting adult population: heart rate (bpm), RMSSD and SDNN (ms)
+static const float hrv_pop_mean[HRV_FEATURES] = { 70.0f, 40.0f, 50.0f };
+static const float hrv_pop_std[HRV_FEATURES] = { 12.0f, 20.0f, 20.0f };
+// Relative alpha, beta, theta and delta power
+static const float eeg_pop_mean[EEG_FEATURES] = { 0.30f, 0.25f, 0.20f, 0.25f };
+static const float eeg_pop_std[EEG_FEATURES] = { 0.10f, 0.10f, 0.08f, 0.10f };
+
+struct auth_stream {
+    int topic;
+    int fuse;                       // Stream index in the fusion stage
+    const float *pop_mean, *pop_std;
+    struct dsp_trust_stats baseline;
+    struct dsp_trust_model model;
+    int ready;
+};
+
+static struct auth_stream hrv_stream, eeg_stream;
+static struct dsp_fuse fusion;
+static struct dsp_trust session;
+static int session_user = -1;
+static int session_live = 0;
+static int session_topic;
+
+static void auth_stream_init(struct auth_stream *s, const char *topic, uint32_t n, uint32_t max_gap_ms,
+                             const float *pop_mean, const float *pop_std) {
+    s->topic = sal_topic_id(topic);
+    s->fuse = dsp_fuse_add_stream(&fusion, n, max_gap_ms);
+    s->pop_mean = pop_mean;
+    s->pop_std = pop_std;
+    s->ready = 0;
+    dsp_trust_stats_init(&s->baseline, n);
+}
+
+static void auth_publish_session(int type, uint32_t ms) {
+    struct AuthMsg msg = {
+        .type = type,
+        .user_id = session_user,
+        .timestamp = ms,
+        .confidence = dsp_trust_confidence(&session),
+    };
+    uint8_t wire[AUTH_MSG_WIRE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    long len = auth_msg_encode(&msg, 1, wire, sizeof(wire));
+    sal_publish_id(session_topic, wire, (size_t)len);
+}
+
+// One stream's part of a frame: baseline learning, or its evidence
+static float auth_stream_evidence(struct auth_stream *s, const struct dsp_fuse_frame *f) {
+    const float *x = f->v + fusion.s[s->fuse].offset;
+    if (s->ready) return dsp_trust_evidence(&s->model, x);
+    dsp_trust_stats_add(&s->baseline, x);
+    if (s->baseline.count < AUTH_BASELINE_RECORDS) return 0.0f;
+    s->ready = dsp_trust_model_init(&s->model, &s->baseline, s->pop_mean, s->pop_std) == 0;
+    // The session runs from the first baseline learned
+    if (s->ready && !session_live) {
+        session_live = 1;
+        dsp_trust_start(&session, f->t_ms, AUTH_START_CONFIDENCE);
+        auth_publish_session(AUTH_UNLOCK, f->t_ms);
+    }
+    return 0.0f;
+}
+
+// One fused frame: streams missing at its time add nothing
+static void auth_monitor_frame(const struct dsp_fuse_frame *f) {
+    float evidence = 0.0f;
+    if (f->valid & (1u << hrv_stream.fuse)) evidence += auth_stream_evidence(&hrv_stream, f);
+    if (f->valid & (1u << eeg_stream.fuse)) evidence += auth_stream_evidence(&eeg_stream, f);
+    if (!session_live) return;
+    int change = dsp_trust_update(&session, f->t_ms, evidence);
+    if (change == DSP_TRUST_LOCK) auth_publish_session(AUTH_LOCK, f->t_ms);
+    if (change == DSP_TRUST_UNLOCK) auth_publish_session(AUTH_UNLOCK, f->t_ms);
+}
+
+// Drain a sensor topic into the fusion stage, then score the frames it
+// made due. Records arrive in batches of up to WIRE_BATCH_MAX.
+static void auth_monitor(struct auth_stream *s) {
+    static uint8_t buf[SAL_MAX_MESSAGE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    static struct HRVBatch hrv;
+    static struct EEGBatch eeg;
+    int len;
+    while ((len = sal_topic_recv(s->topic, NULL, buf, sizeof(buf))) >= 0) {
+        if (s == &hrv_stream) {
+            int n = hrv_batch_decode(buf, (size_t)len, &hrv);
+            for (int i = 0; i < n; i++) {
+                float x[HRV_FEATURES] = { hrv.heart_rate[i], hrv.rmssd[i], hrv.sdnn[i] };
+                dsp_fuse_push(&fusion, (uint32_t)s->fuse, hrv.timestamp[i], x);
+            }
+        } else {
+            int n = eeg_batch_decode(buf, (size_t)len, &eeg);
+            for (int i = 0; i < n; i++) {
+                float x[EEG_FEATURES] = { eeg.alpha_waves[i], eeg.beta_waves[i], eeg.theta_waves[i],
+                                          eeg.delta_waves[i] };
+                dsp_fuse_push(&fusion, (uint32_t)s->fuse, eeg.timestamp[i], x);
+            }
+        }
+    }
+    struct dsp_fuse_frame frame;
+    while (dsp_fuse_pull(&fusion, &frame)) auth_monitor_frame(&frame);
+}
 
 // Simple authentication service implementation
 void auth_service_main(void) {
     // TODO: Initialize biometric sensors
-    // TODO: Load user profiles from storage
-    // TODO: Set up SAL subscriptions for HRV/EEG data
+    const struct boot_module *m = boot_module_find("profiles");
+    auth_profiles_load(m != NULL ? m->data : NULL, m != NULL ? m->size : 0);
     
-    while (1) {
-        // TODO: Collect biometric data
-        // TODO: Process authentication requests
-        // TODO: Send auth success/failure messages
-        
-        // For now, simulate authentication after delay
-        static int counter = 0;
-        counter++;
-        if (counter > 500000) {
-            struct AuthMsg msg;
-            msg.type = AUTH_SUCCESS;
-            msg.user_id = 1;
-            msg.timestamp = counter;  // Simple timestamp
-            
-            // Send auth success to kernel/init
-            sal_send(AUTH_CHANNEL, &msg, sizeof(msg));
-            break;
-        }
-    }
+    // Results go to the kernel's endpoint; requests arrive on ours
+    int kernel = sal_endpoint_open(AUTH_ENDPOINT);
+    int verify = sal_endpoint_create(AUTH_VERIFY_ENDPOINT);
+    sal_endpoint_priority(verify, SAL_PRIO_URGENT);
+    session_topic = sal_topic_id(AUTH_SESSION_TOPIC);
+    sal_topic_retain(session_topic, 1);
+    dsp_trust_init(&session, AUTH_TRUST_HALF_LIFE_MS, AUTH_LOCK_BELOW, AUTH_UNLOCK_ABOVE);
+    dsp_fuse_init(&fusion, AUTH_FUSE_PERIOD_MS, AUTH_FUSE_LATENCY_MS);
+    auth_stream_init(&hrv_stream, "heart_rate", HRV_FEATURES, AUTH_HRV_MAX_GAP_MS, hrv_pop_mean, hrv_pop_std);
+    auth_stream_init(&eeg_stream, "eeg_data", EEG_FEATURES, AUTH_EEG_MAX_GAP_MS, eeg_pop_mean, eeg_pop_std);
     
-    // Continue running to handle future auth requests
+    // One port covers everything the service reacts to: requests in the
+    // mailbox, the timer that stands in for the first verification, and
+    // once a session is up, the sensor topics
+    int port = sal_port_create();
+    struct sal_watch requests = { SAL_EV_MAILBOX, 0, 0, 0 };
+    struct sal_watch sim = { SAL_EV_TIMER, SAL_WATCH_EDGE, AUTH_SIM_DELAY_TICKS, 0 };
+    struct sal_watch hrv = { SAL_EV_TOPIC, 0, (uintptr_t)hrv_stream.topic, (uintptr_t)&hrv_stream };
+    struct sal_watch eeg = { SAL_EV_TOPIC, 0, (uintptr_t)eeg_stream.topic, (uintptr_t)&eeg_stream };
+    sal_port_ctl(port, SAL_PORT_ADD, &requests);
+    sal_port_ctl(port, SAL_PORT_ADD, &sim);
+    
+    struct sal_event events[4];
     while (1) {
-        // TODO: Handle ongoing authentication monitoring
-        asm volatile ("pause");
+        int n = sal_wait(port, events, 4, SAL_WAIT_FOREVER);
+        for (int i = 0; i < n; i++) {
+            if (events[i].type == SAL_EV_TIMER) {
+                // For now, simulate authentication after a delay
+                struct AuthMsg msg = {
+                    .type = AUTH_SUCCESS,
+                    .user_id = 1,
+                    .timestamp = AUTH_SIM_DELAY_TICKS,
+                };
+                uint8_t wire[AUTH_MSG_WIRE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+                
+                // Send auth success to kernel/init
+                long len = auth_msg_encode(&msg, 1, wire, sizeof(wire));
+                sal_handle_send(kernel, wire, (size_t)len, SAL_NO_HANDLE);
+                sal_port_ctl(port, SAL_PORT_DEL, &sim);
+                
+                // Monitor the verified user from here on
+                session_user = msg.user_id;
+                sal_subscribe_id(hrv_stream.topic);
+                sal_subscribe_id(eeg_stream.topic);
+                sal_port_ctl(port, SAL_PORT_ADD, &hrv);
+                sal_port_ctl(port, SAL_PORT_ADD, &eeg);
+            } else if (events[i].type == SAL_EV_MAILBOX) {
+                auth_handle_requests(verify);
+            } else if (events[i].type == SAL_EV_TOPIC) {
+                auth_monitor((struct auth_stream *)events[i].data);
+            }
+        }
     }
 }
-
-// Verify user biometric data
-int auth_verify_user(int user_id, const void *biometric_data) {
-    // TODO: Implement actual biometric matching
-    (void)user_id;
-    (void)biometric_data;
-    return 1;  // Placeholder: always succeed
-}
-
-// Store user biometric profile
-int auth_store_profile(int user_id, const void *profile_data) {
-    // TODO: Implement profile storage
-    (void)user_id;
-    (void)profile_data;
-    return 0;  // Placeholder: always succeed
-}
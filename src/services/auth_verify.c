@@ -0,0 +1,80 @@
+#include "../include/sal/sal.h"
+#include "../include/auth.h"
+#include "../include/dsp/dsp_profile.h"
+#include "../include/klib.h"
+
+#if MAX_USERS > DSP_PROFILE_MAX || AUTH_TEMPLATE_DIM != DSP_PROFILE_DIM
+#error "auth profiles must fit the profile store"
+#endif
+
+// Enrolled profiles (see dsp_profile.h): a stored image, used in place,
+// or an empty store. Enrolments go to the journal; when it fills, the
+// store is compacted into whichever RAM image is not in use and reopened
+// there. This file has no kernel dependencies so the host build links
+// it too (make host-test).
+// TODO: Append journal records to the profile file once there is storage
+#define PROFILE_IMAGE_SIZE DSP_PROFILE_IMAGE_SIZE(MAX_USERS, MAX_USERS)
+
+static struct dsp_profile_store profiles;
+static uint8_t profile_image[2][PROFILE_IMAGE_SIZE] __attribute__((aligned(16)));
+static uint8_t profile_journal[DSP_PROFILE_JOURNAL_SIZE] __attribute__((aligned(16)));
+static int profile_buf = -1;        // profile_image in use, -1 for the stored image
+static int profiles_ready = 0;
+
+void auth_profiles_load(const void *image, uint32_t size) {
+    profile_buf = -1;
+    if (image == NULL || dsp_profile_open(&profiles, image, size, profile_journal, sizeof(profile_journal)) != 0) {
+        profile_buf = 0;
+        dsp_profile_format(profile_image[0], sizeof(profile_image[0]), MAX_USERS);
+        dsp_profile_open(&profiles, profile_image[0], sizeof(profile_image[0]), profile_journal,
+                         sizeof(profile_journal));
+    }
+    profiles_ready = 1;
+}
+
+static struct dsp_profile_store *auth_profiles(void) {
+    if (!profiles_ready) auth_profiles_load(NULL, 0);
+    return &profiles;
+}
+
+// Verify user biometric data
+int auth_verify_user(int user_id, const void *biometric_data) {
+    if (user_id < 0 || biometric_data == NULL) return 0;
+    return dsp_profile_score(auth_profiles(), (uint32_t)user_id, biometric_data) >= AUTH_MATCH_THRESHOLD;
+}
+
+// Store user biometric profile, replacing any earlier one
+int auth_store_profile(int user_id, const void *profile_data) {
+    if (user_id < 0 || profile_data == NULL) return DSP_ERR_INVAL;
+    struct dsp_profile_store *s = auth_profiles();
+    int ret = dsp_profile_put(s, (uint32_t)user_id, profile_data);
+    if (ret != DSP_ERR_FULL) return ret;
+
+    int next = profile_buf == 0 ? 1 : 0;
+    long len = dsp_profile_compact(s, profile_image[next], sizeof(profile_image[next]));
+    if (len < 0) return (int)len;
+    dsp_profile_open(s, profile_image[next], sizeof(profile_image[next]), profile_journal, sizeof(profile_journal));
+    profile_buf = next;
+    return dsp_profile_put(s, (uint32_t)user_id, profile_data);
+}
+
+// Answer queued auth requests with the verification result: the sample
+// in the request scored against the user's profile. Requesters attach a
+// handle to their own endpoint for the reply. The buffer takes
+// any message size so a malformed one cannot wedge the mailbox.
+void auth_handle_requests(int verify) {
+    static uint8_t req[SAL_MAX_MESSAGE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    struct AuthMsg msg;
+    int reply;
+    int len;
+    while ((len = sal_handle_recv(verify, req, sizeof(req), &reply)) >= 0) {
+        if (reply == SAL_NO_HANDLE) continue;
+        if (auth_msg_decode(req, (size_t)len, &msg) > 0 && msg.type == AUTH_VERIFY) {
+            msg.type = auth_verify_user(msg.user_id, msg.sample) ? AUTH_SUCCESS : AUTH_FAILURE;
+            memset(msg.sample, 0, sizeof(msg.sample));  // The reply does not echo it back
+            long out = auth_msg_encode(&msg, 1, req, sizeof(req));
+            sal_handle_send(reply, req, (size_t)out, SAL_NO_HANDLE);
+        }
+        sal_handle_close(reply);
+    }
+}
@@ -1,47 +1,208 @@
 #include "../include/sal/sal.h"
 #include "../include/auth.h"
+#include "../include/dsp/dsp_hrv.h"
+#include "../include/dsp/dsp_eeg.h"
+#include "../include/dsp/dsp_filter.h"
+#include "../include/dsp/dsp_source.h"
+#include "../include/boot.h"
+
+// Mains frequency notched out of every sensor signal
+#define MAINS_HZ 50.0f
+#define TICK_HZ 100             // sal_ticks() rate
+
+// Sensor input: the recording loaded as boot module `name` when there is
+// one in the expected shape, otherwise seeded synthetic signal. The
+// module's speed= option (default 1) sets the replay rate as a multiple
+// of real time; 0 runs unpaced.
+static void sensor_open(struct dsp_source *src, const char *name, enum dsp_source_kind kind, uint32_t channels,
+                        uint32_t rate) {
+    const struct boot_module *m = boot_module_find(name);
+    if (m != NULL && dsp_source_replay(src, m->data, m->size) == 0 && src->channels == channels &&
+        src->sample_rate == rate) {
+        src->loop = 1;
+        src->speed = boot_module_arg(m, "speed", 1);
+        return;
+    }
+    dsp_source_synth(src, kind, channels, rate, 1);
+    if (m != NULL) src->speed = boot_module_arg(m, "speed", 1);
+}
+
+// Wait for the next release (unpaced sources do not wait) and return
+// the frames owed since start
+static uint32_t sensor_wait(const struct dsp_source *src, int port, uint32_t start) {
+    if (src->speed != 0) {
+        struct sal_event ev;
+        sal_wait(port, &ev, 1, SAL_WAIT_FOREVER);
+    }
+    return dsp_source_due(src, sal_ticks() - start, TICK_HZ);
+}
+
+// Time of sample n on the monotonic clock: the service's start tick
+// plus the sample's offset, split so the ms conversion does not wrap in
+// 32 bits. Both sensors stamp this way so consumers can line them up.
+static uint32_t sensor_ms(uint32_t start, uint32_t n, uint32_t rate) {
+    return start * (1000 / TICK_HZ) + n / rate * 1000 + n % rate * 1000 / rate;
+}
+
+// Sampling and DSP run in the real-time class (see sal_rt.c): one job
+// per SENSOR_PERIOD_TICKS with a tick of CPU reserved, due by the next
+// release. A job drains the frames owed since the last one and ends
+// when the loop blocks in sal_wait(). If admission fails the service
+// still runs, best effort.
+#define SENSOR_PERIOD_TICKS 5
+#define SENSOR_BUDGET_TICKS 1
+
+static int sensor_port(void) {
+    int port = sal_port_create();
+    struct sal_watch tick = { SAL_EV_TIMER, 0, SENSOR_PERIOD_TICKS, 0 };
+    sal_port_ctl(port, SAL_PORT_ADD, &tick);
+    struct sal_rt_params rt = { SENSOR_PERIOD_TICKS, SENSOR_BUDGET_TICKS, 0 };
+    sal_rt_admit(&rt);
+    return port;
+}
+
+// HRV sensor service: raw samples band-passed to the QRS band and
+// notched, then through the streaming HRV engine, one record per beat
+#define HRV_SAMPLE_RATE 250
+#define HRV_WINDOW 64           // Beats per metrics window, about a minute
+#define HRV_RMSSD_FULL 100.0f   // RMSSD (ms) that scores 1.0
 
-// Simple HRV sensor service
 void hrv_service_main(void) {
-    // TODO: Initialize I2C for heart rate sensor
-    // TODO: Set up SAL publishing
+    // TODO: Initialize I2C for heart rate sensor; until then a recorded
+    // or synthetic ECG stands in for its samples
+    static struct dsp_source sensor;
+    sensor_open(&sensor, "hrv", DSP_SOURCE_ECG, 1, HRV_SAMPLE_RATE);
+    int port = sensor_port();
+    static struct hrv_stream hrv;
+    hrv_init(&hrv, HRV_SAMPLE_RATE, HRV_WINDOW);
+    static struct dsp_iir_bank filter;
+    struct dsp_biquad sections[3];
+    dsp_biquad_design(&sections[0], DSP_BIQUAD_HIGHPASS, HRV_SAMPLE_RATE, 5.0f, 0.7071f);
+    dsp_biquad_design(&sections[1], DSP_BIQUAD_LOWPASS, HRV_SAMPLE_RATE, 15.0f, 0.7071f);
+    dsp_biquad_design(&sections[2], DSP_BIQUAD_NOTCH, HRV_SAMPLE_RATE, MAINS_HZ, 10.0f);
+    dsp_iir_init(&filter, 1, sections, 3);
+    
+    // Intern the topic once; the loop publishes by id. The loop runs
+    // faster than slow readers consume, so keep the freshest samples.
+    // A retained window lets a restarted HRV consumer start at once.
+    int heart_rate_topic = sal_topic_id("heart_rate");
+    sal_topic_policy(heart_rate_topic, SAL_POLICY_DROP_OLDEST, 0);
+    sal_topic_retain(heart_rate_topic, SAL_RETAIN_MAX);
+    
+    // Beats go out WIRE_BATCH_MAX at a time as one struct-of-arrays batch
+    static struct HRVBatch batch;
+    static uint8_t wire[HRV_BATCH_WIRE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    uint32_t n = 0, start = sal_ticks();
     
     while (1) {
-        // Simulate HRV data collection
-        struct HRVData hrv_data;
-        hrv_data.timestamp = 12345;  // Simple counter
-        hrv_data.heart_rate = 72.0f;
-        hrv_data.hrv_score = 0.8f;
-        hrv_data.stress_level = 0.3f;
-        
-        // Publish HRV data via SAL
-        sal_publish("heart_rate", &hrv_data, sizeof(hrv_data));
-        
-        // Simulate delay
-        for (volatile int i = 0; i < 100000; i++);
+        uint32_t due = sensor_wait(&sensor, port, start);
+        for (uint32_t f = 0; f < due; f++) {
+            float raw, sample;
+            if (dsp_source_read(&sensor, &raw, 1) == 0) break;
+            dsp_iir_push(&filter, &raw, &sample);
+            if (hrv_push(&hrv, sample) && hrv.count > 1) {
+                struct hrv_metrics m;
+                hrv_metrics(&hrv, &m);
+                batch.timestamp[n] = sensor_ms(start, hrv.last_beat, HRV_SAMPLE_RATE);
+                batch.heart_rate[n] = m.heart_rate;
+                batch.hrv_score[n] = dsp_clampf(m.rmssd / HRV_RMSSD_FULL, 0.0f, 1.0f);
+                batch.stress_level[n] = 1.0f - batch.hrv_score[n];
+                batch.rmssd[n] = m.rmssd;
+                batch.sdnn[n] = m.sdnn;
+                batch.pnn50[n] = m.pnn50;
+            
+                // Publish HRV data via SAL
+                if (++n == WIRE_BATCH_MAX) {
+                    long len = hrv_batch_encode(&batch, n, wire, sizeof(wire));
+                    sal_publish_id(heart_rate_topic, wire, (size_t)len);
+                    n = 0;
+                }
+            }
+        }
     }
 }
 
-// Simple EEG sensor service  
+// EEG sensor service: the channels are sampled at twice the analysis
+// rate, high-passed and notched, decimated together, and each goes
+// through the Welch band-power engine. One record per window hop, with
+// the band powers averaged over channels.
+#define EEG_ADC_RATE 512
+#define EEG_DECIMATE 2
+#define EEG_SAMPLE_RATE (EEG_ADC_RATE / EEG_DECIMATE)
+#define EEG_FIR_TAPS 31
+#define EEG_CHANNELS 4
+#define EEG_NFFT 256            // One-second windows, 1 Hz bins
+#define EEG_SEGMENTS 4          // Welch average over 2.5 s
+
 void eeg_service_main(void) {
-    // TODO: Initialize ADC for EEG sensor
-    // TODO: Set up SAL publishing
+    // TODO: Initialize ADC for EEG sensor; until then the channels are
+    // recorded, or synthetic EEG each with its own noise
+    static struct dsp_source sensor;
+    static struct eeg_plan plan;
+    static struct eeg_channel channel[EEG_CHANNELS];
+    sensor_open(&sensor, "eeg", DSP_SOURCE_EEG, EEG_CHANNELS, EEG_ADC_RATE);
+    int port = sensor_port();
+    eeg_plan_init(&plan, EEG_SAMPLE_RATE, EEG_NFFT, EEG_SEGMENTS);
+    for (int c = 0; c < EEG_CHANNELS; c++) eeg_init(&channel[c], &plan);
+    
+    // Drift below the delta band and mains hum out, then an anti-alias
+    // low-pass at 45 Hz for the decimation
+    static struct dsp_iir_bank filter;
+    static struct dsp_fir_decim decimator;
+    struct dsp_biquad sections[2];
+    float taps[EEG_FIR_TAPS];
+    dsp_biquad_design(&sections[0], DSP_BIQUAD_HIGHPASS, EEG_ADC_RATE, 0.5f, 0.7071f);
+    dsp_biquad_design(&sections[1], DSP_BIQUAD_NOTCH, EEG_ADC_RATE, MAINS_HZ, 10.0f);
+    dsp_iir_init(&filter, EEG_CHANNELS, sections, 2);
+    dsp_fir_lowpass(taps, EEG_FIR_TAPS, EEG_ADC_RATE, 45.0f);
+    dsp_fir_decim_init(&decimator, EEG_CHANNELS, taps, EEG_FIR_TAPS, EEG_DECIMATE);
+    float frame[EEG_CHANNELS];
+    
+    int eeg_topic = sal_topic_id("eeg_data");
+    sal_topic_policy(eeg_topic, SAL_POLICY_DROP_OLDEST, 0);
+    sal_topic_retain(eeg_topic, SAL_RETAIN_MAX);
+    
+    static struct EEGBatch batch;
+    static uint8_t wire[EEG_BATCH_WIRE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    uint32_t n = 0, samples = 0, start = sal_ticks();
     
     while (1) {
-        // Simulate EEG data collection
-        struct EEGData eeg_data;
-        eeg_data.timestamp = 12345;
-        eeg_data.alpha_waves = 0.6f;
-        eeg_data.beta_waves = 0.4f;
-        eeg_data.theta_waves = 0.2f;
-        eeg_data.delta_waves = 0.1f;
-        eeg_data.focus_level = 0.7f;
-        eeg_data.relaxation_level = 0.8f;
-        
-        // Publish EEG data via SAL
-        sal_publish("eeg_data", &eeg_data, sizeof(eeg_data));
+        uint32_t due = sensor_wait(&sensor, port, start);
+        for (uint32_t f = 0; f < due; f++) {
+            // Channels are sampled together, so they complete windows together
+            if (dsp_source_read(&sensor, frame, 1) == 0) break;
+            dsp_iir_push(&filter, frame, frame);
+            int window = 0;
+            if (dsp_fir_decim_push(&decimator, frame, frame)) {
+                for (int c = 0; c < EEG_CHANNELS; c++) window |= eeg_push(&channel[c], frame[c]);
+                samples++;
+            }
         
-        // Simulate delay
-        for (volatile int i = 0; i < 100000; i++);
+            if (window) {
+                struct eeg_bands b, avg = { 0 };
+                for (int c = 0; c < EEG_CHANNELS; c++) {
+                    eeg_bands(&channel[c], &b);
+                    for (int band = 0; band < EEG_BANDS; band++) {
+                        avg.relative[band] += b.relative[band] / EEG_CHANNELS;
+                    }
+                    avg.focus += b.focus / EEG_CHANNELS;
+                    avg.relaxation += b.relaxation / EEG_CHANNELS;
+                }
+                batch.timestamp[n] = sensor_ms(start, samples, EEG_SAMPLE_RATE);
+                batch.alpha_waves[n] = avg.relative[EEG_ALPHA];
+                batch.beta_waves[n] = avg.relative[EEG_BETA];
+                batch.theta_waves[n] = avg.relative[EEG_THETA];
+                batch.delta_waves[n] = avg.relative[EEG_DELTA];
+                batch.focus_level[n] = avg.focus;
+                batch.relaxation_level[n] = avg.relaxation;
+            
+                // Publish EEG data via SAL
+                if (++n == WIRE_BATCH_MAX) {
+                    long len = eeg_batch_encode(&batch, n, wire, sizeof(wire));
+                    sal_publish_id(eeg_topic, wire, (size_t)len);
+                    n = 0;
+                }
+            }
+        }
     }
 }
@@ -1,20 +1,40 @@
 #include "../include/sal/sal.h"
+#include "../include/auth.h"
 
+#define RENDER_FRAME_TICKS 2  // 50Hz at the 100Hz system tick
+
+// Session state shown by the UI, from AUTH_LOCK/AUTH_UNLOCK messages on
+// AUTH_SESSION_TOPIC. Locked until the first unlock.
+static struct {
+    int locked;
+    int32_t user_id;
+    float confidence;
+} render_session = { 1, -1, 0.0f };
+
+// Session changes, run from sal_dispatch()
+static void render_on_auth(const void *data, size_t len) {
+    struct AuthMsg msg;
+    if (auth_msg_decode(data, len, &msg) <= 0) return;
+    if (msg.type != AUTH_LOCK && msg.type != AUTH_UNLOCK) return;
+    render_session.locked = msg.type == AUTH_LOCK;
+    render_session.user_id = msg.user_id;
+    render_session.confidence = msg.confidence;
+}
 
 // Simple render/UI service
 void render_service_main(void) {
     // TODO: Initialize graphics/framebuffer
     // TODO: Set up SAL subscriptions for UI events
     
-    // Subscribe to authentication events
-    sal_subscribe("auth_success", NULL);  // Placeholder callback
+    // Subscribe to authentication session changes
+    sal_subscribe(AUTH_SESSION_TOPIC, render_on_auth);
     
     while (1) {
-        // TODO: Handle UI rendering
+        // Deliver pending events, or sleep until the next frame is due
+        sal_dispatch(RENDER_FRAME_TICKS);
+        
         // TODO: Process input events
+        // TODO: Handle UI rendering (lock screen while render_session.locked)
         // TODO: Update display
-        
-        // Simulate UI work
-        for (volatile int i = 0; i < 50000; i++);
     }
 }
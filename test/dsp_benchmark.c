@@ -0,0 +1,553 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/sal/sal_kernel.h"
+#include "../include/dsp/dsp_hrv.h"
+#include "../include/dsp/dsp_synth.h"
+#include "../include/dsp/dsp_fft.h"
+#include "../include/dsp/dsp_eeg.h"
+#include "../include/dsp/dsp_filter.h"
+#include "../include/dsp/dsp_fixed.h"
+#include "../include/dsp/dsp_source.h"
+#include "../include/dsp/dsp_match.h"
+#include "../include/dsp/dsp_trust.h"
+#include "../include/dsp/dsp_profile.h"
+#include "../include/dsp/dsp_fuse.h"
+#include "sal_benchmark.h"
+#include "dsp_benchmark.h"
+
+// Serial output from kernel
+extern void serial_print(const char* str);
+
+#define BENCH_HRV_RATE 250           // Hz
+#define BENCH_HRV_STREAMS 16
+#define BENCH_HRV_SECONDS 10         // Of signal per stream per run
+
+#define BENCH_FFT_RUNS 256
+#define BENCH_EEG_CHANNELS 8
+#define BENCH_EEG_SECONDS 8
+#define BENCH_EEG_MAX_RATE 1024
+#define BENCH_FILTER_FRAMES 1024
+#define BENCH_FILTER_RUNS 16
+#define BENCH_PIPELINE_SECONDS 60
+#define BENCH_PIPELINE_BLOCK 64     // Frames per source read
+#define BENCH_MATCH_QUERIES 256
+#define BENCH_MATCH_CLUSTERS 48
+#define BENCH_TRUST_RECORDS 4096
+#define BENCH_PROFILE_SIZE DSP_PROFILE_IMAGE_SIZE(DSP_PROFILE_MAX, DSP_PROFILE_MAX)
+#define BENCH_PROFILE_LOOKUPS 256
+#define BENCH_FUSE_MS 60000          // Of records per run
+#define BENCH_FUSE_STEP_MS 10
+
+static struct hrv_stream hrv_streams[BENCH_HRV_STREAMS];
+static float hrv_signal[BENCH_HRV_RATE * BENCH_HRV_SECONDS];
+
+// Every stream runs over the same precomputed ECG from a different
+// offset, so synthesis stays out of the timing. Reports the cost per
+// sample and how many streams one core keeps up with at the sample rate.
+void bench_dsp_hrv() {
+    const uint32_t len = BENCH_HRV_RATE * BENCH_HRV_SECONDS;
+    struct dsp_synth_ecg ecg;
+    dsp_synth_ecg_init(&ecg, BENCH_HRV_RATE, 800, 60, 1);
+    ecg.noise = 0.05f;
+    for (uint32_t i = 0; i < len; i++) hrv_signal[i] = dsp_synth_ecg_next(&ecg);
+    for (uint32_t s = 0; s < BENCH_HRV_STREAMS; s++) hrv_init(&hrv_streams[s], BENCH_HRV_RATE, 64);
+
+    uint32_t beats = 0;
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t i = 0; i < len; i++) {
+        for (uint32_t s = 0; s < BENCH_HRV_STREAMS; s++) {
+            uint32_t at = i + s * (len / BENCH_HRV_STREAMS);
+            if (at >= len) at -= len;
+            beats += (uint32_t)hrv_push(&hrv_streams[s], hrv_signal[at]);
+        }
+    }
+    uint64_t per_sample = bench_div(sal_arch_cycles() - start, len * BENCH_HRV_STREAMS);
+    if (per_sample == 0) per_sample = 1;
+
+    // A stream's share of one core is its per-sample cost times the rate
+    uint64_t ns_per_second = bench_ns(per_sample * BENCH_HRV_RATE);
+    if (ns_per_second == 0) ns_per_second = 1;
+
+    bench_begin("dsp_hrv");
+    bench_field("streams", BENCH_HRV_STREAMS);
+    bench_field("rate_hz", BENCH_HRV_RATE);
+    bench_field("beats", beats);
+    bench_field("cycles_per_sample", per_sample);
+    bench_field("ns_per_sample", bench_ns(per_sample));
+    bench_field("max_streams", bench_div(1000000000, (uint32_t)ns_per_second));
+    bench_end();
+}
+
+static struct dsp_fft fft_plan;
+static float fft_in[DSP_FFT_MAX];
+static float fft_re[DSP_FFT_MAX / 2 + 1] __attribute__((aligned(16)));
+static float fft_im[DSP_FFT_MAX / 2 + 1] __attribute__((aligned(16)));
+
+// One real transform of n points
+void bench_dsp_fft(uint32_t n) {
+    dsp_fft_init(&fft_plan, n);
+    uint32_t rng = 1;
+    for (uint32_t i = 0; i < n; i++) fft_in[i] = (float)(dsp_rand(&rng) >> 8) / 16777216.0f - 0.5f;
+    dsp_rfft(&fft_plan, fft_in, fft_re, fft_im);
+
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t i = 0; i < BENCH_FFT_RUNS; i++) {
+        dsp_rfft(&fft_plan, fft_in, fft_re, fft_im);
+    }
+    uint64_t per_fft = bench_div(sal_arch_cycles() - start, BENCH_FFT_RUNS);
+    bench_begin("dsp_fft");
+    bench_field("n", n);
+    bench_field("cycles", per_fft);
+    bench_field("ns", bench_ns(per_fft));
+    bench_end();
+}
+
+static struct eeg_plan eeg_plan;
+static struct eeg_channel eeg_channels[BENCH_EEG_CHANNELS];
+static float eeg_signal[BENCH_EEG_MAX_RATE * BENCH_EEG_SECONDS];
+
+// Welch band power over one-second windows with half overlap, for
+// BENCH_EEG_CHANNELS channels at the given rate. A window's cost
+// includes the pushes of the hop that completed it.
+void bench_dsp_eeg(uint32_t rate) {
+    const uint32_t len = rate * BENCH_EEG_SECONDS;
+    struct dsp_synth_eeg eeg;
+    dsp_synth_eeg_init(&eeg, rate, 1);
+    for (uint32_t i = 0; i < len; i++) eeg_signal[i] = dsp_synth_eeg_next(&eeg);
+    eeg_plan_init(&eeg_plan, rate, rate, 4);
+    for (uint32_t c = 0; c < BENCH_EEG_CHANNELS; c++) eeg_init(&eeg_channels[c], &eeg_plan);
+
+    uint32_t windows = 0;
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t i = 0; i < len; i++) {
+        for (uint32_t c = 0; c < BENCH_EEG_CHANNELS; c++) {
+            windows += (uint32_t)eeg_push(&eeg_channels[c], eeg_signal[i]);
+        }
+    }
+    uint64_t total = sal_arch_cycles() - start;
+    uint64_t per_window = bench_div(total, windows);
+
+    // One channel-second of work against one second of one core
+    uint64_t ns_per_second = bench_ns(bench_div(total, BENCH_EEG_CHANNELS * BENCH_EEG_SECONDS));
+    if (ns_per_second == 0) ns_per_second = 1;
+
+    bench_begin("dsp_eeg");
+    bench_field("channels", BENCH_EEG_CHANNELS);
+    bench_field("rate_hz", rate);
+    bench_field("nfft", eeg_plan.nfft);
+    bench_field("windows", windows);
+    bench_field("cycles_per_window", per_window);
+    bench_field("ns_per_window", bench_ns(per_window));
+    bench_field("max_channels", bench_div(1000000000, (uint32_t)ns_per_second));
+    bench_end();
+}
+
+static struct dsp_iir_bank iir_bank;
+static struct dsp_fir_decim fir_decim;
+static float filter_in[BENCH_FILTER_FRAMES * DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+static float filter_out[BENCH_FILTER_FRAMES * DSP_FILTER_MAX_CHANNELS] __attribute__((aligned(16)));
+
+static void bench_filter_report(const char *name, uint32_t channels, uint64_t cycles, uint32_t samples) {
+    uint64_t per_sample = bench_div(cycles, samples);
+    bench_begin(name);
+    bench_field("channels", channels);
+    bench_field("samples", samples);
+    bench_field("cycles_per_sample", per_sample);
+    bench_field("ns_per_kilosample", bench_ns(bench_div(cycles * 1000, samples)));
+    bench_end();
+}
+
+// Block filtering of 1024-frame blocks; costs are per channel-sample
+void bench_dsp_filter(uint32_t channels) {
+    uint32_t stride = dsp_filter_stride(channels), rng = 7;
+    for (uint32_t i = 0; i < BENCH_FILTER_FRAMES * stride; i++) {
+        filter_in[i] = (float)(dsp_rand(&rng) >> 8) / 16777216.0f - 0.5f;
+    }
+
+    // Band-pass and notch: four biquads, as in front of the HRV stage
+    struct dsp_biquad sections[4];
+    dsp_biquad_design(&sections[0], DSP_BIQUAD_HIGHPASS, 250.0f, 5.0f, 0.7071f);
+    dsp_biquad_design(&sections[1], DSP_BIQUAD_LOWPASS, 250.0f, 15.0f, 0.7071f);
+    dsp_biquad_design(&sections[2], DSP_BIQUAD_NOTCH, 250.0f, 50.0f, 10.0f);
+    dsp_biquad_design(&sections[3], DSP_BIQUAD_NOTCH, 250.0f, 60.0f, 10.0f);
+    dsp_iir_init(&iir_bank, channels, sections, 4);
+    dsp_iir_block(&iir_bank, filter_in, filter_out, BENCH_FILTER_FRAMES);
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t r = 0; r < BENCH_FILTER_RUNS; r++) {
+        dsp_iir_block(&iir_bank, filter_in, filter_out, BENCH_FILTER_FRAMES);
+    }
+    bench_filter_report("dsp_iir", channels, sal_arch_cycles() - start,
+                        BENCH_FILTER_RUNS * BENCH_FILTER_FRAMES * channels);
+
+    // 32 taps decimating by 4; cost per input sample
+    float taps[32];
+    dsp_fir_lowpass(taps, 32, 1024.0f, 100.0f);
+    dsp_fir_decim_init(&fir_decim, channels, taps, 32, 4);
+    dsp_fir_decim_block(&fir_decim, filter_in, BENCH_FILTER_FRAMES, filter_out);
+    start = sal_arch_cycles();
+    for (uint32_t r = 0; r < BENCH_FILTER_RUNS; r++) {
+        dsp_fir_decim_block(&fir_decim, filter_in, BENCH_FILTER_FRAMES, filter_out);
+    }
+    bench_filter_report("dsp_fir_decim", channels, sal_arch_cycles() - start,
+                        BENCH_FILTER_RUNS * BENCH_FILTER_FRAMES * channels);
+}
+
+static struct dsp_iir_q31 iir_q31;
+static struct dsp_fir_q15 fir_q15;
+static struct dsp_fft_q15 fft_q15;
+static int16_t fixed_in[BENCH_FILTER_FRAMES * DSP_FILTER_MAX_CHANNELS];
+static int16_t fixed_out[BENCH_FILTER_FRAMES * DSP_FILTER_MAX_CHANNELS];
+static int32_t fixed_re[DSP_FFT_MAX / 2 + 1], fixed_im[DSP_FFT_MAX / 2 + 1];
+
+// The bench_dsp_filter() and bench_dsp_fft() workloads on the Q15/Q31
+// kernels, sample by sample as a driver would run them
+void bench_dsp_fixed(uint32_t channels) {
+    uint32_t rng = 7;
+    for (uint32_t i = 0; i < BENCH_FILTER_FRAMES * channels; i++) {
+        fixed_in[i] = (int16_t)((int32_t)(dsp_rand(&rng) >> 17) - 16384);
+    }
+
+    struct dsp_biquad sections[4];
+    dsp_biquad_design(&sections[0], DSP_BIQUAD_HIGHPASS, 250.0f, 5.0f, 0.7071f);
+    dsp_biquad_design(&sections[1], DSP_BIQUAD_LOWPASS, 250.0f, 15.0f, 0.7071f);
+    dsp_biquad_design(&sections[2], DSP_BIQUAD_NOTCH, 250.0f, 50.0f, 10.0f);
+    dsp_biquad_design(&sections[3], DSP_BIQUAD_NOTCH, 250.0f, 60.0f, 10.0f);
+    dsp_iir_q31_init(&iir_q31, channels, sections, 4);
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t r = 0; r < BENCH_FILTER_RUNS; r++) {
+        for (uint32_t i = 0; i < BENCH_FILTER_FRAMES; i++) {
+            dsp_iir_q15_push(&iir_q31, fixed_in + i * channels, fixed_out + i * channels);
+        }
+    }
+    bench_filter_report("dsp_iir_q31", channels, sal_arch_cycles() - start,
+                        BENCH_FILTER_RUNS * BENCH_FILTER_FRAMES * channels);
+
+    float taps[32];
+    dsp_fir_lowpass(taps, 32, 1024.0f, 100.0f);
+    dsp_fir_q15_init(&fir_q15, channels, taps, 32, 4);
+    start = sal_arch_cycles();
+    for (uint32_t r = 0; r < BENCH_FILTER_RUNS; r++) {
+        dsp_fir_q15_block(&fir_q15, fixed_in, BENCH_FILTER_FRAMES, fixed_out);
+    }
+    bench_filter_report("dsp_fir_q15", channels, sal_arch_cycles() - start,
+                        BENCH_FILTER_RUNS * BENCH_FILTER_FRAMES * channels);
+
+    if (channels != 1) return;
+    for (uint32_t n = 256; n <= 2048; n *= 2) {
+        dsp_fft_q15_init(&fft_q15, n);
+        start = sal_arch_cycles();
+        for (uint32_t i = 0; i < BENCH_FFT_RUNS; i++) {
+            dsp_rfft_q15(&fft_q15, fixed_in, fixed_re, fixed_im);
+        }
+        uint64_t per_fft = bench_div(sal_arch_cycles() - start, BENCH_FFT_RUNS);
+        bench_begin("dsp_fft_q15");
+        bench_field("n", n);
+        bench_field("cycles", per_fft);
+        bench_field("ns", bench_ns(per_fft));
+        bench_end();
+    }
+}
+
+static struct dsp_source pipe_source;
+static float pipe_block[BENCH_PIPELINE_BLOCK * DSP_SOURCE_MAX_CHANNELS];
+
+static void bench_pipeline_report(const char *name, uint32_t channels, uint32_t rate, uint64_t cycles,
+                                  uint32_t outputs) {
+    // Seconds of signal per second of one core, via microseconds so the
+    // divisor fits in 32 bits
+    uint64_t us = bench_div(bench_ns(cycles), 1000);
+    if (us == 0) us = 1;
+    bench_begin("dsp_pipeline");
+    bench_label("source", name);
+    bench_field("channels", channels);
+    bench_field("rate_hz", rate);
+    bench_field("seconds", BENCH_PIPELINE_SECONDS);
+    bench_field("outputs", outputs);
+    bench_field("cycles_per_frame", bench_div(cycles, BENCH_PIPELINE_SECONDS * rate));
+    bench_field("realtime_x", bench_div((uint64_t)BENCH_PIPELINE_SECONDS * 1000000, (uint32_t)us));
+    bench_end();
+}
+
+// The services' pipelines end to end from an unpaced source, synthesis
+// included: how many times real time one core sustains. HRV is the ECG
+// band-pass and beat detection; EEG is four channels through the
+// high-pass, notch, decimator and Welch engine.
+void bench_dsp_pipeline() {
+    struct dsp_biquad sections[3];
+    dsp_source_synth(&pipe_source, DSP_SOURCE_ECG, 1, BENCH_HRV_RATE, 1);
+    dsp_biquad_design(&sections[0], DSP_BIQUAD_HIGHPASS, BENCH_HRV_RATE, 5.0f, 0.7071f);
+    dsp_biquad_design(&sections[1], DSP_BIQUAD_LOWPASS, BENCH_HRV_RATE, 15.0f, 0.7071f);
+    dsp_biquad_design(&sections[2], DSP_BIQUAD_NOTCH, BENCH_HRV_RATE, 50.0f, 10.0f);
+    dsp_iir_init(&iir_bank, 1, sections, 3);
+    hrv_init(&hrv_streams[0], BENCH_HRV_RATE, 64);
+    uint32_t beats = 0;
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t i = 0; i < BENCH_PIPELINE_SECONDS * BENCH_HRV_RATE; i += BENCH_PIPELINE_BLOCK) {
+        uint32_t got = dsp_source_read(&pipe_source, pipe_block, BENCH_PIPELINE_BLOCK);
+        for (uint32_t k = 0; k < got; k++) {
+            float y;
+            dsp_iir_push(&iir_bank, &pipe_block[k], &y);
+            beats += (uint32_t)hrv_push(&hrv_streams[0], y);
+        }
+    }
+    bench_pipeline_report("hrv", 1, BENCH_HRV_RATE, sal_arch_cycles() - start, beats);
+
+    const uint32_t channels = 4, rate = 512;
+    float taps[31];
+    dsp_source_synth(&pipe_source, DSP_SOURCE_EEG, channels, rate, 1);
+    dsp_biquad_design(&sections[0], DSP_BIQUAD_HIGHPASS, rate, 0.5f, 0.7071f);
+    dsp_biquad_design(&sections[1], DSP_BIQUAD_NOTCH, rate, 50.0f, 10.0f);
+    dsp_iir_init(&iir_bank, channels, sections, 2);
+    dsp_fir_lowpass(taps, 31, rate, 45.0f);
+    dsp_fir_decim_init(&fir_decim, channels, taps, 31, 2);
+    eeg_plan_init(&eeg_plan, rate / 2, 256, 4);
+    for (uint32_t c = 0; c < channels; c++) eeg_init(&eeg_channels[c], &eeg_plan);
+    uint32_t windows = 0;
+    start = sal_arch_cycles();
+    for (uint32_t i = 0; i < BENCH_PIPELINE_SECONDS * rate; i += BENCH_PIPELINE_BLOCK) {
+        uint32_t got = dsp_source_read(&pipe_source, pipe_block, BENCH_PIPELINE_BLOCK);
+        for (uint32_t k = 0; k < got; k++) {
+            float *frame = pipe_block + k * channels;
+            dsp_iir_push(&iir_bank, frame, frame);
+            if (dsp_fir_decim_push(&fir_decim, frame, frame)) {
+                int window = 0;
+                for (uint32_t c = 0; c < channels; c++) window |= eeg_push(&eeg_channels[c], frame[c]);
+                windows += (uint32_t)window;
+            }
+        }
+    }
+    bench_pipeline_report("eeg", channels, rate, sal_arch_cycles() - start, windows);
+}
+
+static struct dsp_match match_set;
+static float match_users[DSP_MATCH_MAX][DSP_MATCH_DIM];
+static float match_probes[BENCH_MATCH_QUERIES][DSP_MATCH_DIM];
+static uint32_t match_owner[BENCH_MATCH_QUERIES];
+
+static float bench_uniform(uint32_t *rng) {
+    return (float)(dsp_rand(rng) >> 8) / 16777216.0f - 0.5f;
+}
+
+static void bench_match_report(const char *mode, uint32_t users, float threshold, uint32_t nprobe) {
+    struct dsp_match_result r;
+    uint32_t found = 0, scanned = 0, scored = 0;
+    match_set.nprobe = nprobe;
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t q = 0; q < BENCH_MATCH_QUERIES; q++) {
+        found += dsp_match_identify(&match_set, match_probes[q], threshold, &r) == (int32_t)match_owner[q];
+        scanned += r.scanned;
+        scored += r.scored;
+    }
+    uint64_t per_query = bench_div(sal_arch_cycles() - start, BENCH_MATCH_QUERIES);
+    bench_begin("dsp_match");
+    bench_label("mode", mode);
+    bench_field("users", users);
+    bench_field("threshold_pct", threshold > 0.0f ? (uint64_t)(threshold * 100.0f) : 0);
+    bench_field("scanned", scanned / BENCH_MATCH_QUERIES);
+    bench_field("scored", scored / BENCH_MATCH_QUERIES);
+    bench_field("cycles_per_query", per_query);
+    bench_field("ns_per_query", bench_ns(per_query));
+    bench_field("recall_pct", found * 100 / BENCH_MATCH_QUERIES);
+    bench_end();
+}
+
+// Identification over a clustered synthetic population, each query a
+// noisy sample of an enrolled user. Past the linear size the indexed
+// search runs beside a search probing every cell, which is the linear
+// scan over the indexed layout; both run without a threshold
+// (nearest neighbour) and at a verification threshold, where the early
+// exit applies.
+void bench_dsp_match(uint32_t users) {
+    uint32_t rng = 5;
+    float centre[BENCH_MATCH_CLUSTERS][DSP_MATCH_DIM];
+    for (uint32_t c = 0; c < BENCH_MATCH_CLUSTERS; c++) {
+        for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) centre[c][d] = bench_uniform(&rng);
+    }
+    dsp_match_init(&match_set);
+    for (uint32_t u = 0; u < users; u++) {
+        const float *c = centre[dsp_rand(&rng) % BENCH_MATCH_CLUSTERS];
+        for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) match_users[u][d] = c[d] + 0.4f * bench_uniform(&rng);
+        dsp_match_enroll(&match_set, u, match_users[u]);
+    }
+    dsp_match_build(&match_set);
+    for (uint32_t q = 0; q < BENCH_MATCH_QUERIES; q++) {
+        match_owner[q] = dsp_rand(&rng) % users;
+        for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) {
+            match_probes[q][d] = match_users[match_owner[q]][d] + 0.1f * bench_uniform(&rng);
+        }
+    }
+
+    if (match_set.lists == 0) {
+        bench_match_report("linear", users, -1.0f, DSP_MATCH_NPROBE);
+        bench_match_report("linear", users, 0.9f, DSP_MATCH_NPROBE);
+        return;
+    }
+    bench_match_report("all_cells", users, -1.0f, match_set.lists);
+    bench_match_report("all_cells", users, 0.9f, match_set.lists);
+    bench_match_report("index", users, -1.0f, DSP_MATCH_NPROBE);
+    bench_match_report("index", users, 0.9f, DSP_MATCH_NPROBE);
+}
+
+static float trust_records[BENCH_TRUST_RECORDS][4];
+
+// Continuous authentication per record: evidence against a 4-feature
+// model (the EEG stream's) and the session update, on records 250 ms
+// apart. The monitor's share of a core is this cost times the record
+// rate, a few records per second.
+void bench_dsp_trust() {
+    static const float pop_mean[4] = { 0.30f, 0.25f, 0.20f, 0.25f }, pop_std[4] = { 0.10f, 0.10f, 0.08f, 0.10f };
+    uint32_t rng = 3;
+    struct dsp_trust_stats stats;
+    dsp_trust_stats_init(&stats, 4);
+    for (uint32_t r = 0; r < BENCH_TRUST_RECORDS; r++) {
+        for (uint32_t i = 0; i < 4; i++) trust_records[r][i] = pop_mean[i] + 0.05f * bench_uniform(&rng);
+        if (r < 64) dsp_trust_stats_add(&stats, trust_records[r]);
+    }
+    struct dsp_trust_model model;
+    struct dsp_trust t;
+    dsp_trust_model_init(&model, &stats, pop_mean, pop_std);
+    dsp_trust_init(&t, 10000, 0.2f, 0.8f);
+    dsp_trust_start(&t, 0, 0.95f);
+    uint32_t changes = 0;
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t r = 0; r < BENCH_TRUST_RECORDS; r++) {
+        changes += dsp_trust_update(&t, r * 250, dsp_trust_evidence(&model, trust_records[r])) != 0;
+    }
+    uint64_t per_record = bench_div(sal_arch_cycles() - start, BENCH_TRUST_RECORDS);
+    bench_begin("dsp_trust");
+    bench_field("features", 4);
+    bench_field("records", BENCH_TRUST_RECORDS);
+    bench_field("changes", changes);
+    bench_field("cycles_per_record", per_record);
+    bench_field("ns_per_record", bench_ns(per_record));
+    bench_end();
+}
+
+static struct dsp_profile_store profile_store;
+static uint8_t profile_images[2][BENCH_PROFILE_SIZE] __attribute__((aligned(16)));
+static uint8_t profile_journal[DSP_PROFILE_JOURNAL_SIZE] __attribute__((aligned(16)));
+
+// Fold the journal into a fresh image in the other buffer
+static long bench_profile_compact(uint32_t *from, uint64_t *cycles) {
+    uint64_t start = sal_arch_cycles();
+    *from = !*from;
+    long used = dsp_profile_compact(&profile_store, profile_images[*from], BENCH_PROFILE_SIZE);
+    dsp_profile_open(&profile_store, profile_images[*from], BENCH_PROFILE_SIZE, profile_journal,
+                     sizeof(profile_journal));
+    *cycles += sal_arch_cycles() - start;
+    return used;
+}
+
+// Profile store cold start: an image of `users` templates is built by
+// rounds of journal appends and compaction, then opened. Verifications
+// of BENCH_PROFILE_LOOKUPS distinct users follow, first cold (each
+// checks its record's CRC) and then warm. Open should cost the same at
+// any size.
+void bench_dsp_profile(uint32_t users) {
+    float v[DSP_PROFILE_DIM];
+    uint32_t rng = 9, from = 0, compactions = 0;
+    uint64_t compact = 0;
+    dsp_profile_format(profile_images[0], BENCH_PROFILE_SIZE, DSP_PROFILE_MAX);
+    dsp_profile_open(&profile_store, profile_images[0], BENCH_PROFILE_SIZE, profile_journal, sizeof(profile_journal));
+    for (uint32_t u = 0; u < users; u++) {
+        for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) v[d] = bench_uniform(&rng);
+        if (dsp_profile_put(&profile_store, u, v) == DSP_ERR_FULL) {
+            bench_profile_compact(&from, &compact);
+            compactions++;
+            dsp_profile_put(&profile_store, u, v);
+        }
+    }
+    long used = bench_profile_compact(&from, &compact);
+    compactions++;
+
+    uint64_t start = sal_arch_cycles();
+    dsp_profile_open(&profile_store, profile_images[from], (uint32_t)used, NULL, 0);
+    uint64_t open = sal_arch_cycles() - start;
+
+    uint64_t verify[2];
+    for (int pass = 0; pass < 2; pass++) {
+        start = sal_arch_cycles();
+        for (uint32_t i = 0; i < BENCH_PROFILE_LOOKUPS; i++) {
+            dsp_profile_score(&profile_store, i * (users / BENCH_PROFILE_LOOKUPS), v);
+        }
+        verify[pass] = bench_div(sal_arch_cycles() - start, BENCH_PROFILE_LOOKUPS);
+    }
+    bench_begin("dsp_profile");
+    bench_field("users", users);
+    bench_field("image_bytes", (uint64_t)used);
+    bench_field("open_cycles", open);
+    bench_field("cold_verify_cycles", verify[0]);
+    bench_field("warm_verify_cycles", verify[1]);
+    bench_field("compact_cycles", bench_div(compact, compactions));
+    bench_end();
+}
+
+static struct dsp_fuse fuse_stage;
+
+// Fusion of `streams` 2-feature streams into 100 ms frames. Stream k
+// records every 50 + 30k ms with jitter; time advances in 10 ms steps,
+// each stream pushes the records due and the stage emits what it can,
+// as the auth service does on each batch. Per-frame cost and the state
+// should grow with the stream count and nothing else.
+void bench_dsp_fuse(uint32_t streams) {
+    uint32_t next[DSP_FUSE_MAX_STREAMS], rng = 5, records = 0, frames = 0;
+    struct dsp_fuse_frame frame;
+    dsp_fuse_init(&fuse_stage, 100, 1000);
+    for (uint32_t k = 0; k < streams; k++) {
+        dsp_fuse_add_stream(&fuse_stage, 2, 400);
+        next[k] = k;
+    }
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t now = 0; now < BENCH_FUSE_MS; now += BENCH_FUSE_STEP_MS) {
+        for (uint32_t k = 0; k < streams; k++) {
+            for (; next[k] <= now; records++) {
+                float x[2] = { (float)next[k], bench_uniform(&rng) };
+                dsp_fuse_push(&fuse_stage, k, next[k], x);
+                next[k] += 50 + 30 * k + (uint32_t)(10.0f * (bench_uniform(&rng) + 1.0f));
+            }
+        }
+        while (dsp_fuse_pull(&fuse_stage, &frame)) frames++;
+    }
+    uint64_t per_frame = bench_div(sal_arch_cycles() - start, frames);
+    bench_begin("dsp_fuse");
+    bench_field("streams", streams);
+    bench_field("state_bytes", streams * sizeof(struct dsp_fuse_stream));
+    bench_field("records", records);
+    bench_field("frames", frames);
+    bench_field("cycles_per_frame", per_frame);
+    bench_field("ns_per_frame", bench_ns(per_frame));
+    bench_end();
+}
+
+// Main benchmark runner
+void run_dsp_benchmarks() {
+    serial_print("\n");
+    serial_print("==========================================\n");
+    serial_print("    AERODESK DSP BENCHMARKS\n");
+    serial_print("==========================================\n");
+
+    bench_calibrate();
+    bench_dsp_hrv();
+    bench_dsp_fft(256);
+    bench_dsp_fft(1024);
+    bench_dsp_fft(2048);
+    bench_dsp_eeg(256);
+    bench_dsp_eeg(512);
+    bench_dsp_eeg(1024);
+    bench_dsp_filter(1);
+    bench_dsp_filter(4);
+    bench_dsp_filter(16);
+    bench_dsp_fixed(1);
+    bench_dsp_fixed(4);
+    bench_dsp_fixed(16);
+    bench_dsp_pipeline();
+    bench_dsp_match(256);
+    bench_dsp_match(1024);
+    bench_dsp_match(DSP_MATCH_MAX);
+    bench_dsp_trust();
+    bench_dsp_profile(256);
+    bench_dsp_profile(DSP_PROFILE_MAX);
+    bench_dsp_fuse(2);
+    bench_dsp_fuse(4);
+    bench_dsp_fuse(DSP_FUSE_MAX_STREAMS);
+}
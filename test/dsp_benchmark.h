@@ -0,0 +1,22 @@
+#ifndef DSP_BENCHMARK_H
+#define DSP_BENCHMARK_H
+
+#include <stdint.h>
+
+// DSP benchmarks (kernel built with BENCH=1), in the same output format
+// as sal_benchmark.c
+void run_dsp_benchmarks(void);
+
+// Individual benchmarks
+void bench_dsp_hrv(void);
+void bench_dsp_fft(uint32_t n);
+void bench_dsp_eeg(uint32_t rate);
+void bench_dsp_filter(uint32_t channels);
+void bench_dsp_fixed(uint32_t channels);
+void bench_dsp_pipeline(void);
+void bench_dsp_match(uint32_t users);
+void bench_dsp_trust(void);
+void bench_dsp_profile(uint32_t users);
+void bench_dsp_fuse(uint32_t streams);
+
+#endif // DSP_BENCHMARK_H
@@ -0,0 +1,1280 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/dsp/dsp_hrv.h"
+#include "../include/dsp/dsp_synth.h"
+#include "../include/dsp/dsp_fft.h"
+#include "../include/dsp/dsp_eeg.h"
+#include "../include/dsp/dsp_filter.h"
+#include "../include/dsp/dsp_fixed.h"
+#include "../include/dsp/dsp_source.h"
+#include "../include/dsp/dsp_match.h"
+#include "../include/dsp/dsp_trust.h"
+#include "../include/dsp/dsp_profile.h"
+#include "../include/dsp/dsp_fuse.h"
+#include "dsp_test.h"
+
+// Test framework from kernel_test.c
+extern void serial_print(const char* str);
+extern void test_start(const char* test_name);
+extern void test_assert(int condition, const char* message);
+extern void test_end(void);
+
+static int close_to(float a, float b, float tol) {
+    float d = a - b;
+    return d <= tol && d >= -tol;
+}
+
+// Window metrics recomputed from scratch over the accepted intervals
+// rr[first..count), where gap[i] marks an interval that followed an
+// artifact and so has no successive difference
+static void hrv_reference(const uint32_t *rr, const uint8_t *gap, uint32_t first, uint32_t count,
+                          struct hrv_metrics *m) {
+    double sum = 0.0, sum2 = 0.0, d2 = 0.0;
+    uint32_t ndiff = 0, nn50 = 0, n = count - first;
+    for (uint32_t i = first; i < count; i++) {
+        sum += rr[i];
+        if (i > first && !gap[i]) {
+            int32_t d = (int32_t)rr[i] - (int32_t)rr[i - 1];
+            d2 += (double)d * d;
+            ndiff++;
+            if (d > HRV_NN50_MS || d < -HRV_NN50_MS) nn50++;
+        }
+    }
+    double mean = sum / n;
+    for (uint32_t i = first; i < count; i++) sum2 += (rr[i] - mean) * (rr[i] - mean);
+    m->beats = n;
+    m->mean_rr = (float)mean;
+    m->sdnn = n > 1 ? dsp_sqrtf((float)(sum2 / (n - 1))) : 0.0f;
+    m->rmssd = ndiff ? dsp_sqrtf((float)(d2 / ndiff)) : 0.0f;
+    m->pnn50 = ndiff ? 100.0f * (float)nn50 / (float)ndiff : 0.0f;
+}
+
+// Test HRV window metrics and beat detection
+void test_dsp_hrv() {
+    test_start("DSP HRV Engine");
+
+    test_assert(close_to(dsp_sqrtf(2.0f), 1.4142135f, 1e-6f), "Square root without libm");
+    test_assert(close_to(dsp_sqrtf(1e6f), 1000.0f, 1e-3f), "Square root of a large value");
+    test_assert(dsp_sqrtf(-1.0f) == 0.0f, "Square root of a negative value is zero");
+
+    // Sliding window against a full recomputation, artifacts included
+    static struct hrv_stream s;
+    static uint32_t rr[400];
+    static uint8_t gap[400];
+    hrv_init(&s, 250, 32);
+    uint32_t rng = 12345, count = 0, artifacts = 0;
+    uint8_t after_artifact = 0;
+    int ok = 1;
+    for (uint32_t i = 0; i < 400; i++) {
+        uint32_t v = 700 + dsp_rand(&rng) % 200;
+        if (i % 37 == 36) v = 2500;   // Dropout
+        if (i % 53 == 52) v = 150;    // Double detection
+        int accepted = hrv_add_rr(&s, v);
+        if (!accepted) {
+            artifacts++;
+            after_artifact = 1;
+            continue;
+        }
+        rr[count] = v;
+        gap[count++] = after_artifact;
+        after_artifact = 0;
+
+        struct hrv_metrics got, want;
+        hrv_metrics(&s, &got);
+        hrv_reference(rr, gap, count > 32 ? count - 32 : 0, count, &want);
+        ok &= got.beats == want.beats && close_to(got.mean_rr, want.mean_rr, 0.01f) &&
+              close_to(got.sdnn, want.sdnn, 0.01f) && close_to(got.rmssd, want.rmssd, 0.01f) &&
+              close_to(got.pnn50, want.pnn50, 0.01f);
+    }
+    test_assert(ok, "Running sums match recomputed window metrics");
+    test_assert(artifacts > 0, "Implausible intervals rejected");
+    test_assert(s.artifacts == artifacts, "Rejected intervals counted");
+
+    // Detection on a noisy synthetic ECG: 800 +/- 60 ms for 60 s
+    static struct dsp_synth_ecg ecg;
+    dsp_synth_ecg_init(&ecg, 250, 800, 60, 7);
+    ecg.noise = 0.05f;
+    hrv_init(&s, 250, 64);
+    uint32_t beats = 0, truth_beats = 0, matched = 0;
+    uint32_t truth[128];
+    uint32_t ntruth = 0;
+    for (uint32_t i = 0; i < 250 * 60; i++) {
+        float x = dsp_synth_ecg_next(&ecg);
+        if (ecg.beat && ecg.rr_ms != 0 && i > 250 * 3) {
+            truth[ntruth++ % 128] = ecg.rr_ms;
+            truth_beats++;
+        }
+        if (hrv_push(&s, x) && i > 250 * 3 && s.last_rr != 0) {
+            beats++;
+            // The detector lags the truth by a fixed delay; match the
+            // interval against the recent true ones
+            for (uint32_t k = 0; k < 4 && k < ntruth; k++) {
+                uint32_t t = truth[(ntruth - 1 - k) % 128];
+                int32_t d = (int32_t)s.last_rr - (int32_t)t;
+                if (d <= 8 && d >= -8) {
+                    matched++;
+                    break;
+                }
+            }
+        }
+    }
+    test_assert(beats + 2 >= truth_beats, "Every beat detected");
+    test_assert(beats <= truth_beats + 2, "No beat detected twice");
+    test_assert(matched * 100 >= beats * 95, "RR intervals within two samples of the truth");
+    struct hrv_metrics m;
+    hrv_metrics(&s, &m);
+    test_assert(m.beats == 64, "Window full");
+    test_assert(close_to(m.heart_rate, 75.0f, 3.0f), "Mean heart rate from the window");
+    test_assert(m.sdnn > 20.0f, "SDNN above the floor for +/-60 ms jitter");
+    test_assert(m.sdnn < 50.0f, "SDNN below the ceiling for +/-60 ms jitter");
+    test_assert(m.rmssd > 30.0f, "RMSSD in range for +/-60 ms jitter");
+    test_assert(m.pnn50 > 20.0f, "pNN50 in range for +/-60 ms jitter");
+
+    // A weaker signal: the threshold decays until beats are found again
+    ecg.amplitude = 0.2f;
+    ecg.noise = 0.01f;
+    beats = 0;
+    for (uint32_t i = 0; i < 250 * 20; i++) {
+        beats += (uint32_t)hrv_push(&s, dsp_synth_ecg_next(&ecg));
+    }
+    test_assert(beats >= 20, "Detection recovers after an amplitude drop");
+}
+
+// Test the real FFT against a direct DFT
+void test_dsp_fft() {
+    test_start("DSP Real FFT");
+
+    double s, c;
+    dsp_sincos(2.5, &s, &c);
+    test_assert(close_to((float)s, 0.5984721f, 1e-7f), "sin without libm");
+    test_assert(close_to((float)c, -0.8011436f, 1e-7f), "cos without libm");
+
+    static struct dsp_fft f;
+    static float x[DSP_FFT_MAX];
+    static float re[DSP_FFT_MAX / 2 + 1] __attribute__((aligned(16)));
+    static float im[DSP_FFT_MAX / 2 + 1] __attribute__((aligned(16)));
+    test_assert(dsp_fft_init(&f, 8) == DSP_ERR_INVAL, "Too small a size rejected");
+    test_assert(dsp_fft_init(&f, 96) == DSP_ERR_INVAL, "Size not a power of two rejected");
+    test_assert(dsp_fft_init(&f, 2 * DSP_FFT_MAX) == DSP_ERR_INVAL, "Size past DSP_FFT_MAX rejected");
+
+    // 64 and 256 points end in radix-4 stages after a radix-2 one or
+    // not (32 and 128 complex points); 2048 is the largest plan
+    static const uint32_t sizes[] = { 16, 64, 256, 2048 };
+    uint32_t rng = 99;
+    int ok = 1;
+    for (uint32_t t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++) {
+        uint32_t n = sizes[t];
+        ok &= dsp_fft_init(&f, n) == 0;
+        for (uint32_t i = 0; i < n; i++) x[i] = (float)(dsp_rand(&rng) >> 8) / 16777216.0f - 0.5f;
+        dsp_rfft(&f, x, re, im);
+        // Check a spread of bins, including DC, the centre and Nyquist
+        for (uint32_t k = 0; k <= n / 2; k += (k < 4 || k + 4 > n / 2) ? 1 : n / 16) {
+            double sr = 0.0, si = 0.0;
+            for (uint32_t i = 0; i < n; i++) {
+                dsp_sincos(-6.28318530717958647692 * (double)((k * i) % n) / (double)n, &s, &c);
+                sr += x[i] * c;
+                si += x[i] * s;
+            }
+            ok &= close_to(re[k], (float)sr, 1e-4f * (float)n) && close_to(im[k], (float)si, 1e-4f * (float)n);
+        }
+    }
+    test_assert(ok, "Bins match a direct DFT from 16 to 2048 points");
+}
+
+// Test Welch band powers and the derived indices
+void test_dsp_eeg() {
+    test_start("DSP EEG Band Power");
+
+    static struct eeg_plan plan;
+    static struct eeg_channel ch;
+    struct eeg_bands b;
+    test_assert(eeg_plan_init(&plan, 256, 100, 4) == DSP_ERR_INVAL, "Bad size rejected");
+    test_assert(eeg_plan_init(&plan, 50, 64, 4) == DSP_ERR_INVAL, "Bad rate rejected");
+    test_assert(eeg_plan_init(&plan, 256, 256, 4) == 0, "Plan at 256 Hz");
+    test_assert(plan.hop == 128, "Hop is half a window");
+    test_assert(plan.band_lo[EEG_ALPHA] == 8, "Alpha band starts at its bin");
+    test_assert(plan.band_hi[EEG_ALPHA] == 13, "Alpha band ends at its bin");
+
+    // A unit 10 Hz sine has power 1/2, all of it in alpha
+    static struct dsp_synth_eeg eeg;
+    dsp_synth_eeg_init(&eeg, 256, 1);
+    eeg.noise = 0.0f;
+    for (int i = 0; i < DSP_SYNTH_TONES; i++) eeg.amplitude[i] = i == 2 ? 1.0f : 0.0f;
+    eeg_init(&ch, &plan);
+    int windows = 0;
+    for (uint32_t i = 0; i < 256 * 4; i++) windows += eeg_push(&ch, dsp_synth_eeg_next(&eeg));
+    eeg_bands(&ch, &b);
+    test_assert(windows == 7, "Windows every half window");
+    test_assert(b.segments == 4, "Four windows averaged");
+    test_assert(close_to(b.power[EEG_ALPHA], 0.5f, 0.01f), "Tone power lands in its band");
+    test_assert(b.relative[EEG_ALPHA] > 0.99f, "No tone power outside its band");
+
+    // Resting mix (alpha-dominant), then an engaged one (beta-dominant)
+    dsp_synth_eeg_init(&eeg, 512, 2);
+    test_assert(eeg_plan_init(&plan, 512, 1024, 4) == 0, "Plan at 512 Hz");
+    eeg_init(&ch, &plan);
+    for (uint32_t i = 0; i < 512 * 8; i++) eeg_push(&ch, dsp_synth_eeg_next(&eeg));
+    eeg_bands(&ch, &b);
+    float rest_relax = b.relaxation, rest_focus = b.focus;
+    float rel_sum = b.relative[0] + b.relative[1] + b.relative[2] + b.relative[3];
+    eeg.amplitude[2] = 0.3f;
+    eeg.amplitude[3] = 1.2f;
+    for (uint32_t i = 0; i < 512 * 8; i++) eeg_push(&ch, dsp_synth_eeg_next(&eeg));
+    eeg_bands(&ch, &b);
+    test_assert(close_to(rel_sum, 1.0f, 1e-4f), "Relative powers sum to one");
+    test_assert(rest_relax > 0.8f, "Alpha-dominant signal reads as relaxed");
+    test_assert(rest_focus < 0.3f, "Alpha-dominant signal does not read as focused");
+    test_assert(b.focus > 0.6f, "Beta-dominant signal reads as focused");
+    test_assert(b.relaxation < 0.2f, "Beta-dominant signal does not read as relaxed");
+}
+
+// Peak magnitude of the filter's steady-state response to a unit sine
+static float filter_gain(struct dsp_iir_bank *f, float rate, float hz) {
+    dsp_iir_reset(f);
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < (uint32_t)rate * 4; i++) {
+        double s, c;
+        dsp_sincos(6.28318530717958647692 * hz * (double)i / rate, &s, &c);
+        float x = (float)s, y;
+        dsp_iir_push(f, &x, &y);
+        if (i >= (uint32_t)rate * 3 && (y > peak || -y > peak)) peak = y > 0.0f ? y : -y;
+    }
+    return peak;
+}
+
+// Test biquad cascades and polyphase decimation
+void test_dsp_filter() {
+    test_start("DSP Filter Bank");
+
+    static struct dsp_iir_bank bank, bank2;
+    struct dsp_biquad sec[3];
+    test_assert(dsp_biquad_design(&sec[0], DSP_BIQUAD_NOTCH, 250.0f, 125.0f, 1.0f) == DSP_ERR_INVAL,
+                "Centre at Nyquist rejected");
+    test_assert(dsp_biquad_design(&sec[0], DSP_BIQUAD_LOWPASS, 250.0f, 10.0f, 0.0f) == DSP_ERR_INVAL,
+                "Zero Q rejected");
+    test_assert(dsp_iir_init(&bank, DSP_FILTER_MAX_CHANNELS + 1, sec, 1) == DSP_ERR_INVAL,
+                "Too many channels rejected");
+
+    // 50 Hz notch: hum removed, the QRS band kept
+    dsp_biquad_design(&sec[0], DSP_BIQUAD_NOTCH, 250.0f, 50.0f, 10.0f);
+    dsp_iir_init(&bank, 1, sec, 1);
+    test_assert(filter_gain(&bank, 250.0f, 50.0f) < 0.01f, "Notch rejects 50 Hz");
+    test_assert(filter_gain(&bank, 250.0f, 10.0f) > 0.97f, "Notch passes 10 Hz");
+    dsp_biquad_design(&sec[0], DSP_BIQUAD_HIGHPASS, 250.0f, 5.0f, 0.7071f);
+    dsp_biquad_design(&sec[1], DSP_BIQUAD_LOWPASS, 250.0f, 15.0f, 0.7071f);
+    dsp_iir_init(&bank, 1, sec, 2);
+    test_assert(filter_gain(&bank, 250.0f, 1.0f) < 0.05f, "Band-pass cascade stops baseline wander");
+    test_assert(filter_gain(&bank, 250.0f, 9.0f) > 0.8f, "Band-pass cascade passes the QRS band");
+    test_assert(filter_gain(&bank, 250.0f, 60.0f) < 0.1f, "Band-pass cascade stops high frequencies");
+
+    // Six channels (two SSE groups, one padded) against a scalar
+    // reference per channel; block in place vs streaming
+    dsp_biquad_design(&sec[2], DSP_BIQUAD_NOTCH, 250.0f, 50.0f, 10.0f);
+    dsp_iir_init(&bank, 6, sec, 3);
+    dsp_iir_init(&bank2, 6, sec, 3);
+    static float frames[64][8] __attribute__((aligned(16)));
+    static float ref_z[6][3][2];
+    uint32_t rng = 5;
+    int ok = 1;
+    for (uint32_t i = 0; i < 64; i++) {
+        for (uint32_t ch = 0; ch < 8; ch++) frames[i][ch] = ch < 6 ? (float)(dsp_rand(&rng) >> 8) / 16777216.0f : 0.0f;
+    }
+    float streamed[64][6];
+    for (uint32_t i = 0; i < 64; i++) dsp_iir_push(&bank2, frames[i], streamed[i]);
+    static float want[64][6];
+    for (uint32_t ch = 0; ch < 6; ch++) {
+        for (uint32_t i = 0; i < 64; i++) {
+            float v = frames[i][ch];
+            for (int k = 0; k < 3; k++) {
+                float y = sec[k].b0 * v + ref_z[ch][k][0];
+                ref_z[ch][k][0] = sec[k].b1 * v - sec[k].a1 * y + ref_z[ch][k][1];
+                ref_z[ch][k][1] = sec[k].b2 * v - sec[k].a2 * y;
+                v = y;
+            }
+            want[i][ch] = v;
+        }
+    }
+    dsp_iir_block(&bank, &frames[0][0], &frames[0][0], 64);
+    for (uint32_t i = 0; i < 64; i++) {
+        for (uint32_t ch = 0; ch < 6; ch++) {
+            ok &= close_to(frames[i][ch], want[i][ch], 1e-5f) && frames[i][ch] == streamed[i][ch];
+        }
+    }
+    test_assert(ok, "Channels filtered independently, block and streaming agree");
+
+    // Decimate five channels by 3 with 31 taps (branches of unequal
+    // length) against the direct convolution
+    static struct dsp_fir_decim dec, dec2;
+    static float h[31];
+    test_assert(dsp_fir_lowpass(h, 31, 750.0f, 100.0f) == 0, "Low-pass taps designed");
+    test_assert(dsp_fir_decim_init(&dec, 5, h, 31, 3) == 0, "Block decimator built");
+    test_assert(dsp_fir_decim_init(&dec2, 5, h, 31, 3) == 0, "Streaming decimator built");
+    test_assert(dec.branch_len == 11, "Taps split into branches of up to 11");
+    static float in[96][8] __attribute__((aligned(16)));
+    static float out[32][8] __attribute__((aligned(16)));
+    for (uint32_t i = 0; i < 96; i++) {
+        for (uint32_t ch = 0; ch < 8; ch++) in[i][ch] = ch < 5 ? (float)(dsp_rand(&rng) >> 8) / 16777216.0f - 0.5f : 0.0f;
+    }
+    uint32_t produced = dsp_fir_decim_block(&dec, &in[0][0], 96, &out[0][0]);
+    ok = produced == 32;
+    uint32_t pushed = 0;
+    for (uint32_t i = 0; i < 96; i++) {
+        float y[5];
+        if (dsp_fir_decim_push(&dec2, in[i], y)) {
+            for (uint32_t ch = 0; ch < 5; ch++) ok &= y[ch] == out[pushed][ch];
+            pushed++;
+        }
+    }
+    for (uint32_t m = 0; m < 32; m++) {
+        for (uint32_t ch = 0; ch < 5; ch++) {
+            float acc = 0.0f;
+            for (uint32_t k = 0; k < 31 && k <= 3 * m; k++) acc += h[k] * in[3 * m - k][ch];
+            ok &= close_to(out[m][ch], acc, 1e-5f);
+        }
+    }
+    test_assert(ok, "Polyphase output matches direct convolution");
+    test_assert(pushed == 32, "Streaming decimator produces every output");
+
+    // The mains hum on an ECG is gone after the band-pass and notch
+    static struct dsp_synth_ecg ecg;
+    static struct hrv_stream s;
+    dsp_synth_ecg_init(&ecg, 250, 800, 60, 3);
+    ecg.noise = 0.05f;
+    dsp_biquad_design(&sec[0], DSP_BIQUAD_HIGHPASS, 250.0f, 5.0f, 0.7071f);
+    dsp_biquad_design(&sec[1], DSP_BIQUAD_LOWPASS, 250.0f, 15.0f, 0.7071f);
+    dsp_biquad_design(&sec[2], DSP_BIQUAD_NOTCH, 250.0f, 50.0f, 10.0f);
+    dsp_iir_init(&bank, 1, sec, 3);
+    hrv_init(&s, 250, 64);
+    uint32_t beats = 0, truth = 0;
+    for (uint32_t i = 0; i < 250 * 40; i++) {
+        double sn, cs;
+        dsp_sincos(6.28318530717958647692 * 50.0 * (double)i / 250.0, &sn, &cs);
+        float x = dsp_synth_ecg_next(&ecg) + 0.5f * (float)sn, y;
+        dsp_iir_push(&bank, &x, &y);
+        if (i > 250 * 3) {
+            truth += (uint32_t)ecg.beat;
+            beats += (uint32_t)hrv_push(&s, y);
+        } else {
+            hrv_push(&s, y);
+        }
+    }
+    struct hrv_metrics m;
+    hrv_metrics(&s, &m);
+    test_assert(beats + 1 >= truth, "Beats found through 50 Hz hum after filtering");
+    test_assert(beats <= truth + 1, "No extra beats from the hum");
+    test_assert(close_to(m.heart_rate, 75.0f, 3.0f), "Heart rate through the hum");
+}
+
+// Fixed-point results against the float path: the largest difference
+// in output LSBs, and signal to error power, with the fixed values
+// read back through `scale` (LSBs per float unit)
+struct fixed_error {
+    float max_lsb;
+    float snr;              // Power ratio; 1e6 is 60 dB
+};
+
+static void fixed_compare(const float *want, const int32_t *got, uint32_t n, float scale, struct fixed_error *e) {
+    double signal = 0.0, noise = 0.0;
+    e->max_lsb = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        float ref = want[i] * scale, d = (float)got[i] - ref;
+        if (d < 0.0f) d = -d;
+        if (d > e->max_lsb) e->max_lsb = d;
+        signal += (double)ref * ref;
+        noise += (double)d * d;
+    }
+    e->snr = noise > 0.0 ? (float)(signal / noise) : 1e30f;
+}
+
+// FNV-1a over the fixed-point output: integer kernels give the same
+// bits on every build, so these are pinned
+static uint32_t fixed_hash(uint32_t h, const int32_t *v, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t w = (uint32_t)v[i];
+        for (int b = 0; b < 4; b++) {
+            h ^= (w >> (8 * b)) & 0xFF;
+            h *= 16777619u;
+        }
+    }
+    return h;
+}
+
+#define FIXED_N 1024
+
+// Test the Q15/Q31 kernels against their float versions
+void test_dsp_fixed() {
+    test_start("DSP Fixed Point");
+
+    test_assert(dsp_mul_q15(-32768, -32768) == 32767, "Q15 multiply saturates -1 * -1");
+    test_assert(dsp_mul_q15(16384, 16384) == 8192, "Q15 multiply of 0.5 * 0.5");
+    test_assert(dsp_add_q15(30000, 10000) == 32767, "Q15 add saturates high");
+    test_assert(dsp_add_q15(-30000, -10000) == -32768, "Q15 add saturates low");
+    test_assert(dsp_sat_q31((int64_t)1 << 40) == 0x7FFFFFFF, "Q31 saturation");
+    test_assert(dsp_mul_q31(0x40000000, -0x40000000) == -0x20000000, "Q31 multiply");
+    test_assert(dsp_udiv64(0xFFFFFFFFFFFFFFFFull, 10) == 1844674407370955161ull, "64-by-32 bit division");
+    test_assert(dsp_isqrt64(1ull << 62) == (1u << 31), "Integer square root of 2^62");
+    test_assert(dsp_isqrt64(99) == 9, "Integer square root rounds down");
+    test_assert(dsp_q15_from_float(1.0f) == 32767, "Float to Q15 saturates 1.0");
+    test_assert(dsp_q15_from_float(-0.5f) == -16384, "Float to Q15 of -0.5");
+
+    static int16_t x16[FIXED_N];
+    static float xf[FIXED_N], yf[FIXED_N];
+    static int32_t y32[FIXED_N];
+    uint32_t rng = 77, hash = 2166136261u;
+    for (uint32_t i = 0; i < FIXED_N; i++) {
+        x16[i] = (int16_t)((int32_t)(dsp_rand(&rng) >> 17) - 16384);   // +/- 0.5
+        xf[i] = (float)x16[i] / DSP_Q15_ONE;
+    }
+    struct fixed_error e;
+
+    // EEG front end, the hardest case: a 0.5 Hz high-pass at 512 Hz
+    // puts its poles right next to 1
+    static struct dsp_iir_bank bank;
+    static struct dsp_iir_q31 q31;
+    struct dsp_biquad sec[2];
+    dsp_biquad_design(&sec[0], DSP_BIQUAD_HIGHPASS, 512.0f, 0.5f, 0.7071f);
+    dsp_biquad_design(&sec[1], DSP_BIQUAD_NOTCH, 512.0f, 50.0f, 10.0f);
+    dsp_iir_init(&bank, 1, sec, 2);
+    test_assert(dsp_iir_q31_init(&q31, 1, sec, 2) == 0, "Q31 cascade from a float design");
+    static float frame[4] __attribute__((aligned(16)));
+    for (uint32_t i = 0; i < FIXED_N; i++) {
+        frame[0] = xf[i];
+        dsp_iir_block(&bank, frame, frame, 1);
+        yf[i] = frame[0];
+        int16_t y;
+        dsp_iir_q15_push(&q31, &x16[i], &y);
+        y32[i] = y;
+    }
+    fixed_compare(yf, y32, FIXED_N, DSP_Q15_ONE, &e);
+    test_assert(e.max_lsb <= 2.0f, "Q31 biquads within two Q15 LSBs of float");
+    test_assert(e.snr > 1e7f, "Q31 biquads SNR above 70 dB");
+    hash = fixed_hash(hash, y32, FIXED_N);
+
+    // Decimating FIR
+    static struct dsp_fir_decim dec;
+    static struct dsp_fir_q15 qdec;
+    static float h[31];
+    dsp_fir_lowpass(h, 31, 512.0f, 45.0f);
+    dsp_fir_decim_init(&dec, 1, h, 31, 2);
+    test_assert(dsp_fir_q15_init(&qdec, 1, h, 31, 2) == 0, "Q15 decimator from a float design");
+    uint32_t outs = 0;
+    for (uint32_t i = 0; i < FIXED_N; i++) {
+        frame[0] = xf[i];
+        int16_t y;
+        if (dsp_fir_decim_block(&dec, frame, 1, frame)) yf[outs] = frame[0];
+        if (dsp_fir_q15_push(&qdec, &x16[i], &y)) y32[outs++] = y;
+    }
+    fixed_compare(yf, y32, outs, DSP_Q15_ONE, &e);
+    test_assert(outs == FIXED_N / 2, "Q15 decimator output count");
+    test_assert(e.max_lsb <= 4.0f, "Q15 decimator within four LSBs of float");
+    test_assert(e.snr > 1e7f, "Q15 decimator SNR above 70 dB");
+    hash = fixed_hash(hash, y32, outs);
+
+    // FFT: both scaled to X / n
+    static struct dsp_fft f;
+    static struct dsp_fft_q15 qf;
+    static float re[FIXED_N / 2 + 1] __attribute__((aligned(16)));
+    static float im[FIXED_N / 2 + 1] __attribute__((aligned(16)));
+    static int32_t qre[FIXED_N / 2 + 1], qim[FIXED_N / 2 + 1];
+    dsp_fft_init(&f, FIXED_N);
+    test_assert(dsp_fft_q15_init(&qf, 100) == DSP_ERR_INVAL, "Q15 FFT rejects a size that is not a power of two");
+    test_assert(dsp_fft_q15_init(&qf, FIXED_N) == 0, "Q15 FFT tables");
+    dsp_rfft(&f, xf, re, im);
+    dsp_rfft_q15(&qf, x16, qre, qim);
+    for (uint32_t k = 0; k <= FIXED_N / 2; k++) {
+        re[k] /= FIXED_N;
+        im[k] /= FIXED_N;
+    }
+    fixed_compare(re, qre, FIXED_N / 2 + 1, DSP_Q15_ONE, &e);
+    float snr_re = e.snr;
+    fixed_compare(im, qim, FIXED_N / 2 + 1, DSP_Q15_ONE, &e);
+    test_assert(snr_re > 1e4f, "Q15 FFT real part within 40 dB of float");
+    test_assert(e.snr > 1e4f, "Q15 FFT imaginary part within 40 dB of float");
+    test_assert(e.max_lsb <= 4.0f, "Q15 FFT imaginary part within four LSBs of float");
+    hash = fixed_hash(hash, qre, FIXED_N / 2 + 1);
+    hash = fixed_hash(hash, qim, FIXED_N / 2 + 1);
+
+    // HRV statistics from the same running sums
+    static struct hrv_stream s;
+    hrv_init(&s, 250, 64);
+    struct hrv_metrics m;
+    struct hrv_metrics_q mq;
+    int beats = 1, mean_rr = 1, heart_rate = 1, sdnn = 1, rmssd = 1, pnn50 = 1;
+    for (uint32_t i = 0; i < 300; i++) {
+        hrv_add_rr(&s, 600 + dsp_rand(&rng) % 400);
+        hrv_metrics(&s, &m);
+        hrv_metrics_q(&s, &mq);
+        beats &= mq.beats == m.beats;
+        mean_rr &= close_to(mq.mean_rr / 65536.0f, m.mean_rr, 0.01f);
+        heart_rate &= close_to(mq.heart_rate / 65536.0f, m.heart_rate, 0.01f);
+        sdnn &= close_to(mq.sdnn / 65536.0f, m.sdnn, 0.01f);
+        rmssd &= close_to(mq.rmssd / 65536.0f, m.rmssd, 0.01f);
+        pnn50 &= close_to(mq.pnn50 / 65536.0f, m.pnn50, 0.01f);
+        int32_t words[5] = { mq.mean_rr, mq.heart_rate, mq.sdnn, mq.rmssd, mq.pnn50 };
+        hash = fixed_hash(hash, words, 5);
+    }
+    test_assert(beats, "Q16.16 HRV beat count matches float");
+    test_assert(mean_rr, "Q16.16 HRV mean RR matches float");
+    test_assert(heart_rate, "Q16.16 HRV heart rate matches float");
+    test_assert(sdnn, "Q16.16 HRV SDNN matches float");
+    test_assert(rmssd, "Q16.16 HRV RMSSD matches float");
+    test_assert(pnn50, "Q16.16 HRV pNN50 matches float");
+
+    test_assert(hash == 0x7ba93685u, "Fixed-point output bit-exact with the pinned results");
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+// A recording of `frames` frames at p, one byte past an aligned buffer
+// so replay cannot rely on alignment
+static uint32_t make_recording(uint8_t *p, uint32_t channels, uint32_t format, uint32_t frames) {
+    put_u32(p, DSP_RECORDING_MAGIC);
+    put_u32(p + 4, DSP_RECORDING_VERSION);
+    put_u32(p + 8, channels);
+    put_u32(p + 12, 250);
+    put_u32(p + 16, format);
+    put_u32(p + 20, frames);
+    uint8_t *q = p + sizeof(struct dsp_recording_header);
+    for (uint32_t i = 0; i < frames * channels; i++) {
+        int32_t v = (int32_t)(i * 977 % 65536) - 32768;
+        if (format == DSP_SAMPLE_Q15) {
+            q[0] = (uint8_t)v;
+            q[1] = (uint8_t)(v >> 8);
+            q += 2;
+        } else {
+            union { float f; uint32_t u; } u = { (float)v / 1024.0f };
+            put_u32(q, u.u);
+            q += 4;
+        }
+    }
+    return (uint32_t)(q - p);
+}
+
+static float recorded(uint32_t i, uint32_t format) {
+    int32_t v = (int32_t)(i * 977 % 65536) - 32768;
+    return format == DSP_SAMPLE_Q15 ? (float)v / DSP_Q15_ONE : (float)v / 1024.0f;
+}
+
+// Test synthetic and recorded sensor sources
+void test_dsp_source() {
+    test_start("DSP Sensor Sources");
+
+    // Synthetic channels are the plain generators, seeded per channel
+    static struct dsp_source src, src2;
+    static struct dsp_synth_ecg ref[2];
+    test_assert(dsp_source_synth(&src, DSP_SOURCE_ECG, 2, 250, 5) == 0, "Synthetic source set up");
+    test_assert(dsp_source_synth(&src2, DSP_SOURCE_ECG, 0, 250, 5) == DSP_ERR_INVAL, "No channels rejected");
+    test_assert(dsp_source_synth(&src2, DSP_SOURCE_EEG, DSP_SOURCE_MAX_CHANNELS + 1, 250, 5) == DSP_ERR_INVAL,
+                "Too many channels rejected");
+    test_assert(dsp_source_synth(&src2, DSP_SOURCE_REPLAY, 1, 250, 5) == DSP_ERR_INVAL,
+                "Replay is not a synthetic kind");
+    dsp_source_synth(&src2, DSP_SOURCE_ECG, 2, 250, 5);
+    for (uint32_t c = 0; c < 2; c++) {
+        dsp_synth_ecg_init(&ref[c], 250, 800, 30, 5 + c);
+        ref[c].rsa_ms = 40;
+        ref[c].noise = 0.05f;
+    }
+    int same = 1, repeat = 1, differ = 0;
+    for (uint32_t i = 0; i < 2500; i++) {
+        float a[2], b[2];
+        dsp_source_read(&src, a, 1);
+        dsp_source_read(&src2, b, 1);
+        for (uint32_t c = 0; c < 2; c++) {
+            same &= a[c] == dsp_synth_ecg_next(&ref[c]);
+            repeat &= a[c] == b[c];
+        }
+        differ |= a[0] != a[1];
+    }
+    test_assert(same, "Each channel is the plain generator with its seed");
+    test_assert(repeat, "Seeded synthetic ECG is deterministic");
+    test_assert(differ, "Channels differ from each other");
+    test_assert(src.frames == 2500, "Frames counted");
+
+    // Respiratory sinus arrhythmia: RR follows the breath, +/- 50 ms
+    static struct dsp_synth_ecg ecg;
+    dsp_synth_ecg_init(&ecg, 250, 800, 0, 3);
+    ecg.rsa_ms = 50;
+    ecg.resp_ms = 4000;
+    uint32_t lo = 10000, hi = 0, sum = 0, beats = 0;
+    for (uint32_t i = 0; i < 250 * 60; i++) {
+        dsp_synth_ecg_next(&ecg);
+        if (ecg.beat && ecg.rr_ms != 0) {
+            if (ecg.rr_ms < lo) lo = ecg.rr_ms;
+            if (ecg.rr_ms > hi) hi = ecg.rr_ms;
+            sum += ecg.rr_ms;
+            beats++;
+        }
+    }
+    test_assert(lo >= 744, "Shortest RR no shorter than the modulation allows");
+    test_assert(lo <= 760, "RR shortened by breathing");
+    test_assert(hi >= 840, "RR lengthened by breathing");
+    test_assert(hi <= 856, "Longest RR no longer than the modulation allows");
+    test_assert(sum / beats >= 790, "Mean RR not below the base interval");
+    test_assert(sum / beats <= 810, "Mean RR not above the base interval");
+
+    // PPG: each pulse peaks a transit time plus half a systole after R
+    dsp_synth_ecg_init(&ecg, 250, 800, 40, 9);
+    uint32_t peak_at = 0, r_at = 0, good = 0, pulses = 0;
+    float peak = -1.0f;
+    for (uint32_t i = 0; i < 250 * 30; i++) {
+        float v = dsp_synth_ppg_next(&ecg);
+        if (ecg.beat) {
+            if (ecg.beats > 2) {
+                uint32_t lag = (peak_at - r_at) * 1000 / 250;
+                good += lag >= 340 && lag <= 360;
+                pulses++;
+            }
+            r_at = i;
+            peak = -1.0f;
+        }
+        if (v > peak) {
+            peak = v;
+            peak_at = i;
+        }
+    }
+    test_assert(pulses > 30, "PPG pulses counted");
+    test_assert(good == pulses, "PPG pulse follows each R peak");
+
+    // Replay, Q15 and float, from unaligned memory
+    static uint8_t buf[4096] __attribute__((aligned(16)));
+    uint8_t *rec = buf + 1;
+    uint32_t size = make_recording(rec, 2, DSP_SAMPLE_Q15, 100);
+    test_assert(dsp_source_replay(&src, rec, size) == 0, "Recording header accepted");
+    test_assert(src.kind == DSP_SOURCE_REPLAY, "Source replays");
+    test_assert(src.channels == 2, "Channel count from the header");
+    test_assert(src.sample_rate == 250, "Sample rate from the header");
+    static float out[2 * 300];
+    uint32_t got = 0, reads[5];
+    for (int r = 0; r < 5; r++) {
+        reads[r] = dsp_source_read(&src, out + got * 2, 30);
+        got += reads[r];
+    }
+    same = 1;
+    for (uint32_t i = 0; i < 200; i++) same &= out[i] == recorded(i, DSP_SAMPLE_Q15);
+    test_assert(reads[0] == 30, "Full read");
+    test_assert(reads[3] == 10, "Short read at the end");
+    test_assert(reads[4] == 0, "Replay stops at the end");
+    test_assert(got == 100, "Every frame replayed");
+    test_assert(same, "Q15 replay is exact");
+
+    dsp_source_replay(&src, rec, size);
+    src.loop = 1;
+    same = dsp_source_read(&src, out, 250) == 250;
+    for (uint32_t i = 0; i < 500; i++) same &= out[i] == recorded(i % 200, DSP_SAMPLE_Q15);
+    test_assert(same, "Looping replay wraps to the first frame");
+
+    size = make_recording(rec, 1, DSP_SAMPLE_F32, 64);
+    test_assert(dsp_source_replay(&src, rec, size) == 0, "Float recording accepted");
+    same = dsp_source_read(&src, out, 64) == 64;
+    for (uint32_t i = 0; i < 64; i++) same &= out[i] == recorded(i, DSP_SAMPLE_F32);
+    test_assert(same, "Float replay is exact");
+
+    test_assert(dsp_source_replay(&src, rec, size - 1) == DSP_ERR_INVAL, "Truncated recording rejected");
+    test_assert(dsp_source_replay(&src, rec, 12) == DSP_ERR_INVAL, "Truncated header rejected");
+    test_assert(dsp_source_replay(&src, NULL, 0) == DSP_ERR_INVAL, "Missing recording rejected");
+    put_u32(rec + 16, 3);
+    test_assert(dsp_source_replay(&src, rec, size) == DSP_ERR_INVAL, "Unknown sample format rejected");
+    put_u32(rec + 16, DSP_SAMPLE_F32);
+    put_u32(rec + 20, 0x40000001);
+    test_assert(dsp_source_replay(&src, rec, size) == DSP_ERR_INVAL, "Overflowing frame count rejected");
+    put_u32(rec + 20, 64);
+    rec[0] ^= 1;
+    test_assert(dsp_source_replay(&src, rec, size) == DSP_ERR_INVAL, "Bad magic rejected");
+
+    // Pacing: at 10x real time, one 100 Hz tick owes 25 frames of 250 Hz
+    dsp_source_synth(&src, DSP_SOURCE_EEG, 1, 250, 1);
+    src.speed = 10;
+    uint32_t due = dsp_source_due(&src, 1, 100);
+    test_assert(due == 25, "Frames owed at a multiple of real time");
+    dsp_source_read(&src, out, due);
+    test_assert(dsp_source_due(&src, 1, 100) == 0, "Nothing owed once read");
+    test_assert(dsp_source_due(&src, 3, 100) == 50, "Owed frames follow the elapsed ticks");
+    src.speed = 0;
+    test_assert(dsp_source_due(&src, 0, 100) == 250, "Unpaced source owed one second of frames");
+}
+
+// Synthetic population: users scattered around a few dozen cluster
+// centres, as templates from similar subjects would be
+#define MATCH_CLUSTERS 48
+static float match_centre[MATCH_CLUSTERS][DSP_MATCH_DIM];
+static float match_user[DSP_MATCH_MAX][DSP_MATCH_DIM];
+
+static float match_uniform(uint32_t *rng) {
+    return (float)(dsp_rand(rng) >> 8) / 16777216.0f - 0.5f;
+}
+
+static void match_population(uint32_t n, uint32_t seed) {
+    uint32_t rng = seed;
+    for (uint32_t c = 0; c < MATCH_CLUSTERS; c++) {
+        for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) match_centre[c][d] = match_uniform(&rng);
+    }
+    for (uint32_t u = 0; u < n; u++) {
+        const float *c = match_centre[dsp_rand(&rng) % MATCH_CLUSTERS];
+        for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) match_user[u][d] = c[d] + 0.4f * match_uniform(&rng);
+    }
+}
+
+// A fresh sample from user u: the template plus sensor noise
+static void match_probe(uint32_t u, float noise, uint32_t *rng, float *p) {
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) p[d] = match_user[u][d] + noise * match_uniform(rng);
+}
+
+static float match_cosine(const float *a, const float *b) {
+    float ab = 0.0f, aa = 0.0f, bb = 0.0f;
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) {
+        ab += a[d] * b[d];
+        aa += a[d] * a[d];
+        bb += b[d] * b[d];
+    }
+    return ab / dsp_sqrtf(aa * bb);
+}
+
+// Exhaustive search over the users flagged in `live`
+static int32_t match_brute(const float *p, const uint8_t *live, uint32_t n, float *best) {
+    int32_t user = -1;
+    *best = DSP_MATCH_NONE;
+    for (uint32_t u = 0; u < n; u++) {
+        float s = live[u] ? match_cosine(p, match_user[u]) : DSP_MATCH_NONE;
+        if (s > *best) {
+            *best = s;
+            user = (int32_t)u;
+        }
+    }
+    return user;
+}
+
+// Test template verification and identification, linear and indexed
+void test_dsp_match() {
+    test_start("DSP Template Matching");
+
+    static struct dsp_match m;
+    static uint8_t live[DSP_MATCH_MAX];
+    struct dsp_match_result r;
+    float p[DSP_MATCH_DIM], best;
+    uint32_t rng = 77;
+    match_population(DSP_MATCH_MAX, 11);
+
+    // Linear: every identification agrees with an exhaustive search
+    dsp_match_init(&m);
+    int ok = 1;
+    for (uint32_t u = 0; u < 300; u++) {
+        ok &= dsp_match_enroll(&m, u, match_user[u]) == 0;
+        live[u] = 1;
+    }
+    test_assert(ok, "Small set enrolled");
+    test_assert(m.count == 300, "Enrolled users counted");
+    test_assert(m.lists == 0, "Small set stays linear");
+    int agree = 1, own = 0;
+    float slowest = 1.0f;
+    for (uint32_t i = 0; i < 200; i++) {
+        uint32_t u = dsp_rand(&rng) % 300;
+        match_probe(u, 0.1f, &rng, p);
+        int32_t want = match_brute(p, live, 300, &best);
+        agree &= dsp_match_identify(&m, p, -1.0f, &r) == want && close_to(r.score, best, 1e-4f);
+        own += r.user == (int32_t)u;
+        float s = dsp_match_score(&m, u, p);
+        if (s < slowest) slowest = s;
+    }
+    test_assert(agree, "Linear identification matches exhaustive search");
+    test_assert(own >= 190, "Fresh samples identify their own user");
+    test_assert(slowest > 0.9f, "Fresh samples score high against their own template");
+
+    // Impostors: other clusters score low, and a high threshold rejects all
+    float impostor = -1.0f;
+    for (uint32_t u = 0; u < 300; u++) {
+        float s = dsp_match_score(&m, u, match_centre[0]);
+        if (s > impostor && match_cosine(match_user[u], match_centre[0]) < 0.5f) impostor = s;
+    }
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) p[d] = -match_user[5][d];
+    test_assert(impostor < 0.5f, "Impostors score low");
+    test_assert(dsp_match_identify(&m, p, 0.99f, &r) == -1, "Impostors fall below the threshold");
+    test_assert(r.score == DSP_MATCH_NONE, "No score reported without a match");
+
+    // With a threshold the early exit cuts most blocks short, still
+    // counted as scanned; only the block holding the user is scored in
+    // full. An impostor probe has every block cut short.
+    match_probe(42, 0.05f, &rng, p);
+    test_assert(dsp_match_identify(&m, p, 0.8f, &r) == 42, "Threshold search finds the user");
+    test_assert(r.scanned == 300, "Every user scanned");
+    test_assert(r.scored >= 4, "User's block scored in full");
+    test_assert(r.scored <= 300 / 10, "Early exit skips the second half of most blocks");
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) p[d] = -match_user[5][d];
+    dsp_match_identify(&m, p, 0.99f, &r);
+    test_assert(r.scored == 0, "Impostor probe cuts every block short");
+
+    // Indexed: 3000 users, most searches reach the best user while
+    // scanning a fraction of the set
+    dsp_match_init(&m);
+    for (uint32_t u = 0; u < 3000; u++) {
+        dsp_match_enroll(&m, u, match_user[u]);
+        live[u] = 1;
+    }
+    test_assert(m.count == 3000, "Large set enrolled");
+    test_assert(m.lists == DSP_MATCH_LISTS, "Large set is indexed");
+    test_assert(m.slots - m.indexed <= DSP_MATCH_TAIL_MAX, "Tail bounded by DSP_MATCH_TAIL_MAX");
+    uint32_t hits = 0, found = 0, scanned = 0;
+    for (uint32_t i = 0; i < 500; i++) {
+        uint32_t u = dsp_rand(&rng) % 3000;
+        match_probe(u, 0.1f, &rng, p);
+        int32_t want = match_brute(p, live, 3000, &best);
+        hits += dsp_match_identify(&m, p, -1.0f, &r) == want;
+        found += r.user == (int32_t)u;
+        scanned += r.scanned;
+    }
+    test_assert(hits >= 490, "Indexed search agrees with exhaustive search at least 98% of the time");
+    test_assert(found >= 480, "Indexed recall at least 96%");
+    test_assert(scanned / 500 < 3000 / 3, "Index scans a fraction of the users");
+
+    // Removal: the user is gone at once; re-enrolment replaces
+    match_probe(7, 0.05f, &rng, p);
+    dsp_match_remove(&m, 7);
+    live[7] = 0;
+    test_assert(dsp_match_identify(&m, p, -1.0f, &r) != 7, "Removed user no longer matches");
+    test_assert(dsp_match_score(&m, 7, p) == DSP_MATCH_NONE, "Removed user has no score");
+    test_assert(dsp_match_remove(&m, 7) == DSP_ERR_INVAL, "Removing twice rejected");
+    test_assert(m.count == 2999, "Removal counted");
+    dsp_match_enroll(&m, 7, match_user[7]);
+    dsp_match_enroll(&m, 8, match_user[9]);
+    test_assert(dsp_match_identify(&m, p, -1.0f, &r) == 7, "Re-enrolled user matches again");
+    test_assert(m.count == 3000, "Replacement not counted twice");
+    test_assert(close_to(dsp_match_score(&m, 8, match_user[9]), 1.0f, 1e-5f), "Re-enrolment replaces a template");
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) match_user[8][d] = match_user[9][d];
+
+    // Enrolments after a build land in the tail until the next rebuild,
+    // and are found either way
+    dsp_match_build(&m);
+    for (uint32_t u = 3000; u < 3100; u++) {
+        dsp_match_enroll(&m, u, match_user[u]);
+        live[u] = 1;
+    }
+    test_assert(m.slots - m.indexed >= 100, "Enrolments after a build land in the tail");
+    int tail_found = 1;
+    for (uint32_t u = 3000; u < 3100; u += 7) {
+        match_probe(u, 0.05f, &rng, p);
+        tail_found &= dsp_match_identify(&m, p, 0.9f, &r) == (int32_t)u;
+    }
+    test_assert(tail_found, "Tail users found before a rebuild");
+    dsp_match_build(&m);
+    test_assert(m.slots == m.indexed, "Rebuild indexes the tail");
+    tail_found = 1;
+    for (uint32_t u = 3000; u < 3100; u += 7) {
+        match_probe(u, 0.05f, &rng, p);
+        tail_found &= dsp_match_identify(&m, p, 0.9f, &r) == (int32_t)u;
+    }
+    test_assert(tail_found, "Tail users found after the rebuild");
+
+    // Filling up, then full
+    ok = 1;
+    for (uint32_t u = 3100; u < DSP_MATCH_MAX; u++) ok &= dsp_match_enroll(&m, u, match_user[u]) == 0;
+    test_assert(ok, "Enrolments up to DSP_MATCH_MAX accepted");
+    test_assert(m.count == DSP_MATCH_MAX, "Set fills to DSP_MATCH_MAX");
+    test_assert(dsp_match_enroll(&m, DSP_MATCH_MAX, match_user[0]) == DSP_ERR_INVAL, "Ids past the limit rejected");
+    test_assert(dsp_match_enroll(&m, 0, match_user[0]) == 0, "Replacing a full set still works");
+    test_assert(m.count == DSP_MATCH_MAX, "Full set stays at DSP_MATCH_MAX");
+    for (uint32_t i = 0; i < 20; i++) {
+        dsp_match_remove(&m, i);
+        dsp_match_enroll(&m, i, match_user[i]);
+    }
+    match_probe(15, 0.05f, &rng, p);
+    test_assert(dsp_match_identify(&m, p, 0.9f, &r) == 15, "Churn at capacity reuses removed slots");
+
+    // Invalid input
+    float zero[DSP_MATCH_DIM] = { 0 };
+    dsp_match_init(&m);
+    test_assert(dsp_match_enroll(&m, 0, zero) == DSP_ERR_INVAL, "Zero template rejected");
+    test_assert(dsp_match_identify(&m, zero, -1.0f, &r) == -1, "Zero probe rejected");
+    test_assert(dsp_match_identify(&m, match_user[0], -1.0f, &r) == -1, "Empty set matches nobody");
+    test_assert(dsp_match_score(&m, DSP_MATCH_MAX, match_user[0]) == DSP_MATCH_NONE, "Id past the limit has no score");
+
+    // Whitening: a feature with 20x the spread of the others swamps plain
+    // cosine; scaled by its inverse deviation it no longer does
+    float scale[DSP_MATCH_DIM], a[DSP_MATCH_DIM], b[DSP_MATCH_DIM];
+    for (uint32_t d = 0; d < DSP_MATCH_DIM; d++) {
+        scale[d] = d == 0 ? 0.05f : 1.0f;
+        a[d] = d == 0 ? 20.0f : (d & 1 ? 1.0f : -1.0f);
+        b[d] = d == 0 ? 20.0f : (d & 1 ? -1.0f : 1.0f);
+    }
+    dsp_match_enroll(&m, 0, a);
+    float plain = dsp_match_score(&m, 0, b);
+    scale[1] = 0.0f;
+    test_assert(dsp_match_set_scale(&m, scale) == DSP_ERR_INVAL, "Scale refused once templates are enrolled");
+    dsp_match_init(&m);
+    test_assert(dsp_match_set_scale(&m, scale) == DSP_ERR_INVAL, "Zero scale rejected");
+    scale[1] = 1.0f;
+    dsp_match_set_scale(&m, scale);
+    dsp_match_enroll(&m, 0, a);
+    test_assert(plain > 0.8f, "High-spread feature swamps plain cosine");
+    test_assert(dsp_match_score(&m, 0, b) < -0.8f, "Diagonal whitening weighs features by their spread");
+}
+
+// An HRV record (heart rate, RMSSD, SDNN) from a subject with the given
+// means, each feature spread about 5% of its population deviation
+static void trust_record(const float *mean, const float *pop_std, uint32_t *rng, float *x) {
+    for (uint32_t i = 0; i < 3; i++) {
+        float u = (float)(dsp_rand(rng) >> 8) / 16777216.0f + (float)(dsp_rand(rng) >> 8) / 16777216.0f - 1.0f;
+        x[i] = mean[i] + 0.1f * pop_std[i] * u;
+    }
+}
+
+// Test continuous-authentication evidence and session locking
+void test_dsp_trust() {
+    test_start("DSP Continuous Authentication");
+
+    static const float pop_mean[3] = { 70.0f, 40.0f, 50.0f }, pop_std[3] = { 12.0f, 20.0f, 20.0f };
+    static const float user[3] = { 62.0f, 55.0f, 60.0f }, other[3] = { 80.0f, 25.0f, 35.0f };
+    uint32_t rng = 21;
+    float x[3];
+
+    // Baseline statistics against a direct two-pass computation
+    static float seen[60][3];
+    struct dsp_trust_stats stats;
+    dsp_trust_stats_init(&stats, 3);
+    for (uint32_t r = 0; r < 60; r++) {
+        trust_record(user, pop_std, &rng, seen[r]);
+        dsp_trust_stats_add(&stats, seen[r]);
+    }
+    int same = stats.count == 60;
+    for (uint32_t i = 0; i < 3; i++) {
+        float mean = 0.0f, var = 0.0f;
+        for (uint32_t r = 0; r < 60; r++) mean += seen[r][i] / 60.0f;
+        for (uint32_t r = 0; r < 60; r++) var += (seen[r][i] - mean) * (seen[r][i] - mean) / 59.0f;
+        same &= close_to((float)stats.mean[i], mean, 1e-3f) && close_to((float)(stats.m2[i] / 59.0), var, 1e-3f);
+    }
+    test_assert(same, "Online baseline matches two-pass mean and variance");
+
+    // Evidence: positive for the user, negative for someone else, clamped
+    struct dsp_trust_model model;
+    test_assert(dsp_trust_model_init(&model, &stats, pop_mean, pop_std) == 0, "Model from baseline");
+    float genuine = 10.0f, impostor = -10.0f;
+    for (uint32_t r = 0; r < 100; r++) {
+        trust_record(user, pop_std, &rng, x);
+        float e = dsp_trust_evidence(&model, x);
+        if (e < genuine) genuine = e;
+        trust_record(other, pop_std, &rng, x);
+        e = dsp_trust_evidence(&model, x);
+        if (e > impostor) impostor = e;
+    }
+    test_assert(genuine > 1.0f, "Evidence favours the user");
+    test_assert(impostor == -DSP_TRUST_EVIDENCE_MAX, "Evidence against an impostor clamped");
+    test_assert(dsp_trust_evidence(&model, user) <= DSP_TRUST_EVIDENCE_MAX, "Evidence for the user clamped");
+
+    // Exponential forgetting: no new evidence halves the log-odds per half-life
+    struct dsp_trust t;
+    test_assert(dsp_trust_init(&t, 0, 0.2f, 0.8f) == DSP_ERR_INVAL, "Zero half-life rejected");
+    test_assert(dsp_trust_init(&t, 1000, 0.8f, 0.2f) == DSP_ERR_INVAL, "Lock above unlock rejected");
+    test_assert(dsp_trust_init(&t, 1000, 0.2f, 1.0f) == DSP_ERR_INVAL, "Unlock at certainty rejected");
+    test_assert(dsp_trust_init(&t, 10000, 0.2f, 0.8f) == 0, "Valid thresholds accepted");
+    test_assert(t.locked, "Sessions start locked");
+    test_assert(close_to(dsp_trust_confidence(&t), 0.5f, 1e-5f), "Sessions start at 0.5");
+    dsp_trust_start(&t, 1000, 0.95f);
+    float start = t.evidence;
+    dsp_trust_update(&t, 11000, 0.0f);
+    float half = t.evidence;
+    dsp_trust_update(&t, 5000, 1.0f);
+    test_assert(!t.locked, "Confident start unlocks the session");
+    test_assert(close_to(start, 2.9444f, 1e-3f), "Start confidence kept as log-odds");
+    test_assert(close_to(half, start / 2.0f, 1e-3f), "Log-odds decay by half-life");
+    test_assert(close_to(t.evidence, half + 1.0f, 1e-5f), "Late records do not decay");
+    test_assert(t.last_ms == 11000, "Late records do not move the clock back");
+
+    // Session: the user for two minutes, one wild record, an impostor,
+    // then the user again. One record per second.
+    dsp_trust_start(&t, 0, 0.95f);
+    int changes = 0;
+    for (uint32_t s = 1; s <= 120; s++) {
+        trust_record(user, pop_std, &rng, x);
+        changes += dsp_trust_update(&t, s * 1000, dsp_trust_evidence(&model, x)) != 0;
+    }
+    test_assert(changes == 0, "Genuine stream stays unlocked");
+    test_assert(dsp_trust_confidence(&t) > 0.999f, "Genuine stream builds confidence");
+    changes += dsp_trust_update(&t, 121000, dsp_trust_evidence(&model, other)) != 0;
+    test_assert(changes == 0, "One outlier does not lock");
+
+    uint32_t locked_at = 0, unlocked_at = 0;
+    for (uint32_t s = 122; s <= 200; s++) {
+        trust_record(other, pop_std, &rng, x);
+        if (dsp_trust_update(&t, s * 1000, dsp_trust_evidence(&model, x)) == DSP_TRUST_LOCK) locked_at = s;
+    }
+    test_assert(locked_at >= 125, "Impostor needs a few records to lock");
+    test_assert(locked_at <= 122 + 15, "Impostor locks within about a half-life");
+    test_assert(t.locked, "Impostor leaves the session locked");
+    test_assert(dsp_trust_confidence(&t) < 0.2f, "Impostor drives confidence down");
+    for (uint32_t s = 201; s <= 260; s++) {
+        trust_record(user, pop_std, &rng, x);
+        if (dsp_trust_update(&t, s * 1000, dsp_trust_evidence(&model, x)) == DSP_TRUST_UNLOCK) unlocked_at = s;
+    }
+    test_assert(unlocked_at > 201, "User's return needs more than one record");
+    test_assert(unlocked_at <= 201 + 15, "User's return unlocks within about a half-life");
+    test_assert(!t.locked, "User's return leaves the session unlocked");
+    test_assert(t.updates == 260 + 2, "Every record counted");
+}
+
+#define PROFILE_TEST_USERS 1000
+#define PROFILE_TEST_SIZE (DSP_PROFILE_IMAGE_SIZE(DSP_PROFILE_MAX, DSP_PROFILE_MAX) + DSP_PROFILE_JOURNAL_SIZE)
+
+static uint8_t profile_file[2][PROFILE_TEST_SIZE] __attribute__((aligned(16)));
+static uint8_t profile_journal[DSP_PROFILE_JOURNAL_SIZE] __attribute__((aligned(16)));
+
+static void profile_template(uint32_t user, float *v) {
+    uint32_t rng = user + 1;
+    for (uint32_t d = 0; d < DSP_PROFILE_DIM; d++) v[d] = (float)(dsp_rand(&rng) >> 8) / 16777216.0f - 0.5f;
+}
+
+// Every user below `users` holds its own template, except where `skip` is set
+static int profile_all_match(struct dsp_profile_store *s, uint32_t users, uint32_t skip) {
+    int ok = 1;
+    for (uint32_t u = 0; u < users; u++) {
+        float v[DSP_PROFILE_DIM];
+        profile_template(u, v);
+        float score = dsp_profile_score(s, u, v);
+        ok &= u % skip == 0 ? score == DSP_PROFILE_NONE : close_to(score, 1.0f, 1e-5f);
+    }
+    return ok;
+}
+
+// The storage layer's append: the journal's records after the image
+static uint32_t profile_flush(uint8_t *file, uint32_t used, const struct dsp_profile_store *s) {
+    const uint8_t *j = (const uint8_t *)s->journal;
+    uint32_t len = s->journal_count * sizeof(struct dsp_profile_record);
+    for (uint32_t i = 0; i < len; i++) file[used + i] = j[i];
+    return used + len;
+}
+
+// Test the persistent profile store
+void test_dsp_profile() {
+    test_start("DSP Profile Store");
+
+    static struct dsp_profile_store s;
+    float v[DSP_PROFILE_DIM];
+    long used = dsp_profile_format(profile_file[0], PROFILE_TEST_SIZE, DSP_PROFILE_MAX);
+    test_assert(used == (long)DSP_PROFILE_IMAGE_SIZE(DSP_PROFILE_MAX, 0), "Empty image holds only the directory");
+    test_assert(dsp_profile_format(profile_file[0] + 2, PROFILE_TEST_SIZE, 16) == DSP_ERR_INVAL,
+                "Misaligned image rejected");
+    test_assert(dsp_profile_format(profile_file[0], 64, DSP_PROFILE_MAX) == DSP_ERR_INVAL, "Short image rejected");
+    test_assert(dsp_profile_open(&s, profile_file[0], PROFILE_TEST_SIZE, profile_journal, sizeof(profile_journal)) == 0,
+                "Empty store opens");
+    test_assert(s.tail_count == 0, "Empty store has no log");
+    test_assert(dsp_profile_get(&s, 0) == NULL, "Empty store has no templates");
+
+    // Enrolments go to the journal; replacing and removing append
+    int ok = 1;
+    for (uint32_t u = 0; u < 200; u++) {
+        profile_template(u, v);
+        ok &= dsp_profile_put(&s, u, v) == 0;
+    }
+    test_assert(ok, "Enrolments accepted");
+    profile_template(3, v);
+    test_assert(dsp_profile_put(&s, 3, v) == 0, "Replacing a template accepted");
+    test_assert(dsp_profile_remove(&s, 0) == 0, "Removal accepted");
+    test_assert(dsp_profile_remove(&s, 0) == DSP_ERR_INVAL, "Removing twice rejected");
+    test_assert(s.journal_count == 202, "Replacing and removing append");
+    test_assert(profile_all_match(&s, 200, 200), "Journal enrolments are visible");
+    float zero[DSP_PROFILE_DIM] = { 0 };
+    test_assert(dsp_profile_put(&s, DSP_PROFILE_MAX, v) == DSP_ERR_INVAL, "Ids past the limit rejected");
+    test_assert(dsp_profile_put(&s, 5, zero) == DSP_ERR_INVAL, "Zero template rejected");
+    ok = 1;
+    for (uint32_t u = 0; u < 60 && ok; u++) ok = dsp_profile_put(&s, 300 + u, v) == (u < 54 ? 0 : DSP_ERR_FULL);
+    test_assert(ok, "A full log asks for compaction");
+    test_assert(s.tail_count == DSP_PROFILE_TAIL_MAX, "Log fills to DSP_PROFILE_TAIL_MAX");
+
+    // The file as storage would hold it: image then appended records.
+    // Reopening replays the log; a torn last record is ignored.
+    profile_flush(profile_file[0], (uint32_t)used, &s);
+    uint32_t size = (uint32_t)used + 202 * sizeof(struct dsp_profile_record) + 5;
+    test_assert(dsp_profile_open(&s, profile_file[0], size, profile_journal, sizeof(profile_journal)) == 0,
+                "Reopen with a torn record");
+    test_assert(s.tail_count == 202, "Torn last record ignored");
+    test_assert(profile_all_match(&s, 200, 200), "Reopen replays the log");
+
+    // Compaction: only live templates, fresh log, next generation
+    used = dsp_profile_compact(&s, profile_file[1], PROFILE_TEST_SIZE);
+    test_assert(used == (long)DSP_PROFILE_IMAGE_SIZE(DSP_PROFILE_MAX, 199), "Compacted image sized for live templates");
+    test_assert(dsp_profile_compact(&s, profile_file[1], 1000) == DSP_ERR_FULL,
+                "Compaction into a short image rejected");
+    test_assert(dsp_profile_open(&s, profile_file[1], PROFILE_TEST_SIZE, profile_journal, sizeof(profile_journal)) == 0,
+                "Compacted image opens");
+    test_assert(s.tail_count == 0, "Compaction starts a fresh log");
+    test_assert(s.header->records == 199, "Compaction drops removed templates");
+    test_assert(s.header->generation == 1, "Compaction advances the generation");
+    test_assert(profile_all_match(&s, 200, 200), "Compaction keeps the live templates");
+
+    // Grow to PROFILE_TEST_USERS through rounds of append and compaction
+    int from = 1;
+    for (uint32_t u = 200; u < PROFILE_TEST_USERS; u++) {
+        profile_template(u, v);
+        if (dsp_profile_put(&s, u, v) == DSP_ERR_FULL) {
+            used = dsp_profile_compact(&s, profile_file[!from], PROFILE_TEST_SIZE);
+            from = !from;
+            dsp_profile_open(&s, profile_file[from], PROFILE_TEST_SIZE, profile_journal, sizeof(profile_journal));
+            dsp_profile_put(&s, u, v);
+        }
+    }
+    used = profile_flush(profile_file[from], (uint32_t)used, &s);
+    test_assert(dsp_profile_open(&s, profile_file[from], (uint32_t)used, NULL, 0) == 0,
+                "Store opens without a journal");
+    test_assert(profile_all_match(&s, PROFILE_TEST_USERS, PROFILE_TEST_USERS), "Every round's templates kept");
+    test_assert(s.header->generation == 4, "Each round compacts once");
+    test_assert(dsp_profile_put(&s, 1, v) == DSP_ERR_INVAL, "Compacted rounds reopen read-only");
+
+    // Opening reads no base record; each is checked on first use
+    dsp_profile_open(&s, profile_file[from], (uint32_t)used, NULL, 0);
+    int unchecked = 1;
+    for (uint32_t i = 0; i < DSP_PROFILE_MAX / 32; i++) unchecked &= s.checked[i] == 0;
+    test_assert(unchecked, "Cold start touches no templates");
+
+    uint8_t *rec = (uint8_t *)&s.base[s.dir[500]];
+    rec[40] ^= 0x10;
+    uint32_t *dir = (uint32_t *)(profile_file[from] + sizeof(struct dsp_profile_header));
+    uint32_t saved = dir[600];
+    dir[600] = dir[601];
+    profile_template(501, v);
+    test_assert(dsp_profile_open(&s, profile_file[from], (uint32_t)used, NULL, 0) == 0,
+                "Corrupt records do not fail open");
+    test_assert(dsp_profile_get(&s, 500) == NULL, "Corrupt record fails that user");
+    test_assert(dsp_profile_get(&s, 600) == NULL, "Corrupt directory entry fails that user");
+    test_assert(close_to(dsp_profile_score(&s, 501, v), 1.0f, 1e-5f), "Neighbouring user still scores");
+    test_assert(dsp_profile_get(&s, 500) == NULL, "Corrupt record stays failed");
+    rec[40] ^= 0x10;
+    dir[600] = saved;
+
+    profile_file[from][12] ^= 1;
+    test_assert(dsp_profile_open(&s, profile_file[from], (uint32_t)used, NULL, 0) == DSP_ERR_INVAL,
+                "Damaged header rejected");
+    profile_file[from][12] ^= 1;
+    test_assert(dsp_profile_open(&s, profile_file[from], 100, NULL, 0) == DSP_ERR_INVAL, "Truncated header rejected");
+    test_assert(dsp_profile_open(&s, profile_file[from] + 1, (uint32_t)used, NULL, 0) == DSP_ERR_INVAL,
+                "Misaligned image rejected on open");
+    test_assert(dsp_profile_open(&s, profile_file[from], (uint32_t)used, NULL, 0) == 0, "Repaired header opens");
+}
+
+// Fusion test streams: A samples about every 70 ms with jitter, B about
+// every 250 ms. Both are linear in time, so interpolation is exact.
+static uint32_t fuse_ta(uint32_t i) { return 10 + 70 * i + i * 37 % 21; }
+static uint32_t fuse_tb(uint32_t i) { return 250 * i + i * 53 % 31; }
+
+struct fuse_check {
+    uint32_t frames, last_ms;
+    uint32_t a_bad;         // A missing or off its line
+    uint32_t b_held, b_missing, b_bad;
+};
+
+// Pull every due frame. B is expected on its line where it has samples
+// within 400 ms either side, held within 200 ms of its only nearby
+// sample, and missing otherwise.
+static void fuse_drain(struct dsp_fuse *f, struct fuse_check *c) {
+    struct dsp_fuse_frame fr;
+    while (dsp_fuse_pull(f, &fr)) {
+        float t = (float)fr.t_ms * 0.001f;
+        c->frames++;
+        c->last_ms = fr.t_ms;
+        if (!(fr.valid & 1) || !close_to(fr.v[0], t, 1e-4f) || !close_to(fr.v[1], 2.0f * t, 1e-4f)) c->a_bad++;
+        if (!(fr.valid & 2)) {
+            c->b_missing++;
+            c->b_bad += fr.v[2] != 0.0f;
+        } else if (!close_to(fr.v[2], -t, 1e-4f)) {
+            c->b_held++;
+        }
+    }
+}
+
+static void fuse_push_a(struct dsp_fuse *f, uint32_t *i, uint32_t end, struct fuse_check *c) {
+    for (; fuse_ta(*i) < end; (*i)++) {
+        float t = (float)fuse_ta(*i) * 0.001f, x[2] = { t, 2.0f * t };
+        dsp_fuse_push(f, 0, fuse_ta(*i), x);
+        if (c != NULL) fuse_drain(f, c);
+    }
+}
+
+static void fuse_push_b(struct dsp_fuse *f, uint32_t i, uint32_t end) {
+    for (; fuse_tb(i) < end; i++) {
+        float x = -(float)fuse_tb(i) * 0.001f;
+        dsp_fuse_push(f, 1, fuse_tb(i), &x);
+    }
+}
+
+void test_dsp_fuse() {
+    test_start("DSP Stream Fusion");
+    static struct dsp_fuse f;
+    struct dsp_fuse_frame fr;
+    float x[DSP_FUSE_MAX_WIDTH] = { 0 };
+
+    test_assert(dsp_fuse_init(&f, 0, 0) == DSP_ERR_INVAL, "Zero frame period rejected");
+    test_assert(dsp_fuse_init(&f, 100, 1000) == 0, "Fusion initialised");
+    test_assert(dsp_fuse_add_stream(&f, 0, 100) == DSP_ERR_INVAL, "Empty stream rejected");
+    test_assert(dsp_fuse_add_stream(&f, DSP_FUSE_MAX_WIDTH + 1, 100) == DSP_ERR_INVAL, "Over-wide stream rejected");
+    test_assert(dsp_fuse_add_stream(&f, 8, 100) == 0, "First stream added");
+    test_assert(dsp_fuse_add_stream(&f, 8, 100) == 1, "Second stream added");
+    test_assert(dsp_fuse_add_stream(&f, 1, 100) == DSP_ERR_INVAL, "Streams past DSP_FUSE_MAX_FEATURES rejected");
+    test_assert(dsp_fuse_push(&f, 2, 0, x) == DSP_ERR_INVAL, "Push to an unknown stream rejected");
+    test_assert(dsp_fuse_pull(&f, &fr) == 0, "No frame before any record");
+
+    dsp_fuse_init(&f, 100, 1000);
+    test_assert(dsp_fuse_add_stream(&f, 2, 200) == 0, "Stream A added");
+    test_assert(dsp_fuse_add_stream(&f, 1, 400) == 1, "Stream B added");
+    test_assert(f.s[1].offset == 2, "Streams laid out in the joint vector");
+    test_assert(f.width == 3, "Joint vector holds every stream");
+
+    // Frames wait for the slower stream to reach them
+    struct fuse_check c = { 0 };
+    uint32_t ia = 0;
+    fuse_push_a(&f, &ia, 900, &c);
+    test_assert(c.frames == 0, "No frame before every stream reaches it");
+    fuse_push_b(&f, 0, 1000);
+    fuse_drain(&f, &c);
+    test_assert(c.frames == 7, "Frames released up to the slower stream");
+    test_assert(c.last_ms == 700, "Frames on the frame clock");
+    test_assert(c.a_bad == 0, "Jittered stream A interpolated onto the frame clock");
+    test_assert(c.b_missing == 0, "Stream B present in every frame");
+    test_assert(c.b_held == 0, "Stream B interpolated, not held");
+
+    // B drops out from 754 to 2503 ms: held near either edge, missing
+    // in between, while A carries on
+    c = (struct fuse_check){ 0 };
+    fuse_push_a(&f, &ia, 2510, &c);
+    fuse_push_b(&f, 10, 3000);
+    fuse_push_a(&f, &ia, 3000, &c);
+    test_assert(c.frames == 20, "Frames continue through the gap");
+    test_assert(c.last_ms == 2700, "Frames through the gap on the frame clock");
+    test_assert(c.a_bad == 0, "Stream A unaffected by the gap");
+    test_assert(c.b_missing == 14, "Gap in one stream marked missing");
+    test_assert(c.b_bad == 0, "Stream B correct around the gap");
+    test_assert(c.b_held == 4, "Gap held at the edges");
+
+    float late = -1.0f;
+    test_assert(dsp_fuse_push(&f, 1, 2600, &late) == DSP_ERR_INVAL, "Out-of-order record rejected");
+    test_assert(f.s[1].dropped == 1, "Out-of-order record dropped");
+
+    // B stalls: A alone releases frames once it is the latency ahead
+    c = (struct fuse_check){ 0 };
+    fuse_push_a(&f, &ia, 6000, &c);
+    test_assert(c.frames > 0, "A alone releases frames");
+    test_assert(c.last_ms + 1000 <= f.newest_ms, "Frames wait for the latency");
+    test_assert(c.last_ms + 1100 > f.newest_ms, "Stalled stream delays frames by the latency only");
+    test_assert(c.a_bad == 0, "Stream A correct while B stalls");
+    test_assert(c.b_missing == c.frames - 2, "Stalled stream marked missing");
+    test_assert(c.b_held == 2, "Stalled stream held at its edge");
+    test_assert(f.s[0].dropped == 0, "No record of A dropped");
+}
+
+// Main DSP test runner
+void run_dsp_tests() {
+    serial_print("\n");
+    serial_print("==========================================\n");
+    serial_print("    AERODESK DSP TEST SUITE\n");
+    serial_print("==========================================\n");
+
+    test_dsp_hrv();
+    test_dsp_fft();
+    test_dsp_eeg();
+    test_dsp_filter();
+    test_dsp_fixed();
+    test_dsp_source();
+    test_dsp_match();
+    test_dsp_trust();
+    test_dsp_profile();
+    test_dsp_fuse();
+
+    test_end();
+}
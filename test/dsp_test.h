@@ -0,0 +1,19 @@
+#ifndef DSP_TEST_H
+#define DSP_TEST_H
+
+// DSP test function declarations
+void run_dsp_tests(void);
+
+// Individual test functions
+void test_dsp_hrv(void);
+void test_dsp_fft(void);
+void test_dsp_eeg(void);
+void test_dsp_filter(void);
+void test_dsp_fixed(void);
+void test_dsp_source(void);
+void test_dsp_match(void);
+void test_dsp_trust(void);
+void test_dsp_profile(void);
+void test_dsp_fuse(void);
+
+#endif // DSP_TEST_H
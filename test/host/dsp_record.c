@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../include/dsp/dsp_source.h"
+#include "../include/dsp/dsp_fixed.h"
+
+// Writes sensor recordings for replay as Multiboot2 modules (see
+// docs/DSP_IMPLEMENTATION.md, Sensor Sources):
+//
+//   dsp_record [-f] synth ecg|ppg|eeg RATE CHANNELS SECONDS [SEED] > out.rec
+//   dsp_record [-f] text RATE CHANNELS < samples.txt > out.rec
+//
+// Text input has one frame per line, CHANNELS numbers separated by
+// spaces or commas, scaled so full scale is +/-1 (for instance a
+// dataset exported from PhysioNet and divided by its ADC range).
+// Samples are written as Q15, or as floats with -f.
+
+static uint32_t format = DSP_SAMPLE_Q15;
+static uint32_t frames_written = 0;
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void write_header(uint32_t channels, uint32_t rate, uint32_t frames) {
+    uint8_t h[sizeof(struct dsp_recording_header)];
+    put_u32(h, DSP_RECORDING_MAGIC);
+    put_u32(h + 4, DSP_RECORDING_VERSION);
+    put_u32(h + 8, channels);
+    put_u32(h + 12, rate);
+    put_u32(h + 16, format);
+    put_u32(h + 20, frames);
+    fwrite(h, sizeof(h), 1, stdout);
+}
+
+static void write_frame(const float *v, uint32_t channels) {
+    for (uint32_t c = 0; c < channels; c++) {
+        uint8_t b[4];
+        if (format == DSP_SAMPLE_Q15) {
+            uint16_t q = (uint16_t)dsp_q15_from_float(v[c]);
+            b[0] = (uint8_t)q;
+            b[1] = (uint8_t)(q >> 8);
+            fwrite(b, 2, 1, stdout);
+        } else {
+            union { float f; uint32_t u; } u = { v[c] };
+            put_u32(b, u.u);
+            fwrite(b, 4, 1, stdout);
+        }
+    }
+    frames_written++;
+}
+
+static int usage(void) {
+    fprintf(stderr, "usage: dsp_record [-f] synth ecg|ppg|eeg RATE CHANNELS SECONDS [SEED]\n"
+                    "       dsp_record [-f] text RATE CHANNELS < samples.txt\n");
+    return 2;
+}
+
+static int record_synth(int argc, char **argv) {
+    if (argc < 5) return usage();
+    enum dsp_source_kind kind;
+    if (strcmp(argv[1], "ecg") == 0) {
+        kind = DSP_SOURCE_ECG;
+    } else if (strcmp(argv[1], "ppg") == 0) {
+        kind = DSP_SOURCE_PPG;
+    } else if (strcmp(argv[1], "eeg") == 0) {
+        kind = DSP_SOURCE_EEG;
+    } else {
+        return usage();
+    }
+    uint32_t rate = (uint32_t)strtoul(argv[2], NULL, 10), channels = (uint32_t)strtoul(argv[3], NULL, 10);
+    uint32_t seconds = (uint32_t)strtoul(argv[4], NULL, 10);
+    uint32_t seed = argc > 5 ? (uint32_t)strtoul(argv[5], NULL, 10) : 1;
+    static struct dsp_source src;
+    if (dsp_source_synth(&src, kind, channels, rate, seed) != 0 || seconds == 0) {
+        fprintf(stderr, "dsp_record: bad rate or channel count\n");
+        return 1;
+    }
+    // Synthetic signal peaks a little above 1; keep it inside Q15
+    float gain = kind == DSP_SOURCE_EEG ? 0.25f : 0.5f;
+    write_header(channels, rate, rate * seconds);
+    float frame[DSP_SOURCE_MAX_CHANNELS];
+    for (uint32_t i = 0; i < rate * seconds; i++) {
+        dsp_source_read(&src, frame, 1);
+        for (uint32_t c = 0; c < channels; c++) frame[c] *= gain;
+        write_frame(frame, channels);
+    }
+    return 0;
+}
+
+static int record_text(int argc, char **argv) {
+    if (argc < 3) return usage();
+    uint32_t rate = (uint32_t)strtoul(argv[1], NULL, 10), channels = (uint32_t)strtoul(argv[2], NULL, 10);
+    if (rate == 0 || channels == 0 || channels > DSP_SOURCE_MAX_CHANNELS) {
+        fprintf(stderr, "dsp_record: bad rate or channel count\n");
+        return 1;
+    }
+    // The frame count is patched in once the input is read
+    write_header(channels, rate, 0);
+    char line[1024];
+    float frame[DSP_SOURCE_MAX_CHANNELS];
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        char *p = line, *end;
+        uint32_t c = 0;
+        while (c < channels) {
+            while (*p == ' ' || *p == ',' || *p == '\t') p++;
+            float v = strtof(p, &end);
+            if (end == p) break;
+            frame[c++] = v;
+            p = end;
+        }
+        if (c == 0) continue;
+        if (c != channels) {
+            fprintf(stderr, "dsp_record: line %u has %u of %u channels\n", frames_written + 1, c, channels);
+            return 1;
+        }
+        write_frame(frame, channels);
+    }
+    if (fseek(stdout, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "dsp_record: output must be a file\n");
+        return 1;
+    }
+    write_header(channels, rate, frames_written);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    argc--;
+    argv++;
+    if (argc > 0 && strcmp(argv[0], "-f") == 0) {
+        format = DSP_SAMPLE_F32;
+        argc--;
+        argv++;
+    }
+    if (argc > 0 && strcmp(argv[0], "synth") == 0) return record_synth(argc, argv);
+    if (argc > 0 && strcmp(argv[0], "text") == 0) return record_text(argc, argv);
+    return usage();
+}
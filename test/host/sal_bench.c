@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_host.h"
+
+// SAL microbenchmarks on the host backend (make host-bench). Each run
+// prints one line of key=value pairs so results can be diffed or
+// collected by scripts:
+//
+//   bench=pingpong msgs=... ns_per_op=... p50_ns=... p99_ns=...
+//
+// Optional argument: iteration count (default 200000).
+
+#define BENCH_SERVER_PID 1
+#define BENCH_CLIENT_PID 2
+#define BENCH_FIRST_WORKER 3
+#define BENCH_MAX_WORKERS 8
+
+static uint32_t iterations = 200000;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Ping-pong: one client and one echo server, a 4-byte message each way.
+// The server blocks in sal_wait() on its mailbox, so every round trip
+// crosses the simulated kernel's sleep/wake path when the server idles.
+static void *pingpong_server(void *arg) {
+    (void)arg;
+    sal_host_attach(BENCH_SERVER_PID);
+    int port = sal_port_create();
+    struct sal_watch mbox = { SAL_EV_MAILBOX, 0, 0, 0 };
+    sal_port_ctl(port, SAL_PORT_ADD, &mbox);
+    struct sal_event ev;
+    for (uint32_t done = 0; done < iterations; ) {
+        uint32_t v;
+        if (sal_recv(BENCH_CLIENT_PID, &v, sizeof(v)) != sizeof(v)) {
+            sal_wait(port, &ev, 1, SAL_WAIT_FOREVER);
+            continue;
+        }
+        while (sal_send(BENCH_CLIENT_PID, &v, sizeof(v)) == SAL_ERR_FULL) sched_yield();
+        done++;
+    }
+    sal_port_close(port);
+    return NULL;
+}
+
+static void bench_pingpong(void) {
+    uint64_t *rtt = malloc(iterations * sizeof(*rtt));
+    pthread_t server;
+    pthread_create(&server, NULL, pingpong_server, NULL);
+    sal_host_attach(BENCH_CLIENT_PID);
+
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint64_t t0 = now_ns();
+        uint32_t v;
+        while (sal_send(BENCH_SERVER_PID, &i, sizeof(i)) == SAL_ERR_FULL) sched_yield();
+        while (sal_recv(BENCH_SERVER_PID, &v, sizeof(v)) != sizeof(v));
+        rtt[i] = now_ns() - t0;
+    }
+    uint64_t elapsed = now_ns() - start;
+    pthread_join(server, NULL);
+
+    qsort(rtt, iterations, sizeof(*rtt), cmp_u64);
+    printf("bench=pingpong msgs=%u ns_per_op=%llu p50_ns=%llu p99_ns=%llu\n", iterations,
+           (unsigned long long)(elapsed / iterations), (unsigned long long)rtt[iterations / 2],
+           (unsigned long long)rtt[(uint64_t)iterations * 99 / 100]);
+    free(rtt);
+}
+
+// Fan-out: one publisher, N subscribers on a credit topic so nothing is
+// dropped and the publisher runs at the pace of the slowest reader
+struct fanout_reader {
+    pthread_t thread;
+    uint32_t pid;
+    int topic;
+    uint32_t received;
+};
+
+static void *fanout_reader_main(void *arg) {
+    struct fanout_reader *r = arg;
+    sal_host_attach(r->pid);
+    uint32_t vals[SAL_MAX_BATCH];
+    struct sal_mmsg msgs[SAL_MAX_BATCH];
+    for (int i = 0; i < SAL_MAX_BATCH; i++) {
+        msgs[i].buf = &vals[i];
+        msgs[i].maxlen = sizeof(vals[i]);
+    }
+    while (r->received < iterations) {
+        int n = sal_topic_recv_many(r->topic, msgs, SAL_MAX_BATCH);
+        if (n > 0) {
+            r->received += (uint32_t)n;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void bench_fanout(int nreaders) {
+    static int run;
+    char name[32];
+    snprintf(name, sizeof(name), "bench/fanout%d", run++);
+
+    struct fanout_reader readers[BENCH_MAX_WORKERS];
+    sal_host_attach(BENCH_SERVER_PID);
+    int topic = sal_topic_id(name);
+    sal_topic_policy(topic, SAL_POLICY_CREDIT, 8);
+    for (int i = 0; i < nreaders; i++) {
+        readers[i].pid = BENCH_FIRST_WORKER + (uint32_t)i;
+        readers[i].topic = topic;
+        readers[i].received = 0;
+        sal_host_attach(readers[i].pid);
+        sal_subscribe_id(topic);
+    }
+    for (int i = 0; i < nreaders; i++) {
+        pthread_create(&readers[i].thread, NULL, fanout_reader_main, &readers[i]);
+    }
+
+    sal_host_attach(BENCH_SERVER_PID);
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sal_publish_id(topic, &i, sizeof(i));
+    }
+    for (int i = 0; i < nreaders; i++) {
+        pthread_join(readers[i].thread, NULL);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    struct sal_topic_stats st;
+    sal_topic_stats(topic, &st);
+    for (int i = 0; i < nreaders; i++) {
+        sal_host_attach(readers[i].pid);
+        sal_unsubscribe(topic);
+    }
+    printf("bench=fanout subscribers=%d msgs=%u deliveries_per_sec=%llu ns_per_publish=%llu stalls=%u\n",
+           nreaders, iterations,
+           (unsigned long long)((uint64_t)iterations * nreaders * 1000000000u / elapsed),
+           (unsigned long long)(elapsed / iterations), st.stalls);
+}
+
+// Many-to-one: N senders into one mailbox, drained in batches
+struct sender {
+    pthread_t thread;
+    uint32_t pid;
+    uint32_t count;
+};
+
+static void *sender_main(void *arg) {
+    struct sender *s = arg;
+    sal_host_attach(s->pid);
+    for (uint32_t i = 0; i < s->count; i++) {
+        while (sal_send(BENCH_SERVER_PID, &i, sizeof(i)) == SAL_ERR_FULL) sched_yield();
+    }
+    return NULL;
+}
+
+static void bench_many_to_one(int nsenders) {
+    struct sender senders[BENCH_MAX_WORKERS];
+    uint32_t per_sender = iterations / (uint32_t)nsenders;
+    for (int i = 0; i < nsenders; i++) {
+        senders[i].pid = BENCH_FIRST_WORKER + (uint32_t)i;
+        senders[i].count = per_sender;
+    }
+
+    sal_host_attach(BENCH_SERVER_PID);
+    uint32_t vals[SAL_MAX_BATCH];
+    struct sal_mmsg msgs[SAL_MAX_BATCH];
+    for (int i = 0; i < SAL_MAX_BATCH; i++) {
+        msgs[i].buf = &vals[i];
+        msgs[i].maxlen = sizeof(vals[i]);
+    }
+
+    // The mailbox counters are cumulative across runs
+    struct sal_queue_stats before, after;
+    sal_stats(SAL_STATS_MAILBOX, BENCH_SERVER_PID, &before);
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < nsenders; i++) {
+        pthread_create(&senders[i].thread, NULL, sender_main, &senders[i]);
+    }
+    uint32_t total = per_sender * (uint32_t)nsenders, received = 0, batches = 0;
+    while (received < total) {
+        int n = sal_recv_many(SAL_ANY_PID, msgs, SAL_MAX_BATCH);
+        if (n > 0) {
+            received += (uint32_t)n;
+            batches++;
+        } else {
+            sched_yield();
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+    for (int i = 0; i < nsenders; i++) {
+        pthread_join(senders[i].thread, NULL);
+    }
+
+    sal_stats(SAL_STATS_MAILBOX, BENCH_SERVER_PID, &after);
+    printf("bench=many_to_one senders=%d msgs=%u msgs_per_sec=%llu avg_batch=%u full_refusals=%u\n",
+           nsenders, total, (unsigned long long)((uint64_t)total * 1000000000u / elapsed),
+           batches ? total / batches : 0, after.drops - before.drops);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+    if (iterations == 0) return 1;
+
+    sal_host_init();
+    bench_pingpong();
+    bench_fanout(1);
+    bench_fanout(4);
+    bench_fanout(8);
+    bench_many_to_one(2);
+    bench_many_to_one(8);
+    sal_host_shutdown();
+    return 0;
+}
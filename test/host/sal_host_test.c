@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "../include/sal/sal.h"
+#include "../include/sal/sal_kernel.h"
+#include "../include/sal/sal_ring.h"
+#include "../include/sal/sal_host.h"
+#include "../include/auth.h"
+#include "../include/dsp/dsp_profile.h"
+#include "../sal_test.h"
+#include "../dsp_test.h"
+
+// Host runner for the SAL test suite (make host-test). Provides the
+// kernel_test.c framework on stdout, runs the in-kernel suite against the
+// simulated kernel, then adds tests that need real concurrency.
+
+static int test_count = 0;
+static int test_passed = 0;
+static int test_failed = 0;
+
+void serial_print(const char* str) {
+    fputs(str, stdout);
+}
+
+void test_start(const char* test_name) {
+    printf("TEST %d: %s\n", ++test_count, test_name);
+}
+
+void test_assert(int condition, const char* message) {
+    printf("%s - %s\n", condition ? "PASS" : "FAIL", message);
+    if (condition) {
+        test_passed++;
+    } else {
+        test_failed++;
+    }
+}
+
+void test_end(void) {
+    printf("==========================================\n");
+    printf("Test Summary:\nTotal tests: %d\nPassed: %d\nFailed: %d\n", test_count, test_passed, test_failed);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Echo server: waits on its mailbox through an event port and replies
+static void *echo_main(void *arg) {
+    int rounds = *(int *)arg;
+    sal_host_attach(2);
+    int port = sal_port_create();
+    struct sal_watch mbox = { SAL_EV_MAILBOX, 0, 0, 0 };
+    sal_port_ctl(port, SAL_PORT_ADD, &mbox);
+    struct sal_event ev;
+    for (int i = 0; i < rounds; ) {
+        if (sal_wait(port, &ev, 1, SAL_WAIT_FOREVER) <= 0) continue;
+        uint32_t v;
+        while (sal_recv(1, &v, sizeof(v)) == sizeof(v)) {
+            sal_send(1, &v, sizeof(v));
+            i++;
+        }
+    }
+    sal_port_close(port);
+    return NULL;
+}
+
+// Test blocking waits woken from another thread
+static void test_host_wakeups(void) {
+    test_start("Host Cross-Thread Wakeups");
+    
+    int rounds = 1000;
+    pthread_t echo;
+    pthread_create(&echo, NULL, echo_main, &rounds);
+    sal_host_attach(1);
+    int ok = 1;
+    for (uint32_t i = 0; i < (uint32_t)rounds; i++) {
+        uint32_t v = 0;
+        while (sal_send(2, &i, sizeof(i)) == SAL_ERR_FULL);
+        while (sal_recv(2, &v, sizeof(v)) == SAL_ERR_AGAIN);
+        if (v != i) ok = 0;
+    }
+    pthread_join(echo, NULL);
+    test_assert(ok, "Echo server answered every request in order");
+    
+    // A timeout wait returns after roughly the requested ticks
+    int port = sal_port_create();
+    struct sal_event ev;
+    uint64_t start = now_ns();
+    int n = sal_wait(port, &ev, 1, 5);
+    uint64_t waited = now_ns() - start;
+    test_assert(n == 0, "Timed wait reports no events");
+    test_assert(waited >= 4u * SAL_HOST_TICK_US * 1000u, "Timed wait sleeps until its deadline");
+    
+    struct sal_watch tick = { SAL_EV_TIMER, 0, 2, 7 };
+    sal_port_ctl(port, SAL_PORT_ADD, &tick);
+    n = sal_wait(port, &ev, 1, 50);
+    test_assert(n == 1, "Tick thread fires port timers");
+    test_assert(ev.type == SAL_EV_TIMER, "Timer event reported");
+    test_assert(ev.data == 7, "Timer event carries its watch data");
+    sal_port_close(port);
+    sal_host_attach(0);
+}
+
+struct credit_args {
+    int topic;
+    int count;
+    int ok;
+};
+
+static void *credit_reader_main(void *arg) {
+    struct credit_args *a = arg;
+    sal_host_attach(4);
+    for (int i = 0; i < a->count; ) {
+        uint32_t v;
+        if (sal_topic_recv(a->topic, NULL, &v, sizeof(v)) == sizeof(v)) {
+            if (v != (uint32_t)i) a->ok = 0;
+            i++;
+        }
+    }
+    return NULL;
+}
+
+// Test a credit topic blocking its publisher until the reader catches up
+static void test_host_backpressure(void) {
+    test_start("Host Credit Backpressure");
+    
+    sal_host_attach(3);
+    struct credit_args a = { sal_topic_id("host/credit"), 2000, 1 };
+    sal_topic_policy(a.topic, SAL_POLICY_CREDIT, 4);
+    sal_host_attach(4);
+    sal_subscribe_id(a.topic);
+    
+    pthread_t reader;
+    pthread_create(&reader, NULL, credit_reader_main, &a);
+    sal_host_attach(3);
+    for (uint32_t v = 0; v < (uint32_t)a.count; v++) {
+        sal_publish_id(a.topic, &v, sizeof(v));
+    }
+    pthread_join(reader, NULL);
+    
+    struct sal_topic_stats st;
+    sal_topic_stats(a.topic, &st);
+    test_assert(a.ok, "Every sample delivered in order");
+    test_assert(st.drops == 0, "No sample dropped");
+    test_assert(st.published == (uint32_t)a.count, "Publisher blocked instead of failing");
+    sal_host_attach(4);
+    sal_unsubscribe(a.topic);
+    sal_host_attach(0);
+}
+
+static void *ring_consumer_main(void *arg) {
+    struct sal_ring *r = arg;
+    uint32_t expect = 0;
+    while (expect < 100000) {
+        uint32_t v;
+        if (sal_ring_pop_wait(r, &v, sizeof(v)) == sizeof(v)) {
+            if (v != expect) break;
+            expect++;
+        }
+    }
+    return (void *)(uintptr_t)expect;
+}
+
+// Test a channel ring and its futex path between two threads
+static void test_host_channel(void) {
+    test_start("Host Channel Across Threads");
+    
+    sal_host_attach(5);
+    struct sal_ring *prod = sal_channel_open("host/ring", SAL_CHAN_PRODUCER, sizeof(uint32_t), 64);
+    struct sal_ring *cons = sal_channel_open("host/ring", SAL_CHAN_CONSUMER, 0, 0);
+    test_assert(prod != NULL, "Channel opened by the producer");
+    test_assert(cons != NULL, "Channel opened by the consumer");
+    
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, ring_consumer_main, cons);
+    for (uint32_t v = 0; v < 100000; v++) {
+        while (sal_ring_send(prod, &v, sizeof(v)) != SAL_OK);
+    }
+    void *got;
+    pthread_join(consumer, &got);
+    test_assert((uintptr_t)got == 100000, "Consumer saw every value in order");
+    sal_channel_close(cons);
+    sal_channel_close(prod);
+    sal_host_attach(0);
+}
+
+// Send one AUTH_VERIFY request to the service's endpoint with a reply
+// handle attached, as the requester (PID 7)
+static void auth_request(int verify, int reply, int user_id, const float *sample) {
+    struct AuthMsg msg = { .type = AUTH_VERIFY, .user_id = user_id };
+    uint8_t wire[AUTH_MSG_WIRE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    if (sample != NULL) memcpy(msg.sample, sample, sizeof(msg.sample));
+    long len = auth_msg_encode(&msg, 1, wire, sizeof(wire));
+    sal_handle_send(verify, wire, (size_t)len, sal_handle_dup(reply, SAL_RIGHT_SEND | SAL_RIGHT_GRANT));
+}
+
+// Test the auth service's verification path against the profile store
+static void test_host_auth(void) {
+    test_start("Host Auth Verification");
+    
+    float profile[AUTH_TEMPLATE_DIM], impostor[AUTH_TEMPLATE_DIM];
+    for (int i = 0; i < AUTH_TEMPLATE_DIM; i++) {
+        profile[i] = (float)(i + 1);
+        impostor[i] = (i & 1) ? 1.0f : -1.0f;
+    }
+    auth_profiles_load(NULL, 0);
+    test_assert(auth_store_profile(3, profile) == 0, "Profile enrolled");
+    test_assert(auth_store_profile(-1, profile) < 0, "Negative user id refused");
+    test_assert(auth_verify_user(3, profile) == 1, "Own sample verifies");
+    test_assert(auth_verify_user(3, impostor) == 0, "Different sample refused");
+    test_assert(auth_verify_user(9, profile) == 0, "Unknown user refused");
+    test_assert(auth_verify_user(3, NULL) == 0, "Missing sample refused");
+    
+    // Enrolments past the journal compact the store into RAM
+    int ok = 1;
+    for (int u = 100; u < 100 + DSP_PROFILE_TAIL_MAX + 10; u++) {
+        profile[0] = (float)u;
+        if (auth_store_profile(u, profile) != 0) ok = 0;
+    }
+    test_assert(ok, "Enrolments continue past a full journal");
+    profile[0] = 100.0f;
+    test_assert(auth_verify_user(100, profile) == 1, "Profile from before the compaction verifies");
+    profile[0] = 1.0f;
+    test_assert(auth_verify_user(3, profile) == 1, "First profile survives the compaction");
+    
+    // Requests over the endpoint: one with the user's sample, one from a
+    // sender that carries none, one of the wrong type
+    sal_host_attach(6);
+    int verify = sal_endpoint_create("test/auth/verify");
+    sal_host_attach(7);
+    int ep = sal_endpoint_open("test/auth/verify");
+    int reply = sal_endpoint_create(NULL);
+    auth_request(ep, reply, 3, profile);
+    auth_request(ep, reply, 3, NULL);
+    struct AuthMsg other = { .type = AUTH_SUCCESS, .user_id = 3 };
+    uint8_t wire[AUTH_MSG_WIRE_SIZE] __attribute__((aligned(WIRE_ALIGN)));
+    long len = auth_msg_encode(&other, 1, wire, sizeof(wire));
+    sal_handle_send(ep, wire, (size_t)len, sal_handle_dup(reply, SAL_RIGHT_SEND | SAL_RIGHT_GRANT));
+    sal_host_attach(6);
+    auth_handle_requests(verify);
+    test_assert(sal_handle_recv(verify, wire, sizeof(wire), NULL) == SAL_ERR_AGAIN, "Every request taken");
+    
+    sal_host_attach(7);
+    struct AuthMsg got;
+    int n = sal_handle_recv(reply, wire, sizeof(wire), NULL);
+    test_assert(auth_msg_decode(wire, (size_t)n, &got) == 1, "Reply decodes");
+    test_assert(got.type == AUTH_SUCCESS, "Matching sample verified");
+    test_assert(got.user_id == 3, "Reply names the user");
+    int zero = 1;
+    for (int i = 0; i < AUTH_TEMPLATE_DIM; i++) {
+        if (got.sample[i] != 0.0f) zero = 0;
+    }
+    test_assert(zero, "Reply does not echo the sample");
+    n = sal_handle_recv(reply, wire, sizeof(wire), NULL);
+    test_assert(auth_msg_decode(wire, (size_t)n, &got) == 1, "Second reply decodes");
+    test_assert(got.type == AUTH_FAILURE, "Request without a sample refused");
+    test_assert(sal_handle_recv(reply, wire, sizeof(wire), NULL) == SAL_ERR_AGAIN, "Non-request left unanswered");
+    
+    sal_handle_close(reply);
+    sal_handle_close(ep);
+    sal_host_attach(6);
+    sal_handle_close(verify);
+    sal_host_attach(0);
+}
+
+int main(void) {
+    sal_host_init();
+    run_sal_tests();
+    run_dsp_tests();
+    test_host_wakeups();
+    test_host_backpressure();
+    test_host_channel();
+    test_host_auth();
+    test_end();
+    sal_host_shutdown();
+    return test_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/sal/sal_kernel.h"
+#include "../include/sal/sal_ring.h"
+#include "../include/dsp/dsp_fixed.h"
+#include "sal_benchmark.h"
+
+// Kernel functions used by the benchmarks
+extern void serial_print(const char* str);
+extern void outb(uint16_t port, uint8_t val);
+extern uint8_t inb(uint16_t port);
+extern uint32_t create_user_process(const char* name);
+
+// Processes have no contexts of their own yet, so each benchmark plays
+// both ends from kernel context by calling the sys_sal_* entry points
+// with the worker PIDs, like sal_test.c. The trap itself is not timed.
+#define BENCH_KPID 0
+#define BENCH_MAX_WORKERS 16
+#define BENCH_WARMUP 64          // Untimed iterations before each run
+#define BENCH_SAMPLES 1024       // Timed iterations per latency benchmark
+#define BENCH_MESSAGES 8192      // Messages per throughput benchmark
+#define BENCH_TOPIC_BATCH 16     // SAL_SUB_QUEUE_DEPTH
+#define BENCH_RING_SLOTS 64
+#define BENCH_RING_PAYLOAD 32
+
+static uint32_t bench_pids[BENCH_MAX_WORKERS];
+static uint32_t bench_workers = 0;
+static uint32_t tsc_khz = 0;     // 0 until calibrated
+static uint32_t samples[BENCH_SAMPLES];
+
+// 64-by-32 bit division; the kernel does not link libgcc's __udivdi3
+uint64_t bench_div(uint64_t n, uint32_t d) {
+    return dsp_udiv64(n, d);
+}
+
+uint64_t bench_ns(uint64_t cycles) {
+    return dsp_udiv64(cycles * 1000, tsc_khz);
+}
+
+// Output: one line per result, "bench=<name> key=value ..."
+static void bench_print_u64(uint64_t v) {
+    char buf[21];
+    int i = 20;
+    buf[i] = '\0';
+    do {
+        uint64_t q = bench_div(v, 10);
+        buf[--i] = (char)('0' + (v - q * 10));
+        v = q;
+    } while (v != 0);
+    serial_print(&buf[i]);
+}
+
+void bench_begin(const char *name) {
+    serial_print("bench=");
+    serial_print(name);
+}
+
+void bench_field(const char *key, uint64_t value) {
+    serial_print(" ");
+    serial_print(key);
+    serial_print("=");
+    bench_print_u64(value);
+}
+
+void bench_label(const char *key, const char *value) {
+    serial_print(" ");
+    serial_print(key);
+    serial_print("=");
+    serial_print(value);
+}
+
+void bench_end(void) {
+    serial_print("\n");
+}
+
+// Count TSC cycles over 10 ms of PIT channel 2, which can be polled
+// with interrupts off. Runs once and reports the result.
+void bench_calibrate(void) {
+    if (tsc_khz != 0) return;
+    uint16_t latch = 1193182 / 100;
+    outb(0x61, (inb(0x61) & ~0x02) | 0x01);  // Gate on, speaker off
+    outb(0x43, 0xB0);                        // Channel 2, lobyte/hibyte, mode 0
+    outb(0x42, latch & 0xFF);
+    outb(0x42, latch >> 8);
+    uint64_t start = sal_arch_cycles();
+    while (!(inb(0x61) & 0x20));             // OUT2 rises at terminal count
+    tsc_khz = (uint32_t)bench_div(sal_arch_cycles() - start, 10);
+    if (tsc_khz == 0) tsc_khz = 1;
+    bench_begin("calibrate");
+    bench_field("tsc_khz", tsc_khz);
+    bench_end();
+}
+
+static void bench_spawn(void) {
+    while (bench_workers < BENCH_MAX_WORKERS) {
+        uint32_t pid = create_user_process("bench_worker");
+        if (pid == 0) break;
+        bench_pids[bench_workers++] = pid;
+    }
+}
+
+static void bench_sort(uint32_t *v, uint32_t n) {
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t x = v[i];
+        uint32_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+// Time op once per sample and report the average, median and p99
+static void bench_latency(void (*op)(uint32_t)) {
+    for (uint32_t i = 0; i < BENCH_WARMUP; i++) op(i);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < BENCH_SAMPLES; i++) {
+        uint64_t start = sal_arch_cycles();
+        op(i);
+        samples[i] = (uint32_t)(sal_arch_cycles() - start);
+        total += samples[i];
+    }
+    bench_sort(samples, BENCH_SAMPLES);
+    uint64_t avg = bench_div(total, BENCH_SAMPLES);
+    uint32_t p50 = samples[BENCH_SAMPLES / 2];
+    uint32_t p99 = samples[BENCH_SAMPLES * 99 / 100];
+    bench_field("samples", BENCH_SAMPLES);
+    bench_field("avg_cycles", avg);
+    bench_field("avg_ns", bench_ns(avg));
+    bench_field("p50_cycles", p50);
+    bench_field("p50_ns", bench_ns(p50));
+    bench_field("p99_cycles", p99);
+    bench_field("p99_ns", bench_ns(p99));
+}
+
+// Run op until it has moved BENCH_MESSAGES messages; op returns how many
+// it moved per call
+static void bench_throughput(uint32_t (*op)(uint32_t)) {
+    for (uint32_t i = 0; i < BENCH_WARMUP; i++) op(i);
+    uint32_t msgs = 0;
+    uint64_t start = sal_arch_cycles();
+    for (uint32_t i = 0; msgs < BENCH_MESSAGES; i++) {
+        msgs += op(i);
+    }
+    uint64_t per_msg = bench_div(sal_arch_cycles() - start, msgs);
+    bench_field("msgs", msgs);
+    bench_field("cycles_per_msg", per_msg);
+    bench_field("ns_per_msg", bench_ns(per_msg));
+}
+
+// Mailbox round trip: A sends to B, B answers
+static void bench_pingpong_once(uint32_t i) {
+    uint32_t a = bench_pids[0], b = bench_pids[1], v;
+    sys_sal_send(a, (int)b, &i, sizeof(i));
+    sys_sal_recv(b, (int)a, &v, sizeof(v));
+    sys_sal_send(b, (int)a, &v, sizeof(v));
+    sys_sal_recv(a, (int)b, &v, sizeof(v));
+}
+
+void bench_sal_pingpong() {
+    bench_begin("pingpong");
+    bench_field("bytes", sizeof(uint32_t));
+    bench_latency(bench_pingpong_once);
+    bench_end();
+}
+
+// Synchronous call through handles, as the auth service is used: the
+// client attaches a send handle for its reply endpoint to each request
+static int call_server = SAL_NO_HANDLE;
+static int call_client = SAL_NO_HANDLE;
+static int call_reply = SAL_NO_HANDLE;
+
+static void bench_call_once(uint32_t i) {
+    uint32_t client = bench_pids[0], server = bench_pids[1], v;
+    int got = SAL_NO_HANDLE;
+    int xfer = (int)sys_sal_handle_dup(client, call_reply, SAL_RIGHT_SEND | SAL_RIGHT_GRANT);
+    sys_sal_handle_send(client, call_client, &i, sizeof(i), xfer);
+    sys_sal_handle_recv(server, call_server, &v, sizeof(v), &got);
+    sys_sal_handle_send(server, got, &v, sizeof(v), SAL_NO_HANDLE);
+    sys_sal_handle_close(server, got);
+    sys_sal_handle_recv(client, call_reply, &v, sizeof(v), NULL);
+}
+
+void bench_sal_call() {
+    uint32_t client = bench_pids[0], server = bench_pids[1];
+    call_server = (int)sys_sal_endpoint_create(server, "bench/call");
+    call_client = (int)sys_sal_endpoint_open(client, "bench/call");
+    call_reply = (int)sys_sal_endpoint_create(client, NULL);
+
+    bench_begin("call");
+    bench_field("bytes", sizeof(uint32_t));
+    bench_latency(bench_call_once);
+    bench_end();
+
+    sys_sal_handle_close(client, call_reply);
+    sys_sal_handle_close(client, call_client);
+    sys_sal_handle_close(server, call_server);
+}
+
+// One publish from the kernel, received by every subscriber
+static int fanout_topic;
+static uint32_t fanout_subs;
+
+static void bench_fanout_once(uint32_t i) {
+    uint32_t v;
+    sys_sal_publish(BENCH_KPID, fanout_topic, &i, sizeof(i));
+    for (uint32_t s = 0; s < fanout_subs; s++) {
+        sys_sal_topic_recv(bench_pids[s], fanout_topic, NULL, &v, sizeof(v));
+    }
+}
+
+void bench_sal_fanout(uint32_t subscribers) {
+    static const char *names[] = { "bench/fanout/a", "bench/fanout/b", "bench/fanout/c", "bench/fanout/d" };
+    static uint32_t run = 0;
+    if (subscribers > bench_workers) subscribers = bench_workers;
+    fanout_subs = subscribers;
+    fanout_topic = (int)sys_sal_topic_intern(BENCH_KPID, names[run++ % 4]);
+    for (uint32_t s = 0; s < subscribers; s++) {
+        sys_sal_subscribe(bench_pids[s], fanout_topic);
+    }
+
+    bench_begin("fanout");
+    bench_field("subscribers", subscribers);
+    bench_latency(bench_fanout_once);
+    bench_end();
+
+    for (uint32_t s = 0; s < subscribers; s++) {
+        sys_sal_unsubscribe(bench_pids[s], fanout_topic);
+    }
+}
+
+// Fill a queue, then drain it one call per message or in one batch
+static int batch_topic;
+static struct sal_mmsg batch_msgs[BENCH_TOPIC_BATCH];
+static uint32_t batch_vals[BENCH_TOPIC_BATCH];
+
+static uint32_t bench_mailbox_single(uint32_t i) {
+    uint32_t a = bench_pids[0], b = bench_pids[1], v;
+    for (uint32_t n = 0; n < SAL_MAILBOX_DEPTH; n++) sys_sal_send(a, (int)b, &i, sizeof(i));
+    for (uint32_t n = 0; n < SAL_MAILBOX_DEPTH; n++) sys_sal_recv(b, (int)a, &v, sizeof(v));
+    return SAL_MAILBOX_DEPTH;
+}
+
+static uint32_t bench_mailbox_batched(uint32_t i) {
+    uint32_t a = bench_pids[0], b = bench_pids[1];
+    for (uint32_t n = 0; n < SAL_MAILBOX_DEPTH; n++) sys_sal_send(a, (int)b, &i, sizeof(i));
+    sys_sal_recv_many(b, (int)a, batch_msgs, SAL_MAILBOX_DEPTH);
+    return SAL_MAILBOX_DEPTH;
+}
+
+static uint32_t bench_topic_single(uint32_t i) {
+    uint32_t v;
+    for (uint32_t n = 0; n < BENCH_TOPIC_BATCH; n++) sys_sal_publish(BENCH_KPID, batch_topic, &i, sizeof(i));
+    for (uint32_t n = 0; n < BENCH_TOPIC_BATCH; n++) {
+        sys_sal_topic_recv(bench_pids[0], batch_topic, NULL, &v, sizeof(v));
+    }
+    return BENCH_TOPIC_BATCH;
+}
+
+static uint32_t bench_topic_batched(uint32_t i) {
+    struct sal_pub_entry entries[BENCH_TOPIC_BATCH];
+    for (uint32_t n = 0; n < BENCH_TOPIC_BATCH; n++) {
+        entries[n].topic_id = batch_topic;
+        entries[n].data = &i;
+        entries[n].len = sizeof(i);
+    }
+    sys_sal_publish_batch(BENCH_KPID, entries, BENCH_TOPIC_BATCH);
+    sys_sal_topic_recv_many(bench_pids[0], batch_topic, batch_msgs, BENCH_TOPIC_BATCH);
+    return BENCH_TOPIC_BATCH;
+}
+
+static void bench_batch_run(const char *name, const char *mode, uint32_t batch, uint32_t (*op)(uint32_t)) {
+    bench_begin(name);
+    bench_label("mode", mode);
+    bench_field("batch", batch);
+    bench_throughput(op);
+    bench_end();
+}
+
+void bench_sal_batching() {
+    for (int n = 0; n < BENCH_TOPIC_BATCH; n++) {
+        batch_msgs[n].buf = &batch_vals[n];
+        batch_msgs[n].maxlen = sizeof(batch_vals[n]);
+    }
+    bench_batch_run("mailbox", "single", 1, bench_mailbox_single);
+    bench_batch_run("mailbox", "batched", SAL_MAILBOX_DEPTH, bench_mailbox_batched);
+
+    batch_topic = (int)sys_sal_topic_intern(BENCH_KPID, "bench/batch");
+    sys_sal_subscribe(bench_pids[0], batch_topic);
+    bench_batch_run("topic", "single", 1, bench_topic_single);
+    bench_batch_run("topic", "batched", BENCH_TOPIC_BATCH, bench_topic_batched);
+    sys_sal_unsubscribe(bench_pids[0], batch_topic);
+}
+
+// SPSC ring between two mappings: fill it, then drain it
+static struct sal_ring *ring_prod;
+static struct sal_ring *ring_cons;
+
+static uint32_t bench_ring_once(uint32_t i) {
+    uint8_t buf[BENCH_RING_PAYLOAD];
+    buf[0] = (uint8_t)i;
+    for (uint32_t n = 0; n < BENCH_RING_SLOTS; n++) sal_ring_push(ring_prod, buf, sizeof(buf));
+    for (uint32_t n = 0; n < BENCH_RING_SLOTS; n++) sal_ring_pop(ring_cons, buf, sizeof(buf));
+    return BENCH_RING_SLOTS;
+}
+
+void bench_sal_ring() {
+    uint32_t prod = bench_pids[0], cons = bench_pids[1];
+    ring_prod = (struct sal_ring *)sys_sal_channel_open(prod, "bench/ring", SAL_CHAN_PRODUCER,
+                                                        BENCH_RING_PAYLOAD, BENCH_RING_SLOTS);
+    ring_cons = (struct sal_ring *)sys_sal_channel_open(cons, "bench/ring", SAL_CHAN_CONSUMER, 0, 0);
+    if ((long)ring_prod <= 0 || (long)ring_cons <= 0) {
+        serial_print("bench=ring error=open\n");
+        return;
+    }
+
+    bench_begin("ring");
+    bench_field("bytes", BENCH_RING_PAYLOAD);
+    bench_throughput(bench_ring_once);
+    bench_end();
+
+    sys_sal_channel_close(cons, ring_cons);
+    sys_sal_channel_close(prod, ring_prod);
+}
+
+// Main benchmark runner
+void run_sal_benchmarks() {
+    serial_print("\n");
+    serial_print("==========================================\n");
+    serial_print("    AERODESK SAL BENCHMARKS\n");
+    serial_print("==========================================\n");
+
+    bench_calibrate();
+    bench_spawn();
+    if (bench_workers < 2) {
+        serial_print("bench=error reason=workers\n");
+        return;
+    }
+
+    bench_sal_pingpong();
+    bench_sal_call();
+    bench_sal_fanout(1);
+    bench_sal_fanout(4);
+    bench_sal_fanout(16);
+    bench_sal_batching();
+    bench_sal_ring();
+}
@@ -0,0 +1,26 @@
+#ifndef SAL_BENCHMARK_H
+#define SAL_BENCHMARK_H
+
+#include <stdint.h>
+
+// SAL IPC benchmarks (kernel built with BENCH=1). Each result is one
+// serial line of key=value pairs starting with "bench=".
+void run_sal_benchmarks(void);
+
+// Output and timing helpers, shared with dsp_benchmark.c
+void bench_calibrate(void);
+uint64_t bench_div(uint64_t n, uint32_t d);
+uint64_t bench_ns(uint64_t cycles);
+void bench_begin(const char *name);
+void bench_field(const char *key, uint64_t value);
+void bench_label(const char *key, const char *value);
+void bench_end(void);
+
+// Individual benchmarks
+void bench_sal_pingpong(void);
+void bench_sal_call(void);
+void bench_sal_fanout(uint32_t subscribers);
+void bench_sal_batching(void);
+void bench_sal_ring(void);
+
+#endif // SAL_BENCHMARK_H
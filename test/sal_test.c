@@ -0,0 +1,783 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/sal/sal_kernel.h"
+#include "../include/sal/sal_ring.h"
+#include "../include/auth.h"
+
+// Test framework from kernel_test.c
+extern void serial_print(const char* str);
+extern void test_start(const char* test_name);
+extern void test_assert(int condition, const char* message);
+extern void test_end(void);
+
+// Kernel context runs as PID 0, which owns a mailbox like any process
+#define KPID 0
+
+static uint8_t grant_buffer[2 * SAL_PAGE_SIZE] __attribute__((aligned(4096)));
+
+// Test point-to-point send/recv through the kernel mailbox
+void test_sal_mailbox() {
+    test_start("SAL Mailbox");
+    
+    uint32_t a = 0x1111, b = 0x2222, out = 0;
+    test_assert(sys_sal_send(KPID, KPID, &a, sizeof(a)) == sizeof(a), "Send to own mailbox");
+    test_assert(sys_sal_send(KPID, KPID, &b, sizeof(b)) == sizeof(b), "Second send queued");
+    test_assert(sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out)) == sizeof(out), "First message received");
+    test_assert(out == a, "Messages delivered in FIFO order");
+    test_assert(sys_sal_recv(KPID, SAL_ANY_PID, &out, 1) == SAL_ERR_TOOBIG,
+                "Short buffer rejected without dequeuing");
+    test_assert(sys_sal_recv(KPID, KPID, &out, sizeof(out)) == sizeof(out), "Receive filtered by sender PID");
+    test_assert(out == b, "Filtered receive got the second message");
+    test_assert(sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out)) == SAL_ERR_AGAIN,
+                "Empty mailbox reports SAL_ERR_AGAIN");
+    
+    int filled = 0;
+    while (sys_sal_send(KPID, KPID, &a, sizeof(a)) == sizeof(a)) filled++;
+    test_assert(filled == SAL_MAILBOX_DEPTH, "Mailbox bounded at SAL_MAILBOX_DEPTH");
+    while (sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out)) > 0);
+    
+    test_assert(sys_sal_send(KPID, 99, &a, sizeof(a)) == SAL_ERR_NOPROC, "Unknown PID rejected");
+}
+
+// Test zero-copy page grants through the grant window
+void test_sal_grants() {
+    test_start("SAL Page Grants");
+    
+    grant_buffer[0] = 0xAB;
+    grant_buffer[SAL_PAGE_SIZE + 7] = 0xCD;
+    
+    test_assert(sys_sal_grant(KPID, KPID, grant_buffer + 1, 16, SAL_GRANT_SHARE_RO) == SAL_ERR_INVAL,
+                "Unaligned buffer rejected");
+    
+    int id = (int)sys_sal_grant(KPID, KPID, grant_buffer, sizeof(grant_buffer), SAL_GRANT_SHARE_RO);
+    test_assert(id > 0, "Shared grant created");
+    
+    void *addr = NULL;
+    size_t len = 0;
+    test_assert(sys_sal_grant_map(KPID, id, &addr, &len) == SAL_OK, "Grant mapped");
+#ifdef SAL_HOST
+    // The host backend maps grants onto the sender's own pages
+    test_assert(addr == (void *)grant_buffer, "Mapped onto the sender pages");
+#else
+    test_assert(addr != NULL, "Mapped at an address");
+    test_assert(addr != (void *)grant_buffer, "Mapped at a grant window address");
+#endif
+    test_assert(len == sizeof(grant_buffer), "Grant length reported");
+    
+    uint8_t *view = addr;
+    test_assert(view[0] == 0xAB, "Mapping aliases the first sender page");
+    test_assert(view[SAL_PAGE_SIZE + 7] == 0xCD, "Mapping aliases the second sender page");
+    grant_buffer[1] = 0xEF;
+    test_assert(view[1] == 0xEF, "Sender writes visible without copy");
+    
+    test_assert(sys_sal_grant_revoke(KPID, id) == SAL_OK, "Grant revoked");
+    test_assert(sys_sal_grant_map(KPID, id, &addr, &len) == SAL_ERR_INVAL, "Revoked id is stale");
+    
+    int moved = (int)sys_sal_grant(KPID, KPID, grant_buffer, SAL_PAGE_SIZE, SAL_GRANT_TRANSFER);
+    test_assert(moved > 0, "Transfer grant created");
+    test_assert(moved != id, "Transfer grant gets a fresh id");
+    test_assert(sys_sal_grant_map(KPID, moved, &addr, &len) == SAL_OK, "Transfer grant mapped");
+    test_assert(sys_sal_grant_unmap(KPID, moved) == SAL_OK, "Transferred pages released");
+    test_assert(sys_sal_grant_unmap(KPID, moved) == SAL_ERR_INVAL, "Released grant is gone");
+}
+
+// Test topic interning and broker fan-out
+void test_sal_pubsub() {
+    test_start("SAL Pub/Sub Broker");
+    
+    int hr = (int)sys_sal_topic_intern(KPID, "test/heart_rate");
+    int eeg = (int)sys_sal_topic_intern(KPID, "test/eeg_data");
+    test_assert(hr > 0, "First name interned");
+    test_assert(eeg > 0, "Second name interned");
+    test_assert(hr != eeg, "Distinct names get distinct ids");
+    test_assert(sys_sal_topic_intern(KPID, "test/heart_rate") == hr, "Interning is idempotent");
+    
+    uint32_t sample = 72, out = 0;
+    int topic = 0;
+    test_assert(sys_sal_publish(KPID, hr, &sample, sizeof(sample)) == 0,
+                "Publish without subscribers delivers nowhere");
+    
+    test_assert(sys_sal_subscribe(KPID, hr) == SAL_OK, "Subscribed by id");
+    test_assert(sys_sal_publish(KPID, hr, &sample, sizeof(sample)) == 1, "Publish fans out to subscriber");
+    test_assert(sys_sal_topic_recv(KPID, SAL_ANY_TOPIC, &topic, &out, sizeof(out)) == sizeof(out),
+                "Subscriber receives the sample");
+    test_assert(out == 72, "Payload intact");
+    test_assert(topic == hr, "Topic id reported");
+    test_assert(sys_sal_topic_recv(KPID, hr, &topic, &out, sizeof(out)) == SAL_ERR_AGAIN,
+                "Queue drained");
+    
+    for (int i = 0; i < SAL_SUB_QUEUE_DEPTH + 4; i++) {
+        sys_sal_publish(KPID, hr, &sample, sizeof(sample));
+    }
+    int drained = 0;
+    while (sys_sal_topic_recv(KPID, hr, &topic, &out, sizeof(out)) > 0) drained++;
+    test_assert(drained == SAL_SUB_QUEUE_DEPTH, "Subscriber queue bounded");
+    
+    test_assert(sys_sal_unsubscribe(KPID, hr) == SAL_OK, "Unsubscribed");
+    test_assert(sys_sal_publish(KPID, hr, &sample, sizeof(sample)) == 0, "No delivery after unsubscribe");
+}
+
+// Test shared-memory rings: setup through the kernel, data path without it
+void test_sal_channels() {
+    test_start("SAL Shared-Memory Channels");
+    
+    test_assert(sys_sal_channel_open(KPID, "test/ring", SAL_CHAN_PRODUCER, 16, 6) == SAL_ERR_INVAL,
+                "Non power-of-two ring rejected");
+    
+    struct sal_ring *prod = (struct sal_ring *)sys_sal_channel_open(KPID, "test/ring", SAL_CHAN_PRODUCER, 16, 8);
+    test_assert((long)prod > 0, "SPSC channel created");
+    test_assert(sys_sal_channel_open(KPID, "test/ring", SAL_CHAN_PRODUCER, 16, 8) == SAL_ERR_BUSY,
+                "Second SPSC producer refused");
+    struct sal_ring *cons = (struct sal_ring *)sys_sal_channel_open(KPID, "test/ring", SAL_CHAN_CONSUMER, 0, 0);
+#ifdef SAL_HOST
+    test_assert((long)cons > 0, "Consumer attached to the same ring");
+#else
+    test_assert((long)cons > 0, "Consumer attached");
+    test_assert(cons != prod, "Consumer attached through its own mapping");
+#endif
+    
+    int ok = 1;
+    for (uint32_t i = 0; i < 8; i++) {
+        ok &= sal_ring_push(prod, &i, sizeof(i)) == SAL_OK;
+    }
+    test_assert(ok, "Producer fills ring");
+    test_assert(sal_ring_push(prod, &ok, sizeof(ok)) == SAL_ERR_FULL, "Full ring refuses push");
+    for (uint32_t i = 0; i < 8; i++) {
+        uint32_t v = 0;
+        ok &= sal_ring_pop(cons, &v, sizeof(v)) == sizeof(v) && v == i;
+    }
+    test_assert(ok, "Consumer drains in order through the other mapping");
+    test_assert(sal_ring_pop(cons, &ok, sizeof(ok)) == SAL_ERR_AGAIN, "Empty ring reports SAL_ERR_AGAIN");
+    
+    test_assert(sys_sal_futex_wait(KPID, &cons->wake_seq, cons->wake_seq + 1) == SAL_ERR_AGAIN,
+                "Futex wait returns at once on a changed word");
+    test_assert(sys_sal_futex_wake(KPID, &prod->wake_seq, 1) == 0, "Futex wake with no waiters");
+    
+    struct sal_ring *mp = (struct sal_ring *)sys_sal_channel_open(KPID, "test/mpsc",
+                                                                 SAL_CHAN_PRODUCER | SAL_CHAN_CONSUMER | SAL_CHAN_MPSC, 8, 4);
+    struct sal_ring *mp2 = (struct sal_ring *)sys_sal_channel_open(KPID, "test/mpsc",
+                                                                  SAL_CHAN_PRODUCER | SAL_CHAN_MPSC, 8, 4);
+    test_assert((long)mp > 0, "MPSC channel created");
+    test_assert((long)mp2 > 0, "MPSC channel accepts several producers");
+    uint32_t a = 1, b = 2, v = 0;
+    sal_ring_push(mp, &a, sizeof(a));
+    sal_ring_push(mp2, &b, sizeof(b));
+    test_assert(sal_ring_pop(mp, &v, sizeof(v)) == sizeof(v), "MPSC delivers the first producer's slot");
+    test_assert(v == 1, "First producer's value intact");
+    test_assert(sal_ring_pop(mp, &v, sizeof(v)) == sizeof(v), "MPSC delivers the second producer's slot");
+    test_assert(v == 2, "Second producer's value intact");
+    
+    test_assert(sys_sal_channel_close(KPID, prod) == SAL_OK, "SPSC producer closed");
+    test_assert(sys_sal_channel_close(KPID, cons) == SAL_OK, "SPSC consumer closed");
+    test_assert(sys_sal_channel_close(KPID, mp) == SAL_OK, "MPSC consumer closed");
+    test_assert(sys_sal_channel_close(KPID, mp2) == SAL_OK, "Second MPSC producer closed");
+}
+
+// Test vectored send, batched receive and batched publish
+void test_sal_batching() {
+    test_start("SAL Vectored and Batched Operations");
+    
+    uint32_t hdr = 0xABCD, body[2] = {1, 2};
+    struct sal_iovec iov[2] = {{&hdr, sizeof(hdr)}, {body, sizeof(body)}};
+    test_assert(sys_sal_sendv(KPID, KPID, iov, 2) == 12, "Vectored send gathers segments");
+    test_assert(sys_sal_send(KPID, KPID, &hdr, sizeof(hdr)) == sizeof(hdr), "Second message queued");
+    
+    uint32_t bufs[3][4];
+    struct sal_mmsg msgs[3];
+    for (int i = 0; i < 3; i++) {
+        msgs[i].buf = bufs[i];
+        msgs[i].maxlen = sizeof(bufs[i]);
+    }
+    test_assert(sys_sal_recv_many(KPID, SAL_ANY_PID, msgs, 3) == 2, "Batched receive drains mailbox");
+    test_assert(msgs[0].len == 12, "Gathered message length intact");
+    test_assert(bufs[0][0] == 0xABCD, "Gathered header intact");
+    test_assert(bufs[0][2] == 2, "Gathered body intact");
+    test_assert(sys_sal_recv_many(KPID, SAL_ANY_PID, msgs, 3) == SAL_ERR_AGAIN, "Empty batch reports SAL_ERR_AGAIN");
+    
+    int t = (int)sys_sal_topic_intern(KPID, "test/batch");
+    sys_sal_subscribe(KPID, t);
+    struct sal_pub_entry entries[3];
+    for (int i = 0; i < 3; i++) {
+        entries[i].topic_id = t;
+        entries[i].data = &body[i & 1];
+        entries[i].len = sizeof(uint32_t);
+    }
+    entries[2].topic_id = SAL_MAX_TOPICS + 1;
+    test_assert(sys_sal_publish_batch(KPID, entries, 3) == 2, "Batch publish stops at bad entry");
+    
+    test_assert(sys_sal_topic_recv_many(KPID, t, msgs, 3) == 2, "Batched samples drained with one receive");
+    test_assert(bufs[0][0] == 1, "First sample first");
+    test_assert(bufs[1][0] == 2, "Second sample second");
+    test_assert(sys_sal_topic_recv_many(KPID, t, msgs, 3) == SAL_ERR_AGAIN, "Drained topic reports SAL_ERR_AGAIN");
+    sys_sal_unsubscribe(KPID, t);
+}
+
+// Test event ports: readiness from several sources through one wait
+void test_sal_ports() {
+    test_start("SAL Event Ports");
+    
+    int port = (int)sys_sal_port_create(KPID);
+    test_assert(port > 0, "Port created");
+    
+    struct sal_watch mailbox = { SAL_EV_MAILBOX, 0, 0, 1 };
+    struct sal_watch irq = { SAL_EV_IRQ, SAL_WATCH_EDGE, 5, 2 };
+    test_assert(sys_sal_port_ctl(KPID, port, SAL_PORT_ADD, &mailbox) == SAL_OK, "Mailbox watch registered");
+    test_assert(sys_sal_port_ctl(KPID, port, SAL_PORT_ADD, &irq) == SAL_OK, "IRQ watch registered");
+    test_assert(sys_sal_port_ctl(KPID, port, SAL_PORT_ADD, &mailbox) == SAL_ERR_BUSY, "Duplicate watch refused");
+    
+    struct sal_event events[4];
+    test_assert(sys_sal_wait(KPID, port, events, 4, 0) == 0, "Nothing ready on an idle port");
+    
+    uint32_t v = 7;
+    sys_sal_send(KPID, KPID, &v, sizeof(v));
+    sal_port_irq(5);
+    long n = sys_sal_wait(KPID, port, events, 4, 0);
+    test_assert(n == 2, "Both sources reported");
+    test_assert(events[0].type == SAL_EV_MAILBOX, "Mailbox reported first");
+    test_assert(events[1].type == SAL_EV_IRQ, "IRQ reported second");
+    
+    test_assert(sys_sal_wait(KPID, port, events, 4, 0) == 1, "Level watch repeats while mail is queued");
+    test_assert(events[0].data == 1, "Repeat carries the mailbox watch data");
+    sys_sal_recv(KPID, SAL_ANY_PID, &v, sizeof(v));
+    test_assert(sys_sal_wait(KPID, port, events, 4, 0) == 0, "Level watch clears once drained");
+    
+    test_assert(sys_sal_port_close(KPID, port) == SAL_OK, "Port closed");
+    test_assert(sys_sal_wait(KPID, port, events, 4, 0) == SAL_ERR_INVAL, "Closed port rejected");
+}
+
+// Test capability handles: rights checks and handle transfer
+void test_sal_handles() {
+    test_start("SAL Capability Handles");
+    
+    int ep = (int)sys_sal_endpoint_create(KPID, "test/endpoint");
+    test_assert(ep >= 0, "Named endpoint created");
+    test_assert(sys_sal_endpoint_create(KPID, "test/endpoint") == SAL_ERR_BUSY, "Duplicate name refused");
+    
+    int peer = (int)sys_sal_endpoint_open(KPID, "test/endpoint");
+    test_assert(peer >= 0, "Endpoint opened by name");
+    test_assert(peer != ep, "Opened handle is a new table entry");
+    uint32_t v = 0x5A5A, out = 0;
+    test_assert(sys_sal_handle_recv(KPID, peer, &out, sizeof(out), NULL) == SAL_ERR_PERM,
+                "Opened handle cannot receive");
+    
+    int reply = (int)sys_sal_endpoint_create(KPID, NULL);
+    int reply_send = (int)sys_sal_handle_dup(KPID, reply, SAL_RIGHT_SEND | SAL_RIGHT_GRANT);
+    test_assert(sys_sal_handle_dup(KPID, reply_send, SAL_RIGHT_RECV) == SAL_ERR_PERM, "Dup cannot add rights");
+    test_assert(sys_sal_handle_send(KPID, peer, &v, sizeof(v), reply_send) == sizeof(v), "Send with handle attached");
+    test_assert(sys_sal_handle_close(KPID, reply_send) == SAL_ERR_INVAL, "Attached handle moved out of the table");
+    
+    int got = SAL_NO_HANDLE;
+    test_assert(sys_sal_handle_recv(KPID, ep, &out, sizeof(out), &got) == sizeof(out), "Receiver gets the message");
+    test_assert(out == v, "Message payload intact");
+    test_assert(got >= 0, "Receiver gets the transferred handle");
+    test_assert(sys_sal_handle_send(KPID, got, &v, sizeof(v), SAL_NO_HANDLE) == sizeof(v),
+                "Reply sent through transferred handle");
+    test_assert(sys_sal_handle_recv(KPID, reply, &out, sizeof(out), NULL) == sizeof(out), "Reply delivered");
+    
+    sys_sal_handle_close(KPID, got);
+    sys_sal_handle_close(KPID, reply);
+    sys_sal_handle_close(KPID, ep);
+    test_assert(sys_sal_handle_send(KPID, peer, &v, sizeof(v), SAL_NO_HANDLE) == SAL_ERR_NOPROC,
+                "Send fails once the endpoint is closed");
+    sys_sal_handle_close(KPID, peer);
+    
+    // Messages still queued when the last receiver goes are dropped, with
+    // any handle they carry, so a new endpoint in the same slot starts empty
+    struct sal_queue_stats before, after;
+    ep = (int)sys_sal_endpoint_create(KPID, "test/endpoint");
+    peer = (int)sys_sal_endpoint_open(KPID, "test/endpoint");
+    reply = (int)sys_sal_endpoint_create(KPID, NULL);
+    reply_send = (int)sys_sal_handle_dup(KPID, reply, SAL_RIGHT_SEND | SAL_RIGHT_GRANT);
+    sys_sal_handle_send(KPID, peer, &v, sizeof(v), reply_send);
+    sys_sal_handle_send(KPID, peer, &v, sizeof(v), SAL_NO_HANDLE);
+    sys_sal_stats(KPID, SAL_STATS_MAILBOX, KPID, &before);
+    sys_sal_handle_close(KPID, ep);
+    sys_sal_stats(KPID, SAL_STATS_MAILBOX, KPID, &after);
+    test_assert(after.drops - before.drops == 2, "Closing the endpoint drops its queued messages");
+    test_assert(sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out)) == SAL_ERR_AGAIN, "Mailbox left empty");
+    
+    ep = (int)sys_sal_endpoint_create(KPID, "test/endpoint");
+    test_assert(sys_sal_handle_recv(KPID, ep, &out, sizeof(out), NULL) == SAL_ERR_AGAIN,
+                "New endpoint does not receive the old messages");
+    sys_sal_handle_close(KPID, ep);
+    sys_sal_handle_close(KPID, peer);
+    sys_sal_handle_close(KPID, reply);
+}
+
+// Test per-topic delivery policies and their counters
+void test_sal_policies() {
+    test_start("SAL Topic Delivery Policies");
+    
+    struct sal_topic_stats st;
+    uint32_t v, out = 0;
+    int latest = (int)sys_sal_topic_intern(KPID, "test/latest");
+    sys_sal_subscribe(KPID, latest);
+    test_assert(sys_sal_topic_policy(KPID, latest, SAL_POLICY_LATEST, 0) == SAL_OK, "Latest-only policy set");
+    for (v = 0; v < 40; v++) sys_sal_publish(KPID, latest, &v, sizeof(v));
+    test_assert(sys_sal_topic_recv(KPID, latest, NULL, &out, sizeof(out)) == sizeof(out), "Latest sample queued");
+    test_assert(out == 39, "Reader sees the newest sample");
+    test_assert(sys_sal_topic_recv(KPID, latest, NULL, &out, sizeof(out)) == SAL_ERR_AGAIN,
+                "Reader sees only the newest sample");
+    sys_sal_topic_stats(KPID, latest, &st);
+    test_assert(st.published == 40, "Every publish counted");
+    test_assert(st.drops == 39, "Overwrites counted as drops");
+    
+    int oldest = (int)sys_sal_topic_intern(KPID, "test/oldest");
+    sys_sal_subscribe(KPID, oldest);
+    sys_sal_topic_policy(KPID, oldest, SAL_POLICY_DROP_OLDEST, 0);
+    for (v = 0; v < SAL_SUB_QUEUE_DEPTH + 2; v++) sys_sal_publish(KPID, oldest, &v, sizeof(v));
+    test_assert(sys_sal_topic_recv(KPID, oldest, NULL, &out, sizeof(out)) == sizeof(out), "Drop-oldest queue readable");
+    test_assert(out == 2, "Full queue evicts its oldest samples");
+    
+    int credit = (int)sys_sal_topic_intern(KPID, "test/credit");
+    sys_sal_subscribe(KPID, credit);
+    test_assert(sys_sal_topic_policy(KPID, credit, SAL_POLICY_CREDIT, 2) == SAL_OK, "Credit window set");
+    test_assert(sys_sal_publish(KPID, credit, &v, sizeof(v)) == 1, "First publish within the window delivered");
+    test_assert(sys_sal_publish(KPID, credit, &v, sizeof(v)) == 1, "Second publish within the window delivered");
+    test_assert(sys_sal_publish(KPID, credit, &v, sizeof(v)) == SAL_ERR_AGAIN, "Exhausted window stalls publisher");
+    sys_sal_topic_recv(KPID, credit, NULL, &out, sizeof(out));
+    test_assert(sys_sal_publish(KPID, credit, &v, sizeof(v)) == 1, "Consuming returns credit");
+    sys_sal_topic_stats(KPID, credit, &st);
+    test_assert(st.stalls > 0, "Stalls counted");
+    test_assert(st.drops == 0, "Nothing dropped");
+    
+    sys_sal_unsubscribe(KPID, latest);
+    sys_sal_unsubscribe(KPID, oldest);
+    sys_sal_unsubscribe(KPID, credit);
+}
+
+// Test that subscribers sitting on full queues cannot starve other topics
+// of payload buffers
+void test_sal_pool() {
+    test_start("SAL Payload Buffer Pool");
+    
+    uint32_t v = 0, out = 0;
+    int fast = (int)sys_sal_topic_intern(KPID, "test/pool/fast");
+    sys_sal_subscribe(KPID, fast);
+    sys_sal_topic_policy(KPID, fast, SAL_POLICY_DROP_OLDEST, 0);
+    
+    // Slow subscribers take every remaining subscription and never read.
+    // Each joins after the others' queues are full, so each queued entry
+    // pins a buffer of its own.
+    int topics[SAL_MAX_PROC_SUBS];
+    char name[] = "test/pool/a";
+    for (int i = 0; i < SAL_MAX_PROC_SUBS; i++) {
+        name[sizeof(name) - 2] = (char)('a' + i);
+        topics[i] = (int)sys_sal_topic_intern(KPID, name);
+    }
+    uint32_t subs = 0, pinned = 0, nomem = 0;
+    for (uint32_t pid = 1; pid < SAL_MAX_PROCS; pid++) {
+        for (int i = 0; i < SAL_MAX_PROC_SUBS; i++) {
+            if (sys_sal_subscribe(pid, topics[i]) == SAL_OK) subs++;
+        }
+        for (int i = 0; i < SAL_MAX_PROC_SUBS; i++) {
+            for (int k = 0; k < SAL_SUB_QUEUE_DEPTH; k++) {
+                long ret = sys_sal_publish(KPID, topics[i], &v, sizeof(v));
+                if (ret == SAL_ERR_NOMEM) nomem++;
+                if (ret > 0) pinned++;
+            }
+        }
+    }
+    test_assert(subs == SAL_MAX_SUBSCRIPTIONS - 1, "Slow subscribers hold every other subscription");
+    test_assert(pinned == subs * SAL_SUB_QUEUE_DEPTH, "Every slow queue filled");
+    test_assert(nomem == 0, "Filling the queues never ran the pool dry");
+    
+    long ret = 0;
+    for (v = 0; v <= SAL_SUB_QUEUE_DEPTH; v++) {
+        ret = sys_sal_publish(KPID, fast, &v, sizeof(v));
+        if (ret != 1) break;
+    }
+    test_assert(ret == 1, "Drop-oldest publish delivered with every other queue full");
+    test_assert(sys_sal_topic_recv(KPID, fast, NULL, &out, sizeof(out)) == sizeof(out), "Fast subscriber reads");
+    test_assert(out == 1, "Oldest sample evicted for the new one");
+    
+    for (uint32_t pid = 1; pid < SAL_MAX_PROCS; pid++) {
+        for (int i = 0; i < SAL_MAX_PROC_SUBS; i++) sys_sal_unsubscribe(pid, topics[i]);
+    }
+    sys_sal_unsubscribe(KPID, fast);
+}
+
+// Test priority classes and deadline ordering in the mailbox
+void test_sal_priority() {
+    test_start("SAL Message Priorities");
+    
+    uint32_t v, out = 0;
+    uint32_t now = (uint32_t)sys_sal_ticks(KPID);
+    struct sal_msg_attr bulk = { SAL_PRIO_BULK, 0 };
+    struct sal_msg_attr urgent = { SAL_PRIO_URGENT, 0 };
+    struct sal_msg_attr late = { SAL_PRIO_HIGH, now + 50 };
+    struct sal_msg_attr soon = { SAL_PRIO_HIGH, now + 10 };
+    struct sal_msg_attr bad = { SAL_NUM_PRIOS, 0 };
+    
+    v = 1; sys_sal_send_attr(KPID, KPID, &v, sizeof(v), &bulk);
+    v = 2; sys_sal_send(KPID, KPID, &v, sizeof(v));
+    v = 3; sys_sal_send_attr(KPID, KPID, &v, sizeof(v), &late);
+    v = 4; sys_sal_send_attr(KPID, KPID, &v, sizeof(v), &soon);
+    v = 5; sys_sal_send_attr(KPID, KPID, &v, sizeof(v), &urgent);
+    test_assert(sys_sal_send_attr(KPID, KPID, &v, sizeof(v), &bad) == SAL_ERR_INVAL, "Unknown class rejected");
+    
+    static const uint32_t expect[] = { 5, 4, 3, 2, 1 };
+    int ordered = 1;
+    for (int i = 0; i < 5; i++) {
+        if (sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out)) != sizeof(out) || out != expect[i]) ordered = 0;
+    }
+    test_assert(ordered, "Dequeued by class, then earliest deadline");
+    
+    int ep = (int)sys_sal_endpoint_create(KPID, NULL);
+    test_assert(sys_sal_endpoint_priority(KPID, ep, SAL_PRIO_URGENT) == SAL_OK, "Endpoint class set");
+    int peer = (int)sys_sal_handle_dup(KPID, ep, SAL_RIGHT_SEND);
+    test_assert(sys_sal_endpoint_priority(KPID, peer, SAL_PRIO_BULK) == SAL_ERR_PERM,
+                "Only the receiver may set the class");
+    v = 6; sys_sal_send(KPID, KPID, &v, sizeof(v));
+    v = 7; sys_sal_handle_send(KPID, peer, &v, sizeof(v), SAL_NO_HANDLE);
+    test_assert(sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out)) == sizeof(out), "Endpoint message received");
+    test_assert(out == 7, "Endpoint messages overtake normal traffic");
+    sys_sal_recv(KPID, SAL_ANY_PID, &out, sizeof(out));
+    sys_sal_handle_close(KPID, peer);
+    sys_sal_handle_close(KPID, ep);
+}
+
+// Test retained history and per-subscriber cursors
+void test_sal_retention() {
+    test_start("SAL Retained History");
+    
+    uint32_t v, out[SAL_RETAIN_MAX];
+    struct sal_mmsg msgs[SAL_RETAIN_MAX];
+    for (int i = 0; i < SAL_RETAIN_MAX; i++) {
+        msgs[i].buf = &out[i];
+        msgs[i].maxlen = sizeof(out[i]);
+    }
+    
+    int topic = (int)sys_sal_topic_intern(KPID, "test/retained");
+    test_assert(sys_sal_topic_retain(KPID, topic, SAL_RETAIN_MAX + 1) == SAL_ERR_INVAL, "Oversized depth rejected");
+    test_assert(sys_sal_topic_retain(KPID, topic, 4) == SAL_OK, "Retention enabled");
+    for (v = 0; v < 6; v++) sys_sal_publish(KPID, topic, &v, sizeof(v));
+    
+    sys_sal_subscribe(KPID, topic);
+    test_assert(sys_sal_topic_history(KPID, topic, msgs, SAL_RETAIN_MAX) == 4,
+                "Late subscriber reads the last N in one batch");
+    test_assert(out[0] == 2, "History starts at the oldest retained");
+    test_assert(out[3] == 5, "History ends at the newest");
+    test_assert(sys_sal_topic_history(KPID, topic, msgs, SAL_RETAIN_MAX) == SAL_ERR_AGAIN,
+                "Cursor caught up");
+    
+    v = 6;
+    sys_sal_publish(KPID, topic, &v, sizeof(v));
+    test_assert(sys_sal_topic_history(KPID, topic, msgs, 1) == 1, "History follows new publishes");
+    test_assert(out[0] == 6, "History returns the new publish");
+    test_assert(sys_sal_topic_recv(KPID, topic, NULL, &v, sizeof(v)) == SAL_ERR_AGAIN,
+                "Message read from history not delivered twice");
+    
+    test_assert(sys_sal_topic_seek(KPID, topic, 2) == 2, "Cursor rewound");
+    test_assert(sys_sal_topic_history(KPID, topic, msgs, SAL_RETAIN_MAX) == 2, "Rewound cursor replays the tail");
+    test_assert(out[0] == 5, "Replay starts at the rewound cursor");
+    test_assert(out[1] == 6, "Replay ends at the newest");
+    
+    struct sal_topic_stats st;
+    sys_sal_topic_stats(KPID, topic, &st);
+    test_assert(st.retained == 4, "Retained count reported");
+    
+    sys_sal_unsubscribe(KPID, topic);
+    test_assert(sys_sal_topic_retain(KPID, topic, 0) == SAL_OK, "Retention released");
+}
+
+// Test hierarchical names and wildcard subscriptions
+void test_sal_wildcards() {
+    test_start("SAL Wildcard Topics");
+    
+    uint32_t v = 7, out = 0;
+    int topic_out = 0;
+    int ch1 = (int)sys_sal_topic_intern(KPID, "test/eeg/ch1");
+    int ch2 = (int)sys_sal_topic_intern(KPID, "test/eeg/ch2");
+    int hr = (int)sys_sal_topic_intern(KPID, "test/hrv");
+    test_assert(sys_sal_topic_intern(KPID, "test/eeg+") == SAL_ERR_INVAL, "Wildcard inside a level rejected");
+    test_assert(sys_sal_topic_intern(KPID, "test/#/ch1") == SAL_ERR_INVAL, "'#' before the last level rejected");
+    
+    int family = (int)sys_sal_topic_intern(KPID, "test/eeg/+");
+    int subtree = (int)sys_sal_topic_intern(KPID, "test/#");
+    test_assert(family > 0, "'+' pattern interned");
+    test_assert(subtree > 0, "'#' pattern interned");
+    test_assert(sys_sal_publish(KPID, family, &v, sizeof(v)) == SAL_ERR_INVAL, "Publishing on a pattern rejected");
+    
+    sys_sal_subscribe(KPID, family);
+    test_assert(sys_sal_publish(KPID, ch2, &v, sizeof(v)) == 1, "'+' matches one level");
+    test_assert(sys_sal_publish(KPID, hr, &v, sizeof(v)) == 0, "'+' does not match a sibling branch");
+    test_assert(sys_sal_topic_recv(KPID, family, &topic_out, &out, sizeof(out)) == sizeof(out),
+                "Pattern subscriber receives");
+    test_assert(topic_out == ch2, "Receiver learns the concrete topic");
+    
+    sys_sal_subscribe(KPID, subtree);
+    test_assert(sys_sal_publish(KPID, ch1, &v, sizeof(v)) == 2, "Overlapping patterns each get a copy");
+    test_assert(sys_sal_publish(KPID, hr, &v, sizeof(v)) == 1, "'#' matches the whole subtree");
+    
+    sys_sal_unsubscribe(KPID, family);
+    test_assert(sys_sal_publish(KPID, ch1, &v, sizeof(v)) == 1, "Cached subscriber set rebuilt on unsubscribe");
+    sys_sal_unsubscribe(KPID, subtree);
+    
+    // Direct, '+' and '#' subscribers all at their per-topic limit: the
+    // topic's set holds every one of them
+    int wide = (int)sys_sal_topic_intern(KPID, "test/fan/wide");
+    int fan_level = (int)sys_sal_topic_intern(KPID, "test/fan/+");
+    int fan_tree = (int)sys_sal_topic_intern(KPID, "test/fan/#");
+    uint32_t subs = 0;
+    for (uint32_t pid = 1; pid <= SAL_MAX_TOPIC_SUBS; pid++) {
+        subs += sys_sal_subscribe(pid, wide) == SAL_OK;
+        subs += sys_sal_subscribe(pid, fan_level) == SAL_OK;
+        subs += sys_sal_subscribe(pid, fan_tree) == SAL_OK;
+    }
+    test_assert(subs == 3 * SAL_MAX_TOPIC_SUBS, "Every subscription at the limit accepted");
+    test_assert(sys_sal_publish(KPID, wide, &v, sizeof(v)) == 3 * SAL_MAX_TOPIC_SUBS,
+                "Publish reaches every direct and pattern subscriber");
+    struct sal_topic_stats st;
+    sys_sal_topic_stats(KPID, wide, &st);
+    test_assert(st.subscribers == 3 * SAL_MAX_TOPIC_SUBS, "Subscriber set counts all of them");
+    test_assert(sys_sal_topic_recv(SAL_MAX_TOPIC_SUBS, fan_tree, &topic_out, &out, sizeof(out)) == sizeof(out),
+                "Last pattern subscriber receives");
+    for (uint32_t pid = 1; pid <= SAL_MAX_TOPIC_SUBS; pid++) {
+        sys_sal_unsubscribe(pid, wide);
+        sys_sal_unsubscribe(pid, fan_level);
+        sys_sal_unsubscribe(pid, fan_tree);
+    }
+}
+
+static uint32_t hist_total(const struct sal_queue_stats *st) {
+    uint32_t n = 0;
+    for (int b = 0; b < SAL_HIST_BUCKETS; b++) n += st->latency[b];
+    return n;
+}
+
+// Test mailbox and topic counters and latency histograms
+void test_sal_stats() {
+    test_start("SAL Queue Statistics");
+    
+    struct sal_queue_stats before, after;
+    uint32_t v = 0;
+    test_assert(sys_sal_stats(KPID, SAL_STATS_MAILBOX, KPID, &before) == SAL_OK, "Mailbox snapshot");
+    sys_sal_send(KPID, KPID, &v, sizeof(v));
+    sys_sal_send(KPID, KPID, &v, sizeof(v));
+    sys_sal_recv(KPID, SAL_ANY_PID, &v, sizeof(v));
+    sys_sal_recv(KPID, SAL_ANY_PID, &v, sizeof(v));
+    sys_sal_stats(KPID, SAL_STATS_MAILBOX, KPID, &after);
+    test_assert(after.messages - before.messages == 2, "Mailbox messages counted");
+    test_assert(after.bytes - before.bytes == 2 * sizeof(v), "Mailbox bytes counted");
+    test_assert(after.dequeued - before.dequeued == 2, "Mailbox receives counted");
+    test_assert(hist_total(&after) - hist_total(&before) == 2, "Each receive lands in one latency bucket");
+    test_assert(after.max_depth >= 2, "Mailbox max depth tracked");
+    
+    int topic = (int)sys_sal_topic_intern(KPID, "test/stats");
+    sys_sal_subscribe(KPID, topic);
+    for (v = 0; v < SAL_SUB_QUEUE_DEPTH + 1; v++) sys_sal_publish(KPID, topic, &v, sizeof(v));
+    sys_sal_topic_recv(KPID, topic, NULL, &v, sizeof(v));
+    test_assert(sys_sal_stats(KPID, SAL_STATS_TOPIC, topic, &after) == SAL_OK, "Topic snapshot");
+    test_assert(after.messages == SAL_SUB_QUEUE_DEPTH + 1, "Topic publishes counted");
+    test_assert(after.drops == 1, "Topic drops counted");
+    test_assert(after.max_depth == SAL_SUB_QUEUE_DEPTH, "Topic max depth tracked");
+    test_assert(after.dequeued == 1, "Topic receives counted");
+    test_assert(sys_sal_stats(KPID, SAL_STATS_TOPIC, 0, &after) == SAL_ERR_INVAL, "Unknown topic rejected");
+    sys_sal_unsubscribe(KPID, topic);
+}
+
+// Real-time tasks for test_sal_rt(): PIDs no other test uses
+#define RT_A 10
+#define RT_B 11
+#define RT_C 12
+#define RT_D 13
+
+// Run the real-time class for ticks [from, to): each tick the earliest
+// deadline job runs, and blocks once it has had demand[i] ticks in its
+// current job. Returns the ticks left over for best effort.
+static uint32_t rt_simulate(const uint32_t *pids, const uint32_t *demand, int n, uint32_t from, uint32_t to) {
+    uint32_t ran[SAL_MAX_PROCS] = { 0 }, jobs[SAL_MAX_PROCS] = { 0 }, mask = 0, idle = 0;
+    struct sal_rt_stats st;
+    for (int i = 0; i < n; i++) {
+        mask |= 1u << pids[i];
+        sys_sal_rt_stats(KPID, (int)pids[i], &st);
+        jobs[pids[i]] = st.jobs;
+    }
+    for (uint32_t t = from; t < to; t++) {
+        int pick = sal_rt_pick(mask);
+        if (pick < 0) {
+            idle++;
+        } else {
+            for (int i = 0; i < n; i++) {
+                if (pids[i] == (uint32_t)pick && ++ran[pick] == demand[i]) sal_rt_complete((uint32_t)pick, t);
+            }
+        }
+        sal_rt_tick(t + 1, pick < 0 ? KPID : (uint32_t)pick);
+        for (int i = 0; i < n; i++) {
+            sys_sal_rt_stats(KPID, (int)pids[i], &st);
+            if (st.jobs != jobs[pids[i]]) ran[pids[i]] = 0;
+            jobs[pids[i]] = st.jobs;
+        }
+    }
+    return idle;
+}
+
+// Test the real-time class: admission, EDF order, budgets and misses
+void test_sal_rt() {
+    test_start("SAL Real-Time Scheduling");
+    
+    struct sal_rt_params zero = { 10, 0, 0 }, over = { 10, 5, 4 }, late = { 10, 2, 12 };
+    struct sal_rt_params slow = { SAL_RT_MAX_PERIOD + 1, 1, 0 };
+    struct sal_rt_stats st;
+    test_assert(sal_rt_admit_at(RT_A, NULL, 0) == SAL_ERR_INVAL, "Missing reservation rejected");
+    test_assert(sal_rt_admit_at(RT_A, &zero, 0) == SAL_ERR_INVAL, "Zero budget rejected");
+    test_assert(sal_rt_admit_at(RT_A, &over, 0) == SAL_ERR_INVAL, "Budget over the deadline rejected");
+    test_assert(sal_rt_admit_at(RT_A, &late, 0) == SAL_ERR_INVAL, "Deadline past the period rejected");
+    test_assert(sal_rt_admit_at(RT_A, &slow, 0) == SAL_ERR_INVAL, "Period over the maximum rejected");
+    test_assert(sys_sal_rt_stats(KPID, RT_A, &st) == SAL_ERR_INVAL, "No stats for a task outside the class");
+    
+    // 30% + 50% (budget over deadline) + 20% passes 90%; 10% fits
+    struct sal_rt_params a = { 10, 3, 0 }, b = { 5, 2, 4 }, c = { 10, 2, 0 };
+    test_assert(sal_rt_admit_at(RT_A, &a, 0) == SAL_OK, "30% reservation admitted");
+    test_assert(sal_rt_admit_at(RT_B, &b, 0) == SAL_OK, "50% reservation admitted");
+    test_assert(sal_rt_admit_at(RT_C, &c, 0) == SAL_ERR_BUSY, "Admission stops at the utilization bound");
+    c.budget = 1;
+    test_assert(sal_rt_admit_at(RT_C, &c, 0) == SAL_OK, "Reservation up to the bound admitted");
+    test_assert(sys_sal_rt_stats(KPID, RT_B, &st) == SAL_OK, "Stats read for a member");
+    test_assert(st.deadline == 4, "Explicit deadline reported");
+    test_assert(st.utilization == 32768, "Utilization is budget over deadline");
+    test_assert(st.jobs == 1, "First job released at admission");
+    
+    uint32_t all = 1u << RT_A | 1u << RT_B | 1u << RT_C;
+    test_assert(sal_rt_pick(all) == RT_B, "Earliest deadline picked");
+    test_assert(sal_rt_pick(all & ~(1u << RT_B)) == RT_A, "Only runnable tasks picked; lowest PID on a tie");
+    test_assert(sal_rt_pick(0) == -1, "Nothing picked with nothing runnable");
+    
+    // Jobs that keep to their budgets all make their deadlines, and the
+    // 20% the class does not use is left to best effort
+    const uint32_t pids[3] = { RT_A, RT_B, RT_C };
+    const uint32_t fit[3] = { 3, 2, 1 }, overrun[3] = { 3, 2, 5 };
+    uint32_t idle = rt_simulate(pids, fit, 3, 0, 100);
+    test_assert(idle == 20, "Feasible set leaves the unreserved ticks idle");
+    sys_sal_rt_stats(KPID, RT_A, &st);
+    test_assert(st.misses == 0, "Feasible set: A meets every deadline");
+    test_assert(st.throttled == 0, "Feasible set: A stays within budget");
+    sys_sal_rt_stats(KPID, RT_B, &st);
+    test_assert(st.misses == 0, "Feasible set: B meets every deadline");
+    test_assert(st.throttled == 0, "Feasible set: B stays within budget");
+    test_assert(st.jobs == 21, "Feasible set: B released every period");
+    sys_sal_rt_stats(KPID, RT_C, &st);
+    test_assert(st.misses == 0, "Feasible set: C meets every deadline");
+    test_assert(st.throttled == 0, "Feasible set: C stays within budget");
+    
+    // C overruns: it is throttled at its budget and misses, nobody else does
+    idle = rt_simulate(pids, overrun, 3, 100, 200);
+    test_assert(idle == 20, "Overrun does not eat into best effort");
+    sys_sal_rt_stats(KPID, RT_A, &st);
+    test_assert(st.misses == 0, "Overrun: A still meets every deadline");
+    sys_sal_rt_stats(KPID, RT_B, &st);
+    test_assert(st.misses == 0, "Overrun: B still meets every deadline");
+    sys_sal_rt_stats(KPID, RT_C, &st);
+    test_assert(st.throttled == 10, "Overrun: C throttled every job");
+    test_assert(st.misses == 10, "Overrun: C misses every job");
+    
+    // A job that finishes after its deadline records its lateness
+    sys_sal_rt_leave(RT_A);
+    sys_sal_rt_leave(RT_B);
+    sys_sal_rt_leave(RT_C);
+    struct sal_rt_params d = { 10, 2, 5 };
+    sal_rt_admit_at(RT_D, &d, 1000);
+    for (uint32_t t = 1001; t <= 1005; t++) sal_rt_tick(t, KPID);
+    sal_rt_complete(RT_D, 1007);
+    sys_sal_rt_stats(KPID, RT_D, &st);
+    test_assert(st.misses == 1, "Miss counted at the deadline");
+    test_assert(st.max_lateness == 2, "Lateness recorded at completion");
+    
+    // Blocking in sal_wait() ends the caller's job
+    struct sal_rt_params k = { 10, 1, 0 };
+    int port = (int)sys_sal_port_create(KPID);
+    struct sal_event ev;
+    sal_rt_admit_at(KPID, &k, sal_arch_ticks());
+    test_assert(sal_rt_pick(1u << KPID) == KPID, "Released job pending");
+    sys_sal_wait(KPID, port, &ev, 1, 1);
+    test_assert(sal_rt_pick(1u << KPID) == -1, "Blocking in sal_wait ends the job");
+    sys_sal_port_close(KPID, port);
+    
+    struct sal_rt_params big = { 10, 9, 0 };
+    test_assert(sys_sal_rt_leave(KPID) == SAL_OK, "Caller leaves the class");
+    test_assert(sys_sal_rt_leave(RT_D) == SAL_OK, "Task leaves the class");
+    test_assert(sys_sal_rt_leave(RT_D) == SAL_ERR_INVAL, "Leaving twice rejected");
+    test_assert(sal_rt_admit_at(RT_A, &big, 0) == SAL_OK, "Leaving frees the reservation");
+    sys_sal_rt_leave(RT_A);
+}
+
+// Test versioned wire layouts and the generated codecs
+void test_sal_wire() {
+    test_start("SAL Wire Layouts");
+    
+    static uint8_t buf[SAL_TOPIC_MSG_MAX] __attribute__((aligned(WIRE_ALIGN)));
+    test_assert(sizeof(struct wire_hdr) == WIRE_ALIGN, "Wire header keeps its size unpacked");
+    test_assert(sizeof(struct sal_message) == 24, "Message header keeps its size unpacked");
+    test_assert(offsetof(struct HRVBatch, heart_rate) % WIRE_ALIGN == 0,
+                "HRV batch arrays start on 16-byte boundaries");
+    test_assert(offsetof(struct EEGBatch, relaxation_level) % WIRE_ALIGN == 0,
+                "EEG batch arrays start on 16-byte boundaries");
+    test_assert(EEG_BATCH_WIRE_SIZE <= SAL_TOPIC_MSG_MAX, "Largest batch fits a topic message");
+    
+    struct AuthMsg msg = { .type = AUTH_VERIFY, .user_id = 7, .timestamp = 1234 };
+    msg.security_token[31] = 0xA5;
+    struct AuthMsg got = { 0 };
+    struct HRVData hrv = { .timestamp = 9, .heart_rate = 72.0f, .hrv_score = 0.8f, .stress_level = 0.3f }, hrv_out;
+    long len = auth_msg_encode(&msg, 1, buf, sizeof(buf));
+    test_assert(len == (long)AUTH_MSG_WIRE_SIZE, "Auth message encoded with header");
+    test_assert(wire_type(buf, (size_t)len) == WIRE_TYPE_AUTH, "Header names the message type");
+    test_assert(auth_msg_decode(buf, (size_t)len, &got) == 1, "Auth message decoded");
+    test_assert(got.user_id == 7, "Round trip keeps the user id");
+    test_assert(got.timestamp == 1234, "Round trip keeps the timestamp");
+    test_assert(got.security_token[31] == 0xA5, "Round trip keeps the token");
+    test_assert(hrv_decode(buf, (size_t)len, &hrv_out) == WIRE_ERR_TYPE, "Wrong type rejected");
+    test_assert(auth_msg_decode(buf, (size_t)len - 1, &got) == WIRE_ERR_FORMAT, "Truncated message rejected");
+    test_assert(auth_msg_encode(&msg, 1, buf, 8) == WIRE_ERR_SPACE, "Encoder checks space");
+    test_assert(auth_msg_encode(&msg, 2, buf, sizeof(buf)) == WIRE_ERR_FORMAT, "Encoder checks count");
+    
+    // An older sender without the last field, then a newer one with extra data
+    len = hrv_encode(&hrv, 1, buf, sizeof(buf));
+    ((struct wire_hdr *)buf)->length = offsetof(struct HRVData, stress_level);
+    test_assert(hrv_decode(buf, (size_t)len, &hrv_out) == 1, "Older version decoded");
+    test_assert(hrv_out.hrv_score == 0.8f, "Fields the older version had are read");
+    test_assert(hrv_out.stress_level == 0.0f, "Field missing from an older version reads as zero");
+    ((struct wire_hdr *)buf)->length = sizeof(struct HRVData) + 16;
+    test_assert(hrv_decode(buf, (size_t)len + 16, &hrv_out) == 1, "Newer version decoded");
+    test_assert(hrv_out.stress_level == 0.3f, "Fields added by a newer version are skipped");
+    
+    // A struct-of-arrays batch through a mailbox
+    static struct EEGBatch batch, batch_out;
+    for (int i = 0; i < 5; i++) {
+        batch.timestamp[i] = (uint32_t)i;
+        batch.alpha_waves[i] = (float)i * 0.5f;
+    }
+    len = eeg_batch_encode(&batch, 5, buf, sizeof(buf));
+    test_assert(sys_sal_send(KPID, KPID, buf, (size_t)len) == len, "Encoded batch sent");
+    uint32_t in[SAL_TOPIC_MSG_MAX / 4];
+    long n = sys_sal_recv(KPID, KPID, in, sizeof(in));
+    test_assert(eeg_batch_decode(in, (size_t)n, &batch_out) == 5, "Batch decoded with its sample count");
+    test_assert(batch_out.timestamp[4] == 4, "Batch timestamps intact");
+    test_assert(batch_out.alpha_waves[3] == 1.5f, "Batch samples intact");
+}
+
+// Main SAL test runner
+void run_sal_tests() {
+    serial_print("\n");
+    serial_print("==========================================\n");
+    serial_print("    AERODESK SAL TEST SUITE\n");
+    serial_print("==========================================\n");
+    
+    test_sal_mailbox();
+    test_sal_grants();
+    test_sal_pubsub();
+    test_sal_channels();
+    test_sal_batching();
+    test_sal_ports();
+    test_sal_handles();
+    test_sal_policies();
+    test_sal_pool();
+    test_sal_priority();
+    test_sal_retention();
+    test_sal_wildcards();
+    test_sal_stats();
+    test_sal_rt();
+    test_sal_wire();
+    
+    test_end();
+}
@@ -0,0 +1,24 @@
+#ifndef SAL_TEST_H
+#define SAL_TEST_H
+
+// SAL test function declarations (run in kernel context as PID 0)
+void run_sal_tests(void);
+
+// Individual test functions
+void test_sal_mailbox(void);
+void test_sal_grants(void);
+void test_sal_pubsub(void);
+void test_sal_channels(void);
+void test_sal_batching(void);
+void test_sal_ports(void);
+void test_sal_handles(void);
+void test_sal_policies(void);
+void test_sal_pool(void);
+void test_sal_priority(void);
+void test_sal_retention(void);
+void test_sal_wildcards(void);
+void test_sal_stats(void);
+void test_sal_rt(void);
+void test_sal_wire(void);
+
+#endif // SAL_TEST_H